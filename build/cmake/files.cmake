@@ -530,6 +530,7 @@ set(BASE_CMN_HDR
     wx/eventfilter.h
     wx/evtloop.h
     wx/evtloopsrc.h
+    wx/evtprofiler.h
     wx/except.h
     wx/features.h
     wx/flags.h
@@ -776,6 +777,7 @@ set(GUI_CMN_SRC
     src/common/imagall.cpp
     src/common/imagbmp.cpp
     src/common/image.cpp
+    src/common/imageloader.cpp
     src/common/imagfill.cpp
     src/common/imaggif.cpp
     src/common/imagiff.cpp
@@ -1085,6 +1087,7 @@ set(GUI_CMN_HDR
     wx/iconbndl.h
     wx/imagbmp.h
     wx/image.h
+    wx/imageloader.h
     wx/imaggif.h
     wx/imagiff.h
     wx/imagjpeg.h
@@ -514,15 +514,15 @@ protected:
 
     // pending events management vars:
 
-    // the array of the handlers with pending events which needs to be processed
+    // the list of the handlers with pending events which needs to be processed
     // inside ProcessPendingEvents()
-    wxEvtHandlerArray m_handlersWithPendingEvents;
+    wxEvtHandlerPendingList m_handlersWithPendingEvents;
 
-    // helper array used by ProcessPendingEvents() to store the event handlers
+    // helper list used by ProcessPendingEvents() to store the event handlers
     // which have pending events but of these events none can be processed right now
     // (because of a call to wxEventLoop::YieldFor() which asked to selectively process
     // pending events)
-    wxEvtHandlerArray m_handlersWithPendingDelayedEvents;
+    wxEvtHandlerPendingList m_handlersWithPendingDelayedEvents;
 
 #if wxUSE_THREADS
     // this critical section protects both the lists above
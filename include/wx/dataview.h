@@ -124,6 +124,12 @@ public:
     virtual bool BeforeReset() { return true; }
     virtual bool AfterReset() { return Cleared(); }
 
+    // called by wxDataViewModel::BeginBatch() and EndBatch(), the notifier may
+    // defer any expensive processing of the notifications received between
+    // these calls until the end of the batch
+    virtual void BeginBatch() { }
+    virtual void EndBatch() { }
+
     virtual void Resort() = 0;
 
     void SetOwner( wxDataViewModel *owner ) { m_owner = owner; }
@@ -265,6 +271,13 @@ public:
     bool BeforeReset();
     bool AfterReset();
 
+    // group many notifications together, allowing the controls to process
+    // them more efficiently: calls to these functions can be nested and only
+    // the outermost EndBatch() really ends the batch
+    void BeginBatch();
+    void EndBatch();
+    bool IsInBatch() const { return m_batchCount != 0; }
+
 
     // delegated action
     virtual void Resort();
@@ -297,6 +310,9 @@ protected:
 
 private:
     wxDataViewModelNotifiers  m_notifiers;
+
+    // the nesting level of BeginBatch() calls
+    int m_batchCount;
 };
 
 // ----------------------------------------------------------------------------
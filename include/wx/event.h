@@ -47,6 +47,9 @@
 class WXDLLIMPEXP_FWD_BASE wxList;
 class WXDLLIMPEXP_FWD_BASE wxEvent;
 class WXDLLIMPEXP_FWD_BASE wxEventFilter;
+class WXDLLIMPEXP_FWD_BASE wxEvtHandlerPendingList;
+class wxDynamicEventTableIndex;
+class wxDynamicEventTableSearch;
 #if wxUSE_GUI
     class WXDLLIMPEXP_FWD_CORE wxDC;
     class WXDLLIMPEXP_FWD_CORE wxMenu;
@@ -3357,7 +3360,8 @@ struct WXDLLIMPEXP_BASE wxEventTableEntryBase
         : m_id(winid),
           m_lastId(idLast),
           m_fn(fn),
-          m_callbackUserData(data)
+          m_callbackUserData(data),
+          m_handlerId(NewHandlerId())
     {
         wxASSERT_MSG( idLast == wxID_ANY || winid <= idLast,
                       "invalid IDs range: lower bound > upper bound" );
@@ -3367,7 +3371,8 @@ struct WXDLLIMPEXP_BASE wxEventTableEntryBase
         : m_id( entry.m_id ),
           m_lastId( entry.m_lastId ),
           m_fn( entry.m_fn ),
-          m_callbackUserData( entry.m_callbackUserData )
+          m_callbackUserData( entry.m_callbackUserData ),
+          m_handlerId( entry.m_handlerId )
     {
         // This is a 'hack' to ensure that only one instance tries to delete
         // the functor pointer. It is safe as long as the only place where the
@@ -3394,7 +3399,14 @@ struct WXDLLIMPEXP_BASE wxEventTableEntryBase
     // arbitrary user data associated with the callback
     wxObject* m_callbackUserData;
 
+    // unique identifier of this entry, used by wxEventProfiler: unlike the
+    // functor pointer, it is never reused for another handler
+    unsigned long m_handlerId;
+
 private:
+    // return a new value for m_handlerId
+    static unsigned long NewHandlerId();
+
     wxDECLARE_NO_ASSIGN_CLASS(wxEventTableEntryBase);
 };
 
@@ -3930,6 +3942,14 @@ protected:
     typedef wxVector<wxDynamicEventTableEntry*> DynamicEvents;
     DynamicEvents* m_dynamicEvents;
 
+    // Index of m_dynamicEvents by the event type, only created if there are
+    // many of them to avoid searching all of them for every event.
+    wxDynamicEventTableIndex* m_dynamicEventsIndex;
+
+    // Number of the null entries corresponding to the unbound handlers in
+    // m_dynamicEvents which haven't been pruned yet.
+    size_t m_dynamicEventsUnbound;
+
     wxList*             m_pendingEvents;
 
 #if wxUSE_THREADS
@@ -3972,14 +3992,75 @@ private:
     // try to process events in all handlers chained to this one
     bool DoTryChain(wxEvent& event);
 
+    // remove the entry which is being unbound from m_dynamicEventsIndex
+    void RemoveFromDynamicEventsIndex(const wxDynamicEventTableEntry* entry);
+
+    // must be called after resetting some entries of m_dynamicEvents to null
+    // and incrementing m_dynamicEventsUnbound
+    void PruneUnboundDynamicEventsIfNeeded();
+
+    // remove the null entries from m_dynamicEvents and m_dynamicEventsIndex,
+    // can only be called when SearchDynamicEventTable() is not running
+    void PruneUnboundDynamicEvents();
+
+    // The innermost SearchDynamicEventTable() call in progress, if any.
+    wxDynamicEventTableSearch* m_dynamicEventsSearch;
+
     // Head of the event filter linked list.
     static wxEventFilter* ms_filterList;
 
+    // The links used by wxEvtHandlerPendingList and the list containing this
+    // handler, if any.
+    wxEvtHandler* m_prevPending;
+    wxEvtHandler* m_nextPending;
+    const wxEvtHandlerPendingList* m_pendingList;
+
+    friend class wxEvtHandlerPendingList;
+    friend class wxDynamicEventTableSearch;
+
     wxDECLARE_DYNAMIC_CLASS_NO_COPY(wxEvtHandler);
 };
 
 WX_DEFINE_ARRAY_WITH_DECL_PTR(wxEvtHandler *, wxEvtHandlerArray, class WXDLLIMPEXP_BASE);
 
+// ----------------------------------------------------------------------------
+// wxEvtHandlerPendingList: list of handlers with pending events
+// ----------------------------------------------------------------------------
+
+// This is an intrusive doubly linked list using the links stored in the event
+// handlers themselves, which allows to add and remove them in constant time.
+// A handler can belong to at most one such list at any given moment.
+//
+// This class is only used by wxAppConsoleBase and is not thread-safe, its
+// users must protect it from concurrent access themselves.
+class WXDLLIMPEXP_BASE wxEvtHandlerPendingList
+{
+public:
+    wxEvtHandlerPendingList() : m_first(NULL), m_last(NULL) { }
+
+    bool IsEmpty() const { return m_first == NULL; }
+
+    wxEvtHandler* GetFirst() const { return m_first; }
+
+    bool Contains(const wxEvtHandler* handler) const
+        { return handler->m_pendingList == this; }
+
+    // append the handler which must not be in any list yet to this one
+    void Append(wxEvtHandler* handler);
+
+    // remove the handler from this list, return false if it wasn't in it
+    bool Remove(wxEvtHandler* handler);
+
+    // move all handlers from the other list to the end of this one
+    void Splice(wxEvtHandlerPendingList& other);
+
+private:
+    wxEvtHandler* m_first;
+    wxEvtHandler* m_last;
+
+    wxDECLARE_NO_COPY_CLASS(wxEvtHandlerPendingList);
+};
+
 
 // Define an inline method of wxObjectEventFunctor which couldn't be defined
 // before wxEvtHandler declaration: at least Sun CC refuses to compile function
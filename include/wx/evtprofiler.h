@@ -0,0 +1,95 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/evtprofiler.h
+// Purpose:     wxEventProfiler class declaration.
+// Author:      wxWidgets team
+// Created:     2020-03-17
+// Copyright:   (c) 2020 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_EVTPROFILER_H_
+#define _WX_EVTPROFILER_H_
+
+#include "wx/defs.h"
+
+#if wxUSE_STOPWATCH
+
+#include "wx/event.h"
+#include "wx/longlong.h"
+#include "wx/string.h"
+#include "wx/vector.h"
+
+// ----------------------------------------------------------------------------
+// wxEventProfiler: collects statistics about the time taken by event handlers
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_BASE wxEventProfiler
+{
+public:
+    // Statistics about all the calls to the given handler, called for the
+    // objects of the given class, for the events of the given type.
+    struct Stats
+    {
+        wxEventType eventType;
+
+        // opaque identifier of the handler, different for each Bind() call
+        // and each event table entry and never reused
+        unsigned long handlerId;
+        wxString handlerClass;
+        unsigned long count;
+
+        // all times are in microseconds
+        wxLongLong totalTime;
+        wxLongLong maxTime;
+    };
+
+    // A single call to an event handler.
+    struct Call
+    {
+        wxEventType eventType;
+        unsigned long handlerId;
+        wxString handlerClass;
+        wxLongLong time;
+    };
+
+
+    // Start collecting the statistics, also remembering the given number of
+    // the most recent handler calls.
+    static void Start(size_t numRecentCalls = 1024);
+
+    // Stop collecting the statistics, the already collected ones are kept.
+    static void Stop();
+
+    // Return true if the statistics are being collected.
+    static bool IsRunning() { return ms_isRunning; }
+
+    // Forget all the statistics collected so far.
+    static void Reset();
+
+
+    // Get the statistics sorted in decreasing total time order.
+    static void GetStats(wxVector<Stats>& stats);
+
+    // Get the most recent handler calls, from the oldest to the newest one.
+    static void GetRecentCalls(wxVector<Call>& calls);
+
+    // Return a human-readable report containing the given number of the most
+    // expensive handlers and event types.
+    static wxString GetReport(size_t maxLines = 20);
+
+
+    // Implementation only: called by wxEvtHandler after calling a handler.
+    static void WXRecordCall(wxEventType eventType,
+                             unsigned long handlerId,
+                             const wxChar* handlerClass,
+                             const wxLongLong& time);
+
+private:
+    static bool ms_isRunning;
+
+    wxDECLARE_NO_COPY_CLASS(wxEventProfiler);
+};
+
+#endif // wxUSE_STOPWATCH
+
+#endif // _WX_EVTPROFILER_H_
@@ -132,6 +132,71 @@ private:
   int m_lasterror; // errno value of last error
 };
 
+// ----------------------------------------------------------------------------
+// class wxMappedFile: read-only access to the entire file contents, which are
+// mapped in memory if possible or read into it otherwise
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_BASE wxMappedFile
+{
+public:
+    // the expected access pattern, used as a hint for the OS paging
+    enum Access
+    {
+        Access_Default,     // no particular pattern
+        Access_Sequential,  // the data is read from the beginning to the end
+        Access_Random       // the data is accessed in random order
+    };
+
+    wxMappedFile() { Init(); }
+    explicit wxMappedFile(const wxString& fileName,
+                          Access access = Access_Sequential)
+    {
+        Init();
+        Open(fileName, access);
+    }
+
+    ~wxMappedFile() { Close(); }
+
+    // map the file with the given name
+    bool Open(const wxString& fileName, Access access = Access_Sequential);
+
+    // map the given file which must be opened for reading, it may be closed
+    // after this function returns without affecting the mapping
+    bool Open(wxFile& file, Access access = Access_Sequential);
+
+    // unmap the file (nothing is done if it wasn't mapped)
+    void Close();
+
+    // is the file opened? notice that it may still be empty
+    bool IsOpened() const { return m_data != NULL; }
+
+    // is the data really mapped in memory or was it read from the file?
+    bool IsMapped() const { return m_mapping != NULL; }
+
+    // access the contents of the file
+    const char *GetData() const { return m_data; }
+    size_t GetLength() const { return m_length; }
+
+private:
+    void Init()
+    {
+        m_data = NULL;
+        m_length = 0;
+        m_mapping = NULL;
+    }
+
+    // the file contents, either pointing to m_mapping or m_buffer
+    const char *m_data;
+    size_t m_length;
+
+    // the mapping, if non-NULL, or the buffer with the file contents otherwise
+    void *m_mapping;
+    wxCharBuffer m_buffer;
+
+    wxDECLARE_NO_COPY_CLASS(wxMappedFile);
+};
+
 // ----------------------------------------------------------------------------
 // class wxTempFile: if you want to replace another file, create an instance
 // of wxTempFile passing the name of the file to be replaced to the ctor. Then
@@ -682,6 +682,12 @@ public:
     virtual void SetRowAttr(wxGridCellAttr *attr, int row);
     virtual void SetColAttr(wxGridCellAttr *attr, int col);
 
+    // set the attribute for all cells of the given block at once, this is
+    // much more efficient than setting it for each of them individually
+    virtual void SetBlockAttr(wxGridCellAttr *attr,
+                              int topRow, int leftCol,
+                              int bottomRow, int rightCol);
+
     // these functions must be called whenever some rows/cols are deleted
     // because the internal data must be updated then
     void UpdateAttrRows( size_t pos, int numRows );
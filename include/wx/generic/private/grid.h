@@ -28,56 +28,69 @@ wxDECLARE_EVENT( wxEVT_GRID_HIDE_EDITOR, wxCommandEvent );
 WX_DEFINE_ARRAY_WITH_DECL_PTR(wxGridCellAttr *, wxArrayAttrs,
                                  class WXDLLIMPEXP_ADV);
 
-struct wxGridCellWithAttr
+// hash and comparison functors allowing to use wxGridCellCoords as hash key
+class wxGridCellCoordsHash
 {
-    wxGridCellWithAttr(int row, int col, wxGridCellAttr *attr_)
-        : coords(row, col), attr(attr_)
+public:
+    wxGridCellCoordsHash() { }
+
+    size_t operator()(const wxGridCellCoords& coords) const
     {
-        wxASSERT( attr );
+        // grids typically have many more rows than columns, so multiply the
+        // row by a prime bigger than any reasonable number of columns
+        return static_cast<size_t>(coords.GetRow()) * 65599u +
+                static_cast<size_t>(coords.GetCol());
     }
+};
+
+class wxGridCellCoordsEqual
+{
+public:
+    wxGridCellCoordsEqual() { }
 
-    wxGridCellWithAttr(const wxGridCellWithAttr& other)
-        : coords(other.coords),
-          attr(other.attr)
+    bool operator()(const wxGridCellCoords& a, const wxGridCellCoords& b) const
     {
-        attr->IncRef();
+        return a == b;
     }
+};
+
+WX_DECLARE_HASH_MAP_WITH_DECL(wxGridCellCoords, wxGridCellAttr*,
+                              wxGridCellCoordsHash, wxGridCellCoordsEqual,
+                              wxGridCellCoordsToAttrMap, class WXDLLIMPEXP_ADV);
 
-    wxGridCellWithAttr& operator=(const wxGridCellWithAttr& other)
+// attribute set for a rectangular block of cells
+struct wxGridCellBlockWithAttr
+{
+    wxGridCellBlockWithAttr(int topRow_, int leftCol_,
+                            int bottomRow_, int rightCol_,
+                            wxGridCellAttr *attr_)
+        : topRow(topRow_), leftCol(leftCol_),
+          bottomRow(bottomRow_), rightCol(rightCol_),
+          attr(attr_)
     {
-        coords = other.coords;
-        if (attr != other.attr)
-        {
-            attr->DecRef();
-            attr = other.attr;
-            attr->IncRef();
-        }
-        return *this;
     }
 
-    void ChangeAttr(wxGridCellAttr* new_attr)
+    bool Contains(int row, int col) const
     {
-        if (attr != new_attr)
-        {
-            // "Delete" (i.e. DecRef) the old attribute.
-            attr->DecRef();
-            attr = new_attr;
-            // Take ownership of the new attribute, i.e. no IncRef.
-        }
+        return row >= topRow && row <= bottomRow &&
+                col >= leftCol && col <= rightCol;
     }
 
-    ~wxGridCellWithAttr()
+    bool SameBlock(int topRow_, int leftCol_, int bottomRow_, int rightCol_) const
     {
-        attr->DecRef();
+        return topRow == topRow_ && leftCol == leftCol_ &&
+                bottomRow == bottomRow_ && rightCol == rightCol_;
     }
 
-    wxGridCellCoords coords;
-    wxGridCellAttr  *attr;
-};
-
-WX_DECLARE_OBJARRAY_WITH_DECL(wxGridCellWithAttr, wxGridCellWithAttrArray,
-                              class WXDLLIMPEXP_ADV);
+    int topRow,
+        leftCol,
+        bottomRow,
+        rightCol;
 
+    // this pointer is owned by wxGridCellAttrData and not by this struct
+    // itself, to allow using it in a wxVector without any overhead
+    wxGridCellAttr *attr;
+};
 
 // ----------------------------------------------------------------------------
 // private classes
@@ -445,19 +458,42 @@ private:
 // ----------------------------------------------------------------------------
 
 // this class stores attributes set for cells
+//
+// The attributes of the individual cells are kept in a hash map indexed by the
+// cell coordinates, so that looking them up, which is done for every cell
+// being drawn, doesn't depend on the number of cells having attributes.
+// Attributes set for whole blocks of cells are stored separately as ranges as
+// there are normally only a few of them.
 class WXDLLIMPEXP_ADV wxGridCellAttrData
 {
 public:
+    wxGridCellAttrData() { }
+    ~wxGridCellAttrData();
+
     void SetAttr(wxGridCellAttr *attr, int row, int col);
+    void SetBlockAttr(wxGridCellAttr *attr,
+                      int topRow, int leftCol, int bottomRow, int rightCol);
     wxGridCellAttr *GetAttr(int row, int col) const;
     void UpdateAttrRows( size_t pos, int numRows );
     void UpdateAttrCols( size_t pos, int numCols );
 
 private:
-    // searches for the attr for given cell, returns wxNOT_FOUND if not found
-    int FindIndex(int row, int col) const;
+    // helper of UpdateAttr{Rows,Cols}(): adjust the given range of rows or
+    // columns for the insertion or deletion of numRowsOrCols at pos, return
+    // false if the range was completely deleted
+    static bool UpdateRange(int& first, int& last, size_t pos, int numRowsOrCols);
+
+    // common part of UpdateAttr{Rows,Cols}()
+    void UpdateCellAttrs(size_t pos, int numRowsOrCols, bool rows);
+    void UpdateBlockAttrs(size_t pos, int numRowsOrCols, bool rows);
+
+    wxGridCellCoordsToAttrMap m_attrs;
+
+    // block attributes, in the order of their addition: later ones take
+    // precedence over the earlier ones
+    wxVector<wxGridCellBlockWithAttr> m_blockAttrs;
 
-    wxGridCellWithAttrArray m_attrs;
+    wxDECLARE_NO_COPY_CLASS(wxGridCellAttrData);
 };
 
 // this class stores attributes set for rows or columns
@@ -18,6 +18,7 @@
 #include "wx/image.h"
 #include "wx/animdecod.h"
 #include "wx/dynarray.h"
+#include "wx/vector.h"
 
 // internal utility used to store a frame in 8bit-per-pixel format
 class GIFImage;
@@ -52,7 +53,9 @@ public:
     wxGIFDecoder();
     ~wxGIFDecoder();
 
-    // get data of current frame
+    // get data of current frame: notice that the frames are decoded on demand
+    // and only a few of them are kept in memory, so the pointer returned by
+    // GetData() is only valid until the data of other frames is requested
     unsigned char* GetData(unsigned int frame) const;
     unsigned char* GetPalette(unsigned int frame) const;
     unsigned int GetNcolours(unsigned int frame) const;
@@ -94,10 +97,16 @@ private:
     wxGIFErrorCode dgif(wxInputStream& stream,
                         GIFImage *img, int interl, int bits);
 
+    // decode the frame if it's not decoded yet
+    wxGIFErrorCode DecodeFrame(unsigned int frame);
+
 
     // array of all frames
     wxArrayPtrVoid m_frames;
 
+    // indices of the decoded frames, from the least to the most recently used
+    wxVector<unsigned int> m_decodedFrames;
+
     // decoder state vars
     int           m_restbits;       // remaining valid bits
     unsigned int  m_restbyte;       // remaining bytes in this block
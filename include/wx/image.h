@@ -73,6 +73,42 @@ enum wxImageResizeQuality
     wxIMAGE_QUALITY_HIGH = 4
 };
 
+// Constants for wxImage::Blur() selecting the blur algorithm
+enum wxImageBlurMode
+{
+    // simple averaging over a box of the given radius
+    wxIMAGE_BLUR_BOX,
+
+    // approximation of the Gaussian blur with the given standard deviation
+    wxIMAGE_BLUR_GAUSSIAN
+};
+
+// Layouts of the interleaved pixel buffers used with wxImage::ExportPixels()
+// and ImportPixels(): all of them use 4 bytes per pixel
+enum wxImagePixelFormat
+{
+    // R, G, B, A bytes, as used by e.g. GdkPixbuf
+    wxIMAGE_PIXEL_RGBA,
+
+    // B, G, R, A bytes, as used by e.g. 32bpp MSW DIBs
+    wxIMAGE_PIXEL_BGRA,
+
+    // native endian 32 bit 0xAARRGGBB values, as used by Cairo ARGB32 and
+    // RGB24 surfaces
+    wxIMAGE_PIXEL_ARGB32
+};
+
+// Flags for wxImage::ExportPixels() and ImportPixels()
+enum
+{
+    // colour components are premultiplied by alpha
+    wxIMAGE_PIXEL_PREMULTIPLIED = 1,
+
+    // the alpha component is not used: it is set to opaque when exporting and
+    // ignored when importing
+    wxIMAGE_PIXEL_NO_ALPHA = 2
+};
+
 // alpha channel values: fully transparent, default threshold separating
 // transparent pixels from opaque for a few functions dealing with alpha and
 // fully opaque
@@ -97,6 +133,32 @@ class WXDLLIMPEXP_FWD_CORE wxPalette;
 DECLARE_VARIANT_OBJECT_EXPORTED(wxImage,WXDLLIMPEXP_CORE)
 #endif
 
+//-----------------------------------------------------------------------------
+// wxImageRowsConsumer
+//-----------------------------------------------------------------------------
+
+// Interface for receiving the image rows as soon as they are decoded by
+// wxImageHandler::LoadRows(), without keeping the entire image in memory.
+class WXDLLIMPEXP_CORE wxImageRowsConsumer
+{
+public:
+    virtual ~wxImageRowsConsumer() { }
+
+    // Called once, before any rows are decoded, with the image size and
+    // whether it may have alpha channel. Return false to cancel loading.
+    virtual bool OnStart(int width, int height, bool hasAlpha) = 0;
+
+    // Called with the band of the rows of full image width starting at the
+    // given one. The image passed to this function is only valid during this
+    // call and must be copied if needed later. Return false to stop loading.
+    virtual bool OnRows(int firstRow, const wxImage& rows) = 0;
+
+    // Helper for wxImageHandler::LoadRows() implementations: calls OnRows()
+    // with an image using the given data, with alpha or not, without copying.
+    bool ConsumeRows(int width, int firstRow, int numRows,
+                     unsigned char* data, unsigned char* alpha);
+};
+
 //-----------------------------------------------------------------------------
 // wxImageHandler
 //-----------------------------------------------------------------------------
@@ -118,6 +180,14 @@ public:
                            bool WXUNUSED(verbose)=true )
         { return false; }
 
+    // Load the image passing its rows to the consumer in bands of (at most)
+    // the given number of rows. The default implementation loads the entire
+    // image using LoadFile() first, the handlers supporting incremental
+    // decoding override it to only keep a single band in memory.
+    virtual bool LoadRows( wxInputStream& stream, wxImageRowsConsumer& consumer,
+                           int bandHeight = 64, bool verbose = true,
+                           int index = -1 );
+
     int GetImageCount( wxInputStream& stream );
         // save the stream position, call DoGetImageCount() and restore the position
 
@@ -216,6 +286,25 @@ public:
                                unsigned char startB = 0 ) const;
 };
 
+//-----------------------------------------------------------------------------
+// wxImageDataReleaser: releases the external data used by wxImage
+//-----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxImageDataReleaser
+{
+public:
+    wxImageDataReleaser() { }
+
+    // Called with the pointers passed to wxImage::CreateFromExternal() when
+    // they're not used by any image any more, this object is deleted after
+    // this.
+    virtual void Release(unsigned char* data, unsigned char* alpha) = 0;
+
+    virtual ~wxImageDataReleaser() { }
+
+    wxDECLARE_NO_COPY_CLASS(wxImageDataReleaser);
+};
+
 //-----------------------------------------------------------------------------
 // wxImage
 //-----------------------------------------------------------------------------
@@ -295,6 +384,12 @@ public:
     bool Create( const wxSize& sz, unsigned char* data, unsigned char* alpha, bool static_data = false )
         { return Create(sz.GetWidth(), sz.GetHeight(), data, alpha, static_data); }
 
+    // Use the data owned by somebody else without copying it, the releaser
+    // (which may be NULL) is called when it's not used by any image any more.
+    bool CreateFromExternal( int width, int height,
+                             unsigned char* data, unsigned char* alpha,
+                             wxImageDataReleaser* releaser );
+
     void Destroy();
 
     // initialize the image data with zeroes
@@ -307,6 +402,9 @@ public:
     // return the new image with size width*height
     wxImage GetSubImage( const wxRect& rect) const;
 
+    // return the image sharing the given rows with this one, without copying
+    wxImage GetRowsView( int y, int height ) const;
+
     // Paste the image or part of this image into an image of the given size at the pos
     //  any newly exposed areas will be filled with the rgb colour
     //  by default if r = g = b = -1 then fill with this image's mask colour or find and
@@ -329,7 +427,7 @@ public:
     wxImage ResampleBicubic(int width, int height) const;
 
     // blur the image according to the specified pixel radius
-    wxImage Blur(int radius) const;
+    wxImage Blur(int radius, wxImageBlurMode mode = wxIMAGE_BLUR_BOX) const;
     wxImage BlurHorizontal(int radius) const;
     wxImage BlurVertical(int radius) const;
 
@@ -424,6 +522,11 @@ public:
     void SetLoadFlags(int flags);
     int GetLoadFlags() const;
 
+    // Set the maximal number of threads used for processing the image data,
+    // e.g. when resampling it, 0 means to use as many threads as CPUs.
+    static void SetMaxThreads(int numThreads);
+    static int GetMaxThreads();
+
     static bool CanRead( const wxString& name );
     static int GetImageCount( const wxString& name, wxBitmapType type = wxBITMAP_TYPE_ANY );
     virtual bool LoadFile( const wxString& name, wxBitmapType type = wxBITMAP_TYPE_ANY, int index = -1 );
@@ -473,6 +576,16 @@ public:
     void InitAlpha();
     void ClearAlpha();
 
+    // copy the image data, including alpha, if any, into/from a buffer with
+    // interleaved pixels in the given format and rows stride bytes apart
+    bool ExportPixels(void *buffer, int stride,
+                      wxImagePixelFormat format = wxIMAGE_PIXEL_RGBA,
+                      int flags = 0) const;
+    bool ImportPixels(int width, int height,
+                      const void *buffer, int stride,
+                      wxImagePixelFormat format = wxIMAGE_PIXEL_RGBA,
+                      int flags = 0);
+
     // return true if this pixel is masked or has alpha less than specified
     // threshold
     bool IsTransparent(int x, int y,
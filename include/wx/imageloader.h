@@ -0,0 +1,127 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/imageloader.h
+// Purpose:     wxImageLoader class declaration.
+// Author:      wxWidgets team
+// Created:     2020-03-19
+// Copyright:   (c) 2020 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_IMAGELOADER_H_
+#define _WX_IMAGELOADER_H_
+
+#include "wx/defs.h"
+
+#if wxUSE_IMAGE && wxUSE_STREAMS && wxUSE_THREADS
+
+#include "wx/event.h"
+#include "wx/image.h"
+
+class WXDLLIMPEXP_FWD_CORE wxImageLoaderEvent;
+class wxImageLoaderImpl;
+
+// ----------------------------------------------------------------------------
+// wxImageLoader: loads many images concurrently using several threads
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxImageLoader
+{
+public:
+    // If the handler is specified, wxEVT_IMAGE_LOADED events are queued to it
+    // as soon as each image is loaded, otherwise the images are kept until
+    // they're retrieved using GetImage(). By default, use as many threads as
+    // there are CPUs in the system.
+    explicit wxImageLoader(wxEvtHandler* handler = NULL, int numThreads = 0);
+
+    // Cancels the images not being loaded yet and waits for the others.
+    ~wxImageLoader();
+
+    // Scale the images loaded after this call down to fit into the given
+    // size, see wxIMAGE_OPTION_MAX_WIDTH and wxIMAGE_OPTION_MAX_HEIGHT.
+    void SetMaxSize(int maxWidth, int maxHeight);
+
+    // Queue an image for loading and return its index, starting from 0.
+    int Load(const wxString& filename,
+             wxBitmapType type = wxBITMAP_TYPE_ANY);
+
+    // Same as above, but for the stream, which is deleted by this object.
+    int Load(wxInputStream* stream,
+             wxBitmapType type = wxBITMAP_TYPE_ANY);
+
+    // Get the total number of the images queued so far.
+    int GetCount() const;
+
+    // Return true if the image with the given index was already loaded, or
+    // failed to be loaded, or was cancelled.
+    bool IsDone(int index) const;
+
+    // Wait until the image with the given index is loaded and return it. The
+    // returned image is invalid if loading it failed or was cancelled. This
+    // can be called only once for each image and can't be used at all if the
+    // images are sent to the event handler.
+    wxImage GetImage(int index);
+
+    // Wait until all the images queued so far are loaded and their events,
+    // if any, are queued.
+    void Wait();
+
+    // Don't load the images which are not being loaded yet.
+    void Cancel();
+
+private:
+    wxImageLoaderImpl* m_impl;
+
+    wxDECLARE_NO_COPY_CLASS(wxImageLoader);
+};
+
+// ----------------------------------------------------------------------------
+// wxImageLoader events
+// ----------------------------------------------------------------------------
+
+wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_CORE, wxEVT_IMAGE_LOADED, wxImageLoaderEvent );
+
+class WXDLLIMPEXP_CORE wxImageLoaderEvent : public wxEvent
+{
+public:
+    wxImageLoaderEvent(int index = -1,
+                       const wxString& filename = wxString(),
+                       const wxImage& image = wxImage())
+        : wxEvent(0, wxEVT_IMAGE_LOADED),
+          m_index(index),
+          m_filename(filename),
+          m_image(image)
+    {
+    }
+
+    // the index of the image returned by wxImageLoader::Load()
+    int GetIndex() const { return m_index; }
+
+    // the name of the image file, empty if it was loaded from a stream
+    const wxString& GetFileName() const { return m_filename; }
+
+    // the loaded image, invalid if loading it failed
+    const wxImage& GetImage() const { return m_image; }
+
+    bool IsOk() const { return m_image.IsOk(); }
+
+    virtual wxEvent *Clone() const wxOVERRIDE { return new wxImageLoaderEvent(*this); }
+
+private:
+    int m_index;
+    wxString m_filename;
+    wxImage m_image;
+
+    wxDECLARE_DYNAMIC_CLASS_NO_ASSIGN(wxImageLoaderEvent);
+};
+
+typedef void (wxEvtHandler::*wxImageLoaderEventFunction)(wxImageLoaderEvent&);
+
+#define wxImageLoaderEventHandler(func) \
+    wxEVENT_HANDLER_CAST(wxImageLoaderEventFunction, func)
+
+#define EVT_IMAGE_LOADED(func) \
+   wx__DECLARE_EVT0(wxEVT_IMAGE_LOADED, wxImageLoaderEventHandler(func))
+
+#endif // wxUSE_IMAGE && wxUSE_STREAMS && wxUSE_THREADS
+
+#endif // _WX_IMAGELOADER_H_
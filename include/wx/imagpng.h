@@ -52,6 +52,9 @@ public:
 #if wxUSE_STREAMS
     virtual bool LoadFile( wxImage *image, wxInputStream& stream, bool verbose=true, int index=-1 ) wxOVERRIDE;
     virtual bool SaveFile( wxImage *image, wxOutputStream& stream, bool verbose=true ) wxOVERRIDE;
+    virtual bool LoadRows( wxInputStream& stream, wxImageRowsConsumer& consumer,
+                           int bandHeight = 64, bool verbose = true,
+                           int index = -1 ) wxOVERRIDE;
 protected:
     virtual bool DoCanRead( wxInputStream& stream ) wxOVERRIDE;
 #endif
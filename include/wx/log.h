@@ -437,6 +437,11 @@ public:
     // change log target, logger may be NULL
     static wxLog *SetActiveTarget(wxLog *logger);
 
+    // return true if this log target can be used from any thread: in this
+    // case the messages logged from the threads other than main are passed
+    // to it directly instead of being buffered until the next Flush()
+    virtual bool IsThreadSafe() const { return false; }
+
 #if wxUSE_THREADS
     // change log target for the current thread only, shouldn't be called from
     // the main thread as it doesn't use thread-specific log target
@@ -655,6 +660,13 @@ private:
                       const wxString& msg,
                       const wxLogRecordInfo& info);
 
+    // called from CallDoLogNow() after handling the repeated messages and
+    // from OnLog() for the thread-safe loggers to add the extra information
+    // to the message and call DoLogRecord()
+    void CallDoLogRecord(wxLogLevel level,
+                         const wxString& msg,
+                         const wxLogRecordInfo& info);
+
 
     // variables
     // ----------------
@@ -864,6 +876,48 @@ private:
     wxDECLARE_NO_COPY_CLASS(wxLogInterposerTemp);
 };
 
+#if wxUSE_THREADS
+
+// a log target which formats the messages in the thread logging them, without
+// blocking the other threads, and passes them to another log target in
+// batches from a background thread
+
+class wxLogAsyncImpl;
+
+class WXDLLIMPEXP_BASE wxLogAsync : public wxLog
+{
+public:
+    // the logger is owned by this object and will be deleted by it, it must
+    // be usable from a thread other than main, i.e. can't be wxLogGui
+    //
+    // at most maxPendingPerThread messages are kept for each thread, the
+    // subsequent ones are dropped until the messages are flushed, which is
+    // done at least every flushInterval milliseconds
+    explicit wxLogAsync(wxLog *logger,
+                        size_t maxPendingPerThread = 4096,
+                        unsigned long flushInterval = 100);
+    virtual ~wxLogAsync();
+
+    // get the total number of the messages dropped so far
+    unsigned long GetDroppedCount() const;
+
+    // pass all the pending messages to the logger and flush it
+    virtual void Flush() wxOVERRIDE;
+
+    virtual bool IsThreadSafe() const wxOVERRIDE { return true; }
+
+protected:
+    virtual void DoLogTextAtLevel(wxLogLevel level,
+                                  const wxString& msg) wxOVERRIDE;
+
+private:
+    wxLogAsyncImpl *m_impl;
+
+    wxDECLARE_NO_COPY_CLASS(wxLogAsync);
+};
+
+#endif // wxUSE_THREADS
+
 #if wxUSE_GUI
     // include GUI log targets:
     #include "wx/generic/logg.h"
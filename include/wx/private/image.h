@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/private/image.h
+// Purpose:     private helpers shared by wxImage and the image handlers
+// Author:      wxWidgets team
+// Created:     2020-03-18
+// Copyright:   (c) 2020 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_PRIVATE_IMAGE_H_
+#define _WX_PRIVATE_IMAGE_H_
+
+#include "wx/image.h"
+
+// Compute the size of the image of the given size loaded with non-zero
+// wxIMAGE_OPTION_MAX_WIDTH or wxIMAGE_OPTION_MAX_HEIGHT options: it is halved,
+// as done by libjpeg, until it fits into them.
+inline void
+wxGetImageLoadSize(unsigned maxWidth, unsigned maxHeight,
+                   unsigned& width, unsigned& height)
+{
+    while ( (maxWidth && width > maxWidth) ||
+                (maxHeight && height > maxHeight) )
+    {
+        // don't let the other dimension of a very elongated image become 0
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+}
+
+// Base class for the objects performing some operation on a range of the
+// image rows. ProcessRows() may be called for different ranges from several
+// threads at once, so it must not modify the object itself.
+class wxImageRowsProcessor
+{
+public:
+    virtual ~wxImageRowsProcessor() { }
+
+    // Process the rows in [start, end) range.
+    virtual void ProcessRows(int start, int end) const = 0;
+};
+
+// Process all the rows, splitting them between several threads, not more than
+// allowed by wxImage::SetMaxThreads(), if there is enough work to do. The work
+// is measured in arbitrary units corresponding, roughly, to the time needed to
+// compute a single pixel using a few source pixels.
+void
+wxProcessImageRowsInParallel(const wxImageRowsProcessor& processor,
+                             int numRows,
+                             size_t work);
+
+#if wxUSE_STREAMS
+
+// Return a new consumer for wxImageHandler::LoadRows() which stores the rows
+// passed to it in the provided image, scaled down as wxImage::Rescale() with
+// wxIMAGE_QUALITY_BOX_AVERAGE would do it to the size returned by the function
+// above.
+// This is used by the handlers supporting incremental decoding to load huge
+// images scaled down without ever keeping them in memory at full size.
+//
+// The caller is responsible for deleting the returned object.
+wxImageRowsConsumer*
+wxCreateImageDownscaler(wxImage& image, unsigned maxWidth, unsigned maxHeight);
+
+#endif // wxUSE_STREAMS
+
+#endif // _WX_PRIVATE_IMAGE_H_
@@ -13,6 +13,20 @@
 #include "wx/defs.h"
 
 class WXDLLIMPEXP_FWD_BASE wxLog;
+class wxLogAsyncBuffer;
+struct wxEventProfilerThreadData;
+
+#if wxUSE_THREADS
+// defined in src/common/log.cpp, releases the reference to the wxLogAsync
+// buffer held by the thread when it exits
+void wxLogAsyncReleaseThreadBuffer(wxLogAsyncBuffer *buffer);
+
+#if wxUSE_STOPWATCH
+// defined in src/common/event.cpp, merges the wxEventProfiler data collected
+// by the thread with the data of the other threads and frees it
+void wxEventProfilerReleaseThreadData(wxEventProfilerThreadData *data);
+#endif // wxUSE_STOPWATCH
+#endif // wxUSE_THREADS
 
 #if wxUSE_INTL
 #include "wx/hashset.h"
@@ -47,12 +61,36 @@ public:
     //     logging
     bool loggingDisabled;
 
+#if wxUSE_THREADS
+    // the buffer used by wxLogAsync for the messages logged by this thread,
+    // only used by it if asyncLogSerial is its serial number, but referenced
+    // by this object in any case until it is replaced or this thread exits
+    wxLogAsyncBuffer *asyncLogBuffer;
+    unsigned asyncLogSerial;
+#endif // wxUSE_THREADS
+
 #if wxUSE_INTL
     // Storage for wxTranslations::GetUntranslatedString()
     wxLocaleUntranslatedStrings untranslatedStrings;
 #endif
 
+#if wxUSE_STOPWATCH
+    // the data collected by wxEventProfiler for this thread or NULL if it
+    // didn't handle any events while the profiler was running
+    wxEventProfilerThreadData *eventProfilerData;
+#endif // wxUSE_STOPWATCH
+
 #if wxUSE_THREADS
+    ~wxThreadSpecificInfo()
+    {
+        if ( asyncLogBuffer )
+            wxLogAsyncReleaseThreadBuffer(asyncLogBuffer);
+#if wxUSE_STOPWATCH
+        if ( eventProfilerData )
+            wxEventProfilerReleaseThreadData(eventProfilerData);
+#endif // wxUSE_STOPWATCH
+    }
+
     // Cleans up storage for the current thread. Should be called when a thread
     // is being destroyed. If it's not called, the only bad thing that happens
     // is that the memory is deallocated later, on process termination.
@@ -60,7 +98,18 @@ public:
 #endif
 
 private:
-    wxThreadSpecificInfo() : logger(NULL), loggingDisabled(false) {}
+    wxThreadSpecificInfo()
+        : logger(NULL),
+          loggingDisabled(false)
+#if wxUSE_THREADS
+          , asyncLogBuffer(NULL),
+          asyncLogSerial(0)
+#endif // wxUSE_THREADS
+#if wxUSE_STOPWATCH
+          , eventProfilerData(NULL)
+#endif // wxUSE_STOPWATCH
+    {
+    }
 };
 
 #define wxThreadInfo wxThreadSpecificInfo::Get()
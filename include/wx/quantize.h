@@ -71,5 +71,58 @@ public:
 
 };
 
+/*
+ * wxQuantizer
+ * Reusable quantizer: computes a single palette for any number of images and
+ * then maps any number of images to it, reusing the colour lookup tables.
+ */
+
+class wxQuantizerImpl;
+
+class WXDLLIMPEXP_CORE wxQuantizer
+{
+public:
+    explicit wxQuantizer(int numColours = 256);
+    ~wxQuantizer();
+
+    // Add the colours of the image to the histogram used for choosing the
+    // palette. This can't be done any more once the palette was created.
+    bool AddImage(const wxImage& image);
+
+    // Choose the palette for all the images added so far, asserts if there are
+    // none. This is done automatically by MapImage() if it wasn't done before.
+    bool CreatePalette();
+
+    // Return the number of colours in the palette, which may be less than
+    // the number requested, and the palette itself as RGB triplets.
+    int GetPaletteSize() const;
+    const unsigned char* GetPaletteData() const;
+
+    // Dither the images in independent bands of the given height, which are
+    // processed in parallel. By default, 0, the whole image is dithered at
+    // once, giving the same results as wxQuantize.
+    void SetBandHeight(int height) { m_bandHeight = height; }
+    int GetBandHeight() const { return m_bandHeight; }
+
+    // Map the image to the palette, storing the palette indices, one byte per
+    // pixel, in the provided buffer of width*height size.
+    bool MapImage(const wxImage& image, unsigned char* indices);
+
+    // Map the image to the palette and replace dest with the result, using
+    // only the palette colours. The palette is also set in dest if possible.
+    bool MapImage(const wxImage& image, wxImage& dest);
+
+    // Forget all the images added and the palette.
+    void Reset();
+
+private:
+    wxQuantizerImpl* m_impl;
+    int m_numColours;
+    int m_bandHeight;
+    unsigned char m_palette[3*256];
+
+    wxDECLARE_NO_COPY_CLASS(wxQuantizer);
+};
+
 #endif
     // _WX_QUANTIZE_H_
@@ -35,6 +35,7 @@ enum wxTextFileType
 #if wxUSE_TEXTBUFFER
 
 #include "wx/dynarray.h"
+#include "wx/vector.h"
 
 // ----------------------------------------------------------------------------
 // wxTextBuffer
@@ -99,10 +100,10 @@ public:
     size_t GetLineCount() const { return m_aLines.size(); }
 
     // the returned line may be modified (but don't add CR/LF at the end!)
-          wxString& GetLine(size_t n)          { return m_aLines[n]; }
-    const wxString& GetLine(size_t n)    const { return m_aLines[n]; }
-          wxString& operator[](size_t n)       { return m_aLines[n]; }
-    const wxString& operator[](size_t n) const { return m_aLines[n]; }
+          wxString& GetLine(size_t n)          { return DoGetLine(n); }
+    const wxString& GetLine(size_t n)    const { return DoGetLine(n); }
+          wxString& operator[](size_t n)       { return DoGetLine(n); }
+    const wxString& operator[](size_t n) const { return DoGetLine(n); }
 
     // the current line has meaning only when you're using
     // GetFirstLine()/GetNextLine() functions, it doesn't get updated when
@@ -116,14 +117,14 @@ public:
     //  for ( str = GetFirstLine(); !Eof(); str = GetNextLine() ) { ... }
 
     wxString& GetFirstLine()
-        { return m_aLines.empty() ? ms_eof : m_aLines[m_nCurLine = 0]; }
+        { return m_aLines.empty() ? ms_eof : DoGetLine(m_nCurLine = 0); }
     wxString& GetNextLine()
         { return ++m_nCurLine == m_aLines.size() ? ms_eof
-                                                 : m_aLines[m_nCurLine]; }
+                                                 : DoGetLine(m_nCurLine); }
     wxString& GetPrevLine()
-        { wxASSERT(m_nCurLine > 0); return m_aLines[--m_nCurLine]; }
+        { wxASSERT(m_nCurLine > 0); return DoGetLine(--m_nCurLine); }
     wxString& GetLastLine()
-        { return m_aLines.empty() ? ms_eof : m_aLines[m_nCurLine = m_aLines.size() - 1]; }
+        { return m_aLines.empty() ? ms_eof : DoGetLine(m_nCurLine = m_aLines.size() - 1); }
 
     // get the type of the line (see also GetEOL)
     wxTextFileType GetLineType(size_t n) const { return m_aTypes[n]; }
@@ -139,7 +140,12 @@ public:
 
     // add a line to the end
     void AddLine(const wxString& str, wxTextFileType type = typeDefault)
-        { m_aLines.push_back(str); m_aTypes.push_back(type); }
+    {
+        m_aLines.push_back(str);
+        m_aTypes.push_back(type);
+        if ( !m_lazyLines.empty() )
+            m_lazyLines.push_back(wxString::npos);
+    }
     // insert a line before the line number n
     void InsertLine(const wxString& str,
                   size_t n,
@@ -147,6 +153,8 @@ public:
     {
         m_aLines.insert(m_aLines.begin() + n, str);
         m_aTypes.insert(m_aTypes.begin()+n, type);
+        if ( !m_lazyLines.empty() )
+            m_lazyLines.insert(m_lazyLines.begin() + n, wxString::npos);
     }
 
     // delete one line
@@ -154,10 +162,27 @@ public:
     {
         m_aLines.erase(m_aLines.begin() + n);
         m_aTypes.erase(m_aTypes.begin() + n);
+        if ( !m_lazyLines.empty() )
+        {
+            m_lazyLines.erase(m_lazyLines.begin() + n);
+            if ( m_lazyLines.empty() )
+                OnLazyLinesReleased();
+        }
     }
 
     // remove all lines
-    void Clear() { m_aLines.clear(); m_aTypes.clear(); m_nCurLine = 0; }
+    void Clear()
+    {
+        m_aLines.clear();
+        m_aTypes.clear();
+        m_nCurLine = 0;
+
+        if ( !m_lazyLines.empty() )
+        {
+            m_lazyLines.clear();
+            OnLazyLinesReleased();
+        }
+    }
 
     // change the buffer (default argument means "don't change type")
     // possibly in another format
@@ -187,12 +212,40 @@ protected:
     virtual bool OnRead(const wxMBConv& conv) = 0;
     virtual bool OnWrite(wxTextFileType typeNew, const wxMBConv& conv) = 0;
 
+    // Derived classes may add lines which are only loaded when they're
+    // accessed for the first time: OnLoadLine() is called with the index
+    // passed to AddLazyLine() then. This is only used by wxTextFile.
+    void AddLazyLine(size_t index, wxTextFileType type);
+    virtual void OnLoadLine(size_t index, wxString& line) const;
+
+    // called when there are no more lines to load using OnLoadLine(), either
+    // because they were all loaded or because the buffer was cleared, so
+    // that the data needed for loading them can be freed
+    virtual void OnLazyLinesReleased() { }
+
+    // load all the lines added by AddLazyLine() which haven't been loaded yet
+    void LoadAllLines();
+
     static wxString ms_eof;     // dummy string returned at EOF
     wxString m_strBufferName;   // name of the buffer
 
 private:
+    wxString& DoGetLine(size_t n) const
+    {
+        if ( !m_lazyLines.empty() && m_lazyLines[n] != wxString::npos )
+            DoLoadLine(n);
+
+        return m_aLines[n];
+    }
+
+    void DoLoadLine(size_t n) const;
+
     wxArrayLinesType m_aTypes;   // type of each line
-    wxArrayString    m_aLines;   // lines of file
+    mutable wxArrayString m_aLines; // lines of file
+
+    // for each line, the index to pass to OnLoadLine() if it hasn't been
+    // loaded yet or npos, empty if AddLazyLine() is not used at all
+    mutable wxVector<size_t> m_lazyLines;
 
     size_t        m_nCurLine; // number of current line in the buffer
 
@@ -20,6 +20,7 @@
 #if wxUSE_TEXTFILE
 
 #include "wx/file.h"
+#include "wx/vector.h"
 
 // ----------------------------------------------------------------------------
 // wxTextFile
@@ -29,9 +30,16 @@ class WXDLLIMPEXP_BASE wxTextFile : public wxTextBuffer
 {
 public:
     // constructors
-    wxTextFile() { }
+    wxTextFile() { m_lazyLoading = false; }
     wxTextFile(const wxString& strFileName);
 
+    // if enabled, the file is mapped in memory and only the offsets of its
+    // lines are stored when it is opened, the lines themselves are converted
+    // to wxString when they're accessed for the first time (this is only done
+    // for UTF-8 files, the others are still loaded entirely)
+    void SetLazyLoading(bool lazy = true) { m_lazyLoading = lazy; }
+    bool IsLazyLoading() const { return m_lazyLoading; }
+
 protected:
     // implement the base class pure virtuals
     virtual bool OnExists() const wxOVERRIDE;
@@ -40,11 +48,20 @@ protected:
     virtual bool OnClose() wxOVERRIDE;
     virtual bool OnRead(const wxMBConv& conv) wxOVERRIDE;
     virtual bool OnWrite(wxTextFileType typeNew, const wxMBConv& conv) wxOVERRIDE;
+    virtual void OnLoadLine(size_t index, wxString& line) const wxOVERRIDE;
+    virtual void OnLazyLinesReleased() wxOVERRIDE;
 
 private:
 
     wxFile m_file;
 
+    // the file contents and the offsets of the beginning of each line in it
+    // followed by the length of the data, only used for lazy loading
+    wxMappedFile m_mapped;
+    wxVector<size_t> m_lineOffsets;
+
+    bool m_lazyLoading;
+
     wxDECLARE_NO_COPY_CLASS(wxTextFile);
 };
 
@@ -60,6 +60,7 @@ class WXDLLIMPEXP_FWD_BASE wxArrayString;
 class WXDLLIMPEXP_FWD_BASE wxTranslationsLoader;
 class WXDLLIMPEXP_FWD_BASE wxLocale;
 
+class wxMsgCatalogFile;
 class wxPluralFormsCalculator;
 wxDECLARE_SCOPED_PTR(wxPluralFormsCalculator, wxPluralFormsCalculatorPtr)
 
@@ -72,9 +73,7 @@ class WXDLLIMPEXP_BASE wxMsgCatalog
 public:
     // Ctor is protected, because CreateFromXXX functions must be used,
     // but destruction should be unrestricted
-#if !wxUSE_UNICODE
     ~wxMsgCatalog();
-#endif
 
     // load the catalog from disk or from data; caller is responsible for
     // deleting them if not NULL
@@ -92,7 +91,7 @@ public:
 
 protected:
     wxMsgCatalog(const wxString& domain)
-        : m_pNext(NULL), m_domain(domain)
+        : m_pNext(NULL), m_file(NULL), m_domain(domain)
 #if !wxUSE_UNICODE
         , m_conv(NULL)
 #endif
@@ -103,6 +102,10 @@ private:
     wxMsgCatalog *m_pNext;
     friend class wxTranslations;
 
+    // if non-NULL, the translations are looked up directly in the catalog
+    // data and m_messages is not used
+    wxMsgCatalogFile       *m_file;
+
     wxStringToStringHashMap m_messages; // all messages in the catalog
     wxString                m_domain;   // name of the domain
 
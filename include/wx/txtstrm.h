@@ -112,6 +112,17 @@ protected:
 #if SIZEOF_WCHAR_T == 2
     wchar_t m_lastWChar;
 #endif // SIZEOF_WCHAR_T == 2
+
+    // ReadLine() can read the input in blocks instead of one character at a
+    // time only if doing it can't block, which is the case for the streams of
+    // known size, and only after at least one character was decoded, so that
+    // the conversion had a chance to detect the BOM.
+    bool m_hasLength,
+         m_hasDecoded;
+
+    // Try reading the line by blocks, decoding it as UTF-8 directly. Returns
+    // false, without consuming any input, if this can't be done.
+    bool ReadLineUTF8(wxString& line);
 #endif // wxUSE_UNICODE
 
     bool   EatEOL(const wxChar &c);
@@ -13,11 +13,14 @@
 #if wxUSE_TIMER
 
 #include "wx/private/timer.h"
+#include "wx/vector.h"
 
 // the type used for milliseconds is large enough for microseconds too but
 // introduce a synonym for it to avoid confusion
 typedef wxMilliClock_t wxUsecClock_t;
 
+struct wxTimerSchedule;
+
 // ----------------------------------------------------------------------------
 // wxTimer implementation class for Unix platforms
 // ----------------------------------------------------------------------------
@@ -45,6 +48,12 @@ public:
 
 private:
     bool m_isRunning;
+
+    // the schedule of this timer if it's running, used by wxTimerScheduler to
+    // find it without searching for it
+    wxTimerSchedule *m_schedule;
+
+    friend class wxTimerScheduler;
 };
 
 // ----------------------------------------------------------------------------
@@ -55,8 +64,21 @@ struct wxTimerSchedule
 {
     wxTimerSchedule(wxUnixTimerImpl *timer, wxUsecClock_t expiration)
         : m_timer(timer),
-          m_expiration(expiration)
+          m_expiration(expiration),
+          m_order(0),
+          m_heapIndex(0)
+    {
+    }
+
+    // return true if this timer must be notified before the other one
+    bool IsBefore(const wxTimerSchedule& other) const
     {
+        if ( m_expiration != other.m_expiration )
+            return m_expiration < other.m_expiration;
+
+        // timers expiring at the same time are notified in the order in
+        // which they were scheduled
+        return m_order < other.m_order;
     }
 
     // the timer itself (we don't own this pointer)
@@ -64,10 +86,14 @@ struct wxTimerSchedule
 
     // the time of its next expiration, in usec
     wxUsecClock_t m_expiration;
-};
 
-// the linked list of all active timers, we keep it sorted by expiration time
-WX_DECLARE_LIST(wxTimerSchedule, wxTimerList);
+    // the sequential number of this schedule, used to order the timers
+    // expiring at the same time
+    wxUint64 m_order;
+
+    // the position of this schedule in wxTimerScheduler heap
+    size_t m_heapIndex;
+};
 
 // ----------------------------------------------------------------------------
 // wxTimerScheduler: class responsible for updating all timers
@@ -118,17 +144,39 @@ public:
 private:
     // ctor and dtor are private, this is a singleton class only created by
     // Get() and destroyed by Shutdown()
-    wxTimerScheduler() { }
+    wxTimerScheduler() { m_nextOrder = 0; }
     ~wxTimerScheduler();
 
-    // add the given timer schedule to the list in the right place
+    // add the given timer schedule to the heap in the right place
     //
     // we take ownership of the pointer "s" which must be heap-allocated
     void DoAddTimer(wxTimerSchedule *s);
 
+    // remove the schedule at the given position from the heap, without
+    // deleting it, and return it
+    wxTimerSchedule *DoRemoveAt(size_t n);
+
+    // helpers restoring the heap property after the schedule at the given
+    // position became earlier or later respectively
+    void SiftUp(size_t n);
+    void SiftDown(size_t n);
+
+    // put the schedule at the given position in the heap
+    void PutAt(size_t n, wxTimerSchedule *s)
+    {
+        m_timers[n] = s;
+        s->m_heapIndex = n;
+    }
+
+
+    // all currently active timers organized as a binary min-heap ordered by
+    // expiration, i.e. the first element is always the next one to expire,
+    // which allows adding and removing timers in logarithmic time
+    typedef wxVector<wxTimerSchedule *> Schedules;
+    Schedules m_timers;
 
-    // the list of all currently active timers sorted by expiration
-    wxTimerList m_timers;
+    // the sequential number to use for the next added timer
+    wxUint64 m_nextOrder;
 
     static wxTimerScheduler *ms_instance;
 };
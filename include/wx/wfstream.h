@@ -175,6 +175,35 @@ private:
     wxDECLARE_NO_COPY_CLASS(wxFileStream);
 };
 
+// ----------------------------------------------------------------------------
+// wxMappedFileInputStream: read-only stream reading the file mapped in memory
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_BASE wxMappedFileInputStream : public wxInputStream
+{
+public:
+    wxMappedFileInputStream(const wxString& fileName,
+                            wxMappedFile::Access access = wxMappedFile::Access_Sequential);
+
+    virtual wxFileOffset GetLength() const wxOVERRIDE;
+
+    virtual bool IsOk() const wxOVERRIDE;
+    virtual bool IsSeekable() const wxOVERRIDE { return true; }
+
+    const wxMappedFile& GetMappedFile() const { return m_file; }
+
+protected:
+    virtual size_t OnSysRead(void *buffer, size_t size) wxOVERRIDE;
+    virtual wxFileOffset OnSysSeek(wxFileOffset pos, wxSeekMode mode) wxOVERRIDE;
+    virtual wxFileOffset OnSysTell() const wxOVERRIDE;
+
+private:
+    wxMappedFile m_file;
+    size_t m_pos;
+
+    wxDECLARE_NO_COPY_CLASS(wxMappedFileInputStream);
+};
+
 #endif //wxUSE_FILE
 
 #if wxUSE_FFILE
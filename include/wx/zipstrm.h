@@ -15,6 +15,7 @@
 
 #include "wx/archive.h"
 #include "wx/filename.h"
+#include "wx/vector.h"
 
 // some methods from wxZipInputStream and wxZipOutputStream stream do not get
 // exported/imported when compiled with Mingw versions before 3.4.2. So they
@@ -420,6 +421,10 @@ private:
     bool FindEndRecord();
     bool LoadEndRecord();
 
+    // used by wxZipIndex for the streams over a seekable archive whose
+    // central directory has already been read
+    void InitRandomAccess();
+
     bool AtHeader() const       { return m_headerSize == 0; }
     bool AfterHeader() const    { return m_headerSize > 0 && !m_decomp; }
     bool IsOpened() const       { return m_decomp != NULL; }
@@ -438,6 +443,7 @@ private:
     wxUint32 m_crcAccumulator;
     wxInputStream *m_decomp;
     bool m_parentSeekable;
+    bool m_randomAccess;
     class wxZipWeakLinks *m_weaklinks;
     class wxZipStreamLink *m_streamlink;
     wxFileOffset m_offsetAdjustment;
@@ -450,11 +456,51 @@ private:
                     wxZipEntry *entry, wxZipInputStream& inputStream);
     friend bool wxZipOutputStream::CopyArchiveMetaData(
                     wxZipInputStream& inputStream);
+    friend class wxZipIndex;
 
     wxDECLARE_NO_COPY_CLASS(wxZipInputStream);
 };
 
 
+/////////////////////////////////////////////////////////////////////////////
+// wxZipIndex: reads the central directory of a zip file once and then allows
+// opening any of its entries directly, possibly from several threads
+
+#if wxUSE_FILE
+
+class WXDLLIMPEXP_BASE wxZipIndex
+{
+public:
+    wxZipIndex(wxMBConv& conv = wxConvLocal);
+    ~wxZipIndex();
+
+    bool Open(const wxString& filename);
+    void Close();
+    bool IsOk() const { return m_file != NULL; }
+
+    // entries are sorted by their internal names
+    size_t GetCount() const { return m_entries.size(); }
+    const wxZipEntry& GetEntry(size_t n) const { return *m_entries[n]; }
+
+    const wxZipEntry *Find(const wxString& name,
+                           wxPathFormat format = wxPATH_NATIVE) const;
+
+    // the returned streams must be deleted by the caller before this object
+    wxZipInputStream *OpenEntry(const wxZipEntry& entry) const;
+    wxZipInputStream *OpenEntry(const wxString& name,
+                                wxPathFormat format = wxPATH_NATIVE) const;
+
+private:
+    wxMBConv& m_conv;
+    class wxZipIndexFile *m_file;
+    wxVector<wxZipEntry*> m_entries;
+
+    wxDECLARE_NO_COPY_CLASS(wxZipIndex);
+};
+
+#endif // wxUSE_FILE
+
+
 /////////////////////////////////////////////////////////////////////////////
 // Iterators
 
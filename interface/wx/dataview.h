@@ -56,6 +56,12 @@
     of the model items and not only for deleting all of them (i.e. clearing the
     model).
 
+    When making many changes to the model at once, the notification calls can
+    also be grouped together by calling wxDataViewModel::BeginBatch() before
+    them and wxDataViewModel::EndBatch() after them. This allows the control
+    to postpone the work it needs to do after each change, such as preserving
+    the selection or refreshing itself, until the end of the batch.
+
     This class maintains a list of wxDataViewModelNotifier which link this class
     to the specific implementations on the supported platforms so that e.g. calling
     wxDataViewModel::ValueChanged on this model will just call
@@ -110,6 +116,41 @@ public:
     */
     void AddNotifier(wxDataViewModelNotifier* notifier);
 
+    /**
+        Start a batch of notifications.
+
+        Calling this method before notifying the control about many changes
+        to the model, e.g. by calling ItemAdded() or ItemDeleted() for a lot of
+        items, allows the control to perform the work required to update its
+        state, e.g. keeping the selection and the current item, and refreshing
+        itself only once, when EndBatch() is called, instead of doing it after
+        each change.
+
+        Notice that the model must be in a consistent state, i.e. all the
+        changes must have been already reported to the control, when
+        EndBatch() is called, and that every call to this method must be
+        matched by a call to EndBatch(). The calls to these methods may be
+        nested, in which case the batch ends with the outermost EndBatch().
+
+        @since 3.1.4
+    */
+    void BeginBatch();
+
+    /**
+        End the batch of notifications started by BeginBatch().
+
+        @since 3.1.4
+    */
+    void EndBatch();
+
+    /**
+        Return @true if BeginBatch() had been called without the matching
+        EndBatch() yet.
+
+        @since 3.1.4
+    */
+    bool IsInBatch() const;
+
     /**
         Change the value of the given item and update the control to reflect
         it.
@@ -1760,6 +1801,28 @@ public:
     */
     virtual ~wxDataViewModelNotifier();
 
+    /**
+        Called by owning model when a batch of notifications starts.
+
+        This is called only for the outermost wxDataViewModel::BeginBatch()
+        call, or when the notifier is added to the model during a batch. The
+        default implementation does nothing.
+
+        @since 3.1.4
+    */
+    virtual void BeginBatch();
+
+    /**
+        Called by owning model when a batch of notifications ends.
+
+        This is called for the outermost wxDataViewModel::EndBatch() call, or
+        when the notifier is removed from the model during a batch, just
+        before deleting it. The default implementation does nothing.
+
+        @since 3.1.4
+    */
+    virtual void EndBatch();
+
     /**
         Called by owning model.
     */
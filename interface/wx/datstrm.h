@@ -23,6 +23,13 @@
     typically uses standard IEEE 754 formats for its data, the use of extended
     precision by default is solely due to backwards compatibility.
 
+    The functions writing arrays of values, such as Write32() or WriteDouble()
+    taking a pointer and the number of elements, are much more efficient than
+    writing the values one by one: the data is written to the underlying
+    stream in big chunks, and directly without any copying if the byte order
+    matches the native one of the machine and UseBasicPrecisions() is used for
+    the floating point types.
+
     If you want to write data to text files (or streams) use wxTextOutputStream
     instead.
 
@@ -214,6 +221,11 @@ public:
     Please see wxDataOutputStream for the discussion of the format expected by
     this stream on input, notably for the floating point values.
 
+    As with wxDataOutputStream, reading arrays of values using the overloads
+    taking a pointer and the number of elements is much faster than reading
+    them one by one, as all the data is read directly into the provided buffer
+    and only converted in place if necessary.
+
     If you want to read data from text files (or streams) use wxTextInputStream
     instead.
 
@@ -122,6 +122,26 @@ enum wxDirFlags
      */
     wxDIR_NO_FOLLOW = 0x0010,
 
+    /**
+        Read the directories using several threads during the traversal.
+
+        This flag is only used by wxDir::Traverse() and the functions using
+        it, such as wxDir::GetAllFiles(), and is ignored if wxUSE_THREADS is
+        0. The directories are read by worker threads, but the
+        wxDirTraverser methods are still only called from the thread calling
+        Traverse(), so they don't need to be thread-safe. However, the
+        directories are not visited in depth-first order in this case, i.e.
+        the files of a directory are not necessarily reported immediately
+        after calling wxDirTraverser::OnDir() for it.
+
+        This is mostly useful for big directory trees on storage which can
+        handle several concurrent requests efficiently, e.g. SSDs or network
+        file systems.
+
+        @since 3.1.4
+     */
+    wxDIR_PARALLEL  = 0x0020,
+
     /**
         Default directory traversal flags include both files and directories,
         even hidden.
@@ -363,6 +383,17 @@ public:
         continue or stop. If entering a subdirectory fails, @ref
         wxDirTraverser::OnOpenError() "sink.OnOpenError()" is called.
 
+        Returning ::wxDIR_STOP from any of the sink methods stops the entire
+        traversal, i.e. no more sink methods are called after it. Notice that
+        in wxWidgets versions before 3.1.4 it only stopped traversing the
+        current directory and the traversal continued in its parent one.
+
+        If @a flags contains ::wxDIR_PARALLEL, the directories are read using
+        several threads, see its description for more details. This directory
+        itself is read directly in this case, so
+        @ref wxDirTraverser::OnOpenError() "sink.OnOpenError()" is only
+        called for its subdirectories, as without this flag.
+
         The function returns the total number of files found or @c "(size_t)-1"
         on error.
 
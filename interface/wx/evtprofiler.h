@@ -0,0 +1,157 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        interface/wx/evtprofiler.h
+// Purpose:     wxEventProfiler class documentation
+// Author:      wxWidgets team
+// Created:     2020-03-17
+// Copyright:   (c) 2020 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+    Collects statistics about the time spent in the event handlers.
+
+    This class allows finding the event handlers which take the most time to
+    run, e.g. to understand why the program UI is not responsive enough. When
+    the profiler is running, the time taken by each call to an event handler,
+    both for the events processed synchronously with wxEvtHandler::ProcessEvent()
+    and for the queued events processed later, is measured and accumulated per
+    event type and per event handler, i.e. separately for each handler bound
+    using wxEvtHandler::Bind() or defined in an event table.
+
+    The statistics are collected by each thread independently, so profiling
+    doesn't add any synchronization between the threads handling the events,
+    and are combined when they are retrieved.
+
+    The profiler also remembers the last few handler calls, which can be useful
+    for finding what happened just before some problem.
+
+    All the methods of this class are static, it is not meant to be
+    instantiated. Notice that the profiler is stopped by default and has
+    negligible overhead while it is not running, but it does add some overhead
+    to each handler call when it is.
+
+    Example of using it:
+    @code
+    wxEventProfiler::Start();
+
+    ... perform the actions which seem to be slow ...
+
+    wxEventProfiler::Stop();
+    wxLogMessage("%s", wxEventProfiler::GetReport());
+    @endcode
+
+    This class is only available if @c wxUSE_STOPWATCH is set to 1.
+
+    @since 3.1.4
+
+    @library{wxbase}
+    @category{events}
+*/
+class wxEventProfiler
+{
+public:
+    /**
+        Statistics about the calls to the same event handler for the events of
+        the same type in the objects of the same class.
+
+        All times are in microseconds.
+     */
+    struct Stats
+    {
+        /// The type of the events handled.
+        wxEventType eventType;
+
+        /**
+            Opaque identifier of the event handler.
+
+            It is different for each wxEvtHandler::Bind() call and for each
+            event table entry, and so allows to distinguish between the
+            different handlers of the same object, e.g. several lambdas bound
+            to it. It is never reused, even after the handler is unbound.
+         */
+        unsigned long handlerId;
+
+        /// The name of the class of the object handling the events.
+        wxString handlerClass;
+
+        /// The number of the calls made.
+        unsigned long count;
+
+        /// The total time taken by all the calls.
+        wxLongLong totalTime;
+
+        /// The time taken by the longest call.
+        wxLongLong maxTime;
+    };
+
+    /**
+        A single call to an event handler.
+     */
+    struct Call
+    {
+        /// The type of the event handled.
+        wxEventType eventType;
+
+        /// Opaque identifier of the event handler, see Stats::handlerId.
+        unsigned long handlerId;
+
+        /// The name of the class of the object handling the event.
+        wxString handlerClass;
+
+        /// The time taken by the call, in microseconds.
+        wxLongLong time;
+    };
+
+    /**
+        Start collecting the statistics.
+
+        Does nothing if the profiler is already running.
+
+        @param numRecentCalls The number of the most recent calls to remember,
+            see GetRecentCalls(). May be 0 to not remember them at all.
+     */
+    static void Start(size_t numRecentCalls = 1024);
+
+    /**
+        Stop collecting the statistics.
+
+        The statistics collected so far are kept and can still be retrieved
+        using GetStats() and the other functions of this class.
+     */
+    static void Stop();
+
+    /**
+        Return @true if the profiler is currently running.
+     */
+    static bool IsRunning();
+
+    /**
+        Forget all the statistics and recent calls collected so far.
+     */
+    static void Reset();
+
+    /**
+        Get the statistics collected so far.
+
+        The statistics are sorted in decreasing order of the total time, i.e.
+        the most expensive handlers come first.
+     */
+    static void GetStats(wxVector<Stats>& stats);
+
+    /**
+        Get the most recent calls to the event handlers.
+
+        The calls are returned in chronological order, from the oldest to the
+        newest one, and include the calls made by all threads.
+     */
+    static void GetRecentCalls(wxVector<Call>& calls);
+
+    /**
+        Return a human-readable report about the most expensive event types and
+        event handlers.
+
+        @param maxLines The maximal number of the event types and handlers to
+            include in the report.
+     */
+    static wxString GetReport(size_t maxLines = 20);
+};
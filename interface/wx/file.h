@@ -1,6 +1,6 @@
 /////////////////////////////////////////////////////////////////////////////
 // Name:        file.h
-// Purpose:     interface of wxTempFile, wxFile
+// Purpose:     interface of wxTempFile, wxFile, wxMappedFile
 // Author:      wxWidgets team
 // Licence:     wxWindows licence
 /////////////////////////////////////////////////////////////////////////////
@@ -465,3 +465,129 @@ public:
     int fd() const;
 };
 
+
+
+/**
+    @class wxMappedFile
+
+    wxMappedFile provides read-only access to the entire contents of a file.
+
+    The file is mapped in memory if possible, which avoids copying its data
+    and only loads the parts of it which are actually accessed. If it can't be
+    mapped, e.g. because it is not a regular file, its contents are read in
+    memory instead, so this class can be used with any files.
+
+    The data of the file remains accessible until Close() is called or the
+    object is destroyed, even if the file used to open it is closed.
+
+    Example of using this class:
+    @code
+    wxMappedFile file("data.bin");
+    if ( file.IsOpened() )
+        Process(file.GetData(), file.GetLength());
+    @endcode
+
+    Notice that the file must not be truncated by another process while it's
+    mapped, as accessing the mapped data beyond its end may result in a crash
+    under some systems.
+
+    @library{wxbase}
+    @category{file}
+
+    @since 3.1.4
+
+    @see wxFile, wxMappedFileInputStream
+*/
+class wxMappedFile
+{
+public:
+    /**
+        The expected pattern of access to the file data.
+
+        This is only a hint used to optimize reading the data of the file from
+        the disk and is currently ignored under non-Unix systems.
+    */
+    enum Access
+    {
+        /// No particular pattern.
+        Access_Default,
+
+        /// The data is read sequentially from the beginning to the end.
+        Access_Sequential,
+
+        /// The data is accessed in random order.
+        Access_Random
+    };
+
+    /**
+        Default constructor, use Open() to map a file.
+    */
+    wxMappedFile();
+
+    /**
+        Constructor mapping the file with the given name.
+
+        Use IsOpened() to check whether it succeeded.
+    */
+    explicit wxMappedFile(const wxString& fileName,
+                          Access access = Access_Sequential);
+
+    /**
+        Destructor calls Close().
+    */
+    ~wxMappedFile();
+
+    /**
+        Maps the file with the given name.
+
+        Any previously mapped file is closed first.
+
+        @return @true on success or @false if the file couldn't be opened or
+            read, in which case an error is logged.
+    */
+    bool Open(const wxString& fileName, Access access = Access_Sequential);
+
+    /**
+        Maps the given file which must be opened for reading.
+
+        The file should be positioned at its beginning, as its data is read
+        from the current position if it can't be mapped. It can be closed
+        after this function returns without affecting this object.
+    */
+    bool Open(wxFile& file, Access access = Access_Sequential);
+
+    /**
+        Unmaps the file or frees its data if it was read in memory.
+
+        Does nothing if no file is opened.
+    */
+    void Close();
+
+    /**
+        Returns @true if a file is opened.
+
+        Notice that the file may still be empty.
+    */
+    bool IsOpened() const;
+
+    /**
+        Returns @true if the file data is really mapped in memory.
+
+        If this function returns @false for an opened file, its contents were
+        read in memory.
+    */
+    bool IsMapped() const;
+
+    /**
+        Returns the pointer to the file contents.
+
+        The returned pointer is @NULL if no file is opened. Notice that the
+        data is not @c NUL-terminated.
+    */
+    const char *GetData() const;
+
+    /**
+        Returns the length of the file contents in bytes.
+    */
+    size_t GetLength() const;
+};
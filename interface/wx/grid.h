@@ -1586,6 +1586,37 @@ public:
     /// Set attribute for the specified column.
     virtual void SetColAttr(wxGridCellAttr *attr, int col);
 
+    /**
+        Set attribute for all cells in the specified block.
+
+        This is equivalent to, but much more efficient than, calling SetAttr()
+        for all cells of the block, both in terms of the memory used and the
+        time needed to set the attribute. It is especially useful for styling
+        big rectangular areas of the grid.
+
+        The attribute set for an individual cell using SetAttr() takes
+        precedence over any block attributes containing this cell and, if
+        several blocks overlap, the attribute of the block set last is used.
+        Calling this function again for exactly the same block replaces its
+        attribute or, if @a attr is @NULL, removes it.
+
+        @param attr
+            The attribute to use for all cells of the block, or @NULL.
+        @param topRow
+            The first row of the block.
+        @param leftCol
+            The first column of the block.
+        @param bottomRow
+            The last row of the block, inclusive.
+        @param rightCol
+            The last column of the block, inclusive.
+
+        @since 3.1.4
+     */
+    virtual void SetBlockAttr(wxGridCellAttr *attr,
+                              int topRow, int leftCol,
+                              int bottomRow, int rightCol);
+
     //@}
 
     /**
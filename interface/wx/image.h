@@ -60,6 +60,81 @@ enum wxImageResizeQuality
     wxIMAGE_QUALITY_HIGH
 };
 
+/**
+    Image blur algorithm.
+
+    This is used with wxImage::Blur().
+
+    @since 3.1.4
+ */
+enum wxImageBlurMode
+{
+    /**
+    Average all the pixels in the square box around each pixel. This is the
+    fastest mode and the only one available in the previous versions.
+    */
+    wxIMAGE_BLUR_BOX,
+
+    /**
+    Approximate the Gaussian blur by applying several box blurs of the
+    appropriate sizes in succession. The blur radius is interpreted as the
+    standard deviation of the Gaussian in this case.
+    */
+    wxIMAGE_BLUR_GAUSSIAN
+};
+
+/**
+    Layouts of the interleaved pixel buffers used by wxImage::ExportPixels()
+    and wxImage::ImportPixels().
+
+    All of them use 4 bytes per pixel.
+
+    @since 3.1.4
+ */
+enum wxImagePixelFormat
+{
+    /**
+    The pixel bytes are red, green, blue and alpha, in this order. This is
+    the format used by e.g. GdkPixbuf.
+    */
+    wxIMAGE_PIXEL_RGBA,
+
+    /**
+    The pixel bytes are blue, green, red and alpha, in this order. This is
+    the format used by e.g. 32bpp DIBs under MSW.
+    */
+    wxIMAGE_PIXEL_BGRA,
+
+    /**
+    Each pixel is a 32 bit value in native endianness with alpha in the most
+    significant byte followed by red, green and blue. This is the format used
+    by Cairo @c CAIRO_FORMAT_ARGB32 and @c CAIRO_FORMAT_RGB24 surfaces.
+    */
+    wxIMAGE_PIXEL_ARGB32
+};
+
+/**
+    Flags for wxImage::ExportPixels() and wxImage::ImportPixels().
+
+    @since 3.1.4
+ */
+enum
+{
+    /**
+    The colour components in the buffer are premultiplied by alpha.
+
+    Notice that the colour of the fully transparent pixels is still preserved
+    as is, to avoid losing it when exporting the image and importing it back.
+    */
+    wxIMAGE_PIXEL_PREMULTIPLIED = 1,
+
+    /**
+    The alpha component in the buffer is not used: it is set to opaque when
+    exporting the image and ignored when importing it.
+    */
+    wxIMAGE_PIXEL_NO_ALPHA = 2
+};
+
 /**
     Possible values for PNG image type option.
 
@@ -127,6 +202,100 @@ enum
 };
 
 
+/**
+    @class wxImageRowsConsumer
+
+    Interface for receiving the image rows from wxImageHandler::LoadRows().
+
+    Derive from this class and implement its pure virtual functions to process
+    the image while it is being decoded, e.g.
+    @code
+    class RowsCounter : public wxImageRowsConsumer
+    {
+    public:
+        virtual bool OnStart(int width, int height, bool hasAlpha)
+        {
+            m_rows = 0;
+            return true;
+        }
+
+        virtual bool OnRows(int firstRow, const wxImage& rows)
+        {
+            m_rows += rows.GetHeight();
+            return true;
+        }
+
+        int m_rows;
+    };
+
+    wxFileInputStream stream("huge.png");
+    RowsCounter counter;
+    wxImage::FindHandler(wxBITMAP_TYPE_PNG)->LoadRows(stream, counter);
+    @endcode
+
+    @library{wxcore}
+    @category{gdi}
+
+    @since 3.1.4
+*/
+class wxImageRowsConsumer
+{
+public:
+    /// Trivial but virtual destructor.
+    virtual ~wxImageRowsConsumer();
+
+    /**
+        Called once before any rows are decoded.
+
+        @param width
+            The width of the image, which is also the width of all the bands.
+        @param height
+            The height of the entire image.
+        @param hasAlpha
+            @true if the image may have alpha channel, in which case all bands
+            passed to OnRows() have it.
+
+        @return @true to continue loading, @false to stop it.
+    */
+    virtual bool OnStart(int width, int height, bool hasAlpha) = 0;
+
+    /**
+        Called for each band of the decoded rows.
+
+        The @a rows image uses the data of the handler directly, so it is only
+        valid during this call and must be copied, e.g. using wxImage::Copy()
+        or wxImage::GetSubImage(), to be used later.
+
+        @param firstRow
+            The index of the first row of the band in the entire image.
+        @param rows
+            The image containing the decoded rows.
+
+        @return @true to continue loading, @false to stop it.
+    */
+    virtual bool OnRows(int firstRow, const wxImage& rows) = 0;
+
+    /**
+        Calls OnRows() with an image using the given buffers.
+
+        This is a helper for the wxImageHandler::LoadRows() implementations,
+        the buffers are not copied nor freed.
+
+        @param width
+            The width of the rows.
+        @param firstRow
+            The index of the first row of the band in the entire image.
+        @param numRows
+            The number of rows in the band.
+        @param data
+            The RGB data of the rows, must be non-@NULL.
+        @param alpha
+            The alpha data of the rows, may be @NULL.
+    */
+    bool ConsumeRows(int width, int firstRow, int numRows,
+                     unsigned char* data, unsigned char* alpha);
+};
+
 /**
     @class wxImageHandler
 
@@ -268,6 +437,50 @@ public:
     virtual bool LoadFile(wxImage* image, wxInputStream& stream,
                           bool verbose = true, int index = -1);
 
+    /**
+        Loads an image from a stream, passing its rows to the consumer as soon
+        as they are decoded.
+
+        This function can be used to process images too big to be kept in
+        memory entirely, e.g. to downscale them, split them into tiles or
+        write them out in another format.
+
+        The rows are passed to wxImageRowsConsumer::OnRows() in bands of
+        @a bandHeight rows, in top to bottom order, with only the last band
+        possibly being shorter.
+
+        PNG, JPEG and TIFF handlers decode the image incrementally and only
+        keep a single band in memory (except for interlaced PNG images and
+        TIFF images not stored from top to bottom which still need to be
+        decoded entirely), while the default implementation of this function
+        loads the entire image using LoadFile() and then splits it into bands.
+        Notice that, unlike LoadFile(), this function doesn't provide the
+        palette nor any of the image options.
+
+        @param stream
+            Opened input stream for reading image data.
+        @param consumer
+            The object receiving the image rows.
+        @param bandHeight
+            The maximal number of rows to pass to the consumer at once, must be
+            strictly positive.
+        @param verbose
+            If set to @true, errors reported by the image handler will produce
+            wxLogMessages.
+        @param index
+            The index of the image in the file (starting from zero).
+
+        @return @true if the entire image was loaded, @false if an error
+            occurred or the consumer cancelled loading.
+
+        @since 3.1.4
+    */
+    virtual bool LoadRows(wxInputStream& stream,
+                          wxImageRowsConsumer& consumer,
+                          int bandHeight = 64,
+                          bool verbose = true,
+                          int index = -1);
+
     /**
         Saves an image in the output stream.
 
@@ -381,6 +594,61 @@ const unsigned char wxIMAGE_ALPHA_OPAQUE = 0xff;
 const unsigned char wxIMAGE_ALPHA_THRESHOLD = 0x80;
 
 
+/**
+    @class wxImageDataReleaser
+
+    Base class for objects releasing the external image data.
+
+    An object of the class deriving from this one can be passed to
+    wxImage::CreateFromExternal() to be notified when the data is not used by
+    any image any more, e.g.:
+    @code
+    class MappedFrameReleaser : public wxImageDataReleaser
+    {
+    public:
+        explicit MappedFrameReleaser(size_t size) : m_size(size) { }
+
+        virtual void Release(unsigned char* data, unsigned char* alpha)
+        {
+            munmap(data, m_size);
+        }
+
+    private:
+        const size_t m_size;
+    };
+
+    wxImage image;
+    image.CreateFromExternal(width, height, mapped, NULL,
+                             new MappedFrameReleaser(3*width*height));
+    @endcode
+
+    @since 3.1.4
+
+    @library{wxcore}
+    @category{gdi}
+
+    @see wxImage::CreateFromExternal()
+*/
+class wxImageDataReleaser
+{
+public:
+    /**
+        Called when the data is not used by any image any more.
+
+        The arguments are the pointers passed to wxImage::CreateFromExternal()
+        and this object is deleted by wxImage immediately after this call.
+
+        Notice that this function may be called from any thread which destroys
+        the last image using this data.
+    */
+    virtual void Release(unsigned char* data, unsigned char* alpha) = 0;
+
+    /**
+        Trivial virtual destructor.
+    */
+    virtual ~wxImageDataReleaser();
+};
+
 /**
     @class wxImage
 
@@ -739,6 +1007,46 @@ public:
     */
     bool Create( const wxSize& sz, unsigned char* data, unsigned char* alpha, bool static_data = false );
 
+    /**
+        Creates an image using the data owned by somebody else without copying
+        it.
+
+        This is similar to Create() with @c static_data set to @true, as the
+        data is used directly and not freed by wxImage, but instead of
+        requiring the data to outlive the image, @a releaser is notified when
+        the data is not used by any image any more, so this can be used for
+        wrapping memory mapped or shared memory buffers, for example.
+
+        As with static data, the image modifies the external data in place.
+        Copies of this image share the same data until one of them is modified
+        using wxImage methods, which makes a copy of it as usual, while the
+        data modified directly using the pointer returned by GetData() is
+        changed for all of them.
+
+        @param width
+            The width of the image.
+        @param height
+            The height of the image.
+        @param data
+            The RGB data, which must contain 3*width*height bytes without any
+            padding between rows, can't be @NULL.
+        @param alpha
+            The alpha data, which must contain width*height bytes, or @NULL.
+        @param releaser
+            The object which is called when the data is not used any more and
+            is deleted by wxImage after this, or @NULL if the data doesn't
+            need to be released. Notice that wxImage takes ownership of it
+            even if this function fails, in which case it is called and
+            deleted immediately.
+
+        @return @true if the call succeeded, @false otherwise.
+
+        @since 3.1.4
+    */
+    bool CreateFromExternal(int width, int height,
+                            unsigned char* data, unsigned char* alpha,
+                            wxImageDataReleaser* releaser);
+
     /**
         Initialize the image data with zeroes (the default) or with the
         byte value given as @a value.
@@ -775,9 +1083,20 @@ public:
         specified pixel @a blurRadius. This should not be used when using
         a single mask colour for transparency.
 
+        The image is processed using several threads if it is big enough, see
+        SetMaxThreads().
+
+        @param blurRadius
+            The radius of the blur in pixels. For wxIMAGE_BLUR_GAUSSIAN @a mode
+            this is the standard deviation of the Gaussian, i.e. the visible
+            effect of the blur extends roughly three times further.
+        @param mode
+            The blur algorithm to use. This parameter is new since wxWidgets
+            3.1.4, previously only wxIMAGE_BLUR_BOX was available.
+
         @see BlurHorizontal(), BlurVertical()
     */
-    wxImage Blur(int blurRadius) const;
+    wxImage Blur(int blurRadius, wxImageBlurMode mode = wxIMAGE_BLUR_BOX) const;
 
     /**
         Blurs the image in the horizontal direction only. This should not be used
@@ -847,10 +1166,13 @@ public:
         Rotates the image about the given point, by @a angle radians.
 
         Passing @true to @a interpolating results in better image quality, but is slower.
+        Since wxWidgets 3.1.4 bilinear interpolation is used in this case.
 
         If the image has a mask, then the mask colour is used for the uncovered
         pixels in the rotated image background. Else, black (rgb 0, 0, 0) will be used.
 
+        Big images are rotated using several threads, see SetMaxThreads().
+
         Returns the rotated image, leaving this image intact.
     */
     wxImage Rotate(double angle, const wxPoint& rotationCentre,
@@ -898,6 +1220,10 @@ public:
         image and will therefore remove the mask partially. Using the alpha channel
         will work.
 
+        When resampling big images using any method other than
+        @c wxIMAGE_QUALITY_NEAREST, the work is split between several threads,
+        see SetMaxThreads().
+
         Example:
         @code
         // get the bitmap from somewhere
@@ -1207,12 +1533,16 @@ public:
             max width given if it is not 0 @em and its height is less than the
             max height given if it is not 0. This is typically used for loading
             thumbnails and the advantage of using these options compared to
-            calling Rescale() after loading is that some handlers (only JPEG
-            one right now) support rescaling the image during loading which is
-            vastly more efficient than loading the entire huge image and
-            rescaling it later (if these options are not supported by the
-            handler, this is still what happens however). These options must be
-            set before calling LoadFile() to have any effect.
+            calling Rescale() after loading is that some handlers (JPEG, PNG
+            and TIFF ones right now) support rescaling the image during loading
+            which is vastly more efficient than loading the entire huge image
+            and rescaling it later (if these options are not supported by the
+            handler, this is still what happens however). The image size is
+            divided by 2 until it fits into the given maximal size, but never
+            becomes less than 1 in either direction, and the result is the
+            same as with Rescale() using @c wxIMAGE_QUALITY_BOX_AVERAGE,
+            except for JPEG images which are scaled by libjpeg itself. These
+            options must be set before calling LoadFile() to have any effect.
 
         @li @c wxIMAGE_OPTION_ORIGINAL_WIDTH and @c wxIMAGE_OPTION_ORIGINAL_HEIGHT:
             These options will return the original size of the image if either
@@ -1342,6 +1672,32 @@ public:
     */
     wxImage GetSubImage(const wxRect& rect) const;
 
+    /**
+        Returns an image consisting of the given rows of this one, without
+        copying them.
+
+        Unlike GetSubImage(), which always copies the pixels, this function
+        returns an image using the same data as this image, which is kept alive
+        as long as the returned image exists. This is only possible for the
+        ranges of entire rows, as the image data is stored contiguously, and
+        can be used to process the bands of a big image independently.
+
+        Modifying the returned image changes the pixels of this one too.
+        However modifying this image using wxImage methods makes a copy of
+        its data first, as it is shared with the returned image, so the
+        changes don't affect the latter, unless they're done directly using
+        the pointer returned by GetData().
+
+        @param y
+            The first row to use, must be in 0..GetHeight()-1 range.
+        @param height
+            The number of rows, must be positive and such that @a y + @a height
+            doesn't exceed GetHeight().
+
+        @since 3.1.4
+    */
+    wxImage GetRowsView(int y, int height) const;
+
     /**
         Gets the type of image found by LoadFile() or specified with SaveFile().
 
@@ -1612,6 +1968,57 @@ public:
     */
     void ClearAlpha();
 
+    /**
+        Copies the image data into a buffer with interleaved pixels.
+
+        wxImage stores the colour and alpha data separately, while most of the
+        other graphics libraries use a single buffer with 4 bytes per pixel.
+        This function fills such a buffer in a single pass, using several
+        threads for big images, see SetMaxThreads(), and is much faster than
+        copying the pixels one by one using the public accessors.
+
+        If the image doesn't have alpha, all pixels are exported as opaque.
+
+        @param buffer
+            The buffer of at least @a stride times the image height bytes.
+        @param stride
+            The offset in bytes between the starts of the consecutive rows in
+            the buffer, which must be at least 4 times the image width. It
+            may be negative for the bottom-up buffers, in which case @a buffer
+            must point to the start of the last row in memory.
+        @param format
+            The layout of the pixels in the buffer.
+        @param flags
+            A combination of wxIMAGE_PIXEL_PREMULTIPLIED and
+            wxIMAGE_PIXEL_NO_ALPHA.
+        @return
+            @true if the pixels were copied or @false if the image or the
+            parameters are invalid.
+
+        @see ImportPixels()
+
+        @since 3.1.4
+    */
+    bool ExportPixels(void* buffer, int stride,
+                      wxImagePixelFormat format = wxIMAGE_PIXEL_RGBA,
+                      int flags = 0) const;
+
+    /**
+        Replaces the image with the contents of a buffer with interleaved
+        pixels.
+
+        This is the inverse of ExportPixels(): the image is (re)created with
+        the given size and the colour and alpha data are copied from the
+        buffer. The image has alpha unless wxIMAGE_PIXEL_NO_ALPHA is specified
+        in @a flags.
+
+        @since 3.1.4
+    */
+    bool ImportPixels(int width, int height,
+                      const void* buffer, int stride,
+                      wxImagePixelFormat format = wxIMAGE_PIXEL_RGBA,
+                      int flags = 0);
+
     /**
         Sets the image data without performing checks.
 
@@ -1675,6 +2082,28 @@ public:
      */
     void SetLoadFlags(int flags);
 
+    /**
+        Sets the maximal number of threads used for processing the image data.
+
+        Some operations, such as resampling the image in Scale() or blurring
+        it with Blur(), split the work between several threads when processing
+        big enough images. By default, as many threads as there are CPUs in the
+        system are used, but this function can be used to limit their number,
+        e.g. when the application already processes several images in parallel
+        itself.
+
+        Notice that this setting affects all images.
+
+        @param numThreads The maximal number of threads to use, 1 to perform
+            all the processing in the calling thread or 0 to use the default
+            number of threads.
+
+        @see GetMaxThreads()
+
+        @since 3.1.4
+     */
+    static void SetMaxThreads(int numThreads);
+
     /**
         Specifies whether there is a mask or not.
 
@@ -1997,6 +2426,17 @@ public:
      */
     int GetLoadFlags() const;
 
+    /**
+        Returns the maximal number of threads used for processing the image data.
+
+        Returns 0 if the default number of threads, i.e. one per CPU, is used.
+
+        @see SetMaxThreads()
+
+        @since 3.1.4
+     */
+    static int GetMaxThreads();
+
     /**
         Converts a color in RGB color space to HSV color space.
     */
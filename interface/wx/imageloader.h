@@ -0,0 +1,216 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        interface/wx/imageloader.h
+// Purpose:     wxImageLoader class documentation
+// Author:      wxWidgets team
+// Created:     2020-03-19
+// Copyright:   (c) 2020 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+    Loads many images concurrently using several threads.
+
+    Loading a lot of images, e.g. all the thumbnails in a directory, using
+    wxImage::LoadFile() one after another only uses a single CPU. This class
+    allows to queue any number of images for loading and decodes them in
+    parallel using a pool of worker threads, which are created as needed.
+
+    The images can be retrieved in one of two ways: either an event handler is
+    specified when creating the loader, and then wxImageLoaderEvent is queued
+    to it as soon as each of the images is loaded, or the images are kept by
+    the loader until they're retrieved by calling GetImage(), which blocks
+    until the image is loaded if necessary, i.e. can be used as a future.
+
+    When the type of the image is not specified, the loader remembers the
+    handler which was able to read the file with the given extension the last
+    time and tries it first for the subsequent files with the same extension,
+    instead of checking all the handlers as wxImage::LoadFile() does. The
+    handler is still checked to be able to read the file, so the files with
+    wrong extensions are still loaded correctly.
+
+    Example of using it:
+    @code
+    wxImageLoader loader;
+    loader.SetMaxSize(128, 128);
+
+    for ( size_t n = 0; n < files.size(); n++ )
+        loader.Load(files[n]);
+
+    for ( size_t n = 0; n < files.size(); n++ )
+    {
+        const wxImage image = loader.GetImage(n);
+        if ( image.IsOk() )
+            ... use the thumbnail ...
+    }
+    @endcode
+
+    Notice that the image handlers must not be added or removed while any
+    images are being loaded. Any errors which happen while loading the images
+    are logged from the worker threads, see wxLog for how such messages are
+    handled.
+
+    This class is only available if @c wxUSE_THREADS is set to 1.
+
+    @since 3.1.4
+
+    @library{wxcore}
+    @category{gdi}
+
+    @see wxImage, wxImageLoaderEvent
+*/
+class wxImageLoader
+{
+public:
+    /**
+        Creates the loader.
+
+        @param handler
+            If non-@NULL, the object to which wxImageLoaderEvent is sent
+            when each image is loaded. It must remain valid as long as the
+            loader exists. If it is @NULL, GetImage() must be used to retrieve
+            the loaded images instead.
+        @param numThreads
+            The maximal number of threads to use. By default, the number of
+            CPUs in the system, as returned by wxThread::GetCPUCount(), is
+            used.
+     */
+    explicit wxImageLoader(wxEvtHandler* handler = NULL, int numThreads = 0);
+
+    /**
+        Destroys the loader.
+
+        The images which are not being loaded yet are cancelled and this
+        destructor waits until the images which are being loaded are done.
+     */
+    ~wxImageLoader();
+
+    /**
+        Scales the images down while loading them.
+
+        This is the same as setting wxIMAGE_OPTION_MAX_WIDTH and
+        wxIMAGE_OPTION_MAX_HEIGHT options before calling wxImage::LoadFile()
+        and only affects the images queued after calling this function.
+
+        Use 0 for either dimension to remove the corresponding limit.
+     */
+    void SetMaxSize(int maxWidth, int maxHeight);
+
+    /**
+        Queues the image file for loading.
+
+        @param filename
+            The name of the file to load.
+        @param type
+            The type of the image, by default it is determined automatically.
+        @return
+            The index of the image, which is the number of images queued before
+            it, used to identify it in GetImage() and in the events.
+     */
+    int Load(const wxString& filename, wxBitmapType type = wxBITMAP_TYPE_ANY);
+
+    /**
+        Queues the image from the given stream for loading.
+
+        This is similar to the overload taking the file name, but loads the
+        image from the given stream, which must be allocated on the heap and
+        is deleted by the loader. Notice that the stream is used from another
+        thread, so it must not be shared with any other objects.
+     */
+    int Load(wxInputStream* stream, wxBitmapType type = wxBITMAP_TYPE_ANY);
+
+    /**
+        Returns the number of images queued for loading so far.
+     */
+    int GetCount() const;
+
+    /**
+        Returns @true if the image with the given index was already loaded.
+
+        Also returns @true if loading it failed or was cancelled.
+     */
+    bool IsDone(int index) const;
+
+    /**
+        Returns the image with the given index, waiting until it is loaded if
+        necessary.
+
+        The returned image is invalid if loading it failed or was cancelled.
+
+        The image is not kept by the loader after it is returned, so this
+        function can be called only once for each image. It also can't be used
+        if the images are sent to the event handler.
+     */
+    wxImage GetImage(int index);
+
+    /**
+        Waits until all the images queued so far are loaded.
+
+        If the images are sent to the event handler, the events for all of
+        them have been queued to it when this function returns, so they can
+        be processed using wxEvtHandler::ProcessPendingEvents().
+     */
+    void Wait();
+
+    /**
+        Cancels loading all the images which are not being loaded yet.
+
+        No events are sent for the cancelled images.
+     */
+    void Cancel();
+};
+
+/**
+    @class wxImageLoaderEvent
+
+    This event is sent by wxImageLoader to the handler specified when creating
+    it when an image is loaded.
+
+    @beginEventTable{wxImageLoaderEvent}
+    @event{EVT_IMAGE_LOADED(func)}
+        Process a @c wxEVT_IMAGE_LOADED event, sent when an image is loaded
+        or loading it failed.
+    @endEventTable
+
+    @since 3.1.4
+
+    @library{wxcore}
+    @category{events}
+
+    @see wxImageLoader, @ref overview_events
+*/
+class wxImageLoaderEvent : public wxEvent
+{
+public:
+    /**
+        Constructor, only used by wxWidgets itself.
+     */
+    wxImageLoaderEvent(int index = -1,
+                       const wxString& filename = wxString(),
+                       const wxImage& image = wxImage());
+
+    /**
+        Returns the index of the image, as returned by wxImageLoader::Load().
+     */
+    int GetIndex() const;
+
+    /**
+        Returns the name of the image file.
+
+        The name is empty if the image was loaded from a stream.
+     */
+    const wxString& GetFileName() const;
+
+    /**
+        Returns the loaded image.
+
+        The image is invalid if loading it failed.
+     */
+    const wxImage& GetImage() const;
+
+    /**
+        Returns @true if the image was loaded successfully.
+     */
+    bool IsOk() const;
+};
+
+wxEventType wxEVT_IMAGE_LOADED;
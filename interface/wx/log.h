@@ -274,6 +274,14 @@ public:
         active log target is set to @NULL a new default log target will be
         created when logging occurs.
 
+        If the previous log target is thread-safe, i.e. its IsThreadSafe()
+        returns @true, the other threads may be using it when this function is
+        called. In this case, this function waits until they stop doing it
+        before returning, so that the returned log target can be safely
+        deleted. Because of this, this function must not be called from the
+        thread-safe log target functions themselves, nor while holding any
+        lock that the thread-safe log target could wait for.
+
         @see SetThreadActiveTarget()
     */
     static wxLog* SetActiveTarget(wxLog* logtarget);
@@ -304,6 +312,29 @@ public:
      */
     static wxLog *SetThreadActiveTarget(wxLog *logger);
 
+    /**
+        Returns @true if this log target can be used from any thread.
+
+        By default, the messages logged by the threads other than the main one
+        are buffered and only passed to the active log target when Flush() is
+        called from the main thread, as most log targets can only be used from
+        it. If this function returns @true for the active log target, the
+        messages are passed to it directly from the thread logging them
+        instead, so it must be safe to call its DoLogRecord() and the other
+        functions from any thread.
+
+        Notice that SetActiveTarget() waits until the other threads stop using
+        the thread-safe log target before returning it, so it is safe to
+        delete the returned log target even if other threads were logging to
+        it, see its description for more details.
+
+        The base class version returns @false, wxLogAsync overrides it to
+        return @true.
+
+        @since 3.1.4
+     */
+    virtual bool IsThreadSafe() const;
+
     /**
         Flushes the current log target if any, does nothing if there is none.
 
@@ -737,6 +768,100 @@ public:
 };
 
 
+/**
+    @class wxLogAsync
+
+    Log target passing the messages to another log target from a background
+    thread.
+
+    This class is useful for the programs logging a lot of messages from
+    several threads: normally, the messages logged from the threads other than
+    main are buffered in a global buffer, protected by a lock, and formatted
+    and passed to the active log target only when the main thread flushes
+    them. When using this class as the active log target, each thread formats
+    its messages itself and appends them to its own buffer, which is almost
+    never contended, and the background thread periodically passes all the
+    buffered messages to the real log target in a single batch, keeping the
+    messages from all threads in order.
+
+    The memory used by each thread buffer is bounded: if it already contains
+    the maximal number of messages, the new messages are dropped until the
+    buffer is flushed. The number of the dropped messages can be retrieved
+    using GetDroppedCount() and a warning about them is also logged to the
+    real log target.
+
+    The buffer of each thread is freed once the thread terminates and its
+    remaining messages are passed to the real log target, or when this object
+    is destroyed.
+
+    As with any other thread-safe log target, it is safe to delete this object
+    after replacing it with another one using wxLog::SetActiveTarget(), even
+    if other threads are still logging, as SetActiveTarget() waits until they
+    don't use it any more.
+
+    Notice that, as the real log target is used from the background thread,
+    it must not be a log target which can only be used from the main thread,
+    such as wxLogGui or wxLogWindow. Typically, this class is used with
+    wxLogStderr or wxLogStream:
+    @code
+    wxLog::SetActiveTarget(new wxLogAsync(new wxLogStderr));
+    @endcode
+
+    Also notice that the repeated messages are not counted for the messages
+    logged from the threads other than main when using this class, even if
+    wxLog::SetRepetitionCounting() was called.
+
+    This class is only available if @c wxUSE_THREADS is 1.
+
+    @library{wxbase}
+    @category{logging}
+
+    @since 3.1.4
+*/
+class wxLogAsync : public wxLog
+{
+public:
+    /**
+        Creates the log target passing the messages to the given one.
+
+        @param logger
+            The log target to pass the messages to, must be non-@NULL. This
+            object takes ownership of it and will delete it.
+        @param maxPendingPerThread
+            The maximal number of messages which can be buffered for each
+            thread before they are flushed.
+        @param flushInterval
+            The maximal time, in milliseconds, between flushing the buffered
+            messages, notice that they are also flushed earlier if any of the
+            buffers becomes half full.
+    */
+    explicit wxLogAsync(wxLog* logger,
+                        size_t maxPendingPerThread = 4096,
+                        unsigned long flushInterval = 100);
+
+    /**
+        Destructor passes all the remaining messages to the real log target
+        and deletes it.
+    */
+    virtual ~wxLogAsync();
+
+    /**
+        Returns the total number of the messages dropped because the buffer of
+        the thread logging them was full.
+    */
+    unsigned long GetDroppedCount() const;
+
+    /**
+        Passes all the buffered messages to the real log target and flushes it.
+
+        Unlike the periodic flushing done by the background thread, this is
+        done synchronously, i.e. when this function returns all the messages
+        logged before calling it have been passed to the real log target.
+    */
+    virtual void Flush();
+};
+
+
 /**
     @class wxLogStream
 
@@ -62,3 +62,146 @@ public:
                                      wxQUANTIZE_RETURN_8BIT_DATA);
 };
 
+
+/**
+    @class wxQuantizer
+
+    Reduces the number of colours in one or more images, like wxQuantize, but
+    allows to reuse the same palette for many images.
+
+    First, all the images whose colours should be taken into account are
+    added to the quantizer using AddImage(). Then the palette is chosen by
+    CreatePalette() and any number of images can be mapped to it using
+    MapImage(), which uses Floyd-Steinberg dithering.
+
+    This is more efficient than calling wxQuantize::Quantize() for each image
+    because the tables used for finding the nearest palette colour are only
+    computed once, and it also allows to use a common palette, e.g. for all
+    frames of an animation.
+
+    Example of using it:
+    @code
+    wxQuantizer quantizer(256);
+    for ( size_t n = 0; n < frames.size(); n++ )
+        quantizer.AddImage(frames[n]);
+
+    for ( size_t n = 0; n < frames.size(); n++ )
+        quantizer.MapImage(frames[n], frames[n]);
+    @endcode
+
+    Notice that the functions of the same object can't be called from
+    different threads at the same time.
+
+    @since 3.1.4
+
+    @library{wxcore}
+    @category{misc}
+
+    @see wxQuantize, wxImage
+*/
+class wxQuantizer
+{
+public:
+    /**
+        Creates the quantizer choosing the palette with at most the given
+        number of colours, which must be between 1 and 256.
+    */
+    explicit wxQuantizer(int numColours = 256);
+
+    /**
+        Destroys the quantizer.
+    */
+    ~wxQuantizer();
+
+    /**
+        Adds the colours of the image to the histogram used for choosing the
+        palette.
+
+        The image alpha channel and mask are ignored.
+
+        The image must be valid and the palette must not have been created
+        yet, as no more images can be added to it then. Otherwise an
+        assertion failure occurs and @false is returned.
+
+        @see Reset()
+    */
+    bool AddImage(const wxImage& image);
+
+    /**
+        Chooses the palette for all the images added so far.
+
+        This function doesn't need to be called explicitly, as MapImage()
+        calls it if necessary, but it must be called before using
+        GetPaletteSize() or GetPaletteData().
+
+        At least one image must have been added using AddImage() before,
+        otherwise an assertion failure occurs and @false is returned.
+    */
+    bool CreatePalette();
+
+    /**
+        Returns the number of colours in the palette.
+
+        This may be less than the number of colours specified in the
+        constructor if the images don't contain enough different colours.
+    */
+    int GetPaletteSize() const;
+
+    /**
+        Returns the palette colours as GetPaletteSize() RGB triplets.
+
+        The returned pointer remains valid until Reset() is called or this
+        object is destroyed.
+    */
+    const unsigned char* GetPaletteData() const;
+
+    /**
+        Sets the height of the bands in which the images are dithered.
+
+        By default, the whole image is dithered at once, giving exactly the
+        same results as wxQuantize. If the band height is positive, the
+        errors are not diffused between the bands, which allows processing
+        them in parallel using several threads, see wxImage::SetMaxThreads().
+        The result doesn't depend on the number of threads used, but may have
+        visible seams between the bands if they are too small, so relatively
+        big values, e.g. 64, should be used.
+    */
+    void SetBandHeight(int height);
+
+    /**
+        Returns the band height set by SetBandHeight().
+    */
+    int GetBandHeight() const;
+
+    /**
+        Maps the image to the palette, storing the indices of the palette
+        colours in the provided buffer.
+
+        The buffer must be big enough to contain one byte for each image pixel.
+
+        The image must be valid and at least one image must have been added
+        using AddImage() before, otherwise an assertion failure occurs and
+        @false is returned.
+    */
+    bool MapImage(const wxImage& image, unsigned char* indices);
+
+    /**
+        Maps the image to the palette, replacing @a dest with an image using
+        only the palette colours.
+
+        The palette is also associated with @a dest if @c wxUSE_PALETTE is 1.
+        Both images may be the same, to overwrite the source image.
+
+        The image must be valid and at least one image must have been added
+        using AddImage() before, otherwise an assertion failure occurs and
+        @false is returned.
+    */
+    bool MapImage(const wxImage& image, wxImage& dest);
+
+    /**
+        Forgets all the images added so far and the palette.
+
+        After calling this function, new images can be added to the quantizer.
+    */
+    void Reset();
+};
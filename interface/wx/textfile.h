@@ -34,7 +34,8 @@ enum wxTextFileType
     not work in this way with large files (as an estimation, anything over 1 Megabyte
     is surely too big for this class). On the other hand, it is not a serious
     limitation for small files like configuration files or program sources
-    which are well handled by wxTextFile.
+    which are well handled by wxTextFile. For bigger files, consider using
+    SetLazyLoading() to avoid converting all their lines when opening them.
 
     The typical things you may do with wxTextFile in order are:
 
@@ -275,6 +276,47 @@ public:
     */
     void RemoveLine(size_t n);
 
+    /**
+        Enables or disables loading the lines only when they're accessed.
+
+        By default, Open() converts all the lines of the file to wxString when
+        it is called. If lazy loading is enabled, the file is mapped in memory
+        using wxMappedFile instead and only the positions of the lines in it
+        are stored, while each line is converted when it is accessed for the
+        first time, e.g. by GetLine(). This makes opening big files much
+        faster and uses less memory if only some of their lines are used.
+
+        Lazy loading is only used for the files which are valid UTF-8, when
+        using the default wxConvAuto or wxConvUTF8 conversion, all the other
+        files are still loaded entirely when they're opened. Notice that the
+        lines not loaded yet are loaded by Write(), which also unmaps the file.
+        The file is also unmapped by Close() or Clear().
+
+        As the file remains mapped while it's used, it must not be truncated
+        by another process, as accessing the lines beyond its new end may
+        result in a crash under some systems, see wxMappedFile.
+
+        Also notice that, unlike usual, even the const functions accessing
+        the lines, such as GetLine() or operator[](), modify the object
+        when lazy loading is used, as they load the line if it hadn't been
+        loaded yet. So they can't be called from several threads at once
+        without synchronization, even if all threads only read the file.
+
+        This function must be called before Open() to have any effect.
+
+        @since 3.1.4
+    */
+    void SetLazyLoading(bool lazy = true);
+
+    /**
+        Returns @true if lazy loading is enabled.
+
+        @see SetLazyLoading()
+
+        @since 3.1.4
+    */
+    bool IsLazyLoading() const;
+
     /**
         Change the file on disk.
 
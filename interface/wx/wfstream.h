@@ -210,6 +210,59 @@ public:
 
 
 
+/**
+    @class wxMappedFileInputStream
+
+    This class reads the data from a file mapped in memory using wxMappedFile.
+
+    As the data is mapped in memory, reading it doesn't involve any system
+    calls and the pages of the file which are never read are not loaded at
+    all. This makes this class a good choice for reading big files, e.g. by
+    wxImage::LoadFile() and wxXmlDocument::Load() which use it. If the file
+    can't be mapped, e.g. because it is a pipe, it is read entirely in memory
+    when the stream is created.
+
+    Notice that the file must not be truncated by another process while it's
+    being read using this class, as accessing the mapped data beyond the end
+    of the file may result in a crash under some systems.
+
+    @library{wxbase}
+    @category{streams}
+
+    @since 3.1.4
+
+    @see wxFileInputStream, wxMappedFile
+*/
+class wxMappedFileInputStream : public wxInputStream
+{
+public:
+    /**
+        Maps the file with the given name.
+
+        @param fileName
+            The name of the file to read.
+        @param access
+            The expected access pattern, see wxMappedFile::Access.
+
+        @warning
+        You should use wxStreamBase::IsOk() to verify if the constructor succeeded.
+    */
+    wxMappedFileInputStream(const wxString& fileName,
+                            wxMappedFile::Access access = wxMappedFile::Access_Sequential);
+
+    /**
+        Returns @true if the file was successfully mapped and no error occurred.
+    */
+    bool IsOk() const;
+
+    /**
+        Returns the object containing the file contents.
+    */
+    const wxMappedFile& GetMappedFile() const;
+};
+
+
+
 /**
     @class wxFileInputStream
 
@@ -440,6 +440,134 @@ public:
 
 
 
+/**
+    @class wxZipIndex
+
+    Provides random access to the entries of a zip file.
+
+    Unlike wxZipInputStream, which needs to read the central directory of the
+    zip each time an entry is looked up by name, this class reads it only once,
+    when Open() is called, and keeps the entries sorted by their names. After
+    this, any entry can be found in logarithmic time using Find() and its data
+    can be read from the stream returned by OpenEntry().
+
+    Each stream returned by OpenEntry() reads the file independently of all the
+    others, so several entries may be read at the same time. The const methods
+    of this class may also be called from several threads at once, allowing
+    the different threads to read the entries of the same zip concurrently.
+
+    Example of using it:
+    @code
+    wxZipIndex index;
+    if ( index.Open("resources.zip") )
+    {
+        wxScopedPtr<wxZipInputStream> in(index.OpenEntry("images/logo.png"));
+        if ( in )
+        {
+            wxImage image(*in, wxBITMAP_TYPE_PNG);
+            ...
+        }
+    }
+    @endcode
+
+    This class is only available if @c wxUSE_FILE is set to 1.
+
+    @since 3.1.4
+
+    @library{wxbase}
+    @category{archive,streams}
+
+    @see @ref overview_archive, wxZipEntry, wxZipInputStream
+*/
+class wxZipIndex
+{
+public:
+    /**
+        Constructor.
+
+        The @a conv parameter is used to translate the filename and comment
+        fields of the entries into Unicode, as in wxZipInputStream.
+
+        Open() must be called to actually use this object.
+    */
+    wxZipIndex(wxMBConv& conv = wxConvLocal);
+
+    /**
+        Destructor closes the zip file.
+
+        All the streams returned by OpenEntry() must have been already deleted.
+    */
+    ~wxZipIndex();
+
+    /**
+        Opens the given zip file and reads its central directory.
+
+        Any previously opened file is closed first.
+
+        @return @true if the file was opened and its entries were read
+            successfully or @false otherwise.
+    */
+    bool Open(const wxString& filename);
+
+    /**
+        Closes the zip file and frees all its entries.
+
+        All the streams returned by OpenEntry() must have been already deleted.
+    */
+    void Close();
+
+    /**
+        Returns @true if a zip file was successfully opened.
+    */
+    bool IsOk() const;
+
+    /**
+        Returns the number of entries in the zip.
+    */
+    size_t GetCount() const;
+
+    /**
+        Returns the entry with the given index.
+
+        The entries are sorted in the lexicographic order of their internal
+        names, see wxZipEntry::GetInternalName().
+
+        @param n Index of the entry, must be less than GetCount().
+    */
+    const wxZipEntry& GetEntry(size_t n) const;
+
+    /**
+        Finds the entry with the given name.
+
+        The name is converted to the internal format using
+        wxZipEntry::GetInternalName() before searching for it.
+
+        @return Pointer to the entry owned by this object or @NULL if there is
+            no entry with such name.
+    */
+    const wxZipEntry* Find(const wxString& name,
+                           wxPathFormat format = wxPATH_NATIVE) const;
+
+    //@{
+    /**
+        Opens the given entry for reading.
+
+        The first overload takes one of the entries of this object, i.e. one
+        returned by GetEntry() or Find(), while the second one finds the entry
+        by name first.
+
+        @return A new stream which must be deleted by the caller before this
+            object is closed or destroyed, or @NULL if the entry couldn't be
+            opened.
+    */
+    wxZipInputStream* OpenEntry(const wxZipEntry& entry) const;
+    wxZipInputStream* OpenEntry(const wxString& name,
+                                wxPathFormat format = wxPATH_NATIVE) const;
+    //@}
+};
+
+
+
 /**
     @class wxZipClassFactory
 
@@ -478,8 +478,8 @@ void wxAppConsoleBase::DelayPendingEventHandler(wxEvtHandler* toDelay)
     // to the list of handlers with pending events which needs to be processed later
     m_handlersWithPendingEvents.Remove(toDelay);
 
-    if (m_handlersWithPendingDelayedEvents.Index(toDelay) == wxNOT_FOUND)
-        m_handlersWithPendingDelayedEvents.Add(toDelay);
+    if ( !m_handlersWithPendingDelayedEvents.Contains(toDelay) )
+        m_handlersWithPendingDelayedEvents.Append(toDelay);
 
     wxLEAVE_CRIT_SECT(m_handlersWithPendingEventsLocker);
 }
@@ -488,26 +488,11 @@ void wxAppConsoleBase::RemovePendingEventHandler(wxEvtHandler* toRemove)
 {
     wxENTER_CRIT_SECT(m_handlersWithPendingEventsLocker);
 
-    if (m_handlersWithPendingEvents.Index(toRemove) != wxNOT_FOUND)
-    {
-        m_handlersWithPendingEvents.Remove(toRemove);
-
-        // check that the handler was present only once in the list
-        wxASSERT_MSG( m_handlersWithPendingEvents.Index(toRemove) == wxNOT_FOUND,
-                        "Handler occurs twice in the m_handlersWithPendingEvents list!" );
-    }
-    //else: it wasn't in this list at all, it's ok
-
-    if (m_handlersWithPendingDelayedEvents.Index(toRemove) != wxNOT_FOUND)
-    {
+    // the handler can be in at most one of these lists and it's ok if it's
+    // not in any of them
+    if ( !m_handlersWithPendingEvents.Remove(toRemove) )
         m_handlersWithPendingDelayedEvents.Remove(toRemove);
 
-        // check that the handler was present only once in the list
-        wxASSERT_MSG( m_handlersWithPendingDelayedEvents.Index(toRemove) == wxNOT_FOUND,
-                        "Handler occurs twice in m_handlersWithPendingDelayedEvents list!" );
-    }
-    //else: it wasn't in this list at all, it's ok
-
     wxLEAVE_CRIT_SECT(m_handlersWithPendingEventsLocker);
 }
 
@@ -515,8 +500,14 @@ void wxAppConsoleBase::AppendPendingEventHandler(wxEvtHandler* toAppend)
 {
     wxENTER_CRIT_SECT(m_handlersWithPendingEventsLocker);
 
-    if ( m_handlersWithPendingEvents.Index(toAppend) == wxNOT_FOUND )
-        m_handlersWithPendingEvents.Add(toAppend);
+    if ( !m_handlersWithPendingEvents.Contains(toAppend) )
+    {
+        // the handler could have been delayed before, but the new event may
+        // be processable now, so give it another chance
+        m_handlersWithPendingDelayedEvents.Remove(toAppend);
+
+        m_handlersWithPendingEvents.Append(toAppend);
+    }
 
     wxLEAVE_CRIT_SECT(m_handlersWithPendingEventsLocker);
 }
@@ -563,7 +554,7 @@ void wxAppConsoleBase::ProcessPendingEvents()
             //       with pending events because handlers auto-remove themselves
             //       from this list (see RemovePendingEventHandler) if they have no
             //       more pending events.
-            m_handlersWithPendingEvents[0]->ProcessPendingEvents();
+            m_handlersWithPendingEvents.GetFirst()->ProcessPendingEvents();
 
             wxENTER_CRIT_SECT(m_handlersWithPendingEventsLocker);
         }
@@ -573,11 +564,7 @@ void wxAppConsoleBase::ProcessPendingEvents()
         // because of a selective wxYield call in progress.
         // Now we need to move them back to wxHandlersWithPendingEvents so the next
         // call to this function has the chance of processing them:
-        if (!m_handlersWithPendingDelayedEvents.IsEmpty())
-        {
-            WX_APPEND_ARRAY(m_handlersWithPendingEvents, m_handlersWithPendingDelayedEvents);
-            m_handlersWithPendingDelayedEvents.Clear();
-        }
+        m_handlersWithPendingEvents.Splice(m_handlersWithPendingDelayedEvents);
 
         wxLEAVE_CRIT_SECT(m_handlersWithPendingEventsLocker);
     }
@@ -590,10 +577,12 @@ void wxAppConsoleBase::DeletePendingEvents()
     wxCHECK_RET( m_handlersWithPendingDelayedEvents.IsEmpty(),
                  "this helper list should be empty" );
 
-    for (unsigned int i=0; i<m_handlersWithPendingEvents.GetCount(); i++)
-        m_handlersWithPendingEvents[i]->DeletePendingEvents();
-
-    m_handlersWithPendingEvents.Clear();
+    while ( !m_handlersWithPendingEvents.IsEmpty() )
+    {
+        wxEvtHandler* const handler = m_handlersWithPendingEvents.GetFirst();
+        m_handlersWithPendingEvents.Remove(handler);
+        handler->DeletePendingEvents();
+    }
 
     wxLEAVE_CRIT_SECT(m_handlersWithPendingEventsLocker);
 }
@@ -135,6 +135,7 @@ bool wxDataViewModelNotifier::ItemsChanged( const wxDataViewItemArray &items )
 
 wxDataViewModel::wxDataViewModel()
 {
+    m_batchCount = 0;
 }
 
 wxDataViewModel::~wxDataViewModel()
@@ -306,10 +307,40 @@ void wxDataViewModel::Resort()
     }
 }
 
+void wxDataViewModel::BeginBatch()
+{
+    if ( m_batchCount++ )
+        return;
+
+    wxDataViewModelNotifiers::iterator iter;
+    for (iter = m_notifiers.begin(); iter != m_notifiers.end(); ++iter)
+    {
+        (*iter)->BeginBatch();
+    }
+}
+
+void wxDataViewModel::EndBatch()
+{
+    wxCHECK_RET( m_batchCount > 0, "EndBatch() without matching BeginBatch()" );
+
+    if ( --m_batchCount )
+        return;
+
+    wxDataViewModelNotifiers::iterator iter;
+    for (iter = m_notifiers.begin(); iter != m_notifiers.end(); ++iter)
+    {
+        (*iter)->EndBatch();
+    }
+}
+
 void wxDataViewModel::AddNotifier( wxDataViewModelNotifier *notifier )
 {
     m_notifiers.push_back( notifier );
     notifier->SetOwner( this );
+
+    // Keep the calls to the notifier BeginBatch() and EndBatch() balanced.
+    if ( m_batchCount )
+        notifier->BeginBatch();
 }
 
 void wxDataViewModel::RemoveNotifier( wxDataViewModelNotifier *notifier )
@@ -319,6 +350,11 @@ void wxDataViewModel::RemoveNotifier( wxDataViewModelNotifier *notifier )
     {
         if ( *iter == notifier )
         {
+            // Balance the BeginBatch() call done for it when the batch
+            // started or when it was added.
+            if ( m_batchCount )
+                notifier->EndBatch();
+
             delete notifier;
             m_notifiers.erase(iter);
 
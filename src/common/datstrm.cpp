@@ -21,6 +21,7 @@
 
 #ifndef WX_PRECOMP
     #include "wx/math.h"
+    #include "wx/utils.h"
 #endif //WX_PRECOMP
 
 namespace
@@ -39,6 +40,121 @@ union Float64Data
     wxUint32 i[2];
 };
 
+// size of the temporary buffers used for converting the arrays of values
+const size_t CHUNK_SIZE = 4096;
+
+// return true if the data in the given byte order doesn't use the native one
+inline bool NeedsSwap(bool be_order)
+{
+    return be_order != (wxBYTE_ORDER == wxBIG_ENDIAN);
+}
+
+inline wxUint16 SwapBytes(wxUint16 v) { return wxUINT16_SWAP_ALWAYS(v); }
+inline wxUint32 SwapBytes(wxUint32 v) { return wxUINT32_SWAP_ALWAYS(v); }
+#ifdef wxLongLong_t
+inline wxUint64 SwapBytes(wxUint64 v) { return wxUINT64_SWAP_ALWAYS(v); }
+#endif // wxLongLong_t
+
+// Copy count values of type T from src to dst, which may be the same, swapping
+// their bytes. The values are accessed using memcpy() as the buffers may
+// actually contain floating point numbers, this loop is simple enough to be
+// vectorized by the compiler.
+template <typename T>
+void SwapArray(void *dst, const void *src, size_t count)
+{
+    char *d = static_cast<char *>(dst);
+    const char *s = static_cast<const char *>(src);
+    for ( size_t n = 0; n < count; n++ )
+    {
+        T v;
+        memcpy(&v, s + n*sizeof(T), sizeof(T));
+        v = SwapBytes(v);
+        memcpy(d + n*sizeof(T), &v, sizeof(T));
+    }
+}
+
+// Read count values of type T into the buffer directly and swap them in place
+// if necessary.
+template <typename T>
+void ReadArray(wxInputStream *input, void *buffer, size_t count, bool be_order)
+{
+    input->Read(buffer, count*sizeof(T));
+
+    if ( NeedsSwap(be_order) )
+        SwapArray<T>(buffer, buffer, count);
+}
+
+// Write count values of type T from the buffer, which is written directly if
+// no swapping is needed or using a temporary buffer otherwise.
+template <typename T>
+void WriteArray(wxOutputStream *output, const void *buffer, size_t count,
+                bool be_order)
+{
+    if ( !NeedsSwap(be_order) )
+    {
+        output->Write(buffer, count*sizeof(T));
+        return;
+    }
+
+    T tmp[CHUNK_SIZE / sizeof(T)];
+    const char *p = static_cast<const char *>(buffer);
+    while ( count )
+    {
+        const size_t n = wxMin(count, WXSIZEOF(tmp));
+        SwapArray<T>(tmp, p, n);
+
+        const size_t len = n*sizeof(T);
+        if ( output->Write(tmp, len).LastWrite() != len )
+            break;
+
+        p += len;
+        count -= n;
+    }
+}
+
+#if wxUSE_APPLE_IEEE
+
+// The size of the extended precision representation of a number.
+const size_t EXTENDED_SIZE = 10;
+
+// Read and write the arrays of numbers using the extended representation. This
+// is still done value by value, but only calls the stream once per chunk.
+template <typename T>
+void ReadExtendedArray(wxInputStream *input, T *buffer, size_t count)
+{
+    wxInt8 tmp[(CHUNK_SIZE / EXTENDED_SIZE)*EXTENDED_SIZE];
+    while ( count )
+    {
+        const size_t n = wxMin(count, WXSIZEOF(tmp) / EXTENDED_SIZE);
+        input->Read(tmp, n*EXTENDED_SIZE);
+
+        for ( size_t i = 0; i < n; i++ )
+            *buffer++ = static_cast<T>(wxConvertFromIeeeExtended(tmp + i*EXTENDED_SIZE));
+
+        count -= n;
+    }
+}
+
+template <typename T>
+void WriteExtendedArray(wxOutputStream *output, const T *buffer, size_t count)
+{
+    wxInt8 tmp[(CHUNK_SIZE / EXTENDED_SIZE)*EXTENDED_SIZE];
+    while ( count )
+    {
+        const size_t n = wxMin(count, WXSIZEOF(tmp) / EXTENDED_SIZE);
+        for ( size_t i = 0; i < n; i++ )
+            wxConvertToIeeeExtended(*buffer++, tmp + i*EXTENDED_SIZE);
+
+        const size_t len = n*EXTENDED_SIZE;
+        if ( output->Write(tmp, len).LastWrite() != len )
+            break;
+
+        count -= n;
+    }
+}
+
+#endif // wxUSE_APPLE_IEEE
+
 } // anonymous namespace
 
 // ----------------------------------------------------------------------------
@@ -282,69 +398,13 @@ static void DoWriteLL(const T *buffer, size_t size, wxOutputStream *output, bool
 
 #endif // wxUSE_LONGLONG
 
-#ifdef wxLongLong_t
-
-template <class T>
-static
-void DoReadI64(T *buffer, size_t size, wxInputStream *input, bool be_order)
-{
-    typedef T DataType;
-    unsigned char *pchBuffer = (unsigned char*) buffer;
-    // TODO: Check for overflow when size is of type uint and is > than 512m
-    input->Read(pchBuffer, size * 8);
-    if ( be_order )
-    {
-        for ( wxUint32 i = 0; i < size; i++ )
-        {
-            DataType v = wxUINT64_SWAP_ON_LE(*buffer);
-            *(buffer++) = v;
-        }
-    }
-    else // little endian
-    {
-        for ( wxUint32 i=0; i<size; i++ )
-        {
-            DataType v = wxUINT64_SWAP_ON_BE(*buffer);
-            *(buffer++) = v;
-        }
-    }
-}
-
-template <class T>
-static
-void DoWriteI64(const T *buffer, size_t size, wxOutputStream *output, bool be_order)
-{
-  typedef T DataType;
-  if ( be_order )
-  {
-    for ( size_t i = 0; i < size; i++ )
-    {
-      DataType i64 = wxUINT64_SWAP_ON_LE(*buffer);
-      buffer++;
-      output->Write(&i64, 8);
-    }
-  }
-  else // little endian
-  {
-    for ( size_t i=0; i < size; i++ )
-    {
-      DataType i64 = wxUINT64_SWAP_ON_BE(*buffer);
-      buffer++;
-      output->Write(&i64, 8);
-    }
-  }
-}
-
-#endif // wxLongLong_t
-
-
 #if wxHAS_INT64
 void wxDataInputStream::Read64(wxUint64 *buffer, size_t size)
 {
 #ifndef wxLongLong_t
     DoReadLL(buffer, size, m_input, m_be_order);
 #else
-    DoReadI64(buffer, size, m_input, m_be_order);
+    ReadArray<wxUint64>(m_input, buffer, size, m_be_order);
 #endif
 }
 
@@ -353,7 +413,7 @@ void wxDataInputStream::Read64(wxInt64 *buffer, size_t size)
 #ifndef wxLongLong_t
     DoReadLL(buffer, size, m_input, m_be_order);
 #else
-    DoReadI64(buffer, size, m_input, m_be_order);
+    ReadArray<wxUint64>(m_input, buffer, size, m_be_order);
 #endif
 }
 #endif // wxHAS_INT64
@@ -391,46 +451,12 @@ wxLongLong wxDataInputStream::ReadLL(void)
 
 void wxDataInputStream::Read32(wxUint32 *buffer, size_t size)
 {
-    m_input->Read(buffer, size * 4);
-
-    if (m_be_order)
-    {
-        for (wxUint32 i=0; i<size; i++)
-        {
-            wxUint32 v = wxUINT32_SWAP_ON_LE(*buffer);
-            *(buffer++) = v;
-        }
-    }
-    else
-    {
-        for (wxUint32 i=0; i<size; i++)
-        {
-            wxUint32 v = wxUINT32_SWAP_ON_BE(*buffer);
-            *(buffer++) = v;
-        }
-    }
+    ReadArray<wxUint32>(m_input, buffer, size, m_be_order);
 }
 
 void wxDataInputStream::Read16(wxUint16 *buffer, size_t size)
 {
-  m_input->Read(buffer, size * 2);
-
-  if (m_be_order)
-  {
-    for (wxUint32 i=0; i<size; i++)
-    {
-      wxUint16 v = wxUINT16_SWAP_ON_LE(*buffer);
-      *(buffer++) = v;
-    }
-  }
-  else
-  {
-    for (wxUint32 i=0; i<size; i++)
-    {
-      wxUint16 v = wxUINT16_SWAP_ON_BE(*buffer);
-      *(buffer++) = v;
-    }
-  }
+    ReadArray<wxUint16>(m_input, buffer, size, m_be_order);
 }
 
 void wxDataInputStream::Read8(wxUint8 *buffer, size_t size)
@@ -440,18 +466,37 @@ void wxDataInputStream::Read8(wxUint8 *buffer, size_t size)
 
 void wxDataInputStream::ReadDouble(double *buffer, size_t size)
 {
-  for (wxUint32 i=0; i<size; i++)
-  {
-    *(buffer++) = ReadDouble();
-  }
+#if wxUSE_APPLE_IEEE
+    if ( m_useExtendedPrecision )
+    {
+        ReadExtendedArray(m_input, buffer, size);
+        return;
+    }
+#endif // wxUSE_APPLE_IEEE
+
+#ifdef wxLongLong_t
+    // Reversing the order of all 8 bytes is the same as what ReadDouble()
+    // does by swapping the two 32 bit halves and the bytes inside them.
+    ReadArray<wxUint64>(m_input, buffer, size, m_be_order);
+#else
+    for ( size_t i = 0; i < size; i++ )
+    {
+        *(buffer++) = ReadDouble();
+    }
+#endif
 }
 
 void wxDataInputStream::ReadFloat(float *buffer, size_t size)
 {
-  for (wxUint32 i=0; i<size; i++)
-  {
-    *(buffer++) = ReadFloat();
-  }
+#if wxUSE_APPLE_IEEE
+    if ( m_useExtendedPrecision )
+    {
+        ReadExtendedArray(m_input, buffer, size);
+        return;
+    }
+#endif // wxUSE_APPLE_IEEE
+
+    ReadArray<wxUint32>(m_input, buffer, size, m_be_order);
 }
 
 wxDataInputStream& wxDataInputStream::operator>>(wxString& s)
@@ -653,7 +698,7 @@ void wxDataOutputStream::Write64(const wxUint64 *buffer, size_t size)
 #ifndef wxLongLong_t
     DoWriteLL(buffer, size, m_output, m_be_order);
 #else
-    DoWriteI64(buffer, size, m_output, m_be_order);
+    WriteArray<wxUint64>(m_output, buffer, size, m_be_order);
 #endif
 }
 
@@ -662,7 +707,7 @@ void wxDataOutputStream::Write64(const wxInt64 *buffer, size_t size)
 #ifndef wxLongLong_t
     DoWriteLL(buffer, size, m_output, m_be_order);
 #else
-    DoWriteI64(buffer, size, m_output, m_be_order);
+    WriteArray<wxUint64>(m_output, buffer, size, m_be_order);
 #endif
 }
 #endif // wxHAS_INT64
@@ -703,46 +748,12 @@ void wxDataOutputStream::WriteLL(const wxULongLong &ll)
 
 void wxDataOutputStream::Write32(const wxUint32 *buffer, size_t size)
 {
-  if (m_be_order)
-  {
-    for (wxUint32 i=0; i<size ;i++)
-    {
-      wxUint32 i32 = wxUINT32_SWAP_ON_LE(*buffer);
-      buffer++;
-      m_output->Write(&i32, 4);
-    }
-  }
-  else
-  {
-    for (wxUint32 i=0; i<size ;i++)
-    {
-      wxUint32 i32 = wxUINT32_SWAP_ON_BE(*buffer);
-      buffer++;
-      m_output->Write(&i32, 4);
-    }
-  }
+    WriteArray<wxUint32>(m_output, buffer, size, m_be_order);
 }
 
 void wxDataOutputStream::Write16(const wxUint16 *buffer, size_t size)
 {
-  if (m_be_order)
-  {
-    for (wxUint32 i=0; i<size ;i++)
-    {
-      wxUint16 i16 = wxUINT16_SWAP_ON_LE(*buffer);
-      buffer++;
-      m_output->Write(&i16, 2);
-    }
-  }
-  else
-  {
-    for (wxUint32 i=0; i<size ;i++)
-    {
-      wxUint16 i16 = wxUINT16_SWAP_ON_BE(*buffer);
-      buffer++;
-      m_output->Write(&i16, 2);
-    }
-  }
+    WriteArray<wxUint16>(m_output, buffer, size, m_be_order);
 }
 
 void wxDataOutputStream::Write8(const wxUint8 *buffer, size_t size)
@@ -752,18 +763,35 @@ void wxDataOutputStream::Write8(const wxUint8 *buffer, size_t size)
 
 void wxDataOutputStream::WriteDouble(const double *buffer, size_t size)
 {
-  for (wxUint32 i=0; i<size; i++)
-  {
-    WriteDouble(*(buffer++));
-  }
+#if wxUSE_APPLE_IEEE
+    if ( m_useExtendedPrecision )
+    {
+        WriteExtendedArray(m_output, buffer, size);
+        return;
+    }
+#endif // wxUSE_APPLE_IEEE
+
+#ifdef wxLongLong_t
+    WriteArray<wxUint64>(m_output, buffer, size, m_be_order);
+#else
+    for ( size_t i = 0; i < size; i++ )
+    {
+        WriteDouble(*(buffer++));
+    }
+#endif
 }
 
 void wxDataOutputStream::WriteFloat(const float *buffer, size_t size)
 {
-  for (wxUint32 i=0; i<size; i++)
-  {
-    WriteFloat(*(buffer++));
-  }
+#if wxUSE_APPLE_IEEE
+    if ( m_useExtendedPrecision )
+    {
+        WriteExtendedArray(m_output, buffer, size);
+        return;
+    }
+#endif // wxUSE_APPLE_IEEE
+
+    WriteArray<wxUint32>(m_output, buffer, size, m_be_order);
 }
 
 wxDataOutputStream& wxDataOutputStream::operator<<(const wxString& string)
@@ -29,11 +29,17 @@
     #include "wx/intl.h"
     #include "wx/filefn.h"
     #include "wx/arrstr.h"
+    #include "wx/utils.h"
 #endif //WX_PRECOMP
 
 #include "wx/dir.h"
 #include "wx/filename.h"
 
+#if wxUSE_THREADS
+    #include "wx/thread.h"
+    #include "wx/vector.h"
+#endif // wxUSE_THREADS
+
 // ============================================================================
 // implementation
 // ============================================================================
@@ -93,32 +99,451 @@ wxString wxDir::GetNameWithSep() const
     return name;
 }
 
+// ----------------------------------------------------------------------------
+// wxDirParallelTraverser: implementation of Traverse() with wxDIR_PARALLEL
+// ----------------------------------------------------------------------------
+
+#if wxUSE_THREADS
+
+namespace
+{
+
+// The worker threads read the directories and pass their contents in batches
+// to the thread which called Traverse(), called the main thread below, which
+// calls the sink functions for them and queues the subdirectories to be read
+// if the sink wants it. So the sink is never used from the other threads.
+class wxDirParallelTraverser
+{
+public:
+    wxDirParallelTraverser(wxDirTraverser& sink,
+                           const wxString& filespec,
+                           int flags);
+    ~wxDirParallelTraverser();
+
+    // Traverse the directory and return the number of files found or -1 if
+    // no threads could be started.
+    size_t Traverse(const wxDir& dir);
+
+private:
+    // The maximal number of entries in a single batch: the directories with
+    // more entries than this are split into several batches.
+    enum { BATCH_SIZE = 1024 };
+
+    // The result of reading a directory or a part of it.
+    struct Batch
+    {
+        explicit Batch(const wxString& dirname_)
+            : dirname(dirname_),
+              openFailed(false),
+              last(false)
+        {
+        }
+
+        const wxString dirname;
+
+        // The full paths of the subdirectories and files found in it.
+        wxArrayString dirs,
+                      files;
+
+        // True if the directory couldn't be opened at all.
+        bool openFailed;
+
+        // True for the last batch for this directory.
+        bool last;
+    };
+
+    class WorkerThread : public wxThread
+    {
+    public:
+        explicit WorkerThread(wxDirParallelTraverser& traverser)
+            : wxThread(wxTHREAD_JOINABLE),
+              m_traverser(traverser)
+        {
+        }
+
+    protected:
+        virtual void* Entry() wxOVERRIDE
+        {
+            m_traverser.Work();
+            return NULL;
+        }
+
+    private:
+        wxDirParallelTraverser& m_traverser;
+    };
+
+    // Called by the worker threads to read the directories until m_exit is
+    // set.
+    void Work();
+
+    // Open and read the given directory, called by the worker threads.
+    void ReadDir(const wxString& dirname);
+
+    // Read the already opened directory.
+    void ReadDir(const wxDir& dir);
+
+    // Pass the batch to the main thread, return false if the traversal was
+    // stopped and the batch was deleted.
+    bool PostBatch(Batch* batch);
+
+    // Start a new worker thread, return false if it couldn't be done.
+    bool StartThread();
+
+    // Queue the directory for reading, starting a new thread if necessary.
+    void QueueDir(const wxString& dirname);
+
+    // Call the sink functions for the batch entries, return false if the
+    // traversal should be stopped.
+    bool ProcessBatch(const Batch& batch, size_t& nFiles, size_t& pending);
+
+
+    wxDirTraverser& m_sink;
+    const wxString m_filespec;
+    const int m_flags;
+    int m_maxThreads;
+
+    wxMutex m_mutex;
+    wxCondition m_condQueued,
+                m_condBatch;
+
+    // All the fields below are protected by m_mutex.
+
+    // The directories to read, the last one is read first to keep the number
+    // of the queued directories small.
+    wxVector<wxString> m_dirs;
+
+    // The batches not processed by the main thread yet.
+    wxVector<Batch*> m_batches;
+
+    int m_numIdle;
+    bool m_exit;
+
+    // The threads are only used by the main thread.
+    wxVector<WorkerThread*> m_threads;
+
+    wxDECLARE_NO_COPY_CLASS(wxDirParallelTraverser);
+};
+
+wxDirParallelTraverser::wxDirParallelTraverser(wxDirTraverser& sink,
+                                               const wxString& filespec,
+                                               int flags)
+    : m_sink(sink),
+      m_filespec(filespec),
+      m_flags(flags),
+      m_condQueued(m_mutex),
+      m_condBatch(m_mutex)
+{
+    // Reading directories is often limited by IO rather than CPU, so use more
+    // than one thread even on single CPU machines.
+    m_maxThreads = wxMax(wxThread::GetCPUCount(), 2);
+
+    m_numIdle = 0;
+    m_exit = false;
+}
+
+wxDirParallelTraverser::~wxDirParallelTraverser()
+{
+    {
+        wxMutexLocker lock(m_mutex);
+        m_exit = true;
+        m_dirs.clear();
+        m_condQueued.Broadcast();
+    }
+
+    for ( size_t n = 0; n < m_threads.size(); n++ )
+    {
+        m_threads[n]->Wait();
+        delete m_threads[n];
+    }
+
+    for ( size_t n = 0; n < m_batches.size(); n++ )
+        delete m_batches[n];
+}
+
+bool wxDirParallelTraverser::StartThread()
+{
+    WorkerThread* const thread = new WorkerThread(*this);
+    if ( thread->Run() != wxTHREAD_NO_ERROR )
+    {
+        delete thread;
+        return false;
+    }
+
+    m_threads.push_back(thread);
+
+    return true;
+}
+
+void wxDirParallelTraverser::QueueDir(const wxString& dirname)
+{
+    {
+        wxMutexLocker lock(m_mutex);
+        m_dirs.push_back(dirname);
+        m_condQueued.Signal();
+
+        if ( m_numIdle >= (int)m_dirs.size() )
+            return;
+    }
+
+    // Create the threads on demand to avoid starting more of them than needed.
+    // If this fails, the existing threads will read this directory later.
+    if ( m_threads.size() < (size_t)m_maxThreads )
+        StartThread();
+}
+
+size_t wxDirParallelTraverser::Traverse(const wxDir& dir)
+{
+    // Start the first thread before doing anything else, so that the caller
+    // can still fall back to the sequential traversal if it fails.
+    if ( !StartThread() )
+        return (size_t)-1;
+
+    // The directory itself is already opened, so just read it here instead
+    // of opening it again in a worker thread.
+    ReadDir(dir);
+
+    size_t nFiles = 0;
+
+    // The number of the directories queued or being read.
+    size_t pending = 1;
+
+    wxVector<Batch*> batches;
+    bool cont = true;
+    while ( cont && pending )
+    {
+        {
+            wxMutexLocker lock(m_mutex);
+            while ( m_batches.empty() )
+                m_condBatch.Wait();
+
+            // Take all the available batches at once to lock the mutex less.
+            batches.swap(m_batches);
+        }
+
+        for ( size_t n = 0; n < batches.size(); n++ )
+        {
+            if ( cont )
+                cont = ProcessBatch(*batches[n], nFiles, pending);
+
+            delete batches[n];
+        }
+
+        batches.clear();
+    }
+
+    // The worker threads are stopped by the dtor, which also deletes any
+    // batches remaining if the traversal was stopped.
+    return nFiles;
+}
+
+bool
+wxDirParallelTraverser::ProcessBatch(const Batch& batch,
+                                     size_t& nFiles,
+                                     size_t& pending)
+{
+    if ( batch.openFailed )
+    {
+        switch ( m_sink.OnOpenError(batch.dirname) )
+        {
+            default:
+                wxFAIL_MSG(wxT("unexpected OnOpenError() return value") );
+                wxFALLTHROUGH;
+
+            case wxDIR_STOP:
+                return false;
+
+            case wxDIR_IGNORE:
+                pending--;
+                return true;
+
+            case wxDIR_CONTINUE:
+                // Try opening it again, the directory remains pending.
+                QueueDir(batch.dirname);
+                return true;
+        }
+    }
+
+    for ( size_t n = 0; n < batch.dirs.size(); n++ )
+    {
+        switch ( m_sink.OnDir(batch.dirs[n]) )
+        {
+            default:
+                wxFAIL_MSG(wxT("unexpected OnDir() return value") );
+                wxFALLTHROUGH;
+
+            case wxDIR_STOP:
+                return false;
+
+            case wxDIR_CONTINUE:
+                QueueDir(batch.dirs[n]);
+                pending++;
+                break;
+
+            case wxDIR_IGNORE:
+                // nothing to do
+                ;
+        }
+    }
+
+    for ( size_t n = 0; n < batch.files.size(); n++ )
+    {
+        wxDirTraverseResult res = m_sink.OnFile(batch.files[n]);
+        if ( res == wxDIR_STOP )
+            return false;
+
+        wxASSERT_MSG( res == wxDIR_CONTINUE,
+                      wxT("unexpected OnFile() return value") );
+
+        nFiles++;
+    }
+
+    if ( batch.last )
+        pending--;
+
+    return true;
+}
+
+void wxDirParallelTraverser::Work()
+{
+    // Don't give the error messages for the directories which can't be
+    // opened, see the comment in wxDir::Traverse().
+    wxLogNull noLog;
+
+    for ( ;; )
+    {
+        wxString dirname;
+
+        {
+            wxMutexLocker lock(m_mutex);
+
+            m_numIdle++;
+            while ( m_dirs.empty() && !m_exit )
+                m_condQueued.Wait();
+            m_numIdle--;
+
+            if ( m_exit )
+                break;
+
+            dirname = m_dirs.back();
+            m_dirs.pop_back();
+        }
+
+        ReadDir(dirname);
+    }
+}
+
+void wxDirParallelTraverser::ReadDir(const wxString& dirname)
+{
+    wxDir dir;
+    if ( !dir.Open(dirname) )
+    {
+        Batch* const batch = new Batch(dirname);
+        batch->openFailed = true;
+        PostBatch(batch);
+        return;
+    }
+
+    ReadDir(dir);
+}
+
+void wxDirParallelTraverser::ReadDir(const wxDir& dir)
+{
+    const wxString dirname = dir.GetName();
+    Batch* batch = new Batch(dirname);
+
+    const wxString prefix = dir.GetNameWithSep();
+
+    wxString name;
+    if ( m_flags & wxDIR_DIRS )
+    {
+        for ( bool cont = dir.GetFirst(&name, wxEmptyString,
+                                       (m_flags & ~(wxDIR_FILES | wxDIR_DOTDOT))
+                                       | wxDIR_DIRS);
+              cont;
+              cont = dir.GetNext(&name) )
+        {
+            batch->dirs.push_back(prefix + name);
+            if ( batch->dirs.size() == BATCH_SIZE )
+            {
+                if ( !PostBatch(batch) )
+                    return;
+
+                batch = new Batch(dirname);
+            }
+        }
+    }
+
+    if ( m_flags & wxDIR_FILES )
+    {
+        for ( bool cont = dir.GetFirst(&name, m_filespec, m_flags & ~wxDIR_DIRS);
+              cont;
+              cont = dir.GetNext(&name) )
+        {
+            batch->files.push_back(prefix + name);
+            if ( batch->files.size() == BATCH_SIZE )
+            {
+                if ( !PostBatch(batch) )
+                    return;
+
+                batch = new Batch(dirname);
+            }
+        }
+    }
+
+    batch->last = true;
+    PostBatch(batch);
+}
+
+bool wxDirParallelTraverser::PostBatch(Batch* batch)
+{
+    wxMutexLocker lock(m_mutex);
+    if ( m_exit )
+    {
+        delete batch;
+        return false;
+    }
+
+    m_batches.push_back(batch);
+    m_condBatch.Signal();
+
+    return true;
+}
+
+} // anonymous namespace
+
+#endif // wxUSE_THREADS
+
 // ----------------------------------------------------------------------------
 // wxDir::Traverse()
 // ----------------------------------------------------------------------------
 
-size_t wxDir::Traverse(wxDirTraverser& sink,
-                       const wxString& filespec,
-                       int flags) const
+namespace
 {
-    wxCHECK_MSG( IsOpened(), (size_t)-1,
-                 wxT("dir must be opened before traversing it") );
 
+// Traverse the directory sequentially and return the number of files found.
+// If the sink asks to stop the traversal, stop is set to true and all the
+// parent directories must stop traversing too.
+size_t DoTraverse(const wxDir& dir,
+                  wxDirTraverser& sink,
+                  const wxString& filespec,
+                  int flags,
+                  bool& stop)
+{
     // the total number of files found
     size_t nFiles = 0;
 
     // the name of this dir with path delimiter at the end
-    const wxString prefix = GetNameWithSep();
+    const wxString prefix = dir.GetNameWithSep();
 
     // first, recurse into subdirs
     if ( flags & wxDIR_DIRS )
     {
         wxString dirname;
-        for ( bool cont = GetFirst(&dirname, wxEmptyString,
-                                   (flags & ~(wxDIR_FILES | wxDIR_DOTDOT))
-                                   | wxDIR_DIRS);
+        for ( bool cont = dir.GetFirst(&dirname, wxEmptyString,
+                                       (flags & ~(wxDIR_FILES | wxDIR_DOTDOT))
+                                       | wxDIR_DIRS);
               cont;
-              cont = cont && GetNext(&dirname) )
+              cont = dir.GetNext(&dirname) )
         {
             const wxString fulldirname = prefix + dirname;
 
@@ -129,8 +554,8 @@ size_t wxDir::Traverse(wxDirTraverser& sink,
                     wxFALLTHROUGH;
 
                 case wxDIR_STOP:
-                    cont = false;
-                    break;
+                    stop = true;
+                    return nFiles;
 
                 case wxDIR_CONTINUE:
                     {
@@ -157,8 +582,8 @@ size_t wxDir::Traverse(wxDirTraverser& sink,
                                         wxFALLTHROUGH;
 
                                     case wxDIR_STOP:
-                                        cont = false;
-                                        wxFALLTHROUGH;
+                                        stop = true;
+                                        return nFiles;
 
                                     case wxDIR_IGNORE:
                                         tryagain = false;
@@ -176,7 +601,10 @@ size_t wxDir::Traverse(wxDirTraverser& sink,
 
                         if ( ok )
                         {
-                            nFiles += subdir.Traverse(sink, filespec, flags);
+                            nFiles += DoTraverse(subdir, sink, filespec, flags,
+                                                 stop);
+                            if ( stop )
+                                return nFiles;
                         }
                     }
                     break;
@@ -194,25 +622,54 @@ size_t wxDir::Traverse(wxDirTraverser& sink,
         flags &= ~wxDIR_DIRS;
 
         wxString filename;
-        bool cont = GetFirst(&filename, filespec, flags);
+        bool cont = dir.GetFirst(&filename, filespec, flags);
         while ( cont )
         {
             wxDirTraverseResult res = sink.OnFile(prefix + filename);
             if ( res == wxDIR_STOP )
+            {
+                stop = true;
                 break;
+            }
 
             wxASSERT_MSG( res == wxDIR_CONTINUE,
                           wxT("unexpected OnFile() return value") );
 
             nFiles++;
 
-            cont = GetNext(&filename);
+            cont = dir.GetNext(&filename);
         }
     }
 
     return nFiles;
 }
 
+} // anonymous namespace
+
+size_t wxDir::Traverse(wxDirTraverser& sink,
+                       const wxString& filespec,
+                       int flags) const
+{
+    wxCHECK_MSG( IsOpened(), (size_t)-1,
+                 wxT("dir must be opened before traversing it") );
+
+    if ( flags & wxDIR_PARALLEL )
+    {
+#if wxUSE_THREADS
+        wxDirParallelTraverser traverser(sink, filespec, flags);
+        const size_t nFiles = traverser.Traverse(*this);
+        if ( nFiles != (size_t)-1 )
+            return nFiles;
+#endif // wxUSE_THREADS
+
+        // Fall back to the sequential traversal if threads are not available.
+        flags &= ~wxDIR_PARALLEL;
+    }
+
+    bool stop = false;
+    return DoTraverse(*this, sink, filespec, flags, stop);
+}
+
 // ----------------------------------------------------------------------------
 // wxDir::GetAllFiles()
 // ----------------------------------------------------------------------------
@@ -26,6 +26,7 @@
 #include "wx/event.h"
 #include "wx/eventfilter.h"
 #include "wx/evtloop.h"
+#include "wx/evtprofiler.h"
 
 #ifndef WX_PRECOMP
     #include "wx/list.h"
@@ -46,6 +47,11 @@
 #endif
 
 #include "wx/thread.h"
+#include "wx/hashmap.h"
+#include "wx/time.h"
+#include "wx/private/threadinfo.h"
+
+#include <algorithm>
 
 #if wxUSE_BASE
     #include "wx/scopedptr.h"
@@ -361,6 +367,24 @@ wxEventFunctor::~wxEventFunctor()
 {
 }
 
+// ----------------------------------------------------------------------------
+// wxEventTableEntryBase
+// ----------------------------------------------------------------------------
+
+/* static */
+unsigned long wxEventTableEntryBase::NewHandlerId()
+{
+    // This is called by the static event tables during the global
+    // initialization, so use function statics which are initialized on first
+    // use instead of globals which could be not initialized yet.
+    wxCRIT_SECT_DECLARE(s_csHandlerId);
+    wxCRIT_SECT_LOCKER(lock, s_csHandlerId);
+
+    static unsigned long s_lastHandlerId = 0;
+
+    return ++s_lastHandlerId;
+}
+
 // ----------------------------------------------------------------------------
 // wxEvent
 // ----------------------------------------------------------------------------
@@ -1143,6 +1167,109 @@ void wxEventHashTable::GrowEventTypeTable()
     delete[] oldEventTypeTable;
 }
 
+// ----------------------------------------------------------------------------
+// wxDynamicEventTableIndex
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Call the given event handler.
+inline void
+DoCallEventHandler(wxEventFunctor& func, wxEvtHandler* handler, wxEvent& event)
+{
+#if wxUSE_EXCEPTIONS
+    if ( wxTheApp )
+    {
+        // call the handler via wxApp method which allows the user to catch
+        // any exceptions which may be thrown by any handler in the program
+        // in one place
+        wxTheApp->CallEventHandler(handler, func, event);
+    }
+    else
+#endif // wxUSE_EXCEPTIONS
+    {
+        func(handler, event);
+    }
+}
+
+// The minimal number of dynamic event handlers for which it's worth indexing
+// them by the event type.
+const size_t DYNAMIC_EVENTS_INDEX_MIN_SIZE = 16;
+
+// Remove the null entries corresponding to the unbound handlers from the
+// vector of dynamic event table entries.
+void PruneDynamicEvents(wxVector<wxDynamicEventTableEntry*>& dynamicEvents)
+{
+    size_t nNew = 0;
+    for ( size_t n = 0; n != dynamicEvents.size(); n++ )
+    {
+        if ( dynamicEvents[n] )
+            dynamicEvents[nNew++] = dynamicEvents[n];
+    }
+
+    dynamicEvents.resize(nNew);
+}
+
+} // anonymous namespace
+
+WX_DECLARE_HASH_MAP(wxEventType, wxVector<wxDynamicEventTableEntry*>,
+                    wxIntegerHash, wxIntegerEqual,
+                    wxDynamicEventTableIndexBase);
+
+// This class only exists to allow forward declaring it in the header.
+class wxDynamicEventTableIndex : public wxDynamicEventTableIndexBase
+{
+};
+
+// Object existing while SearchDynamicEventTable() iterates over the dynamic
+// event table entries, which must not be pruned while this happens.
+//
+// The searches for the same handler may be nested if an event handler
+// processes another event, so they form a stack, and the handler itself may
+// be destroyed by an event handler, which resets the handler pointer in all
+// of them.
+class wxDynamicEventTableSearch
+{
+public:
+    explicit wxDynamicEventTableSearch(wxEvtHandler* handler)
+        : m_handler(handler),
+          m_outer(handler->m_dynamicEventsSearch)
+    {
+        handler->m_dynamicEventsSearch = this;
+    }
+
+    ~wxDynamicEventTableSearch()
+    {
+        if ( !m_handler )
+            return;
+
+        m_handler->m_dynamicEventsSearch = m_outer;
+
+        // Prune the unbound entries only once the outermost search ends, as
+        // the vectors can't be modified while any search uses them.
+        if ( !m_outer && m_handler->m_dynamicEventsUnbound )
+            m_handler->PruneUnboundDynamicEvents();
+    }
+
+    // Called by wxEvtHandler dtor for the innermost search.
+    void OnHandlerDestroyed()
+    {
+        for ( wxDynamicEventTableSearch* search = this;
+              search;
+              search = search->m_outer )
+        {
+            search->m_handler = NULL;
+        }
+    }
+
+private:
+    wxEvtHandler* m_handler;
+    wxDynamicEventTableSearch* const m_outer;
+
+    wxDECLARE_NO_COPY_CLASS(wxDynamicEventTableSearch);
+};
+
 // ----------------------------------------------------------------------------
 // wxEvtHandler
 // ----------------------------------------------------------------------------
@@ -1153,7 +1280,13 @@ wxEvtHandler::wxEvtHandler()
     m_previousHandler = NULL;
     m_enabled = true;
     m_dynamicEvents = NULL;
+    m_dynamicEventsIndex = NULL;
+    m_dynamicEventsUnbound = 0;
+    m_dynamicEventsSearch = NULL;
     m_pendingEvents = NULL;
+    m_prevPending =
+    m_nextPending = NULL;
+    m_pendingList = NULL;
 
     // no client data (yet)
     m_clientData = NULL;
@@ -1164,6 +1297,11 @@ wxEvtHandler::~wxEvtHandler()
 {
     Unlink();
 
+    // We may be destroyed by one of our own event handlers, let the
+    // SearchDynamicEventTable() calls in progress know about it.
+    if ( m_dynamicEventsSearch )
+        m_dynamicEventsSearch->OnHandlerDestroyed();
+
     if (m_dynamicEvents)
     {
         size_t cookie;
@@ -1189,6 +1327,7 @@ wxEvtHandler::~wxEvtHandler()
             delete entry;
         }
         delete m_dynamicEvents;
+        delete m_dynamicEventsIndex;
     }
 
     // Remove us from the list of the pending events if necessary.
@@ -1396,6 +1535,73 @@ void wxEvtHandler::ProcessPendingEvents()
     // of this object any more
 }
 
+// ----------------------------------------------------------------------------
+// wxEvtHandlerPendingList
+// ----------------------------------------------------------------------------
+
+void wxEvtHandlerPendingList::Append(wxEvtHandler* handler)
+{
+    wxCHECK_RET( !handler->m_pendingList,
+                 "handler is already in a pending list" );
+
+    handler->m_pendingList = this;
+    handler->m_prevPending = m_last;
+    handler->m_nextPending = NULL;
+
+    if ( m_last )
+        m_last->m_nextPending = handler;
+    else
+        m_first = handler;
+
+    m_last = handler;
+}
+
+bool wxEvtHandlerPendingList::Remove(wxEvtHandler* handler)
+{
+    if ( !Contains(handler) )
+        return false;
+
+    if ( handler->m_prevPending )
+        handler->m_prevPending->m_nextPending = handler->m_nextPending;
+    else
+        m_first = handler->m_nextPending;
+
+    if ( handler->m_nextPending )
+        handler->m_nextPending->m_prevPending = handler->m_prevPending;
+    else
+        m_last = handler->m_prevPending;
+
+    handler->m_prevPending =
+    handler->m_nextPending = NULL;
+    handler->m_pendingList = NULL;
+
+    return true;
+}
+
+void wxEvtHandlerPendingList::Splice(wxEvtHandlerPendingList& other)
+{
+    if ( other.IsEmpty() )
+        return;
+
+    for ( wxEvtHandler* h = other.m_first; h; h = h->m_nextPending )
+        h->m_pendingList = this;
+
+    if ( m_last )
+    {
+        m_last->m_nextPending = other.m_first;
+        other.m_first->m_prevPending = m_last;
+    }
+    else
+    {
+        m_first = other.m_first;
+    }
+
+    m_last = other.m_last;
+
+    other.m_first =
+    other.m_last = NULL;
+}
+
 /* static */
 bool wxEvtHandler::ProcessEventIfMatchesId(const wxEventTableEntryBase& entry,
                                            wxEvtHandler *handler,
@@ -1416,18 +1622,26 @@ bool wxEvtHandler::ProcessEventIfMatchesId(const wxEventTableEntryBase& entry,
         event.Skip(false);
         event.m_callbackUserData = entry.m_callbackUserData;
 
-#if wxUSE_EXCEPTIONS
-        if ( wxTheApp )
+#if wxUSE_STOPWATCH
+        if ( wxEventProfiler::IsRunning() )
         {
-            // call the handler via wxApp method which allows the user to catch
-            // any exceptions which may be thrown by any handler in the program
-            // in one place
-            wxTheApp->CallEventHandler(handler, *entry.m_fn, event);
+            // Get the class name and the handler id before calling the
+            // handler as it could delete the handler object or unbind it.
+            const wxChar* const
+                handlerClass = handler->GetClassInfo()->GetClassName();
+            const unsigned long handlerId = entry.m_handlerId;
+            const wxEventType eventType = event.GetEventType();
+
+            wxStopWatch sw;
+            DoCallEventHandler(*entry.m_fn, handler, event);
+
+            wxEventProfiler::WXRecordCall(eventType, handlerId, handlerClass,
+                                          sw.TimeInMicro());
         }
         else
-#endif // wxUSE_EXCEPTIONS
+#endif // wxUSE_STOPWATCH
         {
-            (*entry.m_fn)(handler, event);
+            DoCallEventHandler(*entry.m_fn, handler, event);
         }
 
         if (!event.GetSkipped())
@@ -1774,6 +1988,9 @@ void wxEvtHandler::DoBind(int id,
     // than inserting the element at the front.
     m_dynamicEvents->push_back(entry);
 
+    if ( m_dynamicEventsIndex )
+        (*m_dynamicEventsIndex)[eventType].push_back(entry);
+
     // Make sure we get to know when a sink is destroyed
     wxEvtHandler *eventSink = func->GetEvtHandler();
     if ( eventSink && eventSink != this )
@@ -1818,6 +2035,8 @@ wxEvtHandler::DoUnbind(int id,
 
             delete entry->m_callbackUserData;
 
+            RemoveFromDynamicEventsIndex(entry);
+
             // We can't delete the entry from the vector if we're currently
             // iterating over it. As we don't know whether we're or not, just
             // null it for now and we will really erase it when we do finish
@@ -1829,6 +2048,10 @@ wxEvtHandler::DoUnbind(int id,
             (*m_dynamicEvents)[cookie] = NULL;
 
             delete entry;
+
+            m_dynamicEventsUnbound++;
+            PruneUnboundDynamicEventsIfNeeded();
+
             return true;
         }
     }
@@ -1863,14 +2086,107 @@ wxEvtHandler::GetNextDynamicEntry(size_t& cookie) const
     return NULL;
 }
 
+void wxEvtHandler::RemoveFromDynamicEventsIndex(const wxDynamicEventTableEntry* entry)
+{
+    if ( !m_dynamicEventsIndex )
+        return;
+
+    wxDynamicEventTableIndex::iterator it =
+        m_dynamicEventsIndex->find(entry->m_eventType);
+    if ( it == m_dynamicEventsIndex->end() )
+        return;
+
+    // As with m_dynamicEvents itself, we can't erase the entry from the
+    // vector as we could be iterating over it, so just reset it.
+    DynamicEvents& dynamicEvents = it->second;
+    for ( size_t n = 0; n != dynamicEvents.size(); n++ )
+    {
+        if ( dynamicEvents[n] == entry )
+        {
+            dynamicEvents[n] = NULL;
+            break;
+        }
+    }
+}
+
+void wxEvtHandler::PruneUnboundDynamicEventsIfNeeded()
+{
+    // If we're called from an event handler of this object, the unbound
+    // entries will be pruned when the event processing ends. Otherwise, do
+    // it now, but only once they make up a significant part of all entries
+    // to avoid doing it on every call when unbinding many handlers.
+    if ( m_dynamicEventsUnbound && !m_dynamicEventsSearch &&
+            m_dynamicEventsUnbound >= m_dynamicEvents->size() / 2 )
+    {
+        PruneUnboundDynamicEvents();
+    }
+}
+
+void wxEvtHandler::PruneUnboundDynamicEvents()
+{
+    wxASSERT_MSG( !m_dynamicEventsSearch,
+                  "can't prune dynamic events while searching them" );
+
+    PruneDynamicEvents(*m_dynamicEvents);
+
+    if ( m_dynamicEventsIndex )
+    {
+        for ( wxDynamicEventTableIndex::iterator it = m_dynamicEventsIndex->begin();
+              it != m_dynamicEventsIndex->end(); )
+        {
+            PruneDynamicEvents(it->second);
+
+            // Also don't keep the event types without any handlers.
+            wxDynamicEventTableIndex::iterator itCurrent = it++;
+            if ( itCurrent->second.empty() )
+                m_dynamicEventsIndex->erase(itCurrent);
+        }
+    }
+
+    m_dynamicEventsUnbound = 0;
+}
+
 bool wxEvtHandler::SearchDynamicEventTable( wxEvent& event )
 {
     wxCHECK_MSG( m_dynamicEvents, false,
                  wxT("caller should check that we have dynamic events") );
 
-    DynamicEvents& dynamicEvents = *m_dynamicEvents;
+    // Searching all the entries is faster for a small number of them, but
+    // when there are many of them, index them by their event types to only
+    // look at the ones which can match.
+    if ( !m_dynamicEventsIndex &&
+            m_dynamicEvents->size() >= DYNAMIC_EVENTS_INDEX_MIN_SIZE )
+    {
+        m_dynamicEventsIndex = new wxDynamicEventTableIndex;
 
-    bool needToPruneDeleted = false;
+        for ( DynamicEvents::const_iterator it = m_dynamicEvents->begin();
+              it != m_dynamicEvents->end();
+              ++it )
+        {
+            wxDynamicEventTableEntry* const entry = *it;
+            if ( entry )
+                (*m_dynamicEventsIndex)[entry->m_eventType].push_back(entry);
+        }
+    }
+
+    DynamicEvents* events = m_dynamicEvents;
+    if ( m_dynamicEventsIndex )
+    {
+        wxDynamicEventTableIndex::iterator it =
+            m_dynamicEventsIndex->find(event.GetEventType());
+        if ( it == m_dynamicEventsIndex->end() )
+            return false;
+
+        // Notice that the index is never pruned while we're searching it,
+        // so the vector will remain valid even if the handlers below bind or
+        // unbind other handlers.
+        events = &it->second;
+    }
+
+    DynamicEvents& dynamicEvents = *events;
+
+    // This also prunes the unbound entries once we're done, if possible.
+    wxDynamicEventTableSearch search(this);
 
     // We can't use Get{First,Next}DynamicEntry() here as they hide the deleted
     // but not yet pruned entries from the caller, but here we do want to know
@@ -1883,9 +2199,8 @@ bool wxEvtHandler::SearchDynamicEventTable( wxEvent& event )
         if ( !entry )
         {
             // This entry must have been unbound at some time in the past, so
-            // skip it now and really remove it from the vector below, once we
+            // skip it now, it will be really removed from the vector when we
             // finish iterating.
-            needToPruneDeleted = true;
             continue;
         }
 
@@ -1896,37 +2211,15 @@ bool wxEvtHandler::SearchDynamicEventTable( wxEvent& event )
                handler = this;
             if ( ProcessEventIfMatchesId(*entry, handler, event) )
             {
-                // It's important to skip pruning of the unbound event entries
-                // below because this object itself could have been deleted by
-                // the event handler making m_dynamicEvents a dangling pointer
-                // which can't be accessed any longer in the code below.
-                //
-                // In practice, it hopefully shouldn't be a problem to wait
-                // until we get an event that we don't handle before pruning
-                // because this should happen soon enough and even if it
-                // doesn't the worst possible outcome is slightly increased
-                // memory consumption while not skipping pruning can result in
-                // hard to reproduce (because they require the disconnection
-                // and deletion happen at the same time which is not always the
-                // case) crashes.
+                // Notice that this object itself could have been deleted by
+                // the event handler, so nothing must be accessed here any
+                // more. The search object knows about it and doesn't prune
+                // the unbound entries in this case.
                 return true;
             }
         }
     }
 
-    if ( needToPruneDeleted )
-    {
-        size_t nNew = 0;
-        for ( size_t n = 0; n != dynamicEvents.size(); n++ )
-        {
-            if ( dynamicEvents[n] )
-                dynamicEvents[nNew++] = dynamicEvents[n];
-        }
-
-        wxASSERT( nNew != dynamicEvents.size() );
-        dynamicEvents.resize(nNew);
-    }
-
     return false;
 }
 
@@ -2001,15 +2294,564 @@ void wxEvtHandler::OnSinkDestroyed( wxEvtHandler *sink )
         if ( entry->m_fn->GetEvtHandler() == sink )
         {
             delete entry->m_callbackUserData;
+            RemoveFromDynamicEventsIndex(entry);
             delete entry;
 
             // Just as in DoUnbind(), we use our knowledge of
             // GetNextDynamicEntry() implementation here.
             (*m_dynamicEvents)[cookie] = NULL;
+
+            m_dynamicEventsUnbound++;
+        }
+    }
+
+    PruneUnboundDynamicEventsIfNeeded();
+}
+
+// ----------------------------------------------------------------------------
+// wxEventProfiler
+// ----------------------------------------------------------------------------
+
+#if wxUSE_STOPWATCH
+
+namespace
+{
+
+// The key used for the profiler statistics: the handler is identified by its
+// id, which is different for each Bind() call and each event table entry,
+// and by the class of the object it is called for, as the same event table
+// entry is used for all the objects of the class and the derived classes.
+// Notice that the class name can be just compared by pointer as it always
+// comes from wxClassInfo.
+struct wxEventProfilerKey
+{
+    wxEventProfilerKey(wxEventType eventType_,
+                       unsigned long handlerId_,
+                       const wxChar* handlerClass_)
+        : eventType(eventType_),
+          handlerId(handlerId_),
+          handlerClass(handlerClass_)
+    {
+    }
+
+    wxEventType eventType;
+    unsigned long handlerId;
+    const wxChar* handlerClass;
+};
+
+struct wxEventProfilerKeyHash
+{
+    size_t operator()(const wxEventProfilerKey& key) const
+    {
+        return key.handlerId ^
+                (wxPtrToUInt(key.handlerClass) * 31) ^
+                    (key.eventType * 65599);
+    }
+};
+
+struct wxEventProfilerKeyEqual
+{
+    bool operator()(const wxEventProfilerKey& a,
+                    const wxEventProfilerKey& b) const
+    {
+        return a.eventType == b.eventType &&
+                a.handlerId == b.handlerId &&
+                    a.handlerClass == b.handlerClass;
+    }
+};
+
+struct wxEventProfilerValue
+{
+    wxEventProfilerValue() : count(0) { }
+
+    void Add(unsigned long count_,
+             const wxLongLong& totalTime_,
+             const wxLongLong& maxTime_)
+    {
+        count += count_;
+        totalTime += totalTime_;
+        if ( maxTime_ > maxTime )
+            maxTime = maxTime_;
+    }
+
+    unsigned long count;
+    wxLongLong totalTime,
+               maxTime;
+};
+
+WX_DECLARE_HASH_MAP(wxEventProfilerKey, wxEventProfilerValue,
+                    wxEventProfilerKeyHash, wxEventProfilerKeyEqual,
+                    wxEventProfilerMap);
+
+// A single recent call, as stored in the ring buffer.
+struct wxEventProfilerCall
+{
+    wxEventType eventType;
+    unsigned long handlerId;
+    const wxChar* handlerClass;
+    wxLongLong time;
+
+    // the time when the call ended, used for ordering the calls made by the
+    // different threads
+    wxLongLong endTime;
+};
+
+bool CompareCallsByEndTime(const wxEventProfilerCall& a,
+                           const wxEventProfilerCall& b)
+{
+    return a.endTime < b.endTime;
+}
+
+} // anonymous namespace
+
+// The data collected by a single thread: it is only modified by the thread
+// itself, so its critical section is only contended when the statistics are
+// being retrieved or reset.
+//
+// Notice that this struct is not in the anonymous namespace because it is
+// also referenced by wxThreadSpecificInfo.
+struct wxEventProfilerThreadData
+{
+    explicit wxEventProfilerThreadData(size_t numRecentCalls)
+        : recentCalls(numRecentCalls),
+          nextCall(0),
+          numCalls(0)
+    {
+    }
+
+    void Clear()
+    {
+        stats.clear();
+        nextCall =
+        numCalls = 0;
+    }
+
+    void SetNumRecentCalls(size_t numRecentCalls)
+    {
+        if ( numRecentCalls != recentCalls.size() )
+        {
+            recentCalls.resize(numRecentCalls);
+            nextCall =
+            numCalls = 0;
+        }
+    }
+
+    void Record(const wxEventProfilerKey& key, const wxLongLong& time)
+    {
+        wxCRIT_SECT_LOCKER(lock, cs);
+
+        stats[key].Add(1, time, time);
+
+        if ( recentCalls.empty() )
+            return;
+
+        wxEventProfilerCall& call = recentCalls[nextCall];
+        call.eventType = key.eventType;
+        call.handlerId = key.handlerId;
+        call.handlerClass = key.handlerClass;
+        call.time = time;
+        call.endTime = wxGetUTCTimeUSec();
+
+        if ( ++nextCall == recentCalls.size() )
+            nextCall = 0;
+
+        if ( numCalls < recentCalls.size() )
+            numCalls++;
+    }
+
+    // Append the recent calls, from the oldest to the newest one, to the
+    // given vector.
+    void GetRecentCalls(wxVector<wxEventProfilerCall>& calls) const
+    {
+        // The oldest call is the one which will be overwritten next if the
+        // buffer is full, or the first one otherwise.
+        size_t n = numCalls < recentCalls.size() ? 0 : nextCall;
+        for ( size_t i = 0; i < numCalls; i++ )
+        {
+            calls.push_back(recentCalls[n]);
+
+            if ( ++n == recentCalls.size() )
+                n = 0;
+        }
+    }
+
+    wxCRIT_SECT_DECLARE_MEMBER(cs);
+
+    wxEventProfilerMap stats;
+
+    // Circular buffer of the recent calls: its size is fixed when starting
+    // the profiler, nextCall is the index of the next element to overwrite
+    // and numCalls is the number of valid elements in it.
+    wxVector<wxEventProfilerCall> recentCalls;
+    size_t nextCall,
+           numCalls;
+};
+
+namespace
+{
+
+// Set to true when gs_profilerData is destroyed, after which the threads
+// terminating during the program shutdown must not access it any more.
+bool gs_profilerDataDestroyed = false;
+
+// All the data collected by wxEventProfiler: the data of each thread is
+// created when it handles its first event while the profiler is running and
+// is freed when the thread terminates, after merging its statistics and
+// recent calls into the data of all the already terminated threads.
+struct wxEventProfilerData
+{
+    wxEventProfilerData() : numRecentCalls(0) { }
+
+    ~wxEventProfilerData()
+    {
+        for ( size_t n = 0; n < threads.size(); n++ )
+            delete threads[n];
+
+        gs_profilerDataDestroyed = true;
+    }
+
+    // Forget the data of the terminated threads.
+    void ClearExited()
+    {
+        exitedStats.clear();
+        exitedCalls.clear();
+    }
+
+    // Called with gs_profilerCS locked when a thread terminates.
+    void OnThreadExit(wxEventProfilerThreadData* data)
+    {
+        for ( wxVector<wxEventProfilerThreadData*>::iterator it = threads.begin();
+              it != threads.end();
+              ++it )
+        {
+            if ( *it == data )
+            {
+                threads.erase(it);
+                break;
+            }
+        }
+
+        for ( wxEventProfilerMap::const_iterator it = data->stats.begin();
+              it != data->stats.end();
+              ++it )
+        {
+            exitedStats[it->first].Add(it->second.count,
+                                       it->second.totalTime,
+                                       it->second.maxTime);
+        }
+
+        // Keep only as many of the recent calls as can be returned.
+        data->GetRecentCalls(exitedCalls);
+        if ( exitedCalls.size() > numRecentCalls )
+        {
+            std::stable_sort(exitedCalls.begin(), exitedCalls.end(),
+                             CompareCallsByEndTime);
+            exitedCalls.erase(exitedCalls.begin(),
+                              exitedCalls.end() - numRecentCalls);
+        }
+
+        delete data;
+    }
+
+    wxVector<wxEventProfilerThreadData*> threads;
+
+    // the merged data of all the threads which already terminated
+    wxEventProfilerMap exitedStats;
+    wxVector<wxEventProfilerCall> exitedCalls;
+
+    size_t numRecentCalls;
+};
+
+// This critical section protects gs_profilerData but not the data of the
+// individual threads, which have their own critical sections. It is defined
+// before gs_profilerData to ensure that it is destroyed after it.
+wxCRIT_SECT_DECLARE(gs_profilerCS);
+
+wxEventProfilerData gs_profilerData;
+
+// Return the data for the current thread, creating it if necessary.
+wxEventProfilerThreadData& GetProfilerDataForThisThread()
+{
+    wxEventProfilerThreadData*& data = wxThreadInfo.eventProfilerData;
+    if ( !data )
+    {
+        wxCRIT_SECT_LOCKER(lock, gs_profilerCS);
+
+        data = new wxEventProfilerThreadData(gs_profilerData.numRecentCalls);
+        gs_profilerData.threads.push_back(data);
+    }
+
+    return *data;
+}
+
+// Return the string used for the given event type in the report.
+wxString GetEventTypeDescription(wxEventType eventType)
+{
+    return wxString::Format("event type %d", eventType);
+}
+
+// Return the string used for the given handler in the report.
+wxString GetHandlerDescription(const wxString& handlerClass,
+                               unsigned long handlerId)
+{
+    return wxString::Format("%s handler #%lu", handlerClass, handlerId);
+}
+
+// Return the time in microseconds as a string using milliseconds.
+wxString FormatUsecAsMsec(const wxLongLong& time)
+{
+    return wxString::Format("%.3fms", time.ToDouble() / 1000.);
+}
+
+bool CompareStatsByTotalTime(const wxEventProfiler::Stats& a,
+                             const wxEventProfiler::Stats& b)
+{
+    return a.totalTime > b.totalTime;
+}
+
+} // anonymous namespace
+
+#if wxUSE_THREADS
+
+void wxEventProfilerReleaseThreadData(wxEventProfilerThreadData* data)
+{
+    // If the global data was already destroyed, this thread data was
+    // destroyed together with it.
+    if ( !data || gs_profilerDataDestroyed )
+        return;
+
+    wxCRIT_SECT_LOCKER(lock, gs_profilerCS);
+
+    gs_profilerData.OnThreadExit(data);
+}
+
+#endif // wxUSE_THREADS
+
+bool wxEventProfiler::ms_isRunning = false;
+
+/* static */
+void wxEventProfiler::Start(size_t numRecentCalls)
+{
+    wxCRIT_SECT_LOCKER(lock, gs_profilerCS);
+
+    if ( ms_isRunning )
+        return;
+
+    if ( numRecentCalls != gs_profilerData.numRecentCalls )
+    {
+        gs_profilerData.numRecentCalls = numRecentCalls;
+        gs_profilerData.exitedCalls.clear();
+    }
+
+    for ( size_t n = 0; n < gs_profilerData.threads.size(); n++ )
+    {
+        wxEventProfilerThreadData& data = *gs_profilerData.threads[n];
+
+        wxCRIT_SECT_LOCKER(lockThread, data.cs);
+        data.SetNumRecentCalls(numRecentCalls);
+    }
+
+    ms_isRunning = true;
+}
+
+/* static */
+void wxEventProfiler::Stop()
+{
+    wxCRIT_SECT_LOCKER(lock, gs_profilerCS);
+
+    ms_isRunning = false;
+}
+
+/* static */
+void wxEventProfiler::Reset()
+{
+    wxCRIT_SECT_LOCKER(lock, gs_profilerCS);
+
+    gs_profilerData.ClearExited();
+
+    for ( size_t n = 0; n < gs_profilerData.threads.size(); n++ )
+    {
+        wxEventProfilerThreadData& data = *gs_profilerData.threads[n];
+
+        wxCRIT_SECT_LOCKER(lockThread, data.cs);
+        data.Clear();
+    }
+}
+
+/* static */
+void wxEventProfiler::WXRecordCall(wxEventType eventType,
+                                   unsigned long handlerId,
+                                   const wxChar* handlerClass,
+                                   const wxLongLong& time)
+{
+    // The profiler could have been stopped while the handler was running.
+    if ( !ms_isRunning )
+        return;
+
+    GetProfilerDataForThisThread().Record
+    (
+        wxEventProfilerKey(eventType, handlerId, handlerClass),
+        time
+    );
+}
+
+/* static */
+void wxEventProfiler::GetStats(wxVector<Stats>& stats)
+{
+    stats.clear();
+
+    // Merge the statistics of all threads.
+    wxEventProfilerMap all;
+    {
+        wxCRIT_SECT_LOCKER(lock, gs_profilerCS);
+
+        all = gs_profilerData.exitedStats;
+
+        for ( size_t n = 0; n < gs_profilerData.threads.size(); n++ )
+        {
+            wxEventProfilerThreadData& data = *gs_profilerData.threads[n];
+
+            wxCRIT_SECT_LOCKER(lockThread, data.cs);
+
+            for ( wxEventProfilerMap::const_iterator it = data.stats.begin();
+                  it != data.stats.end();
+                  ++it )
+            {
+                all[it->first].Add(it->second.count,
+                                   it->second.totalTime,
+                                   it->second.maxTime);
+            }
         }
     }
+
+    stats.reserve(all.size());
+
+    for ( wxEventProfilerMap::const_iterator it = all.begin();
+          it != all.end();
+          ++it )
+    {
+        Stats s;
+        s.eventType = it->first.eventType;
+        s.handlerId = it->first.handlerId;
+        s.handlerClass = it->first.handlerClass;
+        s.count = it->second.count;
+        s.totalTime = it->second.totalTime;
+        s.maxTime = it->second.maxTime;
+        stats.push_back(s);
+    }
+
+    std::sort(stats.begin(), stats.end(), CompareStatsByTotalTime);
+}
+
+/* static */
+void wxEventProfiler::GetRecentCalls(wxVector<Call>& calls)
+{
+    calls.clear();
+
+    wxVector<wxEventProfilerCall> recent;
+    size_t numRecentCalls;
+    {
+        wxCRIT_SECT_LOCKER(lock, gs_profilerCS);
+
+        numRecentCalls = gs_profilerData.numRecentCalls;
+
+        recent = gs_profilerData.exitedCalls;
+
+        for ( size_t n = 0; n < gs_profilerData.threads.size(); n++ )
+        {
+            wxEventProfilerThreadData& data = *gs_profilerData.threads[n];
+
+            wxCRIT_SECT_LOCKER(lockThread, data.cs);
+            data.GetRecentCalls(recent);
+        }
+    }
+
+    // Merge the calls made by all threads and keep only the most recent ones.
+    std::stable_sort(recent.begin(), recent.end(), CompareCallsByEndTime);
+
+    const size_t
+        first = recent.size() > numRecentCalls ? recent.size() - numRecentCalls
+                                               : 0;
+
+    calls.reserve(recent.size() - first);
+
+    for ( size_t n = first; n < recent.size(); n++ )
+    {
+        const wxEventProfilerCall& call = recent[n];
+
+        Call c;
+        c.eventType = call.eventType;
+        c.handlerId = call.handlerId;
+        c.handlerClass = call.handlerClass;
+        c.time = call.time;
+        calls.push_back(c);
+    }
 }
 
+/* static */
+wxString wxEventProfiler::GetReport(size_t maxLines)
+{
+    wxVector<Stats> stats;
+    GetStats(stats);
+
+    // Also aggregate the statistics for all handlers of the same event type.
+    wxVector<Stats> byType;
+    for ( wxVector<Stats>::const_iterator it = stats.begin();
+          it != stats.end();
+          ++it )
+    {
+        wxVector<Stats>::iterator itType;
+        for ( itType = byType.begin(); itType != byType.end(); ++itType )
+        {
+            if ( itType->eventType == it->eventType )
+                break;
+        }
+
+        if ( itType == byType.end() )
+        {
+            byType.push_back(*it);
+            byType.back().handlerClass.clear();
+            continue;
+        }
+
+        itType->count += it->count;
+        itType->totalTime += it->totalTime;
+        if ( it->maxTime > itType->maxTime )
+            itType->maxTime = it->maxTime;
+    }
+
+    std::sort(byType.begin(), byType.end(), CompareStatsByTotalTime);
+
+    wxString report;
+    report << "Most expensive event types:\n";
+    for ( size_t n = 0; n < byType.size() && n < maxLines; n++ )
+    {
+        const Stats& s = byType[n];
+        report << wxString::Format("  %s: %lu calls, total %s, max %s\n",
+                                   GetEventTypeDescription(s.eventType),
+                                   s.count,
+                                   FormatUsecAsMsec(s.totalTime),
+                                   FormatUsecAsMsec(s.maxTime));
+    }
+
+    report << "Most expensive event handlers:\n";
+    for ( size_t n = 0; n < stats.size() && n < maxLines; n++ )
+    {
+        const Stats& s = stats[n];
+        report << wxString::Format("  %s for %s: %lu calls, total %s, max %s\n",
+                                   GetHandlerDescription(s.handlerClass,
+                                                         s.handlerId),
+                                   GetEventTypeDescription(s.eventType),
+                                   s.count,
+                                   FormatUsecAsMsec(s.totalTime),
+                                   FormatUsecAsMsec(s.maxTime));
+    }
+
+    return report;
+}
+
+#endif // wxUSE_STOPWATCH
+
 #endif // wxUSE_BASE
 
 #if wxUSE_GUI
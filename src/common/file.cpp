@@ -96,6 +96,18 @@
 #include  "wx/file.h"
 #include  "wx/filefn.h"
 
+// wxMappedFile maps the files in memory if possible
+#if defined(__UNIX__)
+    #include <sys/mman.h>
+
+    #define wxHAS_FILE_MMAP
+#elif defined(__WINDOWS__)
+    #include "wx/msw/wrapwin.h"
+    #include <io.h>
+
+    #define wxHAS_FILE_MMAP
+#endif
+
 // there is no distinction between text and binary files under Unix, so define
 // O_BINARY as 0 if the system headers don't do it already
 #if defined(__UNIX__) && !defined(O_BINARY)
@@ -257,18 +269,16 @@ bool wxFile::Close()
 // read/write
 // ----------------------------------------------------------------------------
 
-bool wxFile::ReadAll(wxString *str, const wxMBConv& conv)
+// read all the data from the current position until the end of the file
+// which has the given length, as returned by wxFile::Length()
+static bool wxReadAllData(wxFile& file, wxFileOffset lenFile, wxCharBuffer& buf)
 {
-    wxCHECK_MSG( str, false, wxS("Output string must be non-NULL") );
-
     static const ssize_t READSIZE = 4096;
 
-    wxCharBuffer buf;
-
-    ssize_t length = Length();
+    ssize_t length = lenFile;
     if ( length != -1 )
     {
-        wxCHECK_MSG( (wxFileOffset)length == Length(), false, wxT("huge file not supported") );
+        wxCHECK_MSG( (wxFileOffset)length == lenFile, false, wxT("huge file not supported") );
 
         if ( !buf.extend(length) )
             return false;
@@ -276,7 +286,7 @@ bool wxFile::ReadAll(wxString *str, const wxMBConv& conv)
         char* p = buf.data();
         for ( ;; )
         {
-            ssize_t nread = Read(p, length > READSIZE ? READSIZE : length);
+            ssize_t nread = file.Read(p, length > READSIZE ? READSIZE : length);
             if ( nread == wxInvalidOffset )
                 return false;
 
@@ -315,7 +325,7 @@ bool wxFile::ReadAll(wxString *str, const wxMBConv& conv)
             if ( !buf.extend(len + READSIZE) )
                 return false;
 
-            ssize_t nread = Read(buf.data() + len, READSIZE);
+            ssize_t nread = file.Read(buf.data() + len, READSIZE);
             if ( nread == wxInvalidOffset )
                 return false;
 
@@ -328,6 +338,17 @@ bool wxFile::ReadAll(wxString *str, const wxMBConv& conv)
         }
     }
 
+    return true;
+}
+
+bool wxFile::ReadAll(wxString *str, const wxMBConv& conv)
+{
+    wxCHECK_MSG( str, false, wxS("Output string must be non-NULL") );
+
+    wxCharBuffer buf;
+    if ( !wxReadAllData(*this, Length(), buf) )
+        return false;
+
     str->assign(buf, conv);
 
     return true;
@@ -528,6 +549,128 @@ bool wxFile::Eof() const
     return true;
 }
 
+// ============================================================================
+// implementation of wxMappedFile
+// ============================================================================
+
+bool wxMappedFile::Open(const wxString& fileName, Access access)
+{
+    Close();
+
+    wxFile file(fileName);
+    if ( !file.IsOpened() )
+        return false;
+
+    return Open(file, access);
+}
+
+bool wxMappedFile::Open(wxFile& file, Access access)
+{
+    Close();
+
+    wxCHECK_MSG( file.IsOpened(), false, wxS("file must be opened") );
+
+    const wxFileOffset lenFile = file.Length();
+
+#ifdef wxHAS_FILE_MMAP
+    // only regular files can be mapped, and as the special files, e.g. those
+    // under /proc on Linux systems, can return 0 for their length, don't map
+    // the empty files neither but read them below
+    const size_t size = wx_truncate_cast(size_t, lenFile);
+    if ( lenFile > 0 && static_cast<wxFileOffset>(size) == lenFile &&
+            file.GetKind() == wxFILE_KIND_DISK )
+    {
+#if defined(__UNIX__)
+        void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file.fd(), 0);
+        if ( mapping == MAP_FAILED )
+        {
+            mapping = NULL;
+        }
+        else
+        {
+#ifdef MADV_SEQUENTIAL
+            switch ( access )
+            {
+                case Access_Default:
+                    break;
+
+                case Access_Sequential:
+                    madvise(mapping, size, MADV_SEQUENTIAL);
+                    break;
+
+                case Access_Random:
+                    madvise(mapping, size, MADV_RANDOM);
+                    break;
+            }
+#endif // MADV_SEQUENTIAL
+        }
+#elif defined(__WINDOWS__)
+        void *mapping = NULL;
+
+        const HANDLE hFile = reinterpret_cast<HANDLE>(_get_osfhandle(file.fd()));
+        if ( hFile != INVALID_HANDLE_VALUE )
+        {
+            const HANDLE hMapping = ::CreateFileMapping(hFile, NULL,
+                                                        PAGE_READONLY,
+                                                        0, 0, NULL);
+            if ( hMapping )
+            {
+                mapping = ::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, size);
+
+                // the view keeps a reference to the mapping object, so we
+                // don't need it any more
+                ::CloseHandle(hMapping);
+            }
+        }
+
+        // there is no equivalent of madvise() for the mapped views here, the
+        // access pattern can only be specified when opening the file
+        wxUnusedVar(access);
+#endif // Unix/Windows
+
+        if ( mapping )
+        {
+            m_mapping = mapping;
+            m_data = static_cast<const char *>(mapping);
+            m_length = size;
+
+            return true;
+        }
+    }
+#else // !wxHAS_FILE_MMAP
+    wxUnusedVar(access);
+#endif // wxHAS_FILE_MMAP/!wxHAS_FILE_MMAP
+
+    // the file can't be mapped, fall back to reading it
+    wxCharBuffer buf;
+    if ( !wxReadAllData(file, lenFile, buf) )
+        return false;
+
+    m_buffer = buf;
+    m_length = m_buffer.length();
+    m_data = m_length ? m_buffer.data() : "";
+
+    return true;
+}
+
+void wxMappedFile::Close()
+{
+#ifdef wxHAS_FILE_MMAP
+    if ( m_mapping )
+    {
+#if defined(__UNIX__)
+        munmap(m_mapping, m_length);
+#elif defined(__WINDOWS__)
+        ::UnmapViewOfFile(m_mapping);
+#endif // Unix/Windows
+    }
+#endif // wxHAS_FILE_MMAP
+
+    m_buffer.reset();
+
+    Init();
+}
+
 // ============================================================================
 // implementation of wxTempFile
 // ============================================================================
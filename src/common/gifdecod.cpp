@@ -25,6 +25,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "wx/gifdecod.h"
+#include "wx/mstream.h"
 #include "wx/scopedarray.h"
 #include "wx/scopedptr.h"
 #include "wx/scopeguard.h"
@@ -42,6 +43,10 @@ enum
 
 #define GetFrame(n)     ((GIFImage*)m_frames[n])
 
+// The maximal number of decoded frames to keep in memory, the other ones are
+// only stored in compressed form and decoded again when needed.
+static const size_t MAX_DECODED_FRAMES = 4;
+
 //---------------------------------------------------------------------------
 // GIFImage
 //---------------------------------------------------------------------------
@@ -60,10 +65,13 @@ public:
     int transparent;                // transparent color index (-1 = none)
     wxAnimationDisposal disposal;   // disposal method
     long delay;                     // delay in ms (-1 = unused)
-    unsigned char *p;               // bitmap
+    unsigned char *p;               // bitmap (NULL if not decoded)
     unsigned char *pal;             // palette
     unsigned int ncolours;          // number of colours
     wxString comment;
+    int bits;                       // initial code size
+    int interl;                     // 1 if the image is interlaced
+    wxMemoryBuffer lzw;             // compressed data sub-blocks
 
     wxDECLARE_NO_COPY_CLASS(GIFImage);
 };
@@ -87,6 +95,8 @@ GIFImage::GIFImage()
     p = (unsigned char *) NULL;
     pal = (unsigned char *) NULL;
     ncolours = 0;
+    bits = 0;
+    interl = 0;
 }
 
 //---------------------------------------------------------------------------
@@ -115,6 +125,58 @@ void wxGIFDecoder::Destroy()
 
     m_frames.Clear();
     m_nFrames = 0;
+    m_decodedFrames.clear();
+}
+
+//---------------------------------------------------------------------------
+// Decoding frames on demand
+//---------------------------------------------------------------------------
+
+wxGIFErrorCode wxGIFDecoder::DecodeFrame(unsigned int frame)
+{
+    GIFImage* const img = GetFrame(frame);
+    if ( img->p )
+    {
+        // Already decoded, just mark it as the most recently used one.
+        for ( size_t n = 0; n < m_decodedFrames.size(); n++ )
+        {
+            if ( m_decodedFrames[n] == frame )
+            {
+                m_decodedFrames.erase(m_decodedFrames.begin() + n);
+                break;
+            }
+        }
+
+        m_decodedFrames.push_back(frame);
+        return wxGIF_OK;
+    }
+
+    // Free the least recently used frame if we have too many of them.
+    if ( m_decodedFrames.size() >= MAX_DECODED_FRAMES )
+    {
+        GIFImage* const old = GetFrame(m_decodedFrames[0]);
+        free(old->p);
+        old->p = NULL;
+
+        m_decodedFrames.erase(m_decodedFrames.begin());
+    }
+
+    img->p = (unsigned char *) malloc((unsigned int)(img->w * img->h));
+    if ( !img->p )
+        return wxGIF_MEMERR;
+
+    wxMemoryInputStream stream(img->lzw.GetData(), img->lzw.GetDataLen());
+    wxGIFErrorCode result = dgif(stream, img, img->interl, img->bits);
+    if ( result != wxGIF_OK )
+    {
+        free(img->p);
+        img->p = NULL;
+        return result;
+    }
+
+    m_decodedFrames.push_back(frame);
+
+    return wxGIF_OK;
 }
 
 
@@ -145,6 +207,9 @@ bool wxGIFDecoder::ConvertToImage(unsigned int frame, wxImage *image) const
 
     pal = GetPalette(frame);
     src = GetData(frame);
+    if (!src)
+        return false;
+
     dst = image->GetData();
     transparent = GetTransparentColourIndex(frame);
 
@@ -276,7 +341,16 @@ wxColour wxGIFDecoder::GetTransparentColour(unsigned int frame) const
                     pal[n*3 + 2]);
 }
 
-unsigned char* wxGIFDecoder::GetData(unsigned int frame) const    { return (GetFrame(frame)->p); }
+unsigned char* wxGIFDecoder::GetData(unsigned int frame) const
+{
+    // Decoding the frame on demand doesn't change the observable state.
+    if ( const_cast<wxGIFDecoder*>(this)->DecodeFrame(frame) != wxGIF_OK )
+        return NULL;
+
+    return GetFrame(frame)->p;
+}
+
+
 unsigned char* wxGIFDecoder::GetPalette(unsigned int frame) const { return (GetFrame(frame)->pal); }
 unsigned int wxGIFDecoder::GetNcolours(unsigned int frame) const  { return (GetFrame(frame)->ncolours); }
 int wxGIFDecoder::GetTransparentColourIndex(unsigned int frame) const  { return (GetFrame(frame)->transparent); }
@@ -611,6 +685,33 @@ bool wxGIFDecoder::DoCanRead(wxInputStream &stream) const
 }
 
 
+// ReadSubBlocks:
+//  Appends the data sub-blocks, including their sizes and the terminating
+//  empty block, to the buffer. Returns false if the data is truncated.
+//
+static bool ReadSubBlocks(wxInputStream& stream, wxMemoryBuffer& buf)
+{
+    for ( ;; )
+    {
+        const int len = stream.GetC();
+        if ( len == wxEOF )
+            return false;
+
+        buf.AppendByte((char)len);
+        if ( len == 0 )
+            return true;
+
+        void* const data = buf.GetAppendBuf(len);
+        stream.Read(data, len);
+
+        const size_t lastRead = stream.LastRead();
+        buf.UngetAppendBuf(lastRead);
+        if ( lastRead != (size_t)len )
+            return false;
+    }
+}
+
+
 // LoadGIF:
 //  Reads and decodes one or more GIF images, depending on whether
 //  animated GIF support is enabled. Can read GIFs with any bit
@@ -625,7 +726,6 @@ wxGIFErrorCode wxGIFDecoder::LoadGIF(wxInputStream& stream)
     unsigned int  global_ncolors = 0;
     int           bits, interl, i;
     wxAnimationDisposal disposal;
-    long          size;
     long          delay;
     unsigned char type = 0;
     unsigned char pal[768];
@@ -835,17 +935,16 @@ wxGIFErrorCode wxGIFDecoder::LoadGIF(wxInputStream& stream)
                 }
 
                 interl = ((buf[8] & 0x40)? 1 : 0);
-                size = pimg->w * pimg->h;
 
                 pimg->transparent = transparent;
                 pimg->disposal = disposal;
                 pimg->delay = delay;
 
-                // allocate memory for image and palette
-                pimg->p   = (unsigned char *) malloc((unsigned int)size);
+                // allocate memory for palette, the image itself is only
+                // allocated when it's decoded
                 pimg->pal = (unsigned char *) malloc(768);
 
-                if ((!pimg->p) || (!pimg->pal))
+                if (!pimg->pal)
                     return wxGIF_MEMERR;
 
                 // load local color map if available, else use global map
@@ -869,17 +968,27 @@ wxGIFErrorCode wxGIFDecoder::LoadGIF(wxInputStream& stream)
                 if (bits == 0)
                     return wxGIF_INVFORMAT;
 
-                // decode image
-                wxGIFErrorCode result = dgif(stream, pimg.get(), interl, bits);
-                if (result != wxGIF_OK)
-                    return result;
-
-                guardDestroy.Dismiss();
+                // store the compressed data to decode it when it's needed,
+                // if it's truncated, decode as much of it as possible
+                pimg->bits = bits;
+                pimg->interl = interl;
+                ReadSubBlocks(stream, pimg->lzw);
 
                 // add the image to our frame array
                 m_frames.Add(pimg.release());
                 m_nFrames++;
 
+                // decode the first frame immediately to detect any errors in
+                // it, the other ones are only decoded on demand
+                if (m_nFrames == 1)
+                {
+                    wxGIFErrorCode result = DecodeFrame(0);
+                    if (result != wxGIF_OK)
+                        return result;
+                }
+
+                guardDestroy.Dismiss();
+
                 // if this is not an animated GIF, exit after first image
                 if (!anim)
                     done = true;
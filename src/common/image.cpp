@@ -28,8 +28,10 @@
     #include "wx/colour.h"
 #endif
 
+#include "wx/thread.h"
 #include "wx/wfstream.h"
 #include "wx/xpmdecod.h"
+#include "wx/private/image.h"
 
 // For memcpy
 #include <string.h>
@@ -87,6 +89,12 @@ public:
     // same as m_static but for m_alpha
     bool            m_staticAlpha;
 
+    // if non-NULL, called to release the external data and alpha pointers
+    // passed to CreateFromExternal() which are stored in the fields below
+    wxImageDataReleaser *m_releaser;
+    unsigned char  *m_externalData;
+    unsigned char  *m_externalAlpha;
+
     // global and per-object flags determining LoadFile() behaviour
     int             m_loadFlags;
     static int      sm_defaultLoadFlags;
@@ -121,6 +129,10 @@ wxImageRefData::wxImageRefData()
     m_static =
     m_staticAlpha = false;
 
+    m_releaser = NULL;
+    m_externalData =
+    m_externalAlpha = NULL;
+
     m_loadFlags = sm_defaultLoadFlags;
 }
 
@@ -130,9 +142,132 @@ wxImageRefData::~wxImageRefData()
         free( m_data );
     if ( !m_staticAlpha )
         free( m_alpha );
+
+    if ( m_releaser )
+    {
+        m_releaser->Release(m_externalData, m_externalAlpha);
+        delete m_releaser;
+    }
 }
 
 
+//-----------------------------------------------------------------------------
+// helpers for processing the image rows in parallel
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+// The maximal number of threads to use, 0 means to use one per CPU.
+int gs_maxThreads = 0;
+
+// Minimal amount of work, see ProcessRowsInParallel(), for which it's worth
+// creating a new thread.
+const size_t MIN_WORK_PER_THREAD = 128*1024;
+
+// Base class for the objects performing some operation on a range of the
+// image rows, it's declared in the private header as it's also used by the
+// colour quantization code.
+typedef wxImageRowsProcessor RowsProcessor;
+
+#if wxUSE_THREADS
+
+class RowsProcessorThread : public wxThread
+{
+public:
+    RowsProcessorThread(const RowsProcessor& processor, int start, int end)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_processor(processor),
+          m_start(start),
+          m_end(end)
+    {
+    }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        m_processor.ProcessRows(m_start, m_end);
+
+        return 0;
+    }
+
+private:
+    const RowsProcessor& m_processor;
+    const int m_start;
+    const int m_end;
+
+    wxDECLARE_NO_COPY_CLASS(RowsProcessorThread);
+};
+
+#endif // wxUSE_THREADS
+
+// Process all the rows, splitting them between several threads if there is
+// enough work to do. The work is measured in arbitrary units corresponding,
+// roughly, to the time needed to compute a single pixel using a few source
+// pixels.
+void ProcessRowsInParallel(const RowsProcessor& processor,
+                           int numRows,
+                           size_t work)
+{
+#if wxUSE_THREADS
+    int numThreads = gs_maxThreads ? gs_maxThreads : wxThread::GetCPUCount();
+    if ( numThreads < 1 )
+        numThreads = 1;
+    if ( static_cast<size_t>(numThreads) > work / MIN_WORK_PER_THREAD )
+        numThreads = work / MIN_WORK_PER_THREAD;
+    if ( numThreads > numRows )
+        numThreads = numRows;
+
+    if ( numThreads > 1 )
+    {
+        wxVector<RowsProcessorThread*> threads;
+        threads.reserve(numThreads - 1);
+
+        // The first range of rows is processed by this thread itself.
+        for ( int n = 1; n < numThreads; n++ )
+        {
+            const int start = (numRows*n)/numThreads;
+            const int end = (numRows*(n + 1))/numThreads;
+
+            RowsProcessorThread* const
+                thread = new RowsProcessorThread(processor, start, end);
+            if ( thread->Run() != wxTHREAD_NO_ERROR )
+            {
+                // Not much we can do about it, just process these rows here.
+                delete thread;
+                processor.ProcessRows(start, end);
+                continue;
+            }
+
+            threads.push_back(thread);
+        }
+
+        processor.ProcessRows(0, numRows/numThreads);
+
+        for ( size_t n = 0; n < threads.size(); n++ )
+        {
+            threads[n]->Wait();
+            delete threads[n];
+        }
+
+        return;
+    }
+#else // !wxUSE_THREADS
+    wxUnusedVar(work);
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+
+    processor.ProcessRows(0, numRows);
+}
+
+} // anonymous namespace
+
+void wxProcessImageRowsInParallel(const wxImageRowsProcessor& processor,
+                                  int numRows,
+                                  size_t work)
+{
+    ProcessRowsInParallel(processor, numRows, work);
+}
+
 //-----------------------------------------------------------------------------
 // wxImage
 //-----------------------------------------------------------------------------
@@ -216,6 +351,47 @@ bool wxImage::Create( int width, int height, unsigned char* data, unsigned char*
     return true;
 }
 
+bool wxImage::CreateFromExternal( int width, int height,
+                                  unsigned char* data, unsigned char* alpha,
+                                  wxImageDataReleaser* releaser )
+{
+    UnRef();
+
+    if ( !data )
+    {
+        // We still take ownership of the releaser, so release the alpha, if
+        // any, and delete it, as otherwise nobody would.
+        if ( releaser )
+        {
+            releaser->Release(data, alpha);
+            delete releaser;
+        }
+
+        wxFAIL_MSG( wxT("NULL data in wxImage::CreateFromExternal") );
+        return false;
+    }
+
+    m_refData = new wxImageRefData();
+
+    // The data is never freed by wxImage itself, but only by the releaser
+    // when the ref data is destroyed, which happens when it's not shared by
+    // any image any more. Notice that modifying an image which shares its data
+    // with another one makes a copy of it, so the external data is never
+    // reallocated.
+    M_IMGDATA->m_data = data;
+    M_IMGDATA->m_alpha = alpha;
+    M_IMGDATA->m_width = width;
+    M_IMGDATA->m_height = height;
+    M_IMGDATA->m_ok = true;
+    M_IMGDATA->m_static =
+    M_IMGDATA->m_staticAlpha = true;
+    M_IMGDATA->m_releaser = releaser;
+    M_IMGDATA->m_externalData = data;
+    M_IMGDATA->m_externalAlpha = alpha;
+
+    return true;
+}
+
 void wxImage::Destroy()
 {
     UnRef();
@@ -615,8 +791,287 @@ void ResampleBoxPrecalc(wxVector<BoxPrecalc>& boxes, int oldDim)
     }
 }
 
+// Add the sums of the pixels in all boxes of the given source row, with alpha
+// or not, to the sums array containing 3 or 4 values for each box.
+void BoxSumRow(const unsigned char* src_data,
+               const unsigned char* src_alpha,
+               const wxVector<BoxPrecalc>& hPrecalcs,
+               double* sum)
+{
+    const int dstWidth = hPrecalcs.size();
+
+    if ( src_alpha )
+    {
+        for ( int x = 0; x < dstWidth; x++ )
+        {
+            const BoxPrecalc& hPrecalc = hPrecalcs[x];
+
+            double sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
+            for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; ++i )
+            {
+                const unsigned char a = src_alpha[i];
+                sum_r += src_data[i * 3 + 0] * a;
+                sum_g += src_data[i * 3 + 1] * a;
+                sum_b += src_data[i * 3 + 2] * a;
+                sum_a += a;
+            }
+
+            sum[0] += sum_r;
+            sum[1] += sum_g;
+            sum[2] += sum_b;
+            sum[3] += sum_a;
+            sum += 4;
+        }
+    }
+    else
+    {
+        for ( int x = 0; x < dstWidth; x++ )
+        {
+            const BoxPrecalc& hPrecalc = hPrecalcs[x];
+
+            double sum_r = 0, sum_g = 0, sum_b = 0;
+            for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; ++i )
+            {
+                sum_r += src_data[i * 3 + 0];
+                sum_g += src_data[i * 3 + 1];
+                sum_b += src_data[i * 3 + 2];
+            }
+
+            sum[0] += sum_r;
+            sum[1] += sum_g;
+            sum[2] += sum_b;
+            sum += 3;
+        }
+    }
+}
+
+// Calculate the destination row from the sums of the pixels of the boxes of
+// the given height computed by BoxSumRow().
+void BoxAverageRow(const double* sum,
+                   int box_height,
+                   const wxVector<BoxPrecalc>& hPrecalcs,
+                   unsigned char* dst_data,
+                   unsigned char* dst_alpha)
+{
+    const int dstWidth = hPrecalcs.size();
+
+    for ( int x = 0; x < dstWidth; x++ )
+    {
+        const BoxPrecalc& hPrecalc = hPrecalcs[x];
+        const int averaged_pixels =
+            box_height*(hPrecalc.boxEnd - hPrecalc.boxStart + 1);
+
+        if ( dst_alpha )
+        {
+            const double sum_a = sum[3];
+            if ( sum_a )
+            {
+                dst_data[0] = (unsigned char)(sum[0] / sum_a);
+                dst_data[1] = (unsigned char)(sum[1] / sum_a);
+                dst_data[2] = (unsigned char)(sum[2] / sum_a);
+            }
+            else
+            {
+                dst_data[0] = 0;
+                dst_data[1] = 0;
+                dst_data[2] = 0;
+            }
+            *dst_alpha++ = (unsigned char)(sum_a / averaged_pixels);
+            sum += 4;
+        }
+        else
+        {
+            dst_data[0] = (unsigned char)(sum[0] / averaged_pixels);
+            dst_data[1] = (unsigned char)(sum[1] / averaged_pixels);
+            dst_data[2] = (unsigned char)(sum[2] / averaged_pixels);
+            sum += 3;
+        }
+
+        dst_data += 3;
+    }
+}
+
+// Box averaging resampler: as all the sums here are integer, they are
+// computed exactly and so the rows of each box can be summed separately.
+class BoxResampler : public RowsProcessor
+{
+public:
+    BoxResampler(const wxImage& src,
+                 wxImage& dst,
+                 const wxVector<BoxPrecalc>& vPrecalcs,
+                 const wxVector<BoxPrecalc>& hPrecalcs)
+        : m_srcData(src.GetData()),
+          m_srcAlpha(src.GetAlpha()),
+          m_srcWidth(src.GetWidth()),
+          m_dstData(dst.GetData()),
+          m_dstAlpha(dst.GetAlpha()),
+          m_dstWidth(dst.GetWidth()),
+          m_vPrecalcs(vPrecalcs),
+          m_hPrecalcs(hPrecalcs)
+    {
+    }
+
+    virtual void ProcessRows(int start, int end) const wxOVERRIDE
+    {
+        // Sums of all channels, including alpha if we have it, of all pixels
+        // in the boxes of the current row.
+        const int numChannels = m_srcAlpha ? 4 : 3;
+        wxVector<double> sums(m_dstWidth*numChannels);
+
+        for ( int y = start; y < end; y++ )
+        {
+            const BoxPrecalc& vPrecalc = m_vPrecalcs[y];
+
+            for ( size_t n = 0; n < sums.size(); n++ )
+                sums[n] = 0.0;
+
+            for ( int j = vPrecalc.boxStart; j <= vPrecalc.boxEnd; ++j )
+            {
+                BoxSumRow(m_srcData + size_t(j)*m_srcWidth*3,
+                          m_srcAlpha ? m_srcAlpha + size_t(j)*m_srcWidth
+                                     : NULL,
+                          m_hPrecalcs,
+                          &sums[0]);
+            }
+
+            // Calculate the average from the sum and number of averaged pixels
+            BoxAverageRow(&sums[0],
+                          vPrecalc.boxEnd - vPrecalc.boxStart + 1,
+                          m_hPrecalcs,
+                          m_dstData + size_t(y)*m_dstWidth*3,
+                          m_dstAlpha ? m_dstAlpha + size_t(y)*m_dstWidth
+                                     : NULL);
+        }
+    }
+
+private:
+    const unsigned char* const m_srcData;
+    const unsigned char* const m_srcAlpha;
+    const int m_srcWidth;
+    unsigned char* const m_dstData;
+    unsigned char* const m_dstAlpha;
+    const int m_dstWidth;
+    const wxVector<BoxPrecalc>& m_vPrecalcs;
+    const wxVector<BoxPrecalc>& m_hPrecalcs;
+
+    wxDECLARE_NO_COPY_CLASS(BoxResampler);
+};
+
+// Consumer of the decoded image rows averaging them in the same way as
+// ResampleBox() does, but without ever having the entire source image in
+// memory.
+class ImageDownscaler : public wxImageRowsConsumer
+{
+public:
+    ImageDownscaler(wxImage& image, unsigned maxWidth, unsigned maxHeight)
+        : m_image(image),
+          m_maxWidth(maxWidth),
+          m_maxHeight(maxHeight),
+          m_dstRow(0)
+    {
+    }
+
+    virtual bool OnStart(int width, int height, bool hasAlpha) wxOVERRIDE
+    {
+        unsigned newWidth = width,
+                 newHeight = height;
+        wxGetImageLoadSize(m_maxWidth, m_maxHeight, newWidth, newHeight);
+
+        if ( !m_image.Create(newWidth, newHeight, false) )
+            return false;
+
+        if ( hasAlpha )
+            m_image.SetAlpha();
+
+        if ( newWidth != (unsigned)width || newHeight != (unsigned)height )
+        {
+            m_image.SetOption(wxIMAGE_OPTION_ORIGINAL_WIDTH, width);
+            m_image.SetOption(wxIMAGE_OPTION_ORIGINAL_HEIGHT, height);
+        }
+
+        m_vPrecalcs.resize(newHeight);
+        m_hPrecalcs.resize(newWidth);
+        ResampleBoxPrecalc(m_vPrecalcs, height);
+        ResampleBoxPrecalc(m_hPrecalcs, width);
+
+        const size_t numSums = newWidth*(hasAlpha ? 4 : 3);
+        m_sums.resize(numSums, 0.0);
+        m_sumsNext.resize(numSums, 0.0);
+
+        return true;
+    }
+
+    virtual bool OnRows(int firstRow, const wxImage& rows) wxOVERRIDE
+    {
+        const int width = rows.GetWidth();
+        const int dstWidth = m_image.GetWidth();
+        const int dstHeight = m_image.GetHeight();
+
+        for ( int i = 0; i < rows.GetHeight(); i++ )
+        {
+            const int y = firstRow + i;
+            const unsigned char* const
+                src_data = rows.GetData() + size_t(i)*width*3;
+            const unsigned char* const
+                src_alpha = rows.HasAlpha() ? rows.GetAlpha() + size_t(i)*width
+                                            : NULL;
+
+            // When shrinking the image, each source row belongs to the box of
+            // the current destination row and, possibly, the next one too.
+            BoxSumRow(src_data, src_alpha, m_hPrecalcs, &m_sums[0]);
+
+            if ( m_dstRow + 1 < dstHeight &&
+                    y >= m_vPrecalcs[m_dstRow + 1].boxStart )
+                BoxSumRow(src_data, src_alpha, m_hPrecalcs, &m_sumsNext[0]);
+
+            const BoxPrecalc& vPrecalc = m_vPrecalcs[m_dstRow];
+            if ( y != vPrecalc.boxEnd )
+                continue;
+
+            BoxAverageRow(&m_sums[0],
+                          vPrecalc.boxEnd - vPrecalc.boxStart + 1,
+                          m_hPrecalcs,
+                          m_image.GetData() + size_t(m_dstRow)*dstWidth*3,
+                          m_image.HasAlpha()
+                            ? m_image.GetAlpha() + size_t(m_dstRow)*dstWidth
+                            : NULL);
+
+            m_sums.swap(m_sumsNext);
+            for ( size_t n = 0; n < m_sumsNext.size(); n++ )
+                m_sumsNext[n] = 0.0;
+
+            if ( ++m_dstRow == dstHeight )
+                break;
+        }
+
+        return true;
+    }
+
+private:
+    wxImage& m_image;
+    const unsigned m_maxWidth,
+                   m_maxHeight;
+
+    wxVector<BoxPrecalc> m_vPrecalcs,
+                         m_hPrecalcs;
+
+    // Sums for the current destination row and the next one.
+    wxVector<double> m_sums,
+                     m_sumsNext;
+
+    int m_dstRow;
+
+    wxDECLARE_NO_COPY_CLASS(ImageDownscaler);
+};
+
 } // anonymous namespace
 
+wxImageRowsConsumer*
+wxCreateImageDownscaler(wxImage& image, unsigned maxWidth, unsigned maxHeight)
+{
+    return new ImageDownscaler(image, maxWidth, maxHeight);
+}
+
 wxImage wxImage::ResampleBox(int width, int height) const
 {
     // This function implements a simple pre-blur/box averaging method for
@@ -632,92 +1087,86 @@ wxImage wxImage::ResampleBox(int width, int height) const
     ResampleBoxPrecalc(vPrecalcs, M_IMGDATA->m_height);
     ResampleBoxPrecalc(hPrecalcs, M_IMGDATA->m_width);
 
+    if ( M_IMGDATA->m_alpha )
+        ret_image.SetAlpha();
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_data = ret_image.GetData();
-    unsigned char* dst_alpha = NULL;
+    // Each source pixel is used once when shrinking the image and each
+    // destination one is computed once when enlarging it.
+    const BoxResampler resampler(*this, ret_image, vPrecalcs, hPrecalcs);
+    ProcessRowsInParallel(resampler, height,
+                          size_t(M_IMGDATA->m_width)*M_IMGDATA->m_height +
+                          size_t(width)*height);
 
-    if ( src_alpha )
+    return ret_image;
+}
+
+namespace
+{
+
+// Cache of the source rows already resampled in the horizontal direction,
+// used by the separable resampling algorithms below: as consecutive rows of
+// the destination image are computed using mostly the same source rows, this
+// avoids resampling them more than once.
+class ResampledRowsCache
+{
+public:
+    // Create the cache of the given number of rows, each containing the given
+    // number of values.
+    ResampledRowsCache(int numRows, size_t rowSize)
+        : m_rows(numRows, -1),
+          m_data(numRows*rowSize),
+          m_rowSize(rowSize)
     {
-        ret_image.SetAlpha();
-        dst_alpha = ret_image.GetAlpha();
     }
 
-    int averaged_pixels, src_pixel_index;
-    double sum_r, sum_g, sum_b, sum_a;
-
-    for ( int y = 0; y < height; y++ )         // Destination image - Y direction
+    // Return the data of the given row, resampling it using the provided
+    // function if it's not in the cache yet. The rows in the rowsToKeep array
+    // are supposed to be needed too and won't be removed from the cache, so
+    // its size must not exceed the number of rows in the cache.
+    template <typename T>
+    const double* GetRow(int row,
+                         const int* rowsToKeep,
+                         int numRowsToKeep,
+                         const T& resampler)
     {
-        // Source pixel in the Y direction
-        const BoxPrecalc& vPrecalc = vPrecalcs[y];
+        const int numSlots = m_rows.size();
 
-        for ( int x = 0; x < width; x++ )      // Destination image - X direction
+        int slot;
+        for ( slot = 0; slot < numSlots; slot++ )
         {
-            // Source pixel in the X direction
-            const BoxPrecalc& hPrecalc = hPrecalcs[x];
-
-            // Box of pixels to average
-            averaged_pixels = 0;
-            sum_r = sum_g = sum_b = sum_a = 0.0;
+            if ( m_rows[slot] == row )
+                return &m_data[slot*m_rowSize];
+        }
 
-            for ( int j = vPrecalc.boxStart; j <= vPrecalc.boxEnd; ++j )
+        for ( slot = 0; slot < numSlots; slot++ )
+        {
+            int n;
+            for ( n = 0; n < numRowsToKeep; n++ )
             {
-                for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; ++i )
-                {
-                    // Calculate the actual index in our source pixels
-                    src_pixel_index = j * M_IMGDATA->m_width + i;
-
-                    if (src_alpha)
-                    {
-                        sum_r += src_data[src_pixel_index * 3 + 0] * src_alpha[src_pixel_index];
-                        sum_g += src_data[src_pixel_index * 3 + 1] * src_alpha[src_pixel_index];
-                        sum_b += src_data[src_pixel_index * 3 + 2] * src_alpha[src_pixel_index];
-                        sum_a += src_alpha[src_pixel_index];
-                    }
-                    else
-                    {
-                        sum_r += src_data[src_pixel_index * 3 + 0];
-                        sum_g += src_data[src_pixel_index * 3 + 1];
-                        sum_b += src_data[src_pixel_index * 3 + 2];
-                    }
-
-                    averaged_pixels++;
-                }
+                if ( m_rows[slot] == rowsToKeep[n] )
+                    break;
             }
 
-            // Calculate the average from the sum and number of averaged pixels
-            if (src_alpha)
-            {
-                if (sum_a)
-                {
-                    dst_data[0] = (unsigned char)(sum_r / sum_a);
-                    dst_data[1] = (unsigned char)(sum_g / sum_a);
-                    dst_data[2] = (unsigned char)(sum_b / sum_a);
-                }
-                else
-                {
-                    dst_data[0] = 0;
-                    dst_data[1] = 0;
-                    dst_data[2] = 0;
-                }
-                *dst_alpha++ = (unsigned char)(sum_a / averaged_pixels);
-            }
-            else
-            {
-                dst_data[0] = (unsigned char)(sum_r / averaged_pixels);
-                dst_data[1] = (unsigned char)(sum_g / averaged_pixels);
-                dst_data[2] = (unsigned char)(sum_b / averaged_pixels);
-            }
-            dst_data += 3;
+            if ( n == numRowsToKeep )
+                break;
         }
+
+        wxCHECK_MSG( slot < numSlots, NULL, wxS("no free slot in the cache") );
+
+        m_rows[slot] = row;
+
+        double* const data = &m_data[slot*m_rowSize];
+        resampler.ResampleRow(row, data);
+        return data;
     }
 
-    return ret_image;
-}
+private:
+    wxVector<int> m_rows;
+    wxVector<double> m_data;
+    const size_t m_rowSize;
 
-namespace
-{
+    wxDECLARE_NO_COPY_CLASS(ResampledRowsCache);
+};
 
 struct BilinearPrecalc
 {
@@ -774,84 +1223,132 @@ void ResampleBilinearPrecalc(wxVector<BilinearPrecalc>& precalcs, int oldDim)
     }
 }
 
-} // anonymous namespace
-
-wxImage wxImage::ResampleBilinear(int width, int height) const
+// Bilinear resampler: the source rows are first interpolated horizontally and
+// then the adjacent rows are interpolated vertically, which gives exactly the
+// same results as interpolating each pixel in both directions at once.
+class BilinearResampler : public RowsProcessor
 {
-    // This function implements a Bilinear algorithm for resampling.
-    wxImage ret_image(width, height, false);
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_data = ret_image.GetData();
-    unsigned char* dst_alpha = NULL;
-
-    if ( src_alpha )
+public:
+    BilinearResampler(const wxImage& src,
+                      wxImage& dst,
+                      const wxVector<BilinearPrecalc>& vPrecalcs,
+                      const wxVector<BilinearPrecalc>& hPrecalcs)
+        : m_srcData(src.GetData()),
+          m_srcAlpha(src.GetAlpha()),
+          m_srcWidth(src.GetWidth()),
+          m_dstData(dst.GetData()),
+          m_dstAlpha(dst.GetAlpha()),
+          m_dstWidth(dst.GetWidth()),
+          m_vPrecalcs(vPrecalcs),
+          m_hPrecalcs(hPrecalcs)
     {
-        ret_image.SetAlpha();
-        dst_alpha = ret_image.GetAlpha();
     }
 
-    wxVector<BilinearPrecalc> vPrecalcs(height);
-    wxVector<BilinearPrecalc> hPrecalcs(width);
-    ResampleBilinearPrecalc(vPrecalcs, M_IMGDATA->m_height);
-    ResampleBilinearPrecalc(hPrecalcs, M_IMGDATA->m_width);
+    virtual void ProcessRows(int start, int end) const wxOVERRIDE
+    {
+        // Each row contains the RGB values followed by alpha ones, if any.
+        const size_t numValues = size_t(m_dstWidth)*3;
+        ResampledRowsCache
+            cache(2, m_srcAlpha ? numValues + m_dstWidth : numValues);
 
-    // initialize alpha values to avoid g++ warnings about possibly
-    // uninitialized variables
-    double r1, g1, b1, a1 = 0;
-    double r2, g2, b2, a2 = 0;
+        for ( int y = start; y < end; y++ )
+        {
+            const BilinearPrecalc& vPrecalc = m_vPrecalcs[y];
+            const int offsets[2] = { vPrecalc.offset1, vPrecalc.offset2 };
+            const double dy = vPrecalc.dd;
+            const double dy1 = vPrecalc.dd1;
 
-    for ( int dsty = 0; dsty < height; dsty++ )
-    {
-        // We need to calculate the source pixel to interpolate from - Y-axis
-        const BilinearPrecalc& vPrecalc = vPrecalcs[dsty];
-        const int y_offset1 = vPrecalc.offset1;
-        const int y_offset2 = vPrecalc.offset2;
-        const double dy = vPrecalc.dd;
-        const double dy1 = vPrecalc.dd1;
+            const double* const line1 = cache.GetRow(offsets[0], offsets, 2, *this);
+            const double* const line2 = cache.GetRow(offsets[1], offsets, 2, *this);
 
+            unsigned char* const dst_data = m_dstData + size_t(y)*numValues;
+            for ( size_t n = 0; n < numValues; n++ )
+            {
+                dst_data[n] =
+                    static_cast<unsigned char>(line1[n] * dy1 + line2[n] * dy + .5);
+            }
 
-        for ( int dstx = 0; dstx < width; dstx++ )
-        {
-            // X-axis of pixel to interpolate from
-            const BilinearPrecalc& hPrecalc = hPrecalcs[dstx];
+            if ( m_dstAlpha )
+            {
+                unsigned char* const
+                    dst_alpha = m_dstAlpha + size_t(y)*m_dstWidth;
+                const double* const alpha1 = line1 + numValues;
+                const double* const alpha2 = line2 + numValues;
+                for ( int x = 0; x < m_dstWidth; x++ )
+                {
+                    dst_alpha[x] =
+                        static_cast<unsigned char>(alpha1[x] * dy1 + alpha2[x] * dy +.5);
+                }
+            }
+        }
+    }
 
-            const int x_offset1 = hPrecalc.offset1;
-            const int x_offset2 = hPrecalc.offset2;
+    // Interpolate the given source row horizontally.
+    void ResampleRow(int row, double* line) const
+    {
+        const unsigned char* const
+            src_data = m_srcData + size_t(row)*m_srcWidth*3;
+
+        for ( int x = 0; x < m_dstWidth; x++ )
+        {
+            const BilinearPrecalc& hPrecalc = m_hPrecalcs[x];
+            const unsigned char* const p1 = src_data + hPrecalc.offset1 * 3;
+            const unsigned char* const p2 = src_data + hPrecalc.offset2 * 3;
             const double dx = hPrecalc.dd;
             const double dx1 = hPrecalc.dd1;
 
-            int src_pixel_index00 = y_offset1 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index01 = y_offset1 * M_IMGDATA->m_width + x_offset2;
-            int src_pixel_index10 = y_offset2 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index11 = y_offset2 * M_IMGDATA->m_width + x_offset2;
-
-            // first line
-            r1 = src_data[src_pixel_index00 * 3 + 0] * dx1 + src_data[src_pixel_index01 * 3 + 0] * dx;
-            g1 = src_data[src_pixel_index00 * 3 + 1] * dx1 + src_data[src_pixel_index01 * 3 + 1] * dx;
-            b1 = src_data[src_pixel_index00 * 3 + 2] * dx1 + src_data[src_pixel_index01 * 3 + 2] * dx;
-            if ( src_alpha )
-                a1 = src_alpha[src_pixel_index00] * dx1 + src_alpha[src_pixel_index01] * dx;
-
-            // second line
-            r2 = src_data[src_pixel_index10 * 3 + 0] * dx1 + src_data[src_pixel_index11 * 3 + 0] * dx;
-            g2 = src_data[src_pixel_index10 * 3 + 1] * dx1 + src_data[src_pixel_index11 * 3 + 1] * dx;
-            b2 = src_data[src_pixel_index10 * 3 + 2] * dx1 + src_data[src_pixel_index11 * 3 + 2] * dx;
-            if ( src_alpha )
-                a2 = src_alpha[src_pixel_index10] * dx1 + src_alpha[src_pixel_index11] * dx;
+            line[0] = p1[0] * dx1 + p2[0] * dx;
+            line[1] = p1[1] * dx1 + p2[1] * dx;
+            line[2] = p1[2] * dx1 + p2[2] * dx;
+            line += 3;
+        }
 
-            // result lines
+        if ( m_srcAlpha )
+        {
+            const unsigned char* const
+                src_alpha = m_srcAlpha + size_t(row)*m_srcWidth;
 
-            dst_data[0] = static_cast<unsigned char>(r1 * dy1 + r2 * dy + .5);
-            dst_data[1] = static_cast<unsigned char>(g1 * dy1 + g2 * dy + .5);
-            dst_data[2] = static_cast<unsigned char>(b1 * dy1 + b2 * dy + .5);
-            dst_data += 3;
+            for ( int x = 0; x < m_dstWidth; x++ )
+            {
+                const BilinearPrecalc& hPrecalc = m_hPrecalcs[x];
 
-            if ( src_alpha )
-                *dst_alpha++ = static_cast<unsigned char>(a1 * dy1 + a2 * dy +.5);
+                line[x] = src_alpha[hPrecalc.offset1] * hPrecalc.dd1 +
+                            src_alpha[hPrecalc.offset2] * hPrecalc.dd;
+            }
         }
     }
 
+private:
+    const unsigned char* const m_srcData;
+    const unsigned char* const m_srcAlpha;
+    const int m_srcWidth;
+    unsigned char* const m_dstData;
+    unsigned char* const m_dstAlpha;
+    const int m_dstWidth;
+    const wxVector<BilinearPrecalc>& m_vPrecalcs;
+    const wxVector<BilinearPrecalc>& m_hPrecalcs;
+
+    wxDECLARE_NO_COPY_CLASS(BilinearResampler);
+};
+
+} // anonymous namespace
+
+wxImage wxImage::ResampleBilinear(int width, int height) const
+{
+    // This function implements a Bilinear algorithm for resampling.
+    wxImage ret_image(width, height, false);
+
+    if ( M_IMGDATA->m_alpha )
+        ret_image.SetAlpha();
+
+    wxVector<BilinearPrecalc> vPrecalcs(height);
+    wxVector<BilinearPrecalc> hPrecalcs(width);
+    ResampleBilinearPrecalc(vPrecalcs, M_IMGDATA->m_height);
+    ResampleBilinearPrecalc(hPrecalcs, M_IMGDATA->m_width);
+
+    const BilinearResampler resampler(*this, ret_image, vPrecalcs, hPrecalcs);
+    ProcessRowsInParallel(resampler, height, size_t(width)*height);
+
     return ret_image;
 }
 
@@ -924,6 +1421,170 @@ void ResampleBicubicPrecalc(wxVector<BicubicPrecalc> &aWeight, int oldDim)
     }
 }
 
+// Bicubic resampler: as the B-spline kernel is separable, the source rows are
+// first resampled horizontally and then combined vertically. This gives the
+// same results as applying the 4x4 kernel to each pixel, up to the rounding
+// errors, while requiring only 8 multiplications per pixel instead of 16.
+class BicubicResampler : public RowsProcessor
+{
+public:
+    BicubicResampler(const wxImage& src,
+                     wxImage& dst,
+                     const wxVector<BicubicPrecalc>& vPrecalcs,
+                     const wxVector<BicubicPrecalc>& hPrecalcs)
+        : m_srcData(src.GetData()),
+          m_srcAlpha(src.GetAlpha()),
+          m_srcWidth(src.GetWidth()),
+          m_dstData(dst.GetData()),
+          m_dstAlpha(dst.GetAlpha()),
+          m_dstWidth(dst.GetWidth()),
+          m_vPrecalcs(vPrecalcs),
+          m_hPrecalcs(hPrecalcs)
+    {
+    }
+
+    virtual void ProcessRows(int start, int end) const wxOVERRIDE
+    {
+        // Each row contains the RGB values followed by alpha ones, if any.
+        // Notice that, when using alpha, RGB values are premultiplied by it.
+        const size_t numValues = size_t(m_dstWidth)*3;
+        const size_t rowSize = m_srcAlpha ? numValues + m_dstWidth : numValues;
+        ResampledRowsCache cache(4, rowSize);
+
+        wxVector<double> sums(rowSize);
+
+        for ( int y = start; y < end; y++ )
+        {
+            const BicubicPrecalc& vPrecalc = m_vPrecalcs[y];
+
+            const double* lines[4];
+            for ( int k = 0; k < 4; k++ )
+                lines[k] = cache.GetRow(vPrecalc.offset[k], vPrecalc.offset, 4, *this);
+
+            const double w0 = vPrecalc.weight[0],
+                         w1 = vPrecalc.weight[1],
+                         w2 = vPrecalc.weight[2],
+                         w3 = vPrecalc.weight[3];
+            for ( size_t n = 0; n < rowSize; n++ )
+            {
+                sums[n] = lines[0][n] * w0 + lines[1][n] * w1 +
+                            lines[2][n] * w2 + lines[3][n] * w3;
+            }
+
+            // Put the data into the destination image.  The summed values are
+            // of double data type and are rounded here for accuracy
+            unsigned char* dst_data = m_dstData + size_t(y)*numValues;
+            const double* sum = &sums[0];
+            if ( m_dstAlpha )
+            {
+                unsigned char* const
+                    dst_alpha = m_dstAlpha + size_t(y)*m_dstWidth;
+                const double* const sum_alpha = sum + numValues;
+
+                for ( int x = 0; x < m_dstWidth; x++ )
+                {
+                    const double sum_a = sum_alpha[x];
+                    if ( sum_a )
+                    {
+                         dst_data[0] = (unsigned char)(sum[0] / sum_a + 0.5);
+                         dst_data[1] = (unsigned char)(sum[1] / sum_a + 0.5);
+                         dst_data[2] = (unsigned char)(sum[2] / sum_a + 0.5);
+                    }
+                    else
+                    {
+                        dst_data[0] = 0;
+                        dst_data[1] = 0;
+                        dst_data[2] = 0;
+                    }
+                    dst_alpha[x] = (unsigned char)sum_a;
+
+                    dst_data += 3;
+                    sum += 3;
+                }
+            }
+            else
+            {
+                for ( size_t n = 0; n < numValues; n++ )
+                    dst_data[n] = (unsigned char)(sum[n] + 0.5);
+            }
+        }
+    }
+
+    // Apply the horizontal part of the kernel to the given source row.
+    void ResampleRow(int row, double* line) const
+    {
+        const unsigned char* const
+            src_data = m_srcData + size_t(row)*m_srcWidth*3;
+
+        if ( m_srcAlpha )
+        {
+            const unsigned char* const
+                src_alpha = m_srcAlpha + size_t(row)*m_srcWidth;
+            double* const line_alpha = line + size_t(m_dstWidth)*3;
+
+            for ( int x = 0; x < m_dstWidth; x++ )
+            {
+                const BicubicPrecalc& hPrecalc = m_hPrecalcs[x];
+
+                double sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
+                for ( int i = 0; i < 4; i++ )
+                {
+                    const int x_offset = hPrecalc.offset[i];
+                    const double
+                        pixel_weight = hPrecalc.weight[i] * src_alpha[x_offset];
+
+                    sum_r += src_data[x_offset * 3 + 0] * pixel_weight;
+                    sum_g += src_data[x_offset * 3 + 1] * pixel_weight;
+                    sum_b += src_data[x_offset * 3 + 2] * pixel_weight;
+                    sum_a += pixel_weight;
+                }
+
+                line[0] = sum_r;
+                line[1] = sum_g;
+                line[2] = sum_b;
+                line += 3;
+
+                line_alpha[x] = sum_a;
+            }
+        }
+        else
+        {
+            for ( int x = 0; x < m_dstWidth; x++ )
+            {
+                const BicubicPrecalc& hPrecalc = m_hPrecalcs[x];
+
+                double sum_r = 0, sum_g = 0, sum_b = 0;
+                for ( int i = 0; i < 4; i++ )
+                {
+                    const int x_offset = hPrecalc.offset[i];
+                    const double pixel_weight = hPrecalc.weight[i];
+
+                    sum_r += src_data[x_offset * 3 + 0] * pixel_weight;
+                    sum_g += src_data[x_offset * 3 + 1] * pixel_weight;
+                    sum_b += src_data[x_offset * 3 + 2] * pixel_weight;
+                }
+
+                line[0] = sum_r;
+                line[1] = sum_g;
+                line[2] = sum_b;
+                line += 3;
+            }
+        }
+    }
+
+private:
+    const unsigned char* const m_srcData;
+    const unsigned char* const m_srcAlpha;
+    const int m_srcWidth;
+    unsigned char* const m_dstData;
+    unsigned char* const m_dstAlpha;
+    const int m_dstWidth;
+    const wxVector<BicubicPrecalc>& m_vPrecalcs;
+    const wxVector<BicubicPrecalc>& m_hPrecalcs;
+
+    wxDECLARE_NO_COPY_CLASS(BicubicResampler);
+};
+
 } // anonymous namespace
 
 // This is the bicubic resampling algorithm
@@ -959,208 +1620,274 @@ wxImage wxImage::ResampleBicubic(int width, int height) const
 
     ret_image.Create(width, height, false);
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_data = ret_image.GetData();
-    unsigned char* dst_alpha = NULL;
+    if ( M_IMGDATA->m_alpha )
+        ret_image.SetAlpha();
+
+    // Precalculate weights
+    wxVector<BicubicPrecalc> vPrecalcs(height);
+    wxVector<BicubicPrecalc> hPrecalcs(width);
 
-    if ( src_alpha )
+    ResampleBicubicPrecalc(vPrecalcs, M_IMGDATA->m_height);
+    ResampleBicubicPrecalc(hPrecalcs, M_IMGDATA->m_width);
+
+    const BicubicResampler resampler(*this, ret_image, vPrecalcs, hPrecalcs);
+    ProcessRowsInParallel(resampler, height, size_t(width)*height*4);
+
+    return ret_image;
+}
+
+namespace
+{
+
+// The maximal supported blur radius: this limit ensures that BoxBlurDivider
+// below gives exact results and is big enough to not matter in practice.
+const int MAX_BLUR_RADIUS = 0x7fff;
+
+bool IsValidBlurRadius(int radius)
+{
+    return radius >= 0 && radius <= MAX_BLUR_RADIUS;
+}
+
+// Divides the sums of the pixel values by the number of pixels in the box
+// using multiplication by the reciprocal instead of the much slower integer
+// division. This gives exactly the same result as the division as long as
+// the product of the sum and the divisor is less than 2^40, which is the case
+// for all boxes of up to 2^16 pixels, as the sum is less than 256 times the
+// number of pixels.
+class BoxBlurDivider
+{
+public:
+    BoxBlurDivider(int area, bool round)
+        : m_bias(round ? area / 2 : 0),
+          m_mul((wxUint64(1) << 40) / area + 1)
+    {
+    }
+
+    unsigned char operator()(wxUint32 sum) const
+    {
+        return static_cast<unsigned char>(((sum + m_bias)*m_mul) >> 40);
+    }
+
+private:
+    const wxUint32 m_bias;
+    const wxUint64 m_mul;
+};
+
+// Average all pixels in the specified radius in the horizontal direction,
+// duplicating the pixels at the edges of the row.
+//
+// The template parameter is the number of channels, 3 for the RGB data and 1
+// for alpha.
+template <int N>
+class HorizontalBoxBlur : public RowsProcessor
+{
+public:
+    HorizontalBoxBlur(const unsigned char* src, unsigned char* dst,
+                      int width, int radius, bool round)
+        : m_src(src),
+          m_dst(dst),
+          m_width(width),
+          m_radius(radius),
+          m_divide(2*radius + 1, round)
+    {
+    }
+
+    virtual void ProcessRows(int start, int end) const wxOVERRIDE
+    {
+        const int last = m_width - 1;
+        const int numInside = wxMin(m_radius, last);
+
+        for ( int y = start; y < end; y++ )
+        {
+            const unsigned char* const src = m_src + size_t(y)*m_width*N;
+            unsigned char* dst = m_dst + size_t(y)*m_width*N;
+
+            // Compute the sums for the first pixel of the row: the box
+            // contains radius + 1 copies of the first pixel, the pixels inside
+            // the row and, if the radius is bigger than the row, the copies of
+            // the last pixel.
+            wxUint32 sums[N];
+            for ( int c = 0; c < N; c++ )
+            {
+                sums[c] = (m_radius + 1)*src[c] +
+                            (m_radius - numInside)*src[last*N + c];
+                for ( int x = 1; x <= numInside; x++ )
+                    sums[c] += src[x*N + c];
+            }
+
+            // Now move the box along the row.
+            for ( int x = 0; x < m_width; x++ )
+            {
+                const unsigned char* const
+                    add = src + wxMin(x + m_radius + 1, last)*N;
+                const unsigned char* const
+                    sub = src + wxMax(x - m_radius, 0)*N;
+
+                for ( int c = 0; c < N; c++ )
+                {
+                    *dst++ = m_divide(sums[c]);
+                    sums[c] += add[c];
+                    sums[c] -= sub[c];
+                }
+            }
+        }
+    }
+
+private:
+    const unsigned char* const m_src;
+    unsigned char* const m_dst;
+    const int m_width;
+    const int m_radius;
+    const BoxBlurDivider m_divide;
+
+    wxDECLARE_NO_COPY_TEMPLATE_CLASS(HorizontalBoxBlur, N);
+};
+
+// Average all pixels in the specified radius in the vertical direction,
+// duplicating the pixels at the top and bottom edges.
+//
+// Instead of going down each column, which would access memory with a stride
+// of the entire row, this keeps the sums for all the columns and updates them
+// by adding the next row and subtracting the previous one, so that all the
+// loops access memory sequentially and can be vectorized by the compiler.
+class VerticalBoxBlur : public RowsProcessor
+{
+public:
+    // Notice that the row size is given in bytes, i.e. width*3 for RGB data.
+    VerticalBoxBlur(const unsigned char* src, unsigned char* dst,
+                    size_t rowSize, int height, int radius, bool round)
+        : m_src(src),
+          m_dst(dst),
+          m_rowSize(rowSize),
+          m_height(height),
+          m_radius(radius),
+          m_divide(2*radius + 1, round)
     {
-        ret_image.SetAlpha();
-        dst_alpha = ret_image.GetAlpha();
     }
 
-    // Precalculate weights
-    wxVector<BicubicPrecalc> vPrecalcs(height);
-    wxVector<BicubicPrecalc> hPrecalcs(width);
-
-    ResampleBicubicPrecalc(vPrecalcs, M_IMGDATA->m_height);
-    ResampleBicubicPrecalc(hPrecalcs, M_IMGDATA->m_width);
-
-    for ( int dsty = 0; dsty < height; dsty++ )
+    virtual void ProcessRows(int start, int end) const wxOVERRIDE
     {
-        // We need to calculate the source pixel to interpolate from - Y-axis
-        const BicubicPrecalc& vPrecalc = vPrecalcs[dsty];
+        const int last = m_height - 1;
 
-        for ( int dstx = 0; dstx < width; dstx++ )
+        // Initialize the sums for the first row of this range.
+        wxVector<wxUint32> sumsBuf(m_rowSize, 0);
+        wxUint32* const sums = &sumsBuf[0];
+        for ( int k = start - m_radius; k <= start + m_radius; k++ )
         {
-            // X-axis of pixel to interpolate from
-            const BicubicPrecalc& hPrecalc = hPrecalcs[dstx];
+            const unsigned char* const row = GetRow(wxMin(wxMax(k, 0), last));
+            for ( size_t i = 0; i < m_rowSize; i++ )
+                sums[i] += row[i];
+        }
 
-            // Sums for each color channel
-            double sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
+        // Output the row and update the sums for the next one at once. This
+        // needlessly updates them after the last row too, but avoids having
+        // to check for it in the loop.
+        for ( int y = start; y < end; y++ )
+        {
+            unsigned char* const dst = m_dst + y*m_rowSize;
+            const unsigned char* const
+                add = GetRow(wxMin(y + m_radius + 1, last));
+            const unsigned char* const
+                sub = GetRow(wxMax(y - m_radius, 0));
 
-            // Here we actually determine the RGBA values for the destination pixel
-            for ( int k = -1; k <= 2; k++ )
+            for ( size_t i = 0; i < m_rowSize; i++ )
             {
-                // Y offset
-                const int y_offset = vPrecalc.offset[k + 1];
+                dst[i] = m_divide(sums[i]);
+                sums[i] += add[i] - sub[i];
+            }
+        }
+    }
 
-                // Loop across the X axis
-                for ( int i = -1; i <= 2; i++ )
-                {
-                    // X offset
-                    const int x_offset = hPrecalc.offset[i + 1];
+private:
+    const unsigned char* GetRow(int y) const
+    {
+        return m_src + y*m_rowSize;
+    }
 
-                    // Calculate the exact position where the source data
-                    // should be pulled from based on the x_offset and y_offset
-                    int src_pixel_index = y_offset*M_IMGDATA->m_width + x_offset;
+    const unsigned char* const m_src;
+    unsigned char* const m_dst;
+    const size_t m_rowSize;
+    const int m_height;
+    const int m_radius;
+    const BoxBlurDivider m_divide;
 
-                    // Calculate the weight for the specified pixel according
-                    // to the bicubic b-spline kernel we're using for
-                    // interpolation
-                    const double
-                        pixel_weight = vPrecalc.weight[k + 1] * hPrecalc.weight[i + 1];
+    wxDECLARE_NO_COPY_CLASS(VerticalBoxBlur);
+};
 
-                    // Create a sum of all velues for each color channel
-                    // adjusted for the pixel's calculated weight
-                    if ( src_alpha )
-                    {
-                        const unsigned char a = src_alpha[src_pixel_index];
-                        sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight * a;
-                        sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight * a;
-                        sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight * a;
-                        sum_a += a * pixel_weight;
-                    }
-                    else
-                    {
-                        sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight;
-                        sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight;
-                        sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight;
-                    }
-                }
-            }
+// Perform a single box blur pass from the source image into the destination
+// one which must have the same size and alpha channel presence.
+void DoBoxBlur(const wxImage& src, wxImage& dst, int radius,
+               wxOrientation orient, bool round = false)
+{
+    const int width = src.GetWidth();
+    const int height = src.GetHeight();
+    const size_t work = size_t(width)*height;
 
-            // Put the data into the destination image.  The summed values are
-            // of double data type and are rounded here for accuracy
-            if ( src_alpha )
-            {
-                if ( sum_a )
-                {
-                     dst_data[0] = (unsigned char)(sum_r / sum_a + 0.5);
-                     dst_data[1] = (unsigned char)(sum_g / sum_a + 0.5);
-                     dst_data[2] = (unsigned char)(sum_b / sum_a + 0.5);
-                }
-                else
-                {
-                    dst_data[0] = 0;
-                    dst_data[1] = 0;
-                    dst_data[2] = 0;
-                }
-                *dst_alpha++ = (unsigned char)sum_a;
-            }
-            else
-            {
-                dst_data[0] = (unsigned char)(sum_r + 0.5);
-                dst_data[1] = (unsigned char)(sum_g + 0.5);
-                dst_data[2] = (unsigned char)(sum_b + 0.5);
-            }
-            dst_data += 3;
+    if ( orient == wxHORIZONTAL )
+    {
+        const HorizontalBoxBlur<3>
+            blurData(src.GetData(), dst.GetData(), width, radius, round);
+        ProcessRowsInParallel(blurData, height, work);
+
+        if ( src.HasAlpha() )
+        {
+            const HorizontalBoxBlur<1>
+                blurAlpha(src.GetAlpha(), dst.GetAlpha(), width, radius, round);
+            ProcessRowsInParallel(blurAlpha, height, work);
         }
     }
+    else // wxVERTICAL
+    {
+        const VerticalBoxBlur
+            blurData(src.GetData(), dst.GetData(), width*3, height, radius, round);
+        ProcessRowsInParallel(blurData, height, work);
 
-    return ret_image;
+        if ( src.HasAlpha() )
+        {
+            const VerticalBoxBlur
+                blurAlpha(src.GetAlpha(), dst.GetAlpha(), width, height, radius, round);
+            ProcessRowsInParallel(blurAlpha, height, work);
+        }
+    }
+}
+
+// Number of box blur passes used to approximate the Gaussian blur.
+const int GAUSSIAN_BOX_PASSES = 3;
+
+// Compute the radii of the box blurs which, applied in sequence, approximate
+// the Gaussian blur with the given standard deviation.
+//
+// This uses the algorithm from Peter Kovesi's "Fast Almost-Gaussian Filtering"
+// paper: the boxes of two consecutive odd sizes are chosen so that the
+// variance of their combination is as close to sigma^2 as possible.
+void GetGaussianBoxRadii(int sigma, int radii[GAUSSIAN_BOX_PASSES])
+{
+    const int n = GAUSSIAN_BOX_PASSES;
+    const double var12 = 12.0*sigma*sigma;
+
+    int wl = static_cast<int>(floor(sqrt(var12/n + 1)));
+    if ( wl % 2 == 0 )
+        wl--;
+
+    const int m = wxRound((var12 - n*wl*wl - 4*n*wl - 3*n)/(-4*wl - 4));
+
+    for ( int i = 0; i < n; i++ )
+        radii[i] = i < m ? (wl - 1) / 2 : (wl + 1) / 2;
 }
 
+} // anonymous namespace
+
 // Blur in the horizontal direction
 wxImage wxImage::BlurHorizontal(int blurRadius) const
 {
+    wxCHECK_MSG( IsValidBlurRadius(blurRadius), wxImage(),
+                 wxS("invalid blur radius") );
+
     wxImage ret_image(MakeEmptyClone());
 
     wxCHECK( ret_image.IsOk(), ret_image );
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    unsigned char* dst_data = ret_image.GetData();
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_alpha = ret_image.GetAlpha();
-
-    // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
-
-    // Horizontal blurring algorithm - average all pixels in the specified blur
-    // radius in the X or horizontal direction
-    for ( int y = 0; y < M_IMGDATA->m_height; y++ )
-    {
-        // Variables used in the blurring algorithm
-        long sum_r = 0,
-             sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
-
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
-
-        // Calculate the average of all pixels in the blur radius for the first
-        // pixel of the row
-        for ( int kernel_x = -blurRadius; kernel_x <= blurRadius; kernel_x++ )
-        {
-            // To deal with the pixels at the start of a row so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous row
-            if ( kernel_x < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = kernel_x + y * M_IMGDATA->m_width;
-
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-        }
-
-        dst = dst_data + y * M_IMGDATA->m_width*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
-        if ( src_alpha )
-            dst_alpha[y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
-
-        // Now average the values of the rest of the pixels by just moving the
-        // blur radius box along the row
-        for ( int x = 1; x < M_IMGDATA->m_width; x++ )
-        {
-            // Take care of edge pixels on the left edge by essentially
-            // duplicating the edge pixel
-            if ( x - blurRadius - 1 < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = (x - blurRadius - 1) + y * M_IMGDATA->m_width;
-
-            // Subtract the value of the pixel at the left side of the blur
-            // radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
-
-            // Take care of edge pixels on the right edge
-            if ( x + blurRadius > M_IMGDATA->m_width - 1 )
-                pixel_idx = M_IMGDATA->m_width - 1 + y * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + blurRadius + y * M_IMGDATA->m_width;
-
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-
-            // Save off the averaged data
-            dst = dst_data + x*3 + y*M_IMGDATA->m_width*3;
-            dst[0] = (unsigned char)(sum_r / blurArea);
-            dst[1] = (unsigned char)(sum_g / blurArea);
-            dst[2] = (unsigned char)(sum_b / blurArea);
-            if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
-        }
-    }
+    DoBoxBlur(*this, ret_image, blurRadius, wxHORIZONTAL);
 
     return ret_image;
 }
@@ -1168,117 +1895,52 @@ wxImage wxImage::BlurHorizontal(int blurRadius) const
 // Blur in the vertical direction
 wxImage wxImage::BlurVertical(int blurRadius) const
 {
+    wxCHECK_MSG( IsValidBlurRadius(blurRadius), wxImage(),
+                 wxS("invalid blur radius") );
+
     wxImage ret_image(MakeEmptyClone());
 
     wxCHECK( ret_image.IsOk(), ret_image );
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    unsigned char* dst_data = ret_image.GetData();
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_alpha = ret_image.GetAlpha();
-
-    // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
-
-    // Vertical blurring algorithm - same as horizontal but switched the
-    // opposite direction
-    for ( int x = 0; x < M_IMGDATA->m_width; x++ )
-    {
-        // Variables used in the blurring algorithm
-        long sum_r = 0,
-             sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
-
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
-
-        // Calculate the average of all pixels in our blur radius box for the
-        // first pixel of the column
-        for ( int kernel_y = -blurRadius; kernel_y <= blurRadius; kernel_y++ )
-        {
-            // To deal with the pixels at the start of a column so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous column
-            if ( kernel_y < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + kernel_y * M_IMGDATA->m_width;
-
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-        }
-
-        dst = dst_data + x*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
-        if ( src_alpha )
-            dst_alpha[x] = (unsigned char)(sum_a / blurArea);
-
-        // Now average the values of the rest of the pixels by just moving the
-        // box along the column from top to bottom
-        for ( int y = 1; y < M_IMGDATA->m_height; y++ )
-        {
-            // Take care of pixels that would be beyond the top edge by
-            // duplicating the top edge pixel for the column
-            if ( y - blurRadius - 1 < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + (y - blurRadius - 1) * M_IMGDATA->m_width;
-
-            // Subtract the value of the pixel at the top of our blur radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
-
-            // Take care of the pixels that would be beyond the bottom edge of
-            // the image similar to the top edge
-            if ( y + blurRadius > M_IMGDATA->m_height - 1 )
-                pixel_idx = x + (M_IMGDATA->m_height - 1) * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + (blurRadius + y) * M_IMGDATA->m_width;
-
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-
-            // Save off the averaged data
-            dst = dst_data + (x + y * M_IMGDATA->m_width) * 3;
-            dst[0] = (unsigned char)(sum_r / blurArea);
-            dst[1] = (unsigned char)(sum_g / blurArea);
-            dst[2] = (unsigned char)(sum_b / blurArea);
-            if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
-        }
-    }
+    DoBoxBlur(*this, ret_image, blurRadius, wxVERTICAL);
 
     return ret_image;
 }
 
 // The new blur function
-wxImage wxImage::Blur(int blurRadius) const
+wxImage wxImage::Blur(int blurRadius, wxImageBlurMode mode) const
 {
-    wxImage ret_image;
-    ret_image.Create(M_IMGDATA->m_width, M_IMGDATA->m_height, false);
+    wxCHECK_MSG( IsValidBlurRadius(blurRadius), wxImage(),
+                 wxS("invalid blur radius") );
+
+    if ( mode == wxIMAGE_BLUR_BOX )
+    {
+        // Blur the image in each direction
+        return BlurHorizontal(blurRadius).BlurVertical(blurRadius);
+    }
 
-    // Blur the image in each direction
-    ret_image = BlurHorizontal(blurRadius);
-    ret_image = ret_image.BlurVertical(blurRadius);
+    int radii[GAUSSIAN_BOX_PASSES];
+    GetGaussianBoxRadii(blurRadius, radii);
 
-    return ret_image;
+    // Apply all the horizontal passes and then all the vertical ones, using
+    // just two buffers alternately. Unlike in the simple box blur, the
+    // results of the intermediate passes are rounded rather than truncated
+    // to avoid darkening the image by accumulating truncation errors.
+    wxImage images[2] = { MakeEmptyClone(), MakeEmptyClone() };
+
+    wxCHECK( images[0].IsOk() && images[1].IsOk(), wxImage() );
+
+    const wxImage* src = this;
+    int n = 0;
+    for ( int pass = 0; pass < 2*GAUSSIAN_BOX_PASSES; pass++, n = 1 - n )
+    {
+        DoBoxBlur(*src, images[n], radii[pass % GAUSSIAN_BOX_PASSES],
+                  pass < GAUSSIAN_BOX_PASSES ? wxHORIZONTAL : wxVERTICAL,
+                  true /* round */);
+        src = &images[n];
+    }
+
+    return *src;
 }
 
 wxImage wxImage::Rotate90( bool clockwise ) const
@@ -1557,6 +2219,55 @@ wxImage wxImage::GetSubImage( const wxRect &rect ) const
     return image;
 }
 
+namespace
+{
+
+// Keeps the image whose rows are used by the view returned by GetRowsView()
+// alive as long as the view itself exists.
+class wxImageViewReleaser : public wxImageDataReleaser
+{
+public:
+    explicit wxImageViewReleaser(const wxImage& image) : m_image(image) { }
+
+    virtual void Release(unsigned char* WXUNUSED(data),
+                         unsigned char* WXUNUSED(alpha)) wxOVERRIDE
+    {
+        // Nothing to do, the image reference is released by our dtor.
+    }
+
+private:
+    const wxImage m_image;
+};
+
+} // anonymous namespace
+
+wxImage wxImage::GetRowsView( int y, int height ) const
+{
+    wxImage image;
+
+    wxCHECK_MSG( IsOk(), image, wxT("invalid image") );
+
+    wxCHECK_MSG( y >= 0 && height > 0 && y + height <= GetHeight(),
+                 image, wxT("invalid rows range") );
+
+    // As the rows are stored contiguously, the view can just point into the
+    // data of this image, which must be kept alive while it's used.
+    const int width = GetWidth();
+    const long offset = long(y) * width;
+
+    unsigned char* const
+        alpha = M_IMGDATA->m_alpha ? M_IMGDATA->m_alpha + offset : NULL;
+
+    image.CreateFromExternal(width, height,
+                             M_IMGDATA->m_data + 3 * offset, alpha,
+                             new wxImageViewReleaser(*this));
+
+    if (M_IMGDATA->m_hasMask)
+        image.SetMaskColour( M_IMGDATA->m_maskRed, M_IMGDATA->m_maskGreen, M_IMGDATA->m_maskBlue );
+
+    return image;
+}
+
 wxImage wxImage::Size( const wxSize& size, const wxPoint& pos,
                        int r_, int g_, int b_ ) const
 {
@@ -2090,80 +2801,350 @@ wxImage::ConvertColourToAlpha(unsigned char r, unsigned char g, unsigned char b)
         }
     }
 
-    return true;
-}
+    return true;
+}
+
+void wxImage::SetAlpha( unsigned char *alpha, bool static_data )
+{
+    wxCHECK_RET( IsOk(), wxT("invalid image") );
+
+    AllocExclusive();
+
+    if ( !alpha )
+    {
+        alpha = (unsigned char *)malloc(M_IMGDATA->m_width*M_IMGDATA->m_height);
+    }
+
+    if( !M_IMGDATA->m_staticAlpha )
+        free(M_IMGDATA->m_alpha);
+
+    M_IMGDATA->m_alpha = alpha;
+    M_IMGDATA->m_staticAlpha = static_data;
+}
+
+unsigned char *wxImage::GetAlpha() const
+{
+    wxCHECK_MSG( IsOk(), (unsigned char *)NULL, wxT("invalid image") );
+
+    return M_IMGDATA->m_alpha;
+}
+
+void wxImage::InitAlpha()
+{
+    wxCHECK_RET( !HasAlpha(), wxT("image already has an alpha channel") );
+
+    // initialize memory for alpha channel
+    SetAlpha();
+
+    unsigned char *alpha = M_IMGDATA->m_alpha;
+    const size_t lenAlpha = M_IMGDATA->m_width * M_IMGDATA->m_height;
+
+    if ( HasMask() )
+    {
+        // use the mask to initialize the alpha channel.
+        const unsigned char * const alphaEnd = alpha + lenAlpha;
+
+        const unsigned char mr = M_IMGDATA->m_maskRed;
+        const unsigned char mg = M_IMGDATA->m_maskGreen;
+        const unsigned char mb = M_IMGDATA->m_maskBlue;
+        for ( unsigned char *src = M_IMGDATA->m_data;
+              alpha < alphaEnd;
+              src += 3, alpha++ )
+        {
+            *alpha = (src[0] == mr && src[1] == mg && src[2] == mb)
+                            ? wxIMAGE_ALPHA_TRANSPARENT
+                            : wxIMAGE_ALPHA_OPAQUE;
+        }
+
+        M_IMGDATA->m_hasMask = false;
+    }
+    else // no mask
+    {
+        // make the image fully opaque
+        memset(alpha, wxIMAGE_ALPHA_OPAQUE, lenAlpha);
+    }
+}
+
+void wxImage::ClearAlpha()
+{
+    wxCHECK_RET( HasAlpha(), wxT("image already doesn't have an alpha channel") );
+
+    AllocExclusive();
+
+    if ( !M_IMGDATA->m_staticAlpha )
+        free( M_IMGDATA->m_alpha );
+
+    M_IMGDATA->m_alpha = NULL;
+}
+
+// ----------------------------------------------------------------------------
+// interleaved pixels support
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Notice that the colour of fully transparent pixels is preserved by both of
+// these functions, so that exporting and importing the image back is lossless
+// for them.
+inline unsigned char PremultiplyAlpha(unsigned char alpha, unsigned char c)
+{
+    if ( !alpha )
+        return c;
+
+    // This is exactly the same as (c*alpha)/255, but avoids the division.
+    const unsigned t = c*alpha;
+    return static_cast<unsigned char>((t + 1 + (t >> 8)) >> 8);
+}
+
+// Return the reciprocal of alpha in 16.16 fixed point format, such that
+// (c*reciprocal) >> 16 is exactly the same as (c*255)/alpha for c <= alpha.
+inline unsigned GetAlphaReciprocal(unsigned char alpha)
+{
+    return alpha ? (255*65536 + alpha - 1)/alpha : 0;
+}
+
+inline unsigned char UnpremultiplyAlpha(unsigned char alpha,
+                                        unsigned reciprocal,
+                                        unsigned char c)
+{
+    if ( !alpha )
+        return c;
+
+    // Valid premultiplied colour components can't exceed alpha, but check
+    // for it anyhow to avoid overflowing.
+    const unsigned t = (c*reciprocal) >> 16;
+    return static_cast<unsigned char>(t < 0xff ? t : 0xff);
+}
+
+// Base class for PixelsExporter and PixelsImporter containing their common
+// parameters.
+class PixelsConverterBase : public RowsProcessor
+{
+protected:
+    PixelsConverterBase(const wxImage& image, int stride, int flags)
+        : m_width(image.GetWidth()),
+          m_data(image.GetData()),
+          m_alpha(flags & wxIMAGE_PIXEL_NO_ALPHA ? NULL : image.GetAlpha()),
+          m_stride(stride),
+          m_premultiplied((flags & wxIMAGE_PIXEL_PREMULTIPLIED) != 0)
+    {
+    }
+
+    unsigned char* GetRowData(int y) const
+    {
+        return m_data + 3*static_cast<size_t>(m_width)*y;
+    }
+
+    unsigned char* GetRowAlpha(int y) const
+    {
+        return m_alpha + static_cast<size_t>(m_width)*y;
+    }
+
+    const int m_width;
+    unsigned char* const m_data;
+    unsigned char* const m_alpha;
+    const int m_stride;
+    const bool m_premultiplied;
+};
+
+// Copy the image to the buffer with the colour and alpha components at the
+// given offsets in each pixel.
+template <int R, int G, int B, int A>
+class PixelsExporter : public PixelsConverterBase
+{
+public:
+    PixelsExporter(const wxImage& image,
+                   unsigned char* buffer,
+                   int stride,
+                   int flags)
+        : PixelsConverterBase(image, stride, flags),
+          m_buffer(buffer)
+    {
+    }
+
+    virtual void ProcessRows(int start, int end) const wxOVERRIDE
+    {
+        for ( int y = start; y < end; y++ )
+        {
+            const unsigned char* src = GetRowData(y);
+            unsigned char* dst = m_buffer + static_cast<ptrdiff_t>(m_stride)*y;
+
+            if ( !m_alpha )
+            {
+                for ( int x = 0; x < m_width; x++, src += 3, dst += 4 )
+                {
+                    dst[R] = src[0];
+                    dst[G] = src[1];
+                    dst[B] = src[2];
+                    dst[A] = wxIMAGE_ALPHA_OPAQUE;
+                }
+            }
+            else if ( m_premultiplied )
+            {
+                const unsigned char* alpha = GetRowAlpha(y);
+                for ( int x = 0; x < m_width; x++, src += 3, dst += 4 )
+                {
+                    const unsigned char a = *alpha++;
+                    dst[R] = PremultiplyAlpha(a, src[0]);
+                    dst[G] = PremultiplyAlpha(a, src[1]);
+                    dst[B] = PremultiplyAlpha(a, src[2]);
+                    dst[A] = a;
+                }
+            }
+            else
+            {
+                const unsigned char* alpha = GetRowAlpha(y);
+                for ( int x = 0; x < m_width; x++, src += 3, dst += 4 )
+                {
+                    dst[R] = src[0];
+                    dst[G] = src[1];
+                    dst[B] = src[2];
+                    dst[A] = *alpha++;
+                }
+            }
+        }
+    }
+
+private:
+    unsigned char* const m_buffer;
+};
+
+// Copy the pixels from the buffer to the image, this is the inverse of
+// PixelsExporter.
+template <int R, int G, int B, int A>
+class PixelsImporter : public PixelsConverterBase
+{
+public:
+    PixelsImporter(const wxImage& image,
+                   const unsigned char* buffer,
+                   int stride,
+                   int flags)
+        : PixelsConverterBase(image, stride, flags),
+          m_buffer(buffer)
+    {
+    }
+
+    virtual void ProcessRows(int start, int end) const wxOVERRIDE
+    {
+        for ( int y = start; y < end; y++ )
+        {
+            const unsigned char* src = m_buffer + static_cast<ptrdiff_t>(m_stride)*y;
+            unsigned char* dst = GetRowData(y);
+
+            if ( !m_alpha )
+            {
+                for ( int x = 0; x < m_width; x++, src += 4, dst += 3 )
+                {
+                    dst[0] = src[R];
+                    dst[1] = src[G];
+                    dst[2] = src[B];
+                }
+            }
+            else if ( m_premultiplied )
+            {
+                unsigned char* alpha = GetRowAlpha(y);
+                for ( int x = 0; x < m_width; x++, src += 4, dst += 3 )
+                {
+                    const unsigned char a = src[A];
+                    const unsigned reciprocal = GetAlphaReciprocal(a);
+                    dst[0] = UnpremultiplyAlpha(a, reciprocal, src[R]);
+                    dst[1] = UnpremultiplyAlpha(a, reciprocal, src[G]);
+                    dst[2] = UnpremultiplyAlpha(a, reciprocal, src[B]);
+                    *alpha++ = a;
+                }
+            }
+            else
+            {
+                unsigned char* alpha = GetRowAlpha(y);
+                for ( int x = 0; x < m_width; x++, src += 4, dst += 3 )
+                {
+                    dst[0] = src[R];
+                    dst[1] = src[G];
+                    dst[2] = src[B];
+                    *alpha++ = src[A];
+                }
+            }
+        }
+    }
+
+private:
+    const unsigned char* const m_buffer;
+};
 
-void wxImage::SetAlpha( unsigned char *alpha, bool static_data )
+// Convert the image pixels from or to the buffer using the given converter
+// template, PixelsExporter or PixelsImporter, instantiated for the format.
+template <template <int, int, int, int> class Converter, typename T>
+void ConvertPixels(const wxImage& image,
+                   T* buffer,
+                   int stride,
+                   wxImagePixelFormat format,
+                   int flags)
 {
-    wxCHECK_RET( IsOk(), wxT("invalid image") );
-
-    AllocExclusive();
+    const int height = image.GetHeight();
+    const size_t work = static_cast<size_t>(image.GetWidth())*height;
 
-    if ( !alpha )
+    switch ( format )
     {
-        alpha = (unsigned char *)malloc(M_IMGDATA->m_width*M_IMGDATA->m_height);
-    }
+        case wxIMAGE_PIXEL_RGBA:
+            ProcessRowsInParallel(Converter<0, 1, 2, 3>(image, buffer, stride, flags),
+                                  height, work);
+            break;
 
-    if( !M_IMGDATA->m_staticAlpha )
-        free(M_IMGDATA->m_alpha);
+        case wxIMAGE_PIXEL_BGRA:
+            ProcessRowsInParallel(Converter<2, 1, 0, 3>(image, buffer, stride, flags),
+                                  height, work);
+            break;
 
-    M_IMGDATA->m_alpha = alpha;
-    M_IMGDATA->m_staticAlpha = static_data;
+        case wxIMAGE_PIXEL_ARGB32:
+#ifdef WORDS_BIGENDIAN
+            ProcessRowsInParallel(Converter<1, 2, 3, 0>(image, buffer, stride, flags),
+                                  height, work);
+#else
+            ProcessRowsInParallel(Converter<2, 1, 0, 3>(image, buffer, stride, flags),
+                                  height, work);
+#endif
+            break;
+    }
 }
 
-unsigned char *wxImage::GetAlpha() const
-{
-    wxCHECK_MSG( IsOk(), (unsigned char *)NULL, wxT("invalid image") );
-
-    return M_IMGDATA->m_alpha;
-}
+} // anonymous namespace
 
-void wxImage::InitAlpha()
+bool wxImage::ExportPixels(void *buffer,
+                           int stride,
+                           wxImagePixelFormat format,
+                           int flags) const
 {
-    wxCHECK_RET( !HasAlpha(), wxT("image already has an alpha channel") );
-
-    // initialize memory for alpha channel
-    SetAlpha();
-
-    unsigned char *alpha = M_IMGDATA->m_alpha;
-    const size_t lenAlpha = M_IMGDATA->m_width * M_IMGDATA->m_height;
+    wxCHECK_MSG( IsOk(), false, wxS("invalid image") );
+    wxCHECK_MSG( buffer, false, wxS("NULL buffer") );
+    wxCHECK_MSG( abs(stride) >= 4*GetWidth(), false, wxS("invalid stride") );
 
-    if ( HasMask() )
-    {
-        // use the mask to initialize the alpha channel.
-        const unsigned char * const alphaEnd = alpha + lenAlpha;
-
-        const unsigned char mr = M_IMGDATA->m_maskRed;
-        const unsigned char mg = M_IMGDATA->m_maskGreen;
-        const unsigned char mb = M_IMGDATA->m_maskBlue;
-        for ( unsigned char *src = M_IMGDATA->m_data;
-              alpha < alphaEnd;
-              src += 3, alpha++ )
-        {
-            *alpha = (src[0] == mr && src[1] == mg && src[2] == mb)
-                            ? wxIMAGE_ALPHA_TRANSPARENT
-                            : wxIMAGE_ALPHA_OPAQUE;
-        }
+    ConvertPixels<PixelsExporter>(*this, static_cast<unsigned char*>(buffer),
+                                  stride, format, flags);
 
-        M_IMGDATA->m_hasMask = false;
-    }
-    else // no mask
-    {
-        // make the image fully opaque
-        memset(alpha, wxIMAGE_ALPHA_OPAQUE, lenAlpha);
-    }
+    return true;
 }
 
-void wxImage::ClearAlpha()
+bool wxImage::ImportPixels(int width,
+                           int height,
+                           const void *buffer,
+                           int stride,
+                           wxImagePixelFormat format,
+                           int flags)
 {
-    wxCHECK_RET( HasAlpha(), wxT("image already doesn't have an alpha channel") );
+    wxCHECK_MSG( buffer, false, wxS("NULL buffer") );
+    wxCHECK_MSG( abs(stride) >= 4*width, false, wxS("invalid stride") );
 
-    AllocExclusive();
+    if ( !Create(width, height, false /* don't clear */) )
+        return false;
 
-    if ( !M_IMGDATA->m_staticAlpha )
-        free( M_IMGDATA->m_alpha );
+    if ( !(flags & wxIMAGE_PIXEL_NO_ALPHA) )
+        SetAlpha();
 
-    M_IMGDATA->m_alpha = NULL;
+    ConvertPixels<PixelsImporter>(*this, static_cast<const unsigned char*>(buffer),
+                                  stride, format, flags);
+
+    return true;
 }
 
 
@@ -2471,6 +3452,20 @@ int wxImage::GetDefaultLoadFlags()
     return wxImageRefData::sm_defaultLoadFlags;
 }
 
+/* static */
+void wxImage::SetMaxThreads(int numThreads)
+{
+    wxCHECK_RET( numThreads >= 0, wxS("invalid number of threads") );
+
+    gs_maxThreads = numThreads;
+}
+
+/* static */
+int wxImage::GetMaxThreads()
+{
+    return gs_maxThreads;
+}
+
 void wxImage::SetLoadFlags(int flags)
 {
     AllocExclusive();
@@ -2787,15 +3782,9 @@ bool wxImage::DoLoad(wxImageHandler& handler, wxInputStream& stream, int index)
         const unsigned widthOrig = GetWidth(),
                        heightOrig = GetHeight();
 
-        // this uses the same (trivial) algorithm as the JPEG handler
         unsigned width = widthOrig,
                  height = heightOrig;
-        while ( (maxWidth && width > maxWidth) ||
-                    (maxHeight && height > maxHeight) )
-        {
-            width /= 2;
-            height /= 2;
-        }
+        wxGetImageLoadSize(maxWidth, maxHeight, width, height);
 
         if ( width != widthOrig || height != heightOrig )
         {
@@ -2804,7 +3793,12 @@ bool wxImage::DoLoad(wxImageHandler& handler, wxInputStream& stream, int index)
             int widthOrigOption = GetOptionInt(wxIMAGE_OPTION_ORIGINAL_WIDTH),
                 heightOrigOption = GetOptionInt(wxIMAGE_OPTION_ORIGINAL_HEIGHT);
 
-            Rescale(width, height, wxIMAGE_QUALITY_HIGH);
+            // notice that we always shrink the image here, but we can't use
+            // wxIMAGE_QUALITY_HIGH because it would use bicubic resampling if
+            // one of the dimensions can't be shrunk as it's already 1, while
+            // the handlers scaling the image while loading it always use box
+            // averaging and we want to get the same results for all of them
+            Rescale(width, height, wxIMAGE_QUALITY_BOX_AVERAGE);
 
             SetOption(wxIMAGE_OPTION_ORIGINAL_WIDTH, widthOrigOption ? widthOrigOption : widthOrig);
             SetOption(wxIMAGE_OPTION_ORIGINAL_HEIGHT, heightOrigOption ? heightOrigOption : heightOrig);
@@ -3273,6 +4267,20 @@ void wxImage::RotateHue(double angle)
     }
 }
 
+//-----------------------------------------------------------------------------
+// wxImageRowsConsumer
+//-----------------------------------------------------------------------------
+
+bool
+wxImageRowsConsumer::ConsumeRows(int width, int firstRow, int numRows,
+                                 unsigned char* data, unsigned char* alpha)
+{
+    // Don't copy the data, it remains owned by the caller.
+    const wxImage rows(width, numRows, data, alpha, true /* static data */);
+
+    return OnRows(firstRow, rows);
+}
+
 //-----------------------------------------------------------------------------
 // wxImageHandler
 //-----------------------------------------------------------------------------
@@ -3339,6 +4347,37 @@ bool wxImageHandler::CallDoCanRead(wxInputStream& stream)
     return ok;
 }
 
+bool wxImageHandler::LoadRows(wxInputStream& stream,
+                              wxImageRowsConsumer& consumer,
+                              int bandHeight,
+                              bool verbose,
+                              int index)
+{
+    wxCHECK_MSG( bandHeight > 0, false, wxS("invalid band height") );
+
+    wxImage image;
+    if ( !LoadFile(&image, stream, verbose, index) )
+        return false;
+
+    const int width = image.GetWidth(),
+              height = image.GetHeight();
+    if ( !consumer.OnStart(width, height, image.HasAlpha()) )
+        return false;
+
+    unsigned char* const data = image.GetData();
+    unsigned char* const alpha = image.GetAlpha();
+    for ( int y = 0; y < height; y += bandHeight )
+    {
+        const size_t offset = static_cast<size_t>(y) * width;
+        if ( !consumer.ConsumeRows(width, y, wxMin(bandHeight, height - y),
+                                   data + 3*offset,
+                                   alpha ? alpha + offset : NULL) )
+            return false;
+    }
+
+    return true;
+}
+
 #endif // wxUSE_STREAMS
 
 /* static */
@@ -3508,8 +4547,6 @@ unsigned long wxImage::ComputeHistogram( wxImageHistogram &h ) const
  * Rotation code by Carlos Moreno
  */
 
-static const double wxROTATE_EPSILON = 1e-10;
-
 // Auxiliary function to rotate a point (x,y) with respect to point p0
 // make it inline and use a straight return to facilitate optimization
 // also, the function receives the sine and cosine of the angle to avoid
@@ -3531,6 +4568,239 @@ wxRotatePoint(double x, double y, double cos_angle, double sin_angle,
     return wxRotatePoint (wxRealPoint(x,y), cos_angle, sin_angle, p0);
 }
 
+namespace
+{
+
+// Helper of wxImage::Rotate() computing the rows of the rotated image.
+//
+// For each pixel of the rotated image, we find where it came from by
+// performing an inverse rotation. This is only done using floating point
+// for the first pixel of each row, the source coordinates for the subsequent
+// pixels are computed incrementally using fixed point arithmetic.
+class Rotator : public RowsProcessor
+{
+public:
+    // The position of the first pixel of the rotated image is given by
+    // (x0, y0) in the coordinates of the source image.
+    Rotator(const wxImage& src,
+            wxImage& dst,
+            int x0,
+            int y0,
+            const wxRealPoint& centre,
+            double cosAngle,
+            double sinAngle,
+            bool interpolating,
+            const unsigned char blank[3])
+        : m_srcData(src.GetData()),
+          m_srcAlpha(src.GetAlpha()),
+          m_srcWidth(src.GetWidth()),
+          m_srcHeight(src.GetHeight()),
+          m_dstData(dst.GetData()),
+          m_dstAlpha(dst.GetAlpha()),
+          m_dstWidth(dst.GetWidth()),
+          m_x0(x0),
+          m_y0(y0),
+          m_centre(centre),
+          m_cos(cosAngle),
+          m_sin(sinAngle),
+          m_dx(ToFixed(cosAngle)),
+          m_dy(ToFixed(-sinAngle)),
+          m_interpolating(interpolating)
+    {
+        memcpy(m_blank, blank, sizeof(m_blank));
+    }
+
+    virtual void ProcessRows(int start, int end) const wxOVERRIDE
+    {
+        for ( int y = start; y < end; y++ )
+        {
+            const wxRealPoint src = wxRotatePoint(m_x0, y + m_y0,
+                                                  m_cos, -m_sin, m_centre);
+
+            if ( m_interpolating )
+                InterpolateRow(y, ToFixed(src.x), ToFixed(src.y));
+            else
+                NearestRow(y, ToFixed(src.x), ToFixed(src.y));
+        }
+    }
+
+private:
+    // Fixed point numbers with 32 bit fractional part: this is enough to keep
+    // the accumulated error negligible even for very wide images.
+    typedef wxInt64 Fixed;
+
+    enum
+    {
+        FIXED_SHIFT = 32
+    };
+
+    static Fixed FixedOne() { return static_cast<Fixed>(1) << FIXED_SHIFT; }
+
+    static Fixed ToFixed(double value)
+    {
+        return static_cast<Fixed>(floor(value*FixedOne() + 0.5));
+    }
+
+    static unsigned char
+    Bilinear(unsigned p00, unsigned p01, unsigned p10, unsigned p11,
+             unsigned wx, unsigned wy)
+    {
+        const unsigned top = p00*(256 - wx) + p01*wx;
+        const unsigned bottom = p10*(256 - wx) + p11*wx;
+
+        return static_cast<unsigned char>((top*(256 - wy) + bottom*wy + 0x8000) >> 16);
+    }
+
+    unsigned char* GetDstData(int y) const
+    {
+        return m_dstData + 3*static_cast<size_t>(m_dstWidth)*y;
+    }
+
+    unsigned char* GetDstAlpha(int y) const
+    {
+        return m_dstAlpha ? m_dstAlpha + static_cast<size_t>(m_dstWidth)*y
+                          : NULL;
+    }
+
+    void NearestRow(int y, Fixed fx, Fixed fy) const
+    {
+        // The pixels whose coordinates round, away from zero, to a point
+        // inside the source image.
+        const Fixed half = FixedOne() / 2;
+        const Fixed maxX = m_srcWidth*FixedOne() - half,
+                    maxY = m_srcHeight*FixedOne() - half;
+
+        unsigned char* dst = GetDstData(y);
+        unsigned char* alpha = GetDstAlpha(y);
+
+        for ( int x = 0; x < m_dstWidth; x++, fx += m_dx, fy += m_dy )
+        {
+            if ( -half < fx && fx < maxX && -half < fy && fy < maxY )
+            {
+                const size_t
+                    offset = static_cast<size_t>((fy + half) >> FIXED_SHIFT)*m_srcWidth +
+                                static_cast<size_t>((fx + half) >> FIXED_SHIFT);
+
+                const unsigned char* const p = m_srcData + 3*offset;
+                *dst++ = p[0];
+                *dst++ = p[1];
+                *dst++ = p[2];
+
+                if ( alpha )
+                    *alpha++ = m_srcAlpha[offset];
+            }
+            else
+            {
+                *dst++ = m_blank[0];
+                *dst++ = m_blank[1];
+                *dst++ = m_blank[2];
+
+                if ( alpha )
+                    *alpha++ = wxIMAGE_ALPHA_OPAQUE;
+            }
+        }
+    }
+
+    void InterpolateRow(int y, Fixed fx, Fixed fy) const
+    {
+        // Interpolate the pixels not farther than a quarter of pixel from the
+        // source image, using its border pixels for the points outside of it.
+        const Fixed minXY = -FixedOne() / 4;
+        const Fixed maxX = m_srcWidth*FixedOne() - 3*FixedOne()/4,
+                    maxY = m_srcHeight*FixedOne() - 3*FixedOne()/4;
+
+        unsigned char* dst = GetDstData(y);
+        unsigned char* alpha = GetDstAlpha(y);
+
+        for ( int x = 0; x < m_dstWidth; x++, fx += m_dx, fy += m_dy )
+        {
+            if ( minXY < fx && fx < maxX && minXY < fy && fy < maxY )
+            {
+                // Coordinates may be slightly negative here, avoid shifting
+                // them by making them positive first.
+                const Fixed ux = fx + FixedOne(),
+                            uy = fy + FixedOne();
+
+                int x1 = static_cast<int>(ux >> FIXED_SHIFT) - 1,
+                    y1 = static_cast<int>(uy >> FIXED_SHIFT) - 1;
+                int x2 = x1 + 1,
+                    y2 = y1 + 1;
+
+                // Use the 8 most significant bits of the fractional part of
+                // the coordinates as the interpolation weights.
+                const unsigned wx = static_cast<unsigned>(ux >> (FIXED_SHIFT - 8)) & 0xff,
+                               wy = static_cast<unsigned>(uy >> (FIXED_SHIFT - 8)) & 0xff;
+
+                if ( x1 < 0 )
+                    x1 = 0;
+                if ( x2 >= m_srcWidth )
+                    x2 = m_srcWidth - 1;
+                if ( y1 < 0 )
+                    y1 = 0;
+                if ( y2 >= m_srcHeight )
+                    y2 = m_srcHeight - 1;
+
+                const size_t o11 = static_cast<size_t>(y1)*m_srcWidth + x1,
+                             o12 = static_cast<size_t>(y1)*m_srcWidth + x2,
+                             o21 = static_cast<size_t>(y2)*m_srcWidth + x1,
+                             o22 = static_cast<size_t>(y2)*m_srcWidth + x2;
+
+                const unsigned char* const p11 = m_srcData + 3*o11;
+                const unsigned char* const p12 = m_srcData + 3*o12;
+                const unsigned char* const p21 = m_srcData + 3*o21;
+                const unsigned char* const p22 = m_srcData + 3*o22;
+
+                *dst++ = Bilinear(p11[0], p12[0], p21[0], p22[0], wx, wy);
+                *dst++ = Bilinear(p11[1], p12[1], p21[1], p22[1], wx, wy);
+                *dst++ = Bilinear(p11[2], p12[2], p21[2], p22[2], wx, wy);
+
+                if ( alpha )
+                {
+                    *alpha++ = Bilinear(m_srcAlpha[o11], m_srcAlpha[o12],
+                                        m_srcAlpha[o21], m_srcAlpha[o22],
+                                        wx, wy);
+                }
+            }
+            else
+            {
+                *dst++ = m_blank[0];
+                *dst++ = m_blank[1];
+                *dst++ = m_blank[2];
+
+                if ( alpha )
+                    *alpha++ = wxIMAGE_ALPHA_TRANSPARENT;
+            }
+        }
+    }
+
+    const unsigned char* const m_srcData;
+    const unsigned char* const m_srcAlpha;
+    const int m_srcWidth,
+              m_srcHeight;
+
+    unsigned char* const m_dstData;
+    unsigned char* const m_dstAlpha;
+    const int m_dstWidth;
+
+    const int m_x0,
+              m_y0;
+    const wxRealPoint m_centre;
+    const double m_cos,
+                 m_sin;
+
+    // Increments of the source coordinates for each pixel of the row.
+    const Fixed m_dx,
+                m_dy;
+
+    const bool m_interpolating;
+
+    unsigned char m_blank[3];
+
+    wxDECLARE_NO_COPY_CLASS(Rotator);
+};
+
+} // anonymous namespace
+
 wxImage wxImage::Rotate(double angle,
                         const wxPoint& centre_of_rotation,
                         bool interpolating,
@@ -3539,29 +4809,9 @@ wxImage wxImage::Rotate(double angle,
     // screen coordinates are a mirror image of "real" coordinates
     angle = -angle;
 
-    const bool has_alpha = HasAlpha();
-
     const int w = GetWidth();
     const int h = GetHeight();
 
-    int i;
-
-    // Create pointer-based array to accelerate access to wxImage's data
-    unsigned char ** data = new unsigned char * [h];
-    data[0] = GetData();
-    for (i = 1; i < h; i++)
-        data[i] = data[i - 1] + (3 * w);
-
-    // Same for alpha channel
-    unsigned char ** alpha = NULL;
-    if (has_alpha)
-    {
-        alpha = new unsigned char * [h];
-        alpha[0] = GetAlpha();
-        for (i = 1; i < h; i++)
-            alpha[i] = alpha[i - 1] + w;
-    }
-
     // precompute coefficients for rotation formula
     const double cos_angle = cos(angle);
     const double sin_angle = sin(angle);
@@ -3585,7 +4835,7 @@ wxImage wxImage::Rotate(double angle,
     // Create rotated image
     wxImage rotated (x2a - x1a + 1, y2a - y1a + 1, false);
     // With alpha channel
-    if (has_alpha)
+    if (HasAlpha())
         rotated.SetAlpha();
 
     if (offset_after_rotation != NULL)
@@ -3593,218 +4843,25 @@ wxImage wxImage::Rotate(double angle,
         *offset_after_rotation = wxPoint (x1a, y1a);
     }
 
-    // the rotated (destination) image is always accessed sequentially via this
-    // pointer, there is no need for pointer-based arrays here
-    unsigned char *dst = rotated.GetData();
-
-    unsigned char *alpha_dst = has_alpha ? rotated.GetAlpha() : NULL;
-
     // if the original image has a mask, use its RGB values as the blank pixel,
     // else, fall back to default (black).
-    unsigned char blank_r = 0;
-    unsigned char blank_g = 0;
-    unsigned char blank_b = 0;
+    unsigned char blank[3] = { 0, 0, 0 };
 
     if (HasMask())
     {
-        blank_r = GetMaskRed();
-        blank_g = GetMaskGreen();
-        blank_b = GetMaskBlue();
-        rotated.SetMaskColour( blank_r, blank_g, blank_b );
+        blank[0] = GetMaskRed();
+        blank[1] = GetMaskGreen();
+        blank[2] = GetMaskBlue();
+        rotated.SetMaskColour( blank[0], blank[1], blank[2] );
     }
 
-    // Now, for each point of the rotated image, find where it came from, by
-    // performing an inverse rotation (a rotation of -angle) and getting the
-    // pixel at those coordinates
-
     const int rH = rotated.GetHeight();
     const int rW = rotated.GetWidth();
 
-    // do the (interpolating) test outside of the loops, so that it is done
-    // only once, instead of repeating it for each pixel.
-    if (interpolating)
-    {
-        for (int y = 0; y < rH; y++)
-        {
-            for (int x = 0; x < rW; x++)
-            {
-                wxRealPoint src = wxRotatePoint (x + x1a, y + y1a, cos_angle, -sin_angle, p0);
-
-                if (-0.25 < src.x && src.x < w - 0.75 &&
-                    -0.25 < src.y && src.y < h - 0.75)
-                {
-                    // interpolate using the 4 enclosing grid-points.  Those
-                    // points can be obtained using floor and ceiling of the
-                    // exact coordinates of the point
-                    int x1, y1, x2, y2;
-
-                    if (0 < src.x && src.x < w - 1)
-                    {
-                        x1 = wxRound(floor(src.x));
-                        x2 = wxRound(ceil(src.x));
-                    }
-                    else    // else means that x is near one of the borders (0 or width-1)
-                    {
-                        x1 = x2 = wxRound (src.x);
-                    }
-
-                    if (0 < src.y && src.y < h - 1)
-                    {
-                        y1 = wxRound(floor(src.y));
-                        y2 = wxRound(ceil(src.y));
-                    }
-                    else
-                    {
-                        y1 = y2 = wxRound (src.y);
-                    }
-
-                    // get four points and the distances (square of the distance,
-                    // for efficiency reasons) for the interpolation formula
-
-                    // GRG: Do not calculate the points until they are
-                    //      really needed -- this way we can calculate
-                    //      just one, instead of four, if d1, d2, d3
-                    //      or d4 are < wxROTATE_EPSILON
-
-                    const double d1 = (src.x - x1) * (src.x - x1) + (src.y - y1) * (src.y - y1);
-                    const double d2 = (src.x - x2) * (src.x - x2) + (src.y - y1) * (src.y - y1);
-                    const double d3 = (src.x - x2) * (src.x - x2) + (src.y - y2) * (src.y - y2);
-                    const double d4 = (src.x - x1) * (src.x - x1) + (src.y - y2) * (src.y - y2);
-
-                    // Now interpolate as a weighted average of the four surrounding
-                    // points, where the weights are the distances to each of those points
-
-                    // If the point is exactly at one point of the grid of the source
-                    // image, then don't interpolate -- just assign the pixel
-
-                    // d1,d2,d3,d4 are positive -- no need for abs()
-                    if (d1 < wxROTATE_EPSILON)
-                    {
-                        unsigned char *p = data[y1] + (3 * x1);
-                        *(dst++) = *(p++);
-                        *(dst++) = *(p++);
-                        *(dst++) = *p;
-
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y1] + x1);
-                    }
-                    else if (d2 < wxROTATE_EPSILON)
-                    {
-                        unsigned char *p = data[y1] + (3 * x2);
-                        *(dst++) = *(p++);
-                        *(dst++) = *(p++);
-                        *(dst++) = *p;
-
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y1] + x2);
-                    }
-                    else if (d3 < wxROTATE_EPSILON)
-                    {
-                        unsigned char *p = data[y2] + (3 * x2);
-                        *(dst++) = *(p++);
-                        *(dst++) = *(p++);
-                        *(dst++) = *p;
-
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y2] + x2);
-                    }
-                    else if (d4 < wxROTATE_EPSILON)
-                    {
-                        unsigned char *p = data[y2] + (3 * x1);
-                        *(dst++) = *(p++);
-                        *(dst++) = *(p++);
-                        *(dst++) = *p;
-
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y2] + x1);
-                    }
-                    else
-                    {
-                        // weights for the weighted average are proportional to the inverse of the distance
-                        unsigned char *v1 = data[y1] + (3 * x1);
-                        unsigned char *v2 = data[y1] + (3 * x2);
-                        unsigned char *v3 = data[y2] + (3 * x2);
-                        unsigned char *v4 = data[y2] + (3 * x1);
-
-                        const double w1 = 1/d1, w2 = 1/d2, w3 = 1/d3, w4 = 1/d4;
-
-                        // GRG: Unrolled.
-
-                        *(dst++) = (unsigned char)
-                            ( (w1 * *(v1++) + w2 * *(v2++) +
-                               w3 * *(v3++) + w4 * *(v4++)) /
-                              (w1 + w2 + w3 + w4) );
-                        *(dst++) = (unsigned char)
-                            ( (w1 * *(v1++) + w2 * *(v2++) +
-                               w3 * *(v3++) + w4 * *(v4++)) /
-                              (w1 + w2 + w3 + w4) );
-                        *(dst++) = (unsigned char)
-                            ( (w1 * *v1 + w2 * *v2 +
-                               w3 * *v3 + w4 * *v4) /
-                              (w1 + w2 + w3 + w4) );
-
-                        if (has_alpha)
-                        {
-                            v1 = alpha[y1] + (x1);
-                            v2 = alpha[y1] + (x2);
-                            v3 = alpha[y2] + (x2);
-                            v4 = alpha[y2] + (x1);
-
-                            *(alpha_dst++) = (unsigned char)
-                                ( (w1 * *v1 + w2 * *v2 +
-                                   w3 * *v3 + w4 * *v4) /
-                                  (w1 + w2 + w3 + w4) );
-                        }
-                    }
-                }
-                else
-                {
-                    *(dst++) = blank_r;
-                    *(dst++) = blank_g;
-                    *(dst++) = blank_b;
-
-                    if (has_alpha)
-                        *(alpha_dst++) = 0;
-                }
-            }
-        }
-    }
-    else // not interpolating
-    {
-        for (int y = 0; y < rH; y++)
-        {
-            for (int x = 0; x < rW; x++)
-            {
-                wxRealPoint src = wxRotatePoint (x + x1a, y + y1a, cos_angle, -sin_angle, p0);
-
-                const int xs = wxRound (src.x);      // wxRound rounds to the
-                const int ys = wxRound (src.y);      // closest integer
-
-                if (0 <= xs && xs < w && 0 <= ys && ys < h)
-                {
-                    unsigned char *p = data[ys] + (3 * xs);
-                    *(dst++) = *(p++);
-                    *(dst++) = *(p++);
-                    *(dst++) = *p;
-
-                    if (has_alpha)
-                        *(alpha_dst++) = *(alpha[ys] + (xs));
-                }
-                else
-                {
-                    *(dst++) = blank_r;
-                    *(dst++) = blank_g;
-                    *(dst++) = blank_b;
-
-                    if (has_alpha)
-                        *(alpha_dst++) = 255;
-                }
-            }
-        }
-    }
-
-    delete [] data;
-    delete [] alpha;
+    ProcessRowsInParallel(Rotator(*this, rotated, x1a, y1a, p0,
+                                  cos_angle, sin_angle, interpolating, blank),
+                          rH,
+                          static_cast<size_t>(rW)*rH*(interpolating ? 4 : 1));
 
     return rotated;
 }
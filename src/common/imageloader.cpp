@@ -0,0 +1,475 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        src/common/imageloader.cpp
+// Purpose:     wxImageLoader implementation
+// Author:      wxWidgets team
+// Created:     2020-03-19
+// Copyright:   (c) 2020 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// For compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+#ifdef __BORLANDC__
+    #pragma hdrstop
+#endif
+
+#if wxUSE_IMAGE && wxUSE_STREAMS && wxUSE_THREADS
+
+#include "wx/imageloader.h"
+
+#ifndef WX_PRECOMP
+    #include "wx/log.h"
+    #include "wx/intl.h"
+#endif
+
+#include "wx/thread.h"
+#include "wx/wfstream.h"
+#include "wx/hashmap.h"
+#include "wx/scopedptr.h"
+
+// make the code compile with either wxFile*Stream or wxFFile*Stream, as in
+// image.cpp
+#define HAS_FILE_STREAMS (wxUSE_FILE || wxUSE_FFILE)
+
+#if HAS_FILE_STREAMS
+    #if wxUSE_FFILE
+        typedef wxFFileInputStream wxImageFileInputStream;
+    #else
+        typedef wxFileInputStream wxImageFileInputStream;
+    #endif
+#endif // HAS_FILE_STREAMS
+
+// ============================================================================
+// implementation
+// ============================================================================
+
+wxDEFINE_EVENT(wxEVT_IMAGE_LOADED, wxImageLoaderEvent);
+
+wxIMPLEMENT_DYNAMIC_CLASS(wxImageLoaderEvent, wxEvent);
+
+WX_DECLARE_STRING_HASH_MAP(wxImageHandler*, wxImageHandlersByExtMap);
+
+class wxImageLoaderImpl
+{
+public:
+    wxImageLoaderImpl(wxEvtHandler* handler, int numThreads)
+        : m_handler(handler),
+          m_condQueued(m_mutex),
+          m_condDone(m_mutex)
+    {
+        m_maxThreads = numThreads ? numThreads : wxThread::GetCPUCount();
+        if ( m_maxThreads < 1 )
+            m_maxThreads = 1;
+
+        m_maxWidth =
+        m_maxHeight = 0;
+        m_next =
+        m_numDone = 0;
+        m_exit = false;
+    }
+
+    ~wxImageLoaderImpl()
+    {
+        Cancel();
+
+        {
+            wxMutexLocker lock(m_mutex);
+            m_exit = true;
+            m_condQueued.Broadcast();
+        }
+
+        for ( size_t n = 0; n < m_threads.size(); n++ )
+        {
+            m_threads[n]->Wait();
+            delete m_threads[n];
+        }
+
+        for ( size_t n = 0; n < m_requests.size(); n++ )
+            delete m_requests[n];
+    }
+
+    void SetMaxSize(int maxWidth, int maxHeight)
+    {
+        wxMutexLocker lock(m_mutex);
+        m_maxWidth = maxWidth;
+        m_maxHeight = maxHeight;
+    }
+
+    int Queue(const wxString& filename, wxInputStream* stream, wxBitmapType type);
+
+    int GetCount() const
+    {
+        wxMutexLocker lock(m_mutex);
+        return m_requests.size();
+    }
+
+    bool IsDone(int index) const
+    {
+        wxMutexLocker lock(m_mutex);
+        wxCHECK_MSG( index >= 0 && (size_t)index < m_requests.size(), false,
+                     wxS("invalid image index") );
+
+        return m_requests[index]->done;
+    }
+
+    wxImage GetImage(int index);
+
+    void Wait()
+    {
+        wxMutexLocker lock(m_mutex);
+        while ( m_numDone < m_requests.size() )
+            m_condDone.Wait();
+    }
+
+    void Cancel();
+
+    // Called by the worker threads to process the requests until m_exit is set.
+    void Work();
+
+private:
+    struct Request
+    {
+        Request(const wxString& filename_, wxInputStream* stream_,
+                wxBitmapType type_, int maxWidth_, int maxHeight_)
+            : filename(filename_),
+              stream(stream_),
+              type(type_),
+              maxWidth(maxWidth_),
+              maxHeight(maxHeight_),
+              done(false)
+        {
+        }
+
+        ~Request() { delete stream; }
+
+        // These fields don't change after the request creation, except for the
+        // stream which is deleted by the thread handling the request.
+        const wxString filename;
+        wxInputStream* stream;
+        const wxBitmapType type;
+        const int maxWidth,
+                  maxHeight;
+
+        // These fields are protected by m_mutex.
+        wxImage image;
+        bool done;
+    };
+
+    class WorkerThread : public wxThread
+    {
+    public:
+        explicit WorkerThread(wxImageLoaderImpl& impl)
+            : wxThread(wxTHREAD_JOINABLE),
+              m_impl(impl)
+        {
+        }
+
+    protected:
+        virtual void* Entry() wxOVERRIDE
+        {
+            m_impl.Work();
+            return NULL;
+        }
+
+    private:
+        wxImageLoaderImpl& m_impl;
+    };
+
+    // Load the image for the given request without locking the mutex.
+    wxImage DoLoadImage(Request& req);
+    wxImage DoLoadImage(const Request& req, wxInputStream& stream);
+
+    // Find the handler able to read the stream, trying the one which worked
+    // for the files with the same extension the last time first.
+    wxImageHandler* FindHandler(const wxString& filename, wxInputStream& stream);
+
+    // Must be called with m_mutex locked.
+    void MarkDone(Request& req)
+    {
+        req.done = true;
+        m_numDone++;
+        m_condDone.Broadcast();
+    }
+
+    wxEvtHandler* const m_handler;
+    int m_maxThreads;
+
+    mutable wxMutex m_mutex;
+    wxCondition m_condQueued,
+                m_condDone;
+
+    // All the fields below are protected by m_mutex.
+    wxVector<Request*> m_requests;
+    wxVector<WorkerThread*> m_threads;
+    size_t m_next,
+           m_numDone;
+    int m_maxWidth,
+        m_maxHeight;
+    bool m_exit;
+
+    // The cache of the handlers used by FindHandler(), protected by its own
+    // critical section.
+    wxImageHandlersByExtMap m_handlersByExt;
+    wxCriticalSection m_csHandlers;
+
+    wxDECLARE_NO_COPY_CLASS(wxImageLoaderImpl);
+};
+
+int
+wxImageLoaderImpl::Queue(const wxString& filename,
+                         wxInputStream* stream,
+                         wxBitmapType type)
+{
+    wxMutexLocker lock(m_mutex);
+
+    const int index = m_requests.size();
+    m_requests.push_back(new Request(filename, stream, type,
+                                     m_maxWidth, m_maxHeight));
+
+    // Create the threads on demand to avoid starting more of them than needed.
+    if ( m_threads.size() < (size_t)m_maxThreads )
+    {
+        WorkerThread* const thread = new WorkerThread(*this);
+        if ( thread->Run() == wxTHREAD_NO_ERROR )
+        {
+            m_threads.push_back(thread);
+        }
+        else
+        {
+            delete thread;
+
+            if ( m_threads.empty() )
+            {
+                wxLogError(_("Failed to start image loading thread."));
+
+                MarkDone(*m_requests.back());
+                m_next++;
+                return index;
+            }
+        }
+    }
+
+    m_condQueued.Signal();
+
+    return index;
+}
+
+wxImage wxImageLoaderImpl::GetImage(int index)
+{
+    wxCHECK_MSG( !m_handler, wxNullImage,
+                 wxS("images are sent to the event handler") );
+
+    wxImage image;
+
+    wxMutexLocker lock(m_mutex);
+    wxCHECK_MSG( index >= 0 && (size_t)index < m_requests.size(), wxNullImage,
+                 wxS("invalid image index") );
+
+    Request& req = *m_requests[index];
+    while ( !req.done )
+        m_condDone.Wait();
+
+    // Take the image from the request to ensure that the worker thread doesn't
+    // keep any references to it, as wxImage reference counting is not atomic.
+    image = req.image;
+    req.image.UnRef();
+
+    return image;
+}
+
+void wxImageLoaderImpl::Cancel()
+{
+    wxMutexLocker lock(m_mutex);
+
+    for ( ; m_next < m_requests.size(); m_next++ )
+    {
+        Request& req = *m_requests[m_next];
+
+        wxDELETE(req.stream);
+        MarkDone(req);
+    }
+}
+
+void wxImageLoaderImpl::Work()
+{
+    for ( ;; )
+    {
+        Request* req;
+        int index;
+
+        {
+            wxMutexLocker lock(m_mutex);
+            while ( m_next == m_requests.size() && !m_exit )
+                m_condQueued.Wait();
+
+            if ( m_next == m_requests.size() )
+                break;
+
+            index = m_next++;
+            req = m_requests[index];
+        }
+
+        wxImage image = DoLoadImage(*req);
+
+        wxMutexLocker lock(m_mutex);
+
+        // Queue the event before marking the request as done to ensure that
+        // the events for all the images are queued when Wait() returns.
+        if ( m_handler )
+            wxQueueEvent(m_handler,
+                         new wxImageLoaderEvent(index, req->filename.Clone(), image));
+        else
+            req->image = image;
+
+        // Release our reference while still holding the lock, see the
+        // comment in GetImage().
+        image.UnRef();
+
+        MarkDone(*req);
+    }
+}
+
+wxImage wxImageLoaderImpl::DoLoadImage(Request& req)
+{
+    wxScopedPtr<wxInputStream> stream(req.stream);
+    req.stream = NULL;
+
+    if ( stream )
+        return DoLoadImage(req, *stream);
+
+#if HAS_FILE_STREAMS
+    wxImageFileInputStream file(req.filename);
+    if ( file.IsOk() )
+    {
+        wxBufferedInputStream bstream(file);
+        const wxImage image = DoLoadImage(req, bstream);
+        if ( image.IsOk() )
+            return image;
+    }
+
+    wxLogError(_("Failed to load image from file \"%s\"."), req.filename);
+#endif // HAS_FILE_STREAMS
+
+    return wxImage();
+}
+
+wxImage wxImageLoaderImpl::DoLoadImage(const Request& req, wxInputStream& stream)
+{
+    wxImage image;
+    if ( req.maxWidth )
+        image.SetOption(wxIMAGE_OPTION_MAX_WIDTH, req.maxWidth);
+    if ( req.maxHeight )
+        image.SetOption(wxIMAGE_OPTION_MAX_HEIGHT, req.maxHeight);
+
+    wxBitmapType type = req.type;
+    if ( type == wxBITMAP_TYPE_ANY && stream.IsSeekable() )
+    {
+        // If no handler can read the stream, still call LoadFile() with
+        // wxBITMAP_TYPE_ANY to let it give the appropriate error message.
+        wxImageHandler* const handler = FindHandler(req.filename, stream);
+        if ( handler )
+            type = handler->GetType();
+    }
+
+    if ( !image.LoadFile(stream, type) )
+        return wxImage();
+
+    return image;
+}
+
+wxImageHandler*
+wxImageLoaderImpl::FindHandler(const wxString& filename, wxInputStream& stream)
+{
+    // The images read from streams without names all use the empty extension,
+    // which makes us try the handler used for the previous one first.
+    wxString ext;
+    const size_t posDot = filename.find_last_of(wxS("./\\"));
+    if ( posDot != wxString::npos && filename[posDot] == '.' )
+        ext = filename.substr(posDot + 1).Lower();
+
+    wxImageHandler* handlerLast = NULL;
+    {
+        wxCriticalSectionLocker lock(m_csHandlers);
+        wxImageHandlersByExtMap::const_iterator it = m_handlersByExt.find(ext);
+        if ( it != m_handlersByExt.end() )
+            handlerLast = it->second;
+    }
+
+    if ( handlerLast && handlerLast->CanRead(stream) )
+        return handlerLast;
+
+    const wxList& list = wxImage::GetHandlers();
+    for ( wxList::compatibility_iterator node = list.GetFirst();
+          node;
+          node = node->GetNext() )
+    {
+        wxImageHandler* const handler = (wxImageHandler*)node->GetData();
+        if ( handler != handlerLast && handler->CanRead(stream) )
+        {
+            wxCriticalSectionLocker lock(m_csHandlers);
+            m_handlersByExt[ext] = handler;
+            return handler;
+        }
+    }
+
+    return NULL;
+}
+
+wxImageLoader::wxImageLoader(wxEvtHandler* handler, int numThreads)
+{
+    wxASSERT_MSG( numThreads >= 0, wxS("invalid number of threads") );
+
+    m_impl = new wxImageLoaderImpl(handler, numThreads);
+}
+
+wxImageLoader::~wxImageLoader()
+{
+    delete m_impl;
+}
+
+void wxImageLoader::SetMaxSize(int maxWidth, int maxHeight)
+{
+    wxCHECK_RET( maxWidth >= 0 && maxHeight >= 0, wxS("invalid size") );
+
+    m_impl->SetMaxSize(maxWidth, maxHeight);
+}
+
+int wxImageLoader::Load(const wxString& filename, wxBitmapType type)
+{
+    return m_impl->Queue(filename, NULL, type);
+}
+
+int wxImageLoader::Load(wxInputStream* stream, wxBitmapType type)
+{
+    wxCHECK_MSG( stream, wxNOT_FOUND, wxS("NULL stream") );
+
+    return m_impl->Queue(wxString(), stream, type);
+}
+
+int wxImageLoader::GetCount() const
+{
+    return m_impl->GetCount();
+}
+
+bool wxImageLoader::IsDone(int index) const
+{
+    return m_impl->IsDone(index);
+}
+
+wxImage wxImageLoader::GetImage(int index)
+{
+    return m_impl->GetImage(index);
+}
+
+void wxImageLoader::Wait()
+{
+    m_impl->Wait();
+}
+
+void wxImageLoader::Cancel()
+{
+    m_impl->Cancel();
+}
+
+#endif // wxUSE_IMAGE && wxUSE_STREAMS && wxUSE_THREADS
@@ -350,6 +350,118 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
     return true;
 }
 
+bool wxJPEGHandler::LoadRows( wxInputStream& stream,
+                              wxImageRowsConsumer& consumer,
+                              int bandHeight,
+                              bool verbose,
+                              int WXUNUSED(index) )
+{
+    wxCHECK_MSG( bandHeight > 0, false, "invalid band height" );
+
+    struct jpeg_decompress_struct cinfo;
+    wx_error_mgr jerr;
+
+    cinfo.err = jpeg_std_error( &jerr );
+    jerr.error_exit = wx_error_exit;
+
+    if (!verbose)
+        cinfo.err->output_message = wx_ignore_message;
+
+    if (setjmp(jerr.setjmp_buffer)) {
+      if (verbose)
+      {
+        wxLogError(_("JPEG: Couldn't load - file is probably corrupted."));
+      }
+      (cinfo.src->term_source)(&cinfo);
+      jpeg_destroy_decompress(&cinfo);
+      return false;
+    }
+
+    jpeg_create_decompress( &cinfo );
+    wx_jpeg_io_src( &cinfo, stream );
+    jpeg_read_header( &cinfo, TRUE );
+
+    int bytesPerPixel;
+    if ((cinfo.out_color_space == JCS_CMYK) || (cinfo.out_color_space == JCS_YCCK))
+    {
+        cinfo.out_color_space = JCS_CMYK;
+        bytesPerPixel = 4;
+    }
+    else // all the rest is treated as RGB
+    {
+        cinfo.out_color_space = JCS_RGB;
+        bytesPerPixel = 3;
+    }
+
+    jpeg_start_decompress( &cinfo );
+
+    if ( !consumer.OnStart(cinfo.output_width, cinfo.output_height, false) )
+    {
+        (cinfo.src->term_source)(&cinfo);
+        jpeg_destroy_decompress( &cinfo );
+        return false;
+    }
+
+    // the buffers are allocated from the image pool and so are freed by
+    // libjpeg itself, even if an error occurs
+    const JDIMENSION bandRows = wxMin((JDIMENSION)bandHeight,
+                                      cinfo.output_height);
+    const unsigned stride = cinfo.output_width * 3;
+    unsigned char* const data = (unsigned char*)(*cinfo.mem->alloc_large)
+                                  ((j_common_ptr) &cinfo, JPOOL_IMAGE,
+                                   (size_t)stride * bandRows);
+
+    JSAMPARRAY tempbuf = NULL;
+    if ( cinfo.out_color_space == JCS_CMYK )
+    {
+        tempbuf = (*cinfo.mem->alloc_sarray)
+                    ((j_common_ptr) &cinfo, JPOOL_IMAGE,
+                     cinfo.output_width * bytesPerPixel, 1);
+    }
+
+    while ( cinfo.output_scanline < cinfo.output_height )
+    {
+        const JDIMENSION firstRow = cinfo.output_scanline;
+        const JDIMENSION numRows = wxMin(bandRows,
+                                         cinfo.output_height - firstRow);
+
+        unsigned char* ptr = data;
+        for ( JDIMENSION i = 0; i < numRows; i++ )
+        {
+            if ( cinfo.out_color_space == JCS_RGB )
+            {
+                // decode RGB rows directly into the band
+                JSAMPROW row = ptr;
+                jpeg_read_scanlines( &cinfo, &row, 1 );
+                ptr += stride;
+            }
+            else // CMYK
+            {
+                jpeg_read_scanlines( &cinfo, tempbuf, 1 );
+                const unsigned char* inptr = (const unsigned char*) tempbuf[0];
+                for (size_t n = 0; n < cinfo.output_width; n++)
+                {
+                    wx_cmyk_to_rgb(ptr, inptr);
+                    ptr += 3;
+                    inptr += 4;
+                }
+            }
+        }
+
+        if ( !consumer.ConsumeRows(cinfo.output_width, firstRow, numRows,
+                                   data, NULL) )
+        {
+            (cinfo.src->term_source)(&cinfo);
+            jpeg_destroy_decompress( &cinfo );
+            return false;
+        }
+    }
+
+    jpeg_finish_decompress( &cinfo );
+    jpeg_destroy_decompress( &cinfo );
+    return true;
+}
+
 typedef struct {
     struct jpeg_destination_mgr pub;
 
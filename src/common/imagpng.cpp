@@ -25,12 +25,15 @@
 
 #include "wx/imagpng.h"
 #include "wx/versioninfo.h"
+#include "wx/scopedptr.h"
+#include "wx/private/image.h"
 
 #ifndef WX_PRECOMP
     #include "wx/log.h"
     #include "wx/intl.h"
     #include "wx/palette.h"
     #include "wx/stream.h"
+    #include "wx/utils.h"
 #endif
 
 #include "png.h"
@@ -108,9 +111,12 @@ struct wxPNGImageData
     {
         lines = NULL;
         m_buf = NULL;
+        m_rows = NULL;
+        m_alpha = NULL;
         info_ptr = (png_infop) NULL;
         png_ptr = (png_structp) NULL;
         ok = false;
+        cancelled = false;
     }
 
     bool Alloc(png_uint_32 width, png_uint_32 height, unsigned char* buf)
@@ -142,6 +148,8 @@ struct wxPNGImageData
 
     ~wxPNGImageData()
     {
+        free(m_alpha);
+        free(m_rows);
         free(m_buf);
         free( lines );
 
@@ -156,11 +164,25 @@ struct wxPNGImageData
 
     void DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo);
 
+    void DoLoadPNGRows(wxImageRowsConsumer& consumer,
+                       int bandHeight,
+                       wxPNGInfoStruct& wxinfo);
+
+    void SetImageResolution(wxImage* image);
+
     unsigned char** lines;
     unsigned char* m_buf;
+
+    // the RGB and alpha data of the current band, only used by LoadRows()
+    unsigned char* m_rows;
+    unsigned char* m_alpha;
+
     png_infop info_ptr;
     png_structp png_ptr;
     bool ok;
+
+    // true if loading was stopped by wxImageRowsConsumer, not by an error
+    bool cancelled;
 };
 
 } // anonymous namespace
@@ -282,6 +304,37 @@ void CopyDataFromPNG(wxImage *image,
     }
 }
 
+// check if all pixels of the image with alpha channel are opaque
+static
+bool IsAlphaOpaque(const wxImage& image)
+{
+    const unsigned char *alpha = image.GetAlpha();
+    const size_t count = (size_t)image.GetWidth()*image.GetHeight();
+    for ( size_t n = 0; n < count; n++ )
+    {
+        if ( !IsOpaque(alpha[n]) )
+            return false;
+    }
+
+    return true;
+}
+
+// split a row of RGBA pixels into separate RGB and alpha rows
+static
+void SplitRGBA(const unsigned char *ptrSrc,
+               png_uint_32 width,
+               unsigned char *ptrDst,
+               unsigned char *alpha)
+{
+    for ( png_uint_32 x = 0; x < width; x++ )
+    {
+        *ptrDst++ = *ptrSrc++;
+        *ptrDst++ = *ptrSrc++;
+        *ptrDst++ = *ptrSrc++;
+        *alpha++ = *ptrSrc++;
+    }
+}
+
 // temporarily disable the warning C4611 (interaction between '_setjmp' and
 // C++ object destruction is non-portable) - I don't see any dtors here
 #ifdef __VISUALC__
@@ -372,7 +425,20 @@ wxPNGImageData::DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo)
 #endif // wxUSE_PALETTE
 
 
-    // set the image resolution if it's available
+    SetImageResolution(image);
+
+    // loaded successfully, now init wxImage with this data
+    if (needCopy)
+        CopyDataFromPNG(image, lines, width, height);
+
+    // This will indicate to the caller that loading succeeded.
+    ok = true;
+}
+
+// set the image resolution if it's available
+void
+wxPNGImageData::SetImageResolution(wxImage* image)
+{
     png_uint_32 resX, resY;
     int unitType;
     if (png_get_pHYs(png_ptr, info_ptr, &resX, &resY, &unitType)
@@ -410,13 +476,128 @@ wxPNGImageData::DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo)
 
         image->SetOption(wxIMAGE_OPTION_RESOLUTIONUNIT, res);
     }
+}
+
+// This function is similar to DoLoadPNGFile() and uses wxPNGImageData in the
+// same way, but passes the image rows to the consumer instead of storing them.
+void
+wxPNGImageData::DoLoadPNGRows(wxImageRowsConsumer& consumer,
+                              int bandHeight,
+                              wxPNGInfoStruct& wxinfo)
+{
+    png_uint_32 width, height = 0;
+    int bit_depth, color_type, interlace_type;
 
+    png_ptr = png_create_read_struct
+                          (
+                            PNG_LIBPNG_VER_STRING,
+                            NULL,
+                            wx_PNG_error,
+                            wx_PNG_warning
+                          );
+    if (!png_ptr)
+        return;
 
-    // loaded successfully, now init wxImage with this data
-    if (needCopy)
-        CopyDataFromPNG(image, lines, width, height);
+    png_set_read_fn( png_ptr, &wxinfo, wx_PNG_stream_reader);
+
+    info_ptr = png_create_info_struct( png_ptr );
+    if (!info_ptr)
+        return;
+
+    if (setjmp(wxinfo.jmpbuf))
+        return;
+
+    png_read_info( png_ptr, info_ptr );
+    png_get_IHDR( png_ptr, info_ptr, &width, &height, &bit_depth, &color_type,
+                  &interlace_type, NULL, NULL );
+
+    png_set_expand(png_ptr);
+    png_set_gray_to_rgb(png_ptr);
+    png_set_strip_16( png_ptr );
+    png_set_packing( png_ptr );
+
+    // we can't know if all the pixels are opaque without reading all of them,
+    // so just pass the alpha channel to the consumer if we may have any
+    const bool hasAlpha =
+        (color_type & PNG_COLOR_MASK_ALPHA) ||
+        png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS);
+
+    if ( !consumer.OnStart((int)width, (int)height, hasAlpha) )
+    {
+        cancelled = true;
+        return;
+    }
+
+    // interlaced images can't be decoded row by row as the last pass may
+    // modify any of them, so read the entire image in this case
+    const bool interlaced = interlace_type != PNG_INTERLACE_NONE;
+    if ( interlaced )
+    {
+        if ( !Alloc(width, height, NULL) )
+            return;
+
+        png_read_image( png_ptr, lines );
+    }
+    else if ( hasAlpha )
+    {
+        m_buf = static_cast<unsigned char*>(malloc(width * 4));
+        if ( !m_buf )
+            return;
+    }
+
+    const png_uint_32 bandRows = wxMin((png_uint_32)bandHeight, height);
+    const size_t stride = width * 3;
+
+    m_rows = static_cast<unsigned char*>(malloc(stride * bandRows));
+    if ( !m_rows )
+        return;
+
+    if ( hasAlpha )
+    {
+        m_alpha = static_cast<unsigned char*>(malloc(width * bandRows));
+        if ( !m_alpha )
+            return;
+    }
+
+    for ( png_uint_32 y = 0; y < height; y += bandRows )
+    {
+        const png_uint_32 numRows = wxMin(bandRows, height - y);
+        for ( png_uint_32 i = 0; i < numRows; i++ )
+        {
+            unsigned char* const ptrDst = m_rows + i*stride;
+
+            const unsigned char* ptrSrc;
+            if ( interlaced )
+            {
+                ptrSrc = lines[y + i];
+            }
+            else if ( hasAlpha )
+            {
+                png_read_row( png_ptr, m_buf, NULL );
+                ptrSrc = m_buf;
+            }
+            else // read RGB data directly into the band
+            {
+                png_read_row( png_ptr, ptrDst, NULL );
+                continue;
+            }
+
+            if ( hasAlpha )
+                SplitRGBA(ptrSrc, width, ptrDst, m_alpha + i*width);
+            else
+                memcpy(ptrDst, ptrSrc, stride);
+        }
+
+        if ( !consumer.ConsumeRows((int)width, (int)y, (int)numRows,
+                                   m_rows, m_alpha) )
+        {
+            cancelled = true;
+            return;
+        }
+    }
+
+    png_read_end( png_ptr, info_ptr );
 
-    // This will indicate to the caller that loading succeeded.
     ok = true;
 }
 
@@ -430,8 +611,34 @@ wxPNGHandler::LoadFile(wxImage *image,
     wxinfo.verbose = verbose;
     wxinfo.stream.in = &stream;
 
+    // save this before calling Destroy()
+    const unsigned maxWidth = image->GetOptionInt(wxIMAGE_OPTION_MAX_WIDTH),
+                   maxHeight = image->GetOptionInt(wxIMAGE_OPTION_MAX_HEIGHT);
+
     wxPNGImageData data;
-    data.DoLoadPNGFile(image, wxinfo);
+    if ( maxWidth || maxHeight )
+    {
+        // scale the image down while decoding it, without ever allocating
+        // the memory for all of its pixels
+        image->Destroy();
+
+        wxScopedPtr<wxImageRowsConsumer>
+            downscaler(wxCreateImageDownscaler(*image, maxWidth, maxHeight));
+        data.DoLoadPNGRows(*downscaler, 64, wxinfo);
+
+        if ( data.ok )
+        {
+            data.SetImageResolution(image);
+
+            // as when loading the full image, only keep alpha if needed
+            if ( image->HasAlpha() && IsAlphaOpaque(*image) )
+                image->ClearAlpha();
+        }
+    }
+    else
+    {
+        data.DoLoadPNGFile(image, wxinfo);
+    }
 
     if ( !data.ok )
     {
@@ -451,6 +658,35 @@ wxPNGHandler::LoadFile(wxImage *image,
     return true;
 }
 
+bool
+wxPNGHandler::LoadRows(wxInputStream& stream,
+                       wxImageRowsConsumer& consumer,
+                       int bandHeight,
+                       bool verbose,
+                       int WXUNUSED(index))
+{
+    wxCHECK_MSG( bandHeight > 0, false, wxS("invalid band height") );
+
+    wxPNGInfoStruct wxinfo;
+    wxinfo.verbose = verbose;
+    wxinfo.stream.in = &stream;
+
+    wxPNGImageData data;
+    data.DoLoadPNGRows(consumer, bandHeight, wxinfo);
+
+    if ( !data.ok )
+    {
+        if ( verbose && !data.cancelled )
+        {
+           wxLogError(_("Couldn't load a PNG image - file is corrupted or not enough memory."));
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
 // ----------------------------------------------------------------------------
 // SaveFile() palette helpers
 // ----------------------------------------------------------------------------
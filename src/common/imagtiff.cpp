@@ -25,6 +25,8 @@
 
 #include "wx/imagtiff.h"
 #include "wx/versioninfo.h"
+#include "wx/scopedptr.h"
+#include "wx/private/image.h"
 
 #ifndef WX_PRECOMP
     #include "wx/log.h"
@@ -285,11 +287,252 @@ TIFFwxOpen(wxOutputStream &stream, const char* name, const char* mode)
     return tif;
 }
 
+// check if the current TIFF directory has an alpha channel
+static bool TIFFHasAlpha(TIFF *tif)
+{
+    uint16 samplesPerPixel = 0;
+    (void) TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &samplesPerPixel);
+
+    uint16 extraSamples;
+    uint16* samplesInfo;
+    TIFFGetFieldDefaulted(tif, TIFFTAG_EXTRASAMPLES,
+                          &extraSamples, &samplesInfo);
+
+    uint16 photometric;
+    if (!TIFFGetField(tif, TIFFTAG_PHOTOMETRIC, &photometric))
+    {
+        photometric = PHOTOMETRIC_MINISWHITE;
+    }
+
+    return (extraSamples >= 1
+        && ((samplesInfo[0] == EXTRASAMPLE_UNSPECIFIED)
+            || samplesInfo[0] == EXTRASAMPLE_ASSOCALPHA
+            || samplesInfo[0] == EXTRASAMPLE_UNASSALPHA))
+        || (extraSamples == 0 && samplesPerPixel == 4
+            && photometric == PHOTOMETRIC_RGB);
+}
+
+/*
+Check if the image in the current TIFF directory can be read band by band:
+this is only the case for the images stored top to bottom which can be
+decoded by libtiff RGBA interface, but not for the grey scale images with
+alpha which are handled specially by LoadFile().
+*/
+static bool CanReadTIFFRows(TIFF *tif)
+{
+    uint16 samplesPerPixel = 0;
+    (void) TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &samplesPerPixel);
+
+    uint16 extraSamples;
+    uint16* samplesInfo;
+    TIFFGetFieldDefaulted(tif, TIFFTAG_EXTRASAMPLES,
+                          &extraSamples, &samplesInfo);
+
+    uint16 planarConfig = PLANARCONFIG_CONTIG;
+    (void) TIFFGetField(tif, TIFFTAG_PLANARCONFIG, &planarConfig);
+
+    uint16 orientation = ORIENTATION_TOPLEFT;
+    (void) TIFFGetFieldDefaulted(tif, TIFFTAG_ORIENTATION, &orientation);
+
+    if ( orientation != ORIENTATION_TOPLEFT )
+        return false;
+
+    if ( planarConfig == PLANARCONFIG_CONTIG && samplesPerPixel == 2
+            && extraSamples == 1 )
+        return false;
+
+    char msg[1024] = "";
+    return TIFFRGBAImageOK(tif, msg) != 0;
+}
+
+// read the image, for which CanReadTIFFRows() must return true, band by band
+static bool
+ReadTIFFRows(TIFF *tif, wxImageRowsConsumer& consumer, int bandHeight,
+             bool verbose)
+{
+    char msg[1024] = "";
+    TIFFRGBAImage img;
+    if ( !TIFFRGBAImageBegin(&img, tif, 0, msg) )
+    {
+        if (verbose)
+        {
+            wxLogError( _("TIFF: Error reading image.") );
+        }
+
+        return false;
+    }
+
+    img.req_orientation = ORIENTATION_TOPLEFT;
+
+    const uint32 w = img.width,
+                 h = img.height;
+    const bool hasAlpha = TIFFHasAlpha(tif);
+
+    if ( !consumer.OnStart((int)w, (int)h, hasAlpha) )
+    {
+        TIFFRGBAImageEnd( &img );
+
+        return false;
+    }
+
+    const uint32 bandRows = wxMin((uint32)bandHeight, h);
+    const size_t pixels = (size_t)w * bandRows;
+
+    uint32 *raster = (uint32*) _TIFFmalloc( pixels * sizeof(uint32) );
+    unsigned char *data = (unsigned char*)
+                            _TIFFmalloc( pixels * (hasAlpha ? 4 : 3) );
+
+    if ( !raster || !data )
+    {
+        if (verbose)
+        {
+            wxLogError( _("TIFF: Couldn't allocate memory.") );
+        }
+
+        _TIFFfree( data );
+        _TIFFfree( raster );
+        TIFFRGBAImageEnd( &img );
+
+        return false;
+    }
+
+    unsigned char * const alpha = hasAlpha ? data + 3*pixels : NULL;
+
+    bool ok = true;
+    for ( uint32 y = 0; y < h; y += bandRows )
+    {
+        const uint32 numRows = wxMin(bandRows, h - y);
+
+        img.row_offset = y;
+        img.col_offset = 0;
+        if ( !TIFFRGBAImageGet(&img, raster, w, numRows) )
+        {
+            if (verbose)
+            {
+                wxLogError( _("TIFF: Error reading image.") );
+            }
+
+            ok = false;
+            break;
+        }
+
+        unsigned char *ptr = data;
+        unsigned char *ptrAlpha = alpha;
+        const uint32 count = w * numRows;
+        for ( uint32 pos = 0; pos < count; pos++ )
+        {
+            *(ptr++) = (unsigned char)TIFFGetR(raster[pos]);
+            *(ptr++) = (unsigned char)TIFFGetG(raster[pos]);
+            *(ptr++) = (unsigned char)TIFFGetB(raster[pos]);
+            if ( hasAlpha )
+                *(ptrAlpha++) = (unsigned char)TIFFGetA(raster[pos]);
+        }
+
+        if ( !consumer.ConsumeRows((int)w, (int)y, (int)numRows, data, alpha) )
+        {
+            ok = false;
+            break;
+        }
+    }
+
+    _TIFFfree( data );
+    _TIFFfree( raster );
+    TIFFRGBAImageEnd( &img );
+
+    return ok;
+}
+
+// set the image options from the tags of the current TIFF directory
+static void
+SetTIFFImageOptions(wxImage *image, TIFF *tif,
+                    uint16 photometric,
+                    uint16 samplesPerPixel,
+                    uint16 bitsPerSample)
+{
+    image->SetOption(wxIMAGE_OPTION_TIFF_PHOTOMETRIC, photometric);
+
+    uint16 compression;
+    /*
+    Copy some baseline TIFF tags which helps when re-saving a TIFF
+    to be similar to the original image.
+    */
+    if (samplesPerPixel)
+    {
+        image->SetOption(wxIMAGE_OPTION_TIFF_SAMPLESPERPIXEL, samplesPerPixel);
+    }
+
+    if (bitsPerSample)
+    {
+        image->SetOption(wxIMAGE_OPTION_TIFF_BITSPERSAMPLE, bitsPerSample);
+    }
+
+    if ( TIFFGetFieldDefaulted(tif, TIFFTAG_COMPRESSION, &compression) )
+    {
+        image->SetOption(wxIMAGE_OPTION_TIFF_COMPRESSION, compression);
+    }
+
+    // Set the resolution unit.
+    wxImageResolution resUnit = wxIMAGE_RESOLUTION_NONE;
+    uint16 tiffRes;
+    if ( TIFFGetFieldDefaulted(tif, TIFFTAG_RESOLUTIONUNIT, &tiffRes) )
+    {
+        switch (tiffRes)
+        {
+            default:
+                wxLogWarning(_("Unknown TIFF resolution unit %d ignored"),
+                    tiffRes);
+                wxFALLTHROUGH;
+
+            case RESUNIT_NONE:
+                resUnit = wxIMAGE_RESOLUTION_NONE;
+                break;
+
+            case RESUNIT_INCH:
+                resUnit = wxIMAGE_RESOLUTION_INCHES;
+                break;
+
+            case RESUNIT_CENTIMETER:
+                resUnit = wxIMAGE_RESOLUTION_CM;
+                break;
+        }
+    }
+
+    image->SetOption(wxIMAGE_OPTION_RESOLUTIONUNIT, resUnit);
+
+    /*
+    Set the image resolution if it's available. Resolution tag is not
+    dependent on RESOLUTIONUNIT != RESUNIT_NONE (according to TIFF spec).
+    */
+    float resX, resY;
+
+    if ( TIFFGetField(tif, TIFFTAG_XRESOLUTION, &resX) )
+    {
+        /*
+        Use a string value to not lose precision.
+        rounding to int as cm and then converting to inch may
+        result in whole integer rounding error, eg. 201 instead of 200 dpi.
+        If an app wants an int, GetOptionInt will convert and round down.
+        */
+        image->SetOption(wxIMAGE_OPTION_RESOLUTIONX,
+            wxString::FromCDouble((double) resX));
+    }
+
+    if ( TIFFGetField(tif, TIFFTAG_YRESOLUTION, &resY) )
+    {
+        image->SetOption(wxIMAGE_OPTION_RESOLUTIONY,
+            wxString::FromCDouble((double) resY));
+    }
+}
+
 bool wxTIFFHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbose, int index )
 {
     if (index == -1)
         index = 0;
 
+    // save this before calling Destroy()
+    const unsigned maxWidth = image->GetOptionInt(wxIMAGE_OPTION_MAX_WIDTH),
+                   maxHeight = image->GetOptionInt(wxIMAGE_OPTION_MAX_HEIGHT);
+
     image->Destroy();
 
     TIFF *tif = TIFFwxOpen( stream, "image", "r" );
@@ -338,12 +581,38 @@ bool wxTIFFHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
     {
         photometric = PHOTOMETRIC_MINISWHITE;
     }
-    const bool hasAlpha = (extraSamples >= 1
-        && ((samplesInfo[0] == EXTRASAMPLE_UNSPECIFIED)
-            || samplesInfo[0] == EXTRASAMPLE_ASSOCALPHA
-            || samplesInfo[0] == EXTRASAMPLE_UNASSALPHA))
-        || (extraSamples == 0 && samplesPerPixel == 4
-            && photometric == PHOTOMETRIC_RGB);
+    const bool hasAlpha = TIFFHasAlpha(tif);
+
+    if ( maxWidth || maxHeight )
+    {
+        unsigned width = w,
+                 height = h;
+        wxGetImageLoadSize(maxWidth, maxHeight, width, height);
+
+        // scale the image down while decoding it if possible, without ever
+        // allocating the memory for all of its pixels
+        if ( (width != w || height != h) && CanReadTIFFRows(tif) )
+        {
+            wxScopedPtr<wxImageRowsConsumer>
+                downscaler(wxCreateImageDownscaler(*image, maxWidth, maxHeight));
+            if ( !ReadTIFFRows(tif, *downscaler, 64, verbose) )
+            {
+                if ( image->IsOk() )
+                    image->Destroy();
+
+                TIFFClose( tif );
+
+                return false;
+            }
+
+            SetTIFFImageOptions(image, tif, photometric, samplesPerPixel,
+                                bitsPerSample);
+
+            TIFFClose( tif );
+
+            return true;
+        }
+    }
 
     // guard against integer overflow during multiplication which could result
     // in allocating a too small buffer and then overflowing it
@@ -496,85 +765,69 @@ bool wxTIFFHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
     }
 
 
-    image->SetOption(wxIMAGE_OPTION_TIFF_PHOTOMETRIC, photometric);
+    SetTIFFImageOptions(image, tif, photometric, samplesPerPixel, bitsPerSample);
 
-    uint16 compression;
-    /*
-    Copy some baseline TIFF tags which helps when re-saving a TIFF
-    to be similar to the original image.
-    */
-    if (samplesPerPixel)
-    {
-        image->SetOption(wxIMAGE_OPTION_TIFF_SAMPLESPERPIXEL, samplesPerPixel);
-    }
+    _TIFFfree( raster );
 
-    if (bitsPerSample)
-    {
-        image->SetOption(wxIMAGE_OPTION_TIFF_BITSPERSAMPLE, bitsPerSample);
-    }
+    TIFFClose( tif );
 
-    if ( TIFFGetFieldDefaulted(tif, TIFFTAG_COMPRESSION, &compression) )
-    {
-        image->SetOption(wxIMAGE_OPTION_TIFF_COMPRESSION, compression);
-    }
+    return true;
+}
 
-    // Set the resolution unit.
-    wxImageResolution resUnit = wxIMAGE_RESOLUTION_NONE;
-    uint16 tiffRes;
-    if ( TIFFGetFieldDefaulted(tif, TIFFTAG_RESOLUTIONUNIT, &tiffRes) )
-    {
-        switch (tiffRes)
-        {
-            default:
-                wxLogWarning(_("Unknown TIFF resolution unit %d ignored"),
-                    tiffRes);
-                wxFALLTHROUGH;
+bool wxTIFFHandler::LoadRows( wxInputStream& stream,
+                              wxImageRowsConsumer& consumer,
+                              int bandHeight,
+                              bool verbose,
+                              int index )
+{
+    wxCHECK_MSG( bandHeight > 0, false, wxS("invalid band height") );
 
-            case RESUNIT_NONE:
-                resUnit = wxIMAGE_RESOLUTION_NONE;
-                break;
+    if (index == -1)
+        index = 0;
 
-            case RESUNIT_INCH:
-                resUnit = wxIMAGE_RESOLUTION_INCHES;
-                break;
+    const wxFileOffset posOld = stream.TellI();
 
-            case RESUNIT_CENTIMETER:
-                resUnit = wxIMAGE_RESOLUTION_CM;
-                break;
+    TIFF *tif = TIFFwxOpen( stream, "image", "r" );
+
+    if (!tif)
+    {
+        if (verbose)
+        {
+            wxLogError( _("TIFF: Error loading image.") );
         }
+
+        return false;
     }
 
-    image->SetOption(wxIMAGE_OPTION_RESOLUTIONUNIT, resUnit);
+    if (!TIFFSetDirectory( tif, (tdir_t)index ))
+    {
+        if (verbose)
+        {
+            wxLogError( _("Invalid TIFF image index.") );
+        }
 
-    /*
-    Set the image resolution if it's available. Resolution tag is not
-    dependent on RESOLUTIONUNIT != RESUNIT_NONE (according to TIFF spec).
-    */
-    float resX, resY;
+        TIFFClose( tif );
 
-    if ( TIFFGetField(tif, TIFFTAG_XRESOLUTION, &resX) )
-    {
-        /*
-        Use a string value to not lose precision.
-        rounding to int as cm and then converting to inch may
-        result in whole integer rounding error, eg. 201 instead of 200 dpi.
-        If an app wants an int, GetOptionInt will convert and round down.
-        */
-        image->SetOption(wxIMAGE_OPTION_RESOLUTIONX,
-            wxString::FromCDouble((double) resX));
+        return false;
     }
 
-    if ( TIFFGetField(tif, TIFFTAG_YRESOLUTION, &resY) )
+    if ( !CanReadTIFFRows(tif) )
     {
-        image->SetOption(wxIMAGE_OPTION_RESOLUTIONY,
-            wxString::FromCDouble((double) resY));
+        // Load the entire image and split it into bands.
+        TIFFClose( tif );
+
+        if ( stream.SeekI(posOld) == wxInvalidOffset )
+            return false;
+
+        return wxImageHandler::LoadRows(stream, consumer, bandHeight,
+                                        verbose, index);
     }
 
-    _TIFFfree( raster );
+    const bool ok = ReadTIFFRows(tif, consumer, bandHeight, verbose);
 
     TIFFClose( tif );
 
-    return true;
+    return ok;
 }
 
 int wxTIFFHandler::DoGetImageCount( wxInputStream& stream )
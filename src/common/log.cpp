@@ -36,6 +36,7 @@
 #endif //WX_PRECOMP
 
 #include "wx/apptrait.h"
+#include "wx/atomic.h"
 #include "wx/datetime.h"
 #include "wx/file.h"
 #include "wx/msgout.h"
@@ -43,6 +44,7 @@
 #include "wx/thread.h"
 #include "wx/private/threadinfo.h"
 #include "wx/crt.h"
+#include "wx/time.h"
 #include "wx/vector.h"
 
 // other standard headers
@@ -103,6 +105,28 @@ WX_DEFINE_LOG_CS(TraceMask);
 // and this one is used for GetComponentLevels()
 WX_DEFINE_LOG_CS(Levels);
 
+// the number of threads other than main currently using the global log target
+// directly, because it is thread-safe, used by SetActiveTarget() to wait
+// until the old target is not used any more
+wxAtomicInt gs_numThreadsUsingGlobalLogger(0);
+
+// wait until no other threads use the global log target which was just changed
+void WaitUntilGlobalLoggerUnused()
+{
+    // this works because both this thread, after changing the pointer, and
+    // the other threads, before reading it, modify the counter atomically,
+    // which implies a full memory barrier: so either the other thread sees the
+    // new value of the pointer or we see its counter increment and wait
+    for ( ;; )
+    {
+        wxAtomicInc(gs_numThreadsUsingGlobalLogger);
+        if ( !wxAtomicDec(gs_numThreadsUsingGlobalLogger) )
+            break;
+
+        wxMilliSleep(1);
+    }
+}
+
 } // anonymous namespace
 
 #endif // wxUSE_THREADS
@@ -357,7 +381,26 @@ wxLog::OnLog(wxLogLevel level,
         logger = wxThreadInfo.logger;
         if ( !logger )
         {
-            if ( ms_pLogger )
+            // notice that we must increment the counter before reading the
+            // global logger pointer, see WaitUntilGlobalLoggerUnused()
+            wxAtomicInc(gs_numThreadsUsingGlobalLogger);
+
+            wxLog * const loggerGlobal = ms_pLogger;
+            if ( loggerGlobal && loggerGlobal->IsThreadSafe() )
+            {
+                // we can use the global logger directly from this thread, but
+                // without counting the repeated messages as this can't be
+                // done safely from multiple threads
+                loggerGlobal->CallDoLogRecord(level, msg, info);
+
+                wxAtomicDec(gs_numThreadsUsingGlobalLogger);
+
+                return;
+            }
+
+            wxAtomicDec(gs_numThreadsUsingGlobalLogger);
+
+            if ( loggerGlobal )
             {
                 // buffer the messages until they can be shown from the main
                 // thread
@@ -411,6 +454,14 @@ wxLog::CallDoLogNow(wxLogLevel level,
         gs_prevLog.info = info;
     }
 
+    CallDoLogRecord(level, msg, info);
+}
+
+void
+wxLog::CallDoLogRecord(wxLogLevel level,
+                       const wxString& msg,
+                       const wxLogRecordInfo& info)
+{
     // handle extra data which may be passed to us by wxLogXXX()
     wxString prefix, suffix;
     wxUIntPtr num = 0;
@@ -549,6 +600,14 @@ wxLog *wxLog::SetActiveTarget(wxLog *pLogger)
     wxLog *pOldLogger = ms_pLogger;
     ms_pLogger = pLogger;
 
+#if wxUSE_THREADS
+    // the old logger could be still used by the other threads if it's
+    // thread-safe, wait until they're done with it as the caller typically
+    // deletes it as soon as we return
+    if ( pOldLogger && pOldLogger->IsThreadSafe() )
+        WaitUntilGlobalLoggerUnused();
+#endif // wxUSE_THREADS
+
     return pOldLogger;
 }
 
@@ -983,6 +1042,424 @@ wxLogInterposerTemp::wxLogInterposerTemp()
     #pragma warning(default:4355)
 #endif // VC++
 
+// ----------------------------------------------------------------------------
+// wxLogAsync
+// ----------------------------------------------------------------------------
+
+#if wxUSE_THREADS
+
+// a single message logged by wxLogAsync
+struct wxLogAsyncRecord
+{
+    wxLogAsyncRecord(wxLogLevel level_, const wxString& msg_)
+        : level(level_),
+          msg(msg_),
+          time(wxGetUTCTimeUSec())
+    {
+    }
+
+    wxLogLevel level;
+    wxString msg;
+
+    // used for merging the messages from different threads in order
+    wxLongLong time;
+};
+
+typedef wxVector<wxLogAsyncRecord> wxLogAsyncRecords;
+
+// the messages logged by a single thread and not flushed yet
+//
+// this object is referenced both by wxLogAsyncImpl and by the thread-specific
+// information of the thread using it and is deleted when both of them release
+// it, i.e. when the thread exits and the remaining messages are flushed or
+// when wxLogAsync is destroyed, whichever happens last
+class wxLogAsyncBuffer
+{
+public:
+    wxLogAsyncBuffer()
+        : m_refCount(2),
+          m_dropped(0),
+          m_threadExited(false)
+    {
+    }
+
+    void DecRef()
+    {
+        bool deleteThis;
+        {
+            wxCriticalSectionLocker lock(m_cs);
+
+            deleteThis = --m_refCount == 0;
+        }
+
+        if ( deleteThis )
+            delete this;
+    }
+
+    // called by the thread using this buffer when it terminates, the buffer
+    // must not be used by it after calling this function
+    void OnThreadExit()
+    {
+        {
+            wxCriticalSectionLocker lock(m_cs);
+
+            m_threadExited = true;
+        }
+
+        DecRef();
+    }
+
+    bool HasThreadExited() const
+    {
+        wxCriticalSectionLocker lock(m_cs);
+
+        return m_threadExited;
+    }
+
+    // add a new record unless the buffer is full, return the number of
+    // records in it
+    size_t Add(wxLogLevel level, const wxString& msg, size_t maxRecords)
+    {
+        wxCriticalSectionLocker lock(m_cs);
+
+        if ( m_records.size() >= maxRecords )
+        {
+            m_dropped++;
+            return maxRecords;
+        }
+
+        m_records.push_back(wxLogAsyncRecord(level, msg));
+
+        return m_records.size();
+    }
+
+    // take all the records from the buffer
+    void TakeRecords(wxLogAsyncRecords& records)
+    {
+        wxCriticalSectionLocker lock(m_cs);
+
+        records.swap(m_records);
+    }
+
+    unsigned long GetDroppedCount() const
+    {
+        wxCriticalSectionLocker lock(m_cs);
+
+        return m_dropped;
+    }
+
+private:
+    // this critical section is only used by this thread and when flushing,
+    // so it's almost never contended
+    mutable wxCriticalSection m_cs;
+
+    unsigned m_refCount;
+
+    wxLogAsyncRecords m_records;
+    unsigned long m_dropped;
+
+    bool m_threadExited;
+
+    wxDECLARE_NO_COPY_CLASS(wxLogAsyncBuffer);
+};
+
+// the background thread passing the messages to the real logger and the data
+// shared by it with wxLogAsync
+class wxLogAsyncImpl : public wxThread
+{
+public:
+    wxLogAsyncImpl(wxLog *logger,
+                   size_t maxPendingPerThread,
+                   unsigned long flushInterval)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_logger(logger),
+          m_maxPendingPerThread(maxPendingPerThread),
+          m_flushInterval(flushInterval),
+          m_serial(GetNextSerial()),
+          m_droppedExited(0),
+          m_droppedReported(0),
+          m_stop(false)
+    {
+    }
+
+    virtual ~wxLogAsyncImpl()
+    {
+        for ( size_t n = 0; n < m_buffers.size(); n++ )
+            m_buffers[n]->DecRef();
+
+        delete m_logger;
+    }
+
+    // called from any thread to log a message
+    void Log(wxLogLevel level, const wxString& msg)
+    {
+        wxLogAsyncBuffer * const buffer = GetBufferForThisThread();
+        const size_t count = buffer->Add(level, msg, m_maxPendingPerThread);
+
+        // wake up the background thread if the buffer is getting full to
+        // avoid losing the messages
+        if ( count == m_maxPendingPerThread / 2 + 1 )
+            m_wakeUp.Post();
+    }
+
+    // pass all the pending messages to the real logger and optionally flush
+    // it too, may be called from any thread
+    void FlushBuffers(bool flushLogger = false);
+
+    unsigned long GetDroppedCount() const
+    {
+        wxCriticalSectionLocker lock(m_buffersCS);
+
+        unsigned long dropped = m_droppedExited;
+        for ( size_t n = 0; n < m_buffers.size(); n++ )
+            dropped += m_buffers[n]->GetDroppedCount();
+
+        return dropped;
+    }
+
+    // stop the background thread and wait until it terminates
+    void Stop()
+    {
+        m_stop = true;
+        m_wakeUp.Post();
+
+        Wait();
+    }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        while ( !m_stop )
+        {
+            m_wakeUp.WaitTimeout(m_flushInterval);
+
+            FlushBuffers();
+        }
+
+        return 0;
+    }
+
+private:
+    static unsigned GetNextSerial()
+    {
+        wxCriticalSectionLocker lock(GetBackgroundLogCS());
+
+        static unsigned s_serial = 0;
+        return ++s_serial;
+    }
+
+    wxLogAsyncBuffer *GetBufferForThisThread();
+
+    wxLog * const m_logger;
+    const size_t m_maxPendingPerThread;
+    const unsigned long m_flushInterval;
+
+    // the serial number of this object, used to check if the buffer pointer
+    // stored in wxThreadSpecificInfo was created by it
+    const unsigned m_serial;
+
+    // the buffers of all threads which logged anything and the number of
+    // messages dropped by the threads which have already exited and whose
+    // buffers were freed, protected by the critical section which is only
+    // locked when a thread logs its first message and when flushing
+    wxVector<wxLogAsyncBuffer*> m_buffers;
+    unsigned long m_droppedExited;
+    mutable wxCriticalSection m_buffersCS;
+
+    // used to ensure that the messages are passed to m_logger by one thread
+    // at a time and in order
+    wxCriticalSection m_flushCS;
+
+    // the number of dropped messages we had already reported, only used
+    // inside m_flushCS
+    unsigned long m_droppedReported;
+
+    wxSemaphore m_wakeUp;
+    volatile bool m_stop;
+
+    wxDECLARE_NO_COPY_CLASS(wxLogAsyncImpl);
+};
+
+wxLogAsyncBuffer *wxLogAsyncImpl::GetBufferForThisThread()
+{
+    wxThreadSpecificInfo& info = wxThreadInfo;
+    if ( info.asyncLogSerial == m_serial )
+        return info.asyncLogBuffer;
+
+    wxLogAsyncBuffer * const buffer = new wxLogAsyncBuffer;
+    {
+        wxCriticalSectionLocker lock(m_buffersCS);
+
+        m_buffers.push_back(buffer);
+    }
+
+    // release the buffer used by a previously active wxLogAsync, if any
+    if ( info.asyncLogBuffer )
+        info.asyncLogBuffer->DecRef();
+
+    info.asyncLogBuffer = buffer;
+    info.asyncLogSerial = m_serial;
+
+    return buffer;
+}
+
+void wxLogAsyncImpl::FlushBuffers(bool flushLogger)
+{
+    wxCriticalSectionLocker lockFlush(m_flushCS);
+
+    // take the records from all buffers, without locking the buffers list for
+    // longer than necessary
+    wxVector<wxLogAsyncRecords> batches;
+    unsigned long dropped = 0;
+    {
+        wxCriticalSectionLocker lock(m_buffersCS);
+
+        batches.resize(m_buffers.size());
+
+        wxVector<wxLogAsyncBuffer*> buffersAlive;
+        buffersAlive.reserve(m_buffers.size());
+
+        for ( size_t n = 0; n < m_buffers.size(); n++ )
+        {
+            wxLogAsyncBuffer * const buffer = m_buffers[n];
+
+            // check this before taking the records, as no new records can be
+            // added after the thread exited
+            const bool threadExited = buffer->HasThreadExited();
+
+            buffer->TakeRecords(batches[n]);
+
+            if ( threadExited )
+            {
+                // nobody else is going to use this buffer, so free it
+                m_droppedExited += buffer->GetDroppedCount();
+                buffer->DecRef();
+            }
+            else
+            {
+                dropped += buffer->GetDroppedCount();
+                buffersAlive.push_back(buffer);
+            }
+        }
+
+        m_buffers.swap(buffersAlive);
+
+        dropped += m_droppedExited;
+    }
+
+    // the messages from each thread are already in order, so we just need to
+    // merge them
+    wxVector<size_t> next(batches.size(), 0);
+    for ( ;; )
+    {
+        const wxLogAsyncRecord *record = NULL;
+        size_t batch = 0;
+        for ( size_t n = 0; n < batches.size(); n++ )
+        {
+            if ( next[n] == batches[n].size() )
+                continue;
+
+            const wxLogAsyncRecord& r = batches[n][next[n]];
+            if ( !record || r.time < record->time )
+            {
+                record = &r;
+                batch = n;
+            }
+        }
+
+        if ( !record )
+            break;
+
+        m_logger->LogTextAtLevel(record->level, record->msg);
+        next[batch]++;
+    }
+
+    if ( dropped != m_droppedReported )
+    {
+        const unsigned long numDropped = dropped - m_droppedReported;
+
+        wxLogRecordInfo info;
+        info.timestamp = time(NULL);
+        info.threadId = wxThread::GetCurrentId();
+
+        m_logger->LogRecord
+                  (
+                    wxLOG_Warning,
+                    wxString::Format
+                    (
+#if wxUSE_INTL
+                        wxPLURAL
+                        (
+                            "%lu log message was dropped",
+                            "%lu log messages were dropped",
+                            numDropped
+                        ),
+#else
+                        wxS("%lu log message(s) were dropped"),
+#endif
+                        numDropped
+                    ),
+                    info
+                  );
+
+        m_droppedReported = dropped;
+    }
+
+    if ( flushLogger )
+        m_logger->Flush();
+}
+
+wxLogAsync::wxLogAsync(wxLog *logger,
+                       size_t maxPendingPerThread,
+                       unsigned long flushInterval)
+{
+    wxASSERT_MSG( logger, "must have a log target" );
+
+    m_impl = new wxLogAsyncImpl(logger, maxPendingPerThread, flushInterval);
+    if ( m_impl->Run() != wxTHREAD_NO_ERROR )
+    {
+        // we can still work, but the messages will be only flushed when
+        // Flush() is called
+        wxFAIL_MSG( "failed to start the background logging thread" );
+    }
+}
+
+wxLogAsync::~wxLogAsync()
+{
+    if ( m_impl->IsRunning() )
+        m_impl->Stop();
+
+    // flush the messages which could have been logged after the thread
+    // terminated
+    m_impl->FlushBuffers();
+
+    delete m_impl;
+}
+
+unsigned long wxLogAsync::GetDroppedCount() const
+{
+    return m_impl->GetDroppedCount();
+}
+
+void wxLogAsync::Flush()
+{
+    wxLog::Flush();
+
+    m_impl->FlushBuffers(true /* flush the logger too */);
+}
+
+void wxLogAsync::DoLogTextAtLevel(wxLogLevel level, const wxString& msg)
+{
+    m_impl->Log(level, msg);
+}
+
+void wxLogAsyncReleaseThreadBuffer(wxLogAsyncBuffer *buffer)
+{
+    buffer->OnThreadExit();
+}
+
+#endif // wxUSE_THREADS
+
 // ============================================================================
 // Global functions/variables
 // ============================================================================
@@ -45,6 +45,8 @@
     #include "wx/image.h"
 #endif
 
+#include "wx/private/image.h"
+
 #ifdef __WXMSW__
     #include "wx/msw/private.h"
 #endif
@@ -1031,9 +1033,11 @@ pass2_no_dither (j_decompress_ptr cinfo,
 #endif
 
 void
-pass2_fs_dither (j_decompress_ptr cinfo,
+fs_dither_rows (j_decompress_ptr cinfo, FSERRPTR fserrors, bool *on_odd_row,
          JSAMPARRAY input_buf, JSAMPARRAY output_buf, int num_rows)
 /* This version performs Floyd-Steinberg dithering */
+/* using the given error array and row parity, so that different bands */
+/* of the image can be processed in parallel */
 {
   my_cquantize_ptr cquantize = (my_cquantize_ptr) cinfo->cquantize;
   hist3d histogram = cquantize->histogram;
@@ -1059,20 +1063,20 @@ pass2_fs_dither (j_decompress_ptr cinfo,
   for (row = 0; row < num_rows; row++) {
     inptr = input_buf[row];
     outptr = output_buf[row];
-    if (cquantize->on_odd_row) {
+    if (*on_odd_row) {
       /* work right to left in this row */
       inptr += (width-1) * 3;   /* so point to rightmost pixel */
       outptr += width-1;
       dir = -1;
       dir3 = -3;
-      errorptr = cquantize->fserrors + (width+1)*3; /* => entry after last column */
-      cquantize->on_odd_row = false; /* flip for next time */
+      errorptr = fserrors + (width+1)*3; /* => entry after last column */
+      *on_odd_row = false; /* flip for next time */
     } else {
       /* work left to right in this row */
       dir = 1;
       dir3 = 3;
-      errorptr = cquantize->fserrors; /* => entry before first real column */
-      cquantize->on_odd_row = true; /* flip for next time */
+      errorptr = fserrors; /* => entry before first real column */
+      *on_odd_row = true; /* flip for next time */
     }
     /* Preset error values: no error propagated to first pixel from left */
     cur0 = cur1 = cur2 = 0;
@@ -1192,6 +1196,36 @@ pass2_fs_dither (j_decompress_ptr cinfo,
   }
 }
 
+void
+pass2_fs_dither (j_decompress_ptr cinfo,
+         JSAMPARRAY input_buf, JSAMPARRAY output_buf, int num_rows)
+{
+  my_cquantize_ptr cquantize = (my_cquantize_ptr) cinfo->cquantize;
+
+  fs_dither_rows(cinfo, cquantize->fserrors, &cquantize->on_odd_row,
+         input_buf, output_buf, num_rows);
+}
+
+void
+fill_whole_inverse_cmap (j_decompress_ptr cinfo)
+/* Fill all the inverse-colormap entries which are not filled yet, this */
+/* allows using the inverse colormap from several threads */
+{
+  my_cquantize_ptr cquantize = (my_cquantize_ptr) cinfo->cquantize;
+  hist3d histogram = cquantize->histogram;
+  int c0, c1, c2;
+
+  for (c0 = 0; c0 < HIST_C0_ELEMS; c0 += BOX_C0_ELEMS) {
+    for (c1 = 0; c1 < HIST_C1_ELEMS; c1 += BOX_C1_ELEMS) {
+      for (c2 = 0; c2 < HIST_C2_ELEMS; c2 += BOX_C2_ELEMS) {
+        /* the whole box is filled at once, so checking one cell is enough */
+        if (histogram[c0][c1][c2] == 0)
+          fill_inverse_cmap(cinfo, c0, c1, c2);
+      }
+    }
+  }
+}
+
 /*
  * Initialize the error-limiting transfer function (lookup table).
  * The raw F-S error computation can potentially compute error values of up to
@@ -1416,54 +1450,203 @@ prepare_range_limit_table (j_decompress_ptr cinfo)
 } // anonymous namespace
 
 
-/*
- * wxQuantize
- */
+// ----------------------------------------------------------------------------
+// wxQuantizerImpl: wrapper for the quantizer state above
+// ----------------------------------------------------------------------------
 
-wxIMPLEMENT_DYNAMIC_CLASS(wxQuantize, wxObject);
+namespace
+{
 
-void wxQuantize::DoQuantize(unsigned w, unsigned h, unsigned char **in_rows, unsigned char **out_rows,
-    unsigned char *palette, int desiredNoColours)
+// Dithers the image in independent bands of the given height.
+class DitherBandsProcessor : public wxImageRowsProcessor
+{
+public:
+    DitherBandsProcessor(j_decompress_ptr cinfo,
+                         JSAMPARRAY in_rows,
+                         JSAMPARRAY out_rows,
+                         int numRows,
+                         int bandHeight)
+        : m_cinfo(cinfo),
+          m_inRows(in_rows),
+          m_outRows(out_rows),
+          m_numRows(numRows),
+          m_bandHeight(bandHeight)
+    {
+    }
+
+    virtual void ProcessRows(int start, int end) const wxOVERRIDE
+    {
+        const size_t arraysize = (m_cinfo->output_width + 2) *
+                                    (3 * sizeof(FSERROR));
+        FSERRPTR fserrors = (FSERRPTR) malloc(arraysize);
+
+        for ( int band = start; band < end; band++ )
+        {
+            const int first = band * m_bandHeight;
+            int num = m_numRows - first;
+            if ( num > m_bandHeight )
+                num = m_bandHeight;
+
+            // Each band starts as if it were a separate image, this makes the
+            // result independent of the number of threads used.
+            memset(fserrors, 0, arraysize);
+            bool on_odd_row = false;
+
+            fs_dither_rows(m_cinfo, fserrors, &on_odd_row,
+                           m_inRows + first, m_outRows + first, num);
+        }
+
+        free(fserrors);
+    }
+
+private:
+    const j_decompress_ptr m_cinfo;
+    const JSAMPARRAY m_inRows;
+    const JSAMPARRAY m_outRows;
+    const int m_numRows;
+    const int m_bandHeight;
+};
+
+} // anonymous namespace
+
+class wxQuantizerImpl
 {
-    j_decompress dec;
-    my_cquantize_ptr cquantize;
+public:
+    explicit wxQuantizerImpl(int numColours)
+    {
+        m_dec.colormap = NULL;
+        m_dec.output_width = 0;
+        m_dec.desired_number_of_colors = numColours;
+        prepare_range_limit_table(&m_dec);
+        jinit_2pass_quantizer(&m_dec);
+        m_cquantize = (my_cquantize_ptr) m_dec.cquantize;
+
+        m_cquantize->pub.start_pass(&m_dec, true);
+
+        m_hasImages =
+        m_hasPalette =
+        m_inverseCmapFilled = false;
+    }
+
+    ~wxQuantizerImpl()
+    {
+        for (int ii = 0; ii < HIST_C0_ELEMS; ii++) free(m_cquantize->histogram[ii]);
+        free(m_cquantize->histogram);
+        free(m_cquantize->sv_colormap[0]);
+        free(m_cquantize->sv_colormap[1]);
+        free(m_cquantize->sv_colormap[2]);
+        free(m_cquantize->sv_colormap);
+        free(m_dec.srl_orig);
+
+        free((void*)(m_cquantize->error_limiter - MAXJSAMPLE)); // To reverse what was done to it
+
+        free(m_cquantize->fserrors);
+        free(m_cquantize);
+    }
+
+    bool HasImages() const { return m_hasImages; }
+    bool HasPalette() const { return m_hasPalette; }
+
+    // Add the colours of the given rows to the histogram.
+    void AddRows(unsigned w, unsigned h, JSAMPARRAY in_rows)
+    {
+        wxASSERT( !m_hasPalette );
+
+        if ( !w || !h )
+            return;
+
+        m_dec.output_width = w;
+        m_cquantize->pub.color_quantize(&m_dec, in_rows, NULL, h);
+        m_hasImages = true;
+    }
+
+    // Select the palette colours from the histogram.
+    void CreatePalette()
+    {
+        if ( m_hasPalette )
+            return;
+
+        m_cquantize->pub.finish_pass(&m_dec);
+        m_hasPalette = true;
+    }
+
+    int GetPaletteSize() const { return m_dec.actual_number_of_colors; }
 
-    dec.colormap = NULL;
-    dec.output_width = w;
-    dec.desired_number_of_colors = desiredNoColours;
-    prepare_range_limit_table(&dec);
-    jinit_2pass_quantizer(&dec);
-    cquantize = (my_cquantize_ptr) dec.cquantize;
+    // Copy the first "count" palette entries as RGB triplets.
+    void CopyPalette(unsigned char* palette, int count) const
+    {
+        for (int i = 0; i < count; i++) {
+            palette[3 * i + 0] = m_dec.colormap[0][i];
+            palette[3 * i + 1] = m_dec.colormap[1][i];
+            palette[3 * i + 2] = m_dec.colormap[2][i];
+        }
+    }
+
+    // Map the rows to the palette indices using Floyd-Steinberg dithering,
+    // either for the whole image at once, if bandHeight is 0, or in
+    // independent bands of the given height which are processed in parallel.
+    void MapRows(unsigned w, unsigned h,
+                 JSAMPARRAY in_rows, JSAMPARRAY out_rows,
+                 int bandHeight)
+    {
+        CreatePalette();
 
+        // Reallocate the errors array for the width of this image: this also
+        // clears the inverse colormap cache, but only the first time, so that
+        // it's reused for all the subsequent images.
+        m_dec.output_width = w;
+        free(m_cquantize->fserrors);
+        m_cquantize->fserrors = NULL;
+        m_cquantize->pub.start_pass(&m_dec, false);
 
-    cquantize->pub.start_pass(&dec, true);
-    cquantize->pub.color_quantize(&dec, in_rows, out_rows, h);
-    cquantize->pub.finish_pass(&dec);
+        if ( bandHeight <= 0 || h <= (unsigned)bandHeight )
+        {
+            m_cquantize->pub.color_quantize(&m_dec, in_rows, out_rows, h);
+            m_cquantize->pub.finish_pass(&m_dec);
+            return;
+        }
 
-    cquantize->pub.start_pass(&dec, false);
-    cquantize->pub.color_quantize(&dec, in_rows, out_rows, h);
-    cquantize->pub.finish_pass(&dec);
+        // The inverse colormap cache is filled lazily, which can't be done
+        // from multiple threads, so fill it completely before starting them.
+        if ( !m_inverseCmapFilled )
+        {
+            fill_whole_inverse_cmap(&m_dec);
+            m_inverseCmapFilled = true;
+        }
 
+        const int numBands = (h + bandHeight - 1) / bandHeight;
+        DitherBandsProcessor processor(&m_dec, in_rows, out_rows, h, bandHeight);
+        wxProcessImageRowsInParallel(processor, numBands, (size_t)w * h * 4);
 
-    for (int i = 0; i < dec.desired_number_of_colors; i++) {
-        palette[3 * i + 0] = dec.colormap[0][i];
-        palette[3 * i + 1] = dec.colormap[1][i];
-        palette[3 * i + 2] = dec.colormap[2][i];
+        m_cquantize->pub.finish_pass(&m_dec);
     }
 
-    for (int ii = 0; ii < HIST_C0_ELEMS; ii++) free(cquantize->histogram[ii]);
-    free(cquantize->histogram);
-    free(dec.colormap[0]);
-    free(dec.colormap[1]);
-    free(dec.colormap[2]);
-    free(dec.colormap);
-    free(dec.srl_orig);
+private:
+    j_decompress m_dec;
+    my_cquantize_ptr m_cquantize;
+
+    bool m_hasImages;
+    bool m_hasPalette;
+    bool m_inverseCmapFilled;
 
-    //free(cquantize->error_limiter);
-    free((void*)(cquantize->error_limiter - MAXJSAMPLE)); // To reverse what was done to it
+    wxDECLARE_NO_COPY_CLASS(wxQuantizerImpl);
+};
+
+/*
+ * wxQuantize
+ */
 
-    free(cquantize->fserrors);
-    free(cquantize);
+wxIMPLEMENT_DYNAMIC_CLASS(wxQuantize, wxObject);
+
+void wxQuantize::DoQuantize(unsigned w, unsigned h, unsigned char **in_rows, unsigned char **out_rows,
+    unsigned char *palette, int desiredNoColours)
+{
+    wxQuantizerImpl quantizer(desiredNoColours);
+
+    quantizer.AddRows(w, h, in_rows);
+    quantizer.MapRows(w, h, in_rows, out_rows, 0);
+
+    quantizer.CopyPalette(palette, desiredNoColours);
 }
 
 // TODO: somehow make use of the Windows system colours, rather than ignoring them for the
@@ -1625,5 +1808,159 @@ bool wxQuantize::Quantize(const wxImage& src,
     return true;
 }
 
+/*
+ * wxQuantizer
+ */
+
+wxQuantizer::wxQuantizer(int numColours)
+{
+    wxASSERT_MSG( numColours >= 1 && numColours <= 256,
+                  wxS("invalid number of colours") );
+
+    if ( numColours < 1 )
+        numColours = 1;
+    else if ( numColours > 256 )
+        numColours = 256;
+
+    m_numColours = numColours;
+    m_bandHeight = 0;
+    m_impl = new wxQuantizerImpl(m_numColours);
+}
+
+wxQuantizer::~wxQuantizer()
+{
+    delete m_impl;
+}
+
+void wxQuantizer::Reset()
+{
+    delete m_impl;
+    m_impl = new wxQuantizerImpl(m_numColours);
+}
+
+bool wxQuantizer::AddImage(const wxImage& image)
+{
+    wxCHECK_MSG( image.IsOk(), false, wxS("invalid image") );
+    wxCHECK_MSG( !m_impl->HasPalette(), false,
+                 wxS("can't add images after creating the palette") );
+
+    const int w = image.GetWidth();
+    const int h = image.GetHeight();
+
+    unsigned char** const rows = new unsigned char *[h];
+    unsigned char* const data = image.GetData();
+    for ( int y = 0; y < h; y++ )
+        rows[y] = data + 3*w*y;
+
+    m_impl->AddRows(w, h, rows);
+
+    delete[] rows;
+
+    return true;
+}
+
+bool wxQuantizer::CreatePalette()
+{
+    // The palette can't be chosen from an empty histogram.
+    wxCHECK_MSG( m_impl->HasImages(), false, wxS("no images added") );
+
+    if ( !m_impl->HasPalette() )
+    {
+        m_impl->CreatePalette();
+        m_impl->CopyPalette(m_palette, m_impl->GetPaletteSize());
+    }
+
+    return true;
+}
+
+int wxQuantizer::GetPaletteSize() const
+{
+    wxCHECK_MSG( m_impl->HasPalette(), 0, wxS("palette not created yet") );
+
+    return m_impl->GetPaletteSize();
+}
+
+const unsigned char* wxQuantizer::GetPaletteData() const
+{
+    wxCHECK_MSG( m_impl->HasPalette(), NULL, wxS("palette not created yet") );
+
+    return m_palette;
+}
+
+bool wxQuantizer::MapImage(const wxImage& image, unsigned char* indices)
+{
+    wxCHECK_MSG( image.IsOk(), false, wxS("invalid image") );
+    wxCHECK_MSG( indices, false, wxS("NULL output buffer") );
+    wxCHECK_MSG( m_impl->HasImages(), false, wxS("no images added") );
+
+    if ( !CreatePalette() )
+        return false;
+
+    const int w = image.GetWidth();
+    const int h = image.GetHeight();
+
+    unsigned char** const rows = new unsigned char *[h];
+    unsigned char** const outrows = new unsigned char *[h];
+    unsigned char* const data = image.GetData();
+    for ( int y = 0; y < h; y++ )
+    {
+        rows[y] = data + 3*w*y;
+        outrows[y] = indices + w*y;
+    }
+
+    m_impl->MapRows(w, h, rows, outrows, m_bandHeight);
+
+    delete[] rows;
+    delete[] outrows;
+
+    return true;
+}
+
+bool wxQuantizer::MapImage(const wxImage& image, wxImage& dest)
+{
+    wxCHECK_MSG( image.IsOk(), false, wxS("invalid image") );
+    wxCHECK_MSG( m_impl->HasImages(), false, wxS("no images added") );
+
+    const int w = image.GetWidth();
+    const int h = image.GetHeight();
+
+    unsigned char* const data8bit = new unsigned char[w * h];
+    if ( !MapImage(image, data8bit) )
+    {
+        delete[] data8bit;
+        return false;
+    }
+
+    // Always use a new image, as dest may share its data with the source.
+    wxImage result(w, h, false);
+    unsigned char* imgdt = result.GetData();
+    for ( int i = 0; i < w * h; i++ )
+    {
+        const unsigned char c = data8bit[i];
+        *imgdt++ = m_palette[3 * c + 0];
+        *imgdt++ = m_palette[3 * c + 1];
+        *imgdt++ = m_palette[3 * c + 2];
+    }
+
+    delete[] data8bit;
+
+#if wxUSE_PALETTE
+    const int count = m_impl->GetPaletteSize();
+    unsigned char r[256], g[256], b[256];
+    for ( int n = 0; n < count; n++ )
+    {
+        r[n] = m_palette[3 * n + 0];
+        g[n] = m_palette[3 * n + 1];
+        b[n] = m_palette[3 * n + 2];
+    }
+
+    result.SetPalette(wxPalette(count, r, g, b));
+#endif // wxUSE_PALETTE
+
+    dest = result;
+
+    return true;
+}
+
 #endif
     // wxUSE_IMAGE
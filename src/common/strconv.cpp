@@ -60,6 +60,14 @@
     #define WC_UTF16
 #endif
 
+// SSE2 is used for converting ASCII and BMP characters in bulk if available:
+// it always is for x86-64 and may be for x86 too, depending on the options.
+#if defined(__SSE2__) || defined(_M_X64) || \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define wxHAS_SSE2_CONV
+    #include <emmintrin.h>
+#endif
+
 
 // ============================================================================
 // implementation
@@ -143,6 +151,254 @@ static wxUint32 wxDecodeSurrogate(const wxChar16 **pSrc, const wxChar16* end)
     return ((u - 0xd7c0) << 10) + (u2 - 0xdc00);
 }
 
+// ----------------------------------------------------------------------------
+// bulk conversion of ASCII and BMP characters
+// ----------------------------------------------------------------------------
+
+// The functions below convert the initial run of characters not needing any
+// special handling, i.e. ASCII ones for UTF-8 and BMP ones for UTF-16, and
+// return the number of characters converted. If dst is NULL, they only count
+// them. As these characters are by far the most common ones in practice, this
+// makes the conversions much faster than decoding everything one by one.
+
+// Convert ASCII characters from UTF-8 to wchar_t.
+static size_t wxWidenASCII(wchar_t *dst, const char *src, size_t len)
+{
+    size_t n = 0;
+
+#ifdef wxHAS_SSE2_CONV
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; n + 16 <= len; n += 16 )
+    {
+        const __m128i
+            v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + n));
+        if ( _mm_movemask_epi8(v) )
+            break;
+
+        if ( dst )
+        {
+            const __m128i lo = _mm_unpacklo_epi8(v, zero);
+            const __m128i hi = _mm_unpackhi_epi8(v, zero);
+
+            __m128i * const out = reinterpret_cast<__m128i *>(dst + n);
+#ifdef WC_UTF16
+            _mm_storeu_si128(out, lo);
+            _mm_storeu_si128(out + 1, hi);
+#else // !WC_UTF16
+            _mm_storeu_si128(out, _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+#endif // WC_UTF16/!WC_UTF16
+        }
+    }
+#else // !wxHAS_SSE2_CONV
+    // Check 8 bytes at once and then convert them in a loop without any
+    // branches, which the compiler can vectorize.
+    for ( ; n + 8 <= len; n += 8 )
+    {
+        wxUint64 v;
+        memcpy(&v, src + n, sizeof(v));
+        if ( v & wxULL(0x8080808080808080) )
+            break;
+
+        if ( dst )
+        {
+            for ( size_t i = n; i < n + 8; i++ )
+                dst[i] = static_cast<unsigned char>(src[i]);
+        }
+    }
+#endif // wxHAS_SSE2_CONV/!wxHAS_SSE2_CONV
+
+    for ( ; n < len; n++ )
+    {
+        const unsigned char c = src[n];
+        if ( c >= 0x80 )
+            break;
+
+        if ( dst )
+            dst[n] = c;
+    }
+
+    return n;
+}
+
+// Convert ASCII characters from wchar_t to UTF-8.
+static size_t wxNarrowASCII(char *dst, const wchar_t *src, size_t len)
+{
+    size_t n = 0;
+
+#ifdef wxHAS_SSE2_CONV
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; n + 16 <= len; n += 16 )
+    {
+        const __m128i * const in = reinterpret_cast<const __m128i *>(src + n);
+
+#ifdef WC_UTF16
+        const __m128i a = _mm_loadu_si128(in);
+        const __m128i b = _mm_loadu_si128(in + 1);
+        const __m128i nonASCII = _mm_set1_epi16(static_cast<short>(0xff80));
+        const __m128i
+            any = _mm_and_si128(_mm_or_si128(a, b), nonASCII);
+        if ( _mm_movemask_epi8(_mm_cmpeq_epi16(any, zero)) != 0xffff )
+            break;
+
+        if ( dst )
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + n),
+                             _mm_packus_epi16(a, b));
+        }
+#else // !WC_UTF16
+        const __m128i a = _mm_loadu_si128(in);
+        const __m128i b = _mm_loadu_si128(in + 1);
+        const __m128i c = _mm_loadu_si128(in + 2);
+        const __m128i d = _mm_loadu_si128(in + 3);
+        const __m128i nonASCII = _mm_set1_epi32(~0x7f);
+        const __m128i
+            any = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b),
+                                             _mm_or_si128(c, d)), nonASCII);
+        if ( _mm_movemask_epi8(_mm_cmpeq_epi32(any, zero)) != 0xffff )
+            break;
+
+        if ( dst )
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + n),
+                             _mm_packus_epi16(_mm_packs_epi32(a, b),
+                                              _mm_packs_epi32(c, d)));
+        }
+#endif // WC_UTF16/!WC_UTF16
+    }
+#else // !wxHAS_SSE2_CONV
+    for ( ; n + 8 <= len; n += 8 )
+    {
+        wxUint32 any = 0;
+        for ( size_t i = n; i < n + 8; i++ )
+            any |= static_cast<wxUint32>(src[i]);
+
+        if ( any & ~0x7fu )
+            break;
+
+        if ( dst )
+        {
+            for ( size_t i = n; i < n + 8; i++ )
+                dst[i] = static_cast<char>(src[i]);
+        }
+    }
+#endif // wxHAS_SSE2_CONV/!wxHAS_SSE2_CONV
+
+    for ( ; n < len; n++ )
+    {
+        const wxUint32 c = static_cast<wxUint32>(src[n]);
+        if ( c >= 0x80 )
+            break;
+
+        if ( dst )
+            dst[n] = static_cast<char>(c);
+    }
+
+    return n;
+}
+
+#ifndef WC_UTF16
+
+// Convert BMP characters, i.e. anything but surrogates, from UTF-16 in either
+// native or swapped byte order to wchar_t.
+static size_t
+wxWidenBMP(wchar_t *dst, const wxUint16 *src, size_t len, bool swap)
+{
+    size_t n = 0;
+
+#ifdef wxHAS_SSE2_CONV
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i surrogateMask = _mm_set1_epi16(static_cast<short>(0xf800));
+    const __m128i surrogate = _mm_set1_epi16(static_cast<short>(0xd800));
+    for ( ; n + 8 <= len; n += 8 )
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + n));
+        if ( swap )
+            v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+
+        const __m128i s = _mm_cmpeq_epi16(_mm_and_si128(v, surrogateMask),
+                                          surrogate);
+        if ( _mm_movemask_epi8(s) )
+            break;
+
+        if ( dst )
+        {
+            __m128i * const out = reinterpret_cast<__m128i *>(dst + n);
+            _mm_storeu_si128(out, _mm_unpacklo_epi16(v, zero));
+            _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(v, zero));
+        }
+    }
+#endif // wxHAS_SSE2_CONV
+
+    for ( ; n < len; n++ )
+    {
+        const wxUint16 u = swap ? wxUINT16_SWAP_ALWAYS(src[n]) : src[n];
+        if ( u >= 0xd800 && u <= 0xdfff )
+            break;
+
+        if ( dst )
+            dst[n] = u;
+    }
+
+    return n;
+}
+
+// Convert BMP characters from wchar_t to UTF-16 in either native or swapped
+// byte order. Notice that surrogates are just copied, as encode_utf16() does.
+static size_t
+wxNarrowBMP(wxUint16 *dst, const wchar_t *src, size_t len, bool swap)
+{
+    size_t n = 0;
+
+#ifdef wxHAS_SSE2_CONV
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i nonBMP = _mm_set1_epi32(~0xffff);
+    for ( ; n + 8 <= len; n += 8 )
+    {
+        const __m128i * const in = reinterpret_cast<const __m128i *>(src + n);
+        __m128i a = _mm_loadu_si128(in);
+        __m128i b = _mm_loadu_si128(in + 1);
+
+        const __m128i any = _mm_and_si128(_mm_or_si128(a, b), nonBMP);
+        if ( _mm_movemask_epi8(_mm_cmpeq_epi32(any, zero)) != 0xffff )
+            break;
+
+        if ( dst )
+        {
+            // There is no unsigned saturating pack in SSE2, so sign-extend
+            // the values to use the signed one without changing them.
+            a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+            b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+
+            __m128i v = _mm_packs_epi32(a, b);
+            if ( swap )
+                v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + n), v);
+        }
+    }
+#endif // wxHAS_SSE2_CONV
+
+    for ( ; n < len; n++ )
+    {
+        const wxUint32 c = static_cast<wxUint32>(src[n]);
+        if ( c > 0xffff )
+            break;
+
+        if ( dst )
+        {
+            const wxUint16 u = static_cast<wxUint16>(c);
+            dst[n] = swap ? wxUINT16_SWAP_ALWAYS(u) : u;
+        }
+    }
+
+    return n;
+}
+
+#endif // !WC_UTF16
+
 // ----------------------------------------------------------------------------
 // wxMBConv
 // ----------------------------------------------------------------------------
@@ -987,6 +1243,26 @@ wxMBConvStrictUTF8::ToWChar(wchar_t *dst, size_t dstLen,
             return written;
         }
 
+        // Convert all ASCII characters at once, notice that srcLen can't be
+        // wxNO_LEN here as we computed it above.
+        size_t numASCII = out && dstLen < srcLen ? dstLen : srcLen;
+        numASCII = wxWidenASCII(out, p, numASCII);
+        if ( numASCII )
+        {
+            if ( out )
+            {
+                out += numASCII;
+                dstLen -= numASCII;
+            }
+
+            written += numASCII;
+            srcLen -= numASCII;
+
+            // -1 because the loop increments it too
+            p += numASCII - 1;
+            continue;
+        }
+
         if ( out && !dstLen-- )
             break;
 
@@ -1077,10 +1353,11 @@ wxMBConvStrictUTF8::FromWChar(char *dst, size_t dstLen,
     char *out = dstLen ? dst : NULL;
     size_t written = 0;
 
-    const wchar_t* const end = srcLen == wxNO_LEN ? NULL : src + srcLen;
+    const wchar_t* const
+        end = src + (srcLen == wxNO_LEN ? wxWcslen(src) : srcLen);
     for ( const wchar_t *wp = src; ; )
     {
-        if ( end ? wp == end : !*wp )
+        if ( wp == end )
         {
             // all done successfully, just add the trailing NULL if we are not
             // using explicit length
@@ -1100,6 +1377,24 @@ wxMBConvStrictUTF8::FromWChar(char *dst, size_t dstLen,
             return written;
         }
 
+        // Convert all ASCII characters at once.
+        size_t numASCII = end - wp;
+        if ( out && dstLen < numASCII )
+            numASCII = dstLen;
+        numASCII = wxNarrowASCII(out, wp, numASCII);
+        if ( numASCII )
+        {
+            if ( out )
+            {
+                out += numASCII;
+                dstLen -= numASCII;
+            }
+
+            written += numASCII;
+            wp += numASCII;
+            continue;
+        }
+
         wxUint32 code;
 #ifdef WC_UTF16
         code = wxDecodeSurrogate(&wp, end);
@@ -1601,6 +1896,20 @@ wxMBConvUTF16straight::ToWChar(wchar_t *dst, size_t dstLen,
     const wxUint16 *inBuff = reinterpret_cast<const wxUint16 *>(src);
     for ( const wxUint16 * const inEnd = inBuff + inLen; inBuff < inEnd; )
     {
+        // Convert all BMP characters at once.
+        size_t numBMP = inEnd - inBuff;
+        if ( dst && dstLen - outLen < numBMP )
+            numBMP = dstLen - outLen;
+        numBMP = wxWidenBMP(dst, inBuff, numBMP, false);
+        if ( numBMP )
+        {
+            inBuff += numBMP;
+            outLen += numBMP;
+            if ( dst )
+                dst += numBMP;
+            continue;
+        }
+
         const wxUint32 ch = wxDecodeSurrogate(&inBuff, inEnd);
         if ( !inBuff )
             return wxCONV_FAILED;
@@ -1631,6 +1940,23 @@ wxMBConvUTF16straight::FromWChar(char *dst, size_t dstLen,
     wxUint16 *outBuff = reinterpret_cast<wxUint16 *>(dst);
     for ( size_t n = 0; n < srcLen; n++ )
     {
+        // Convert all BMP characters at once.
+        size_t numBMP = srcLen - n;
+        if ( outBuff && (dstLen - outLen) / BYTES_PER_CHAR < numBMP )
+            numBMP = (dstLen - outLen) / BYTES_PER_CHAR;
+        numBMP = wxNarrowBMP(outBuff, src, numBMP, false);
+        if ( numBMP )
+        {
+            src += numBMP;
+            outLen += numBMP * BYTES_PER_CHAR;
+            if ( outBuff )
+                outBuff += numBMP;
+
+            // -1 because the loop increments it too
+            n += numBMP - 1;
+            continue;
+        }
+
         wxUint16 cc[2] = { 0 };
         const size_t numChars = encode_utf16(*src++, cc);
         if ( numChars == wxCONV_FAILED )
@@ -1671,6 +1997,20 @@ wxMBConvUTF16swap::ToWChar(wchar_t *dst, size_t dstLen,
     const wxUint16 *inBuff = reinterpret_cast<const wxUint16 *>(src);
     for ( const wxUint16 * const inEnd = inBuff + inLen; inBuff < inEnd; )
     {
+        // Convert all BMP characters at once.
+        size_t numBMP = inEnd - inBuff;
+        if ( dst && dstLen - outLen < numBMP )
+            numBMP = dstLen - outLen;
+        numBMP = wxWidenBMP(dst, inBuff, numBMP, true);
+        if ( numBMP )
+        {
+            inBuff += numBMP;
+            outLen += numBMP;
+            if ( dst )
+                dst += numBMP;
+            continue;
+        }
+
         wxUint16 tmp[2];
         const wxUint16* tmpEnd = tmp;
 
@@ -1718,6 +2058,22 @@ wxMBConvUTF16swap::FromWChar(char *dst, size_t dstLen,
     wxUint16 *outBuff = reinterpret_cast<wxUint16 *>(dst);
     for ( const wchar_t *srcEnd = src + srcLen; src < srcEnd; src++ )
     {
+        // Convert all BMP characters at once.
+        size_t numBMP = srcEnd - src;
+        if ( outBuff && (dstLen - outLen) / BYTES_PER_CHAR < numBMP )
+            numBMP = (dstLen - outLen) / BYTES_PER_CHAR;
+        numBMP = wxNarrowBMP(outBuff, src, numBMP, true);
+        if ( numBMP )
+        {
+            outLen += numBMP * BYTES_PER_CHAR;
+            if ( outBuff )
+                outBuff += numBMP;
+
+            // -1 because the loop increments it too
+            src += numBMP - 1;
+            continue;
+        }
+
         wxUint16 cc[2] = { 0 };
         const size_t numChars = encode_utf16(*src, cc);
         if ( numChars == wxCONV_FAILED )
@@ -271,4 +271,48 @@ bool wxTextBuffer::Write(wxTextFileType typeNew, const wxMBConv& conv)
     return OnWrite(typeNew, conv);
 }
 
+// ----------------------------------------------------------------------------
+// lazily loaded lines
+// ----------------------------------------------------------------------------
+
+void wxTextBuffer::AddLazyLine(size_t index, wxTextFileType type)
+{
+    // all the lines added before were already loaded
+    if ( m_lazyLines.empty() )
+        m_lazyLines.assign(m_aLines.size(), wxString::npos);
+
+    m_aLines.push_back(wxString());
+    m_aTypes.push_back(type);
+    m_lazyLines.push_back(index);
+}
+
+void wxTextBuffer::OnLoadLine(size_t WXUNUSED(index),
+                              wxString& WXUNUSED(line)) const
+{
+    wxFAIL_MSG( wxS("must be overridden if AddLazyLine() is used") );
+}
+
+void wxTextBuffer::DoLoadLine(size_t n) const
+{
+    OnLoadLine(m_lazyLines[n], m_aLines[n]);
+
+    m_lazyLines[n] = wxString::npos;
+}
+
+void wxTextBuffer::LoadAllLines()
+{
+    if ( m_lazyLines.empty() )
+        return;
+
+    const size_t count = m_lazyLines.size();
+    for ( size_t n = 0; n < count; n++ )
+    {
+        if ( m_lazyLines[n] != wxString::npos )
+            DoLoadLine(n);
+    }
+
+    m_lazyLines.clear();
+    OnLazyLinesReleased();
+}
+
 #endif // wxUSE_TEXTBUFFER
@@ -35,6 +35,91 @@
 #include "wx/textfile.h"
 #include "wx/filename.h"
 #include "wx/buffer.h"
+#include "wx/scopedptr.h"
+
+// ============================================================================
+// helper functions
+// ============================================================================
+
+#if wxUSE_UNICODE
+
+namespace
+{
+
+// Check if the given data can be decoded line by line using UTF-8 instead of
+// the given conversion, i.e. if the data is valid UTF-8 and the conversion
+// would decode it in the same way, as is the case for the default wxConvAuto.
+// If true is returned, lenBOM is set to the length of the BOM which must be
+// skipped, if any.
+bool CanDecodeAsUTF8(const wxMBConv& conv,
+                     const char *data, size_t len,
+                     size_t& lenBOM)
+{
+    if ( wxConvUTF8.ToWChar(NULL, 0, data, len) == wxCONV_FAILED )
+        return false;
+
+    // Check that the conversion is UTF-8 and doesn't do anything special for
+    // the backslashes, as wxMBConvUTF8::MAP_INVALID_UTF8_TO_OCTAL does.
+    // Notice that we must use a copy of the conversion for this as it can
+    // have state, e.g. wxConvAuto determines the encoding on the first use.
+    wchar_t wbuf[4];
+
+    wxScopedPtr<wxMBConv> convTest(conv.Clone());
+    if ( convTest->ToWChar(wbuf, WXSIZEOF(wbuf), "\\\xc3\xa9", 3) != 2 ||
+            wbuf[0] != L'\\' || wbuf[1] != 0xe9 )
+        return false;
+
+    lenBOM = 0;
+    if ( len >= 3 && memcmp(data, "\xef\xbb\xbf", 3) == 0 )
+    {
+        // Check whether the BOM is skipped by the conversion or not.
+        convTest.reset(conv.Clone());
+        switch ( convTest->ToWChar(wbuf, WXSIZEOF(wbuf), "\xef\xbb\xbf\xc3\xa9", 5) )
+        {
+            case 1:
+                lenBOM = 3;
+                break;
+
+            case 2:
+                if ( wbuf[0] != 0xfeff )
+                    return false;
+                break;
+
+            default:
+                return false;
+        }
+    }
+
+    return true;
+}
+
+// Create a string from the given valid UTF-8 data.
+wxString LineFromUTF8(const char *start, const char *end)
+{
+    const size_t len = end - start;
+    if ( !len )
+        return wxString();
+
+    // The number of characters can't be greater than the number of bytes, so
+    // this is enough for the typical lines and avoids allocating memory.
+    wchar_t bufStatic[256];
+    wchar_t *buf = bufStatic;
+
+    wxWCharBuffer bufHeap;
+    if ( len > WXSIZEOF(bufStatic) )
+    {
+        if ( !bufHeap.extend(len) )
+            return wxString();
+
+        buf = bufHeap.data();
+    }
+
+    return wxString(buf, wxConvUTF8.ToWChar(buf, len, start, len));
+}
+
+} // anonymous namespace
+
+#endif // wxUSE_UNICODE
 
 // ============================================================================
 // wxTextFile class implementation
@@ -43,6 +128,7 @@
 wxTextFile::wxTextFile(const wxString& strFileName)
           : wxTextBuffer(strFileName)
 {
+    m_lazyLoading = false;
 }
 
 
@@ -93,13 +179,92 @@ bool wxTextFile::OnRead(const wxMBConv& conv)
     // file should be opened
     wxASSERT_MSG( m_file.IsOpened(), wxT("can't read closed file") );
 
-    wxString str;
-    if ( !m_file.ReadAll(&str, conv) )
+    // the lines from the previously read file can still reference its
+    // contents which are going to be replaced now
+    LoadAllLines();
+
+    // map the file instead of reading it to avoid making a copy of its data
+    if ( !m_mapped.Open(m_file, m_lazyLoading ? wxMappedFile::Access_Default
+                                              : wxMappedFile::Access_Sequential) )
     {
         wxLogError(_("Failed to read text file \"%s\"."), GetName());
         return false;
     }
 
+    const char* const data = m_mapped.GetData();
+    const size_t len = m_mapped.GetLength();
+
+#if wxUSE_UNICODE
+    // Decoding UTF-8 files line by line avoids converting the entire file to
+    // a temporary wxString and then copying each line from it, and also allows
+    // to do it only when the line is accessed if lazy loading is used.
+    size_t lenBOM;
+    if ( CanDecodeAsUTF8(conv, data, len, lenBOM) )
+    {
+        // the beginning of the current line, changes inside the loop
+        const char* lineStart = data + lenBOM;
+        const char* const end = data + len;
+        for ( const char* p = lineStart; p != end; ++p )
+        {
+            const char ch = *p;
+            if ( ch != '\r' && ch != '\n' )
+                continue;
+
+            wxTextFileType lineType;
+            if ( ch == '\r' )
+            {
+                if ( p + 1 != end && p[1] == '\n' )
+                    lineType = wxTextFileType_Dos;
+                else
+                    lineType = wxTextFileType_Mac;
+            }
+            else // ch == '\n'
+            {
+                lineType = wxTextFileType_Unix;
+            }
+
+            if ( m_lazyLoading )
+            {
+                AddLazyLine(m_lineOffsets.size(), lineType);
+                m_lineOffsets.push_back(lineStart - data);
+            }
+            else
+            {
+                AddLine(LineFromUTF8(lineStart, p), lineType);
+            }
+
+            if ( lineType == wxTextFileType_Dos )
+                ++p;
+
+            lineStart = p + 1;
+        }
+
+        if ( lineStart != end )
+        {
+            if ( m_lazyLoading )
+            {
+                AddLazyLine(m_lineOffsets.size(), wxTextFileType_None);
+                m_lineOffsets.push_back(lineStart - data);
+            }
+            else
+            {
+                AddLine(LineFromUTF8(lineStart, end), wxTextFileType_None);
+            }
+        }
+
+        // keep the file mapped only if there are any lines to load from it
+        if ( !m_lineOffsets.empty() )
+            m_lineOffsets.push_back(len);
+        else
+            m_mapped.Close();
+
+        return true;
+    }
+#endif // wxUSE_UNICODE
+
+    const wxString str(data, conv, len);
+    m_mapped.Close();
+
     // now break the buffer in lines
 
     // the beginning of the current line, changes inside the loop
@@ -147,6 +312,33 @@ bool wxTextFile::OnRead(const wxMBConv& conv)
     return true;
 }
 
+void wxTextFile::OnLoadLine(size_t index, wxString& line) const
+{
+#if wxUSE_UNICODE
+    const char* const start = m_mapped.GetData() + m_lineOffsets[index];
+    const char* end = m_mapped.GetData() + m_lineOffsets[index + 1];
+
+    // strip the line terminator, notice that the line itself can't contain
+    // any CR or LF characters
+    if ( end != start && end[-1] == '\n' )
+        --end;
+    if ( end != start && end[-1] == '\r' )
+        --end;
+
+    line = LineFromUTF8(start, end);
+#else // !wxUSE_UNICODE
+    // lazy loading is only used for UTF-8 files in Unicode build
+    wxUnusedVar(index);
+    wxUnusedVar(line);
+#endif // wxUSE_UNICODE/!wxUSE_UNICODE
+}
+
+void wxTextFile::OnLazyLinesReleased()
+{
+    m_lineOffsets.clear();
+    m_mapped.Close();
+}
+
 
 bool wxTextFile::OnWrite(wxTextFileType typeNew, const wxMBConv& conv)
 {
@@ -158,6 +350,10 @@ bool wxTextFile::OnWrite(wxTextFileType typeNew, const wxMBConv& conv)
         fn.Normalize(wxPATH_NORM_ENV_VARS | wxPATH_NORM_DOTS | wxPATH_NORM_TILDE |
                      wxPATH_NORM_ABSOLUTE | wxPATH_NORM_LONG);
 
+    // the file can't be replaced while it's still mapped under Windows, so
+    // load all its lines, which releases it, before writing it
+    LoadAllLines();
+
     wxTempFile fileTmp(fn.GetFullPath());
 
     if ( !fileTmp.IsOpened() ) {
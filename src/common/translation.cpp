@@ -48,6 +48,7 @@
 #include "wx/fontmap.h"
 #include "wx/scopedptr.h"
 #include "wx/stdpaths.h"
+#include "wx/thread.h"
 #include "wx/private/threadinfo.h"
 
 #ifdef __WINDOWS__
@@ -56,6 +57,7 @@
     #include "wx/msw/wrapwin.h"
     #include "wx/msw/missing.h"
 #endif
+
 #ifdef __WXOSX__
     #include "wx/osx/core/cfstring.h"
     #include <CoreFoundation/CFBundle.h>
@@ -1034,6 +1036,17 @@ public:
     // fills the hash with string-translation pairs
     bool FillHash(wxStringToStringHashMap& hash, const wxString& domain) const;
 
+#if wxUSE_UNICODE
+    // prepare for looking up the translations directly in the catalog data,
+    // using its hash table, instead of using FillHash(): returns false if
+    // this is impossible, e.g. because the catalog doesn't have a hash table
+    bool InitLookup();
+
+    // get the translation of the given string, with the index of the plural
+    // form, or NULL if not found; can only be used if InitLookup() succeeded
+    const wxString *GetString(const wxString& msgid, unsigned index) const;
+#endif // wxUSE_UNICODE
+
     // return the charset of the strings in this catalog or empty string if
     // none/unknown
     wxString GetCharset() const { return m_charset; }
@@ -1086,7 +1099,7 @@ private:
 
         // this check could fail for a corrupt message catalog
         size_t32 ofsString = Swap(ent->ofsString);
-        if ( ofsString + Swap(ent->nLen) > m_data.length())
+        if ( wxUint64(ofsString) + Swap(ent->nLen) > m_data.length())
         {
             return NULL;
         }
@@ -1096,6 +1109,32 @@ private:
 
     bool m_bSwapped;   // wrong endianness?
 
+    // the file contents used as m_data
+    wxMappedFile m_file;
+
+#if wxUSE_UNICODE
+    // find the given string in the catalog hash table and return its index in
+    // the string tables in n or return false if it wasn't found
+    bool FindString(const char *msgid, size_t32& n) const;
+
+    // the catalog hash table, only used if InitLookup() was called
+    const size_t32 *m_pHashTable;
+    size_t32        m_nHashSize;
+
+    // the conversion from the catalog charset, possibly owned by us
+    const wxMBConv *m_conv;
+    wxScopedPtr<wxMBConv> m_convOwned;
+
+    // the translations already returned by GetString(), indexed in the same
+    // way as wxMsgCatalog::m_messages
+    mutable wxStringToStringHashMap m_cache;
+
+#if wxUSE_THREADS
+    // protects m_cache as GetString() can be called from any thread
+    mutable wxCriticalSection m_cacheCS;
+#endif // wxUSE_THREADS
+#endif // wxUSE_UNICODE
+
     wxDECLARE_NO_COPY_CLASS(wxMsgCatalogFile);
 };
 
@@ -1105,10 +1144,17 @@ private:
 
 wxMsgCatalogFile::wxMsgCatalogFile()
 {
+#if wxUSE_UNICODE
+    m_pHashTable = NULL;
+    m_nHashSize = 0;
+    m_conv = NULL;
+#endif // wxUSE_UNICODE
 }
 
 wxMsgCatalogFile::~wxMsgCatalogFile()
 {
+    // we must not keep referencing the data we're going to unmap
+    m_data.reset();
 }
 
 // open disk file and read in it's contents
@@ -1119,27 +1165,15 @@ bool wxMsgCatalogFile::LoadFile(const wxString& filename,
     if ( !fileMsg.IsOpened() )
         return false;
 
-    // get the file size (assume it is less than 4GB...)
-    wxFileOffset lenFile = fileMsg.Length();
-    if ( lenFile == wxInvalidOffset )
+    // map the file in memory instead of reading it if possible, as this
+    // allows to avoid loading its pages which are never accessed
+    if ( !m_file.Open(fileMsg, wxMappedFile::Access_Random) )
         return false;
 
-    size_t nSize = wx_truncate_cast(size_t, lenFile);
-    wxASSERT_MSG( nSize == lenFile + size_t(0), wxS("message catalog bigger than 4GB?") );
-
-    wxMemoryBuffer filedata;
-
-    // read the whole file in memory
-    if ( fileMsg.Read(filedata.GetWriteBuf(nSize), nSize) != lenFile )
-        return false;
+    const DataBuffer
+        data = DataBuffer::CreateNonOwned(m_file.GetData(), m_file.GetLength());
 
-    filedata.UngetWriteBuf(nSize);
-
-    bool ok = LoadData
-              (
-                  DataBuffer::CreateOwned((char*)filedata.release(), nSize),
-                  rPluralFormsCalculator
-              );
+    bool ok = LoadData(data, rPluralFormsCalculator);
     if ( !ok )
     {
         wxLogWarning(_("'%s' is not a valid message catalog."), filename.c_str());
@@ -1341,14 +1375,169 @@ bool wxMsgCatalogFile::FillHash(wxStringToStringHashMap& hash,
     return true;
 }
 
+#if wxUSE_UNICODE
+
+bool wxMsgCatalogFile::InitLookup()
+{
+    const wxMsgCatalogHeader * const
+        pHeader = reinterpret_cast<const wxMsgCatalogHeader*>(m_data.data());
+
+    // the catalogs created with "msgfmt --no-hash" don't have the hash table,
+    // and we also need at least 3 entries in it for the lookup algorithm
+    m_nHashSize = Swap(pHeader->nHashSize);
+    if ( m_nHashSize <= 2 )
+        return false;
+
+    // check that all the tables we use are inside the data, we don't want to
+    // crash for corrupted message catalogs
+    const wxUint64 length = m_data.length();
+    const wxUint64 ofsHashTable = Swap(pHeader->ofsHashTable);
+    if ( ofsHashTable + wxUint64(m_nHashSize)*sizeof(size_t32) > length )
+        return false;
+
+    const wxUint64 tableSize = wxUint64(m_numStrings)*sizeof(wxMsgTableEntry);
+    if ( Swap(pHeader->ofsOrigTable) + tableSize > length ||
+            Swap(pHeader->ofsTransTable) + tableSize > length )
+        return false;
+
+    // and also check that all the strings are inside it, as FillHash() does,
+    // as we're going to access them later without any further checks
+    for ( size_t32 i = 0; i < m_numStrings; i++ )
+    {
+        if ( !StringAtOfs(m_pOrigTable, i) || !StringAtOfs(m_pTransTable, i) )
+            return false;
+    }
+
+    if ( !m_charset.empty() )
+    {
+        wxCSConv * const conv = new wxCSConv(m_charset);
+        m_convOwned.reset(conv);
+        if ( !conv->IsOk() )
+            return false;
+
+        m_conv = conv;
+    }
+    else // no charset, use the default conversion as FillHash() does
+    {
+        m_conv = wxConvCurrent;
+    }
+
+    m_pHashTable = reinterpret_cast<const size_t32*>(m_data.data() +
+                                                     ofsHashTable);
+
+    return true;
+}
+
+bool wxMsgCatalogFile::FindString(const char *msgid, size_t32& n) const
+{
+    // compute the hash value in exactly the same way as GNU gettext does
+    size_t32 hashVal = 0;
+    for ( const unsigned char *p = reinterpret_cast<const unsigned char*>(msgid);
+          *p;
+          ++p )
+    {
+        hashVal = (hashVal << 4) + *p;
+
+        const size_t32 g = hashVal & 0xf0000000;
+        if ( g )
+        {
+            hashVal ^= g >> 24;
+            hashVal ^= g;
+        }
+    }
+
+    const size_t len = strlen(msgid);
+
+    // and use the same open addressing scheme to look it up: notice that we
+    // bound the number of probes to avoid looping forever over a corrupted
+    // table without any empty slots
+    size_t32 idx = hashVal % m_nHashSize;
+    const size_t32 incr = 1 + hashVal % (m_nHashSize - 2);
+    for ( size_t32 probe = 0; probe < m_nHashSize; probe++ )
+    {
+        const size_t32 nstr = Swap(m_pHashTable[idx]);
+        if ( !nstr )
+            return false;
+
+        n = nstr - 1;
+        if ( n < m_numStrings )
+        {
+            // the original string may be followed by the plural form after
+            // the embedded NUL, so check just for the prefix match
+            const char * const orig = StringAtOfs(m_pOrigTable, n);
+            const size_t origLen = Swap(m_pOrigTable[n].nLen);
+            if ( orig && origLen >= len &&
+                    memcmp(orig, msgid, len) == 0 &&
+                        (origLen == len || orig[len] == '\0') )
+            {
+                return true;
+            }
+        }
+
+        if ( idx >= m_nHashSize - incr )
+            idx -= m_nHashSize - incr;
+        else
+            idx += incr;
+    }
+
+    return false;
+}
+
+const wxString *
+wxMsgCatalogFile::GetString(const wxString& msgid, unsigned index) const
+{
+    const wxString key = index == 0 ? msgid : msgid + wxChar(index);
+
+#if wxUSE_THREADS
+    wxCriticalSectionLocker lock(m_cacheCS);
+#endif // wxUSE_THREADS
+
+    wxStringToStringHashMap::const_iterator it = m_cache.find(key);
+    if ( it != m_cache.end() )
+        return &it->second;
+
+    const wxCharBuffer buf = m_conv->cWC2MB(msgid.wc_str());
+    if ( !buf )
+        return NULL;
+
+    size_t32 n;
+    if ( !FindString(buf, n) )
+        return NULL;
+
+    const char * const data = StringAtOfs(m_pTransTable, n);
+    if ( !data )
+        return NULL; // may happen for invalid MO files
+
+    // skip the translations for the preceding plural forms, see the comment
+    // in FillHash() for the explanation of the use of wxStrnlen()
+    const size_t length = Swap(m_pTransTable[n].nLen);
+    size_t offset = 0;
+    for ( unsigned i = 0; i < index && offset < length; i++ )
+        offset += wxStrnlen(data + offset, length - offset) + 1;
+
+    if ( offset >= length )
+        return NULL;
+
+    const char * const str = data + offset;
+    const wxString msgstr(str, *m_conv, wxStrnlen(str, length - offset));
+    if ( msgstr.empty() )
+        return NULL;
+
+    return &(m_cache[key] = msgstr);
+}
+
+#endif // wxUSE_UNICODE
+
 
 // ----------------------------------------------------------------------------
 // wxMsgCatalog class
 // ----------------------------------------------------------------------------
 
-#if !wxUSE_UNICODE
 wxMsgCatalog::~wxMsgCatalog()
 {
+    delete m_file;
+
+#if !wxUSE_UNICODE
     if ( m_conv )
     {
         if ( wxConvUI == m_conv )
@@ -1360,8 +1549,8 @@ wxMsgCatalog::~wxMsgCatalog()
 
         delete m_conv;
     }
-}
 #endif // !wxUSE_UNICODE
+}
 
 /* static */
 wxMsgCatalog *wxMsgCatalog::CreateFromFile(const wxString& filename,
@@ -1369,12 +1558,22 @@ wxMsgCatalog *wxMsgCatalog::CreateFromFile(const wxString& filename,
 {
     wxScopedPtr<wxMsgCatalog> cat(new wxMsgCatalog(domain));
 
-    wxMsgCatalogFile file;
+    wxScopedPtr<wxMsgCatalogFile> file(new wxMsgCatalogFile);
 
-    if ( !file.LoadFile(filename, cat->m_pluralFormsCalculator) )
+    if ( !file->LoadFile(filename, cat->m_pluralFormsCalculator) )
         return NULL;
 
-    if ( !file.FillHash(cat->m_messages, domain) )
+#if wxUSE_UNICODE
+    // if possible, keep the catalog data and look up the strings in it only
+    // when they're needed instead of converting all of them right now
+    if ( file->InitLookup() )
+    {
+        cat->m_file = file.release();
+        return cat.release();
+    }
+#endif // wxUSE_UNICODE
+
+    if ( !file->FillHash(cat->m_messages, domain) )
         return NULL;
 
     return cat.release();
@@ -1386,12 +1585,29 @@ wxMsgCatalog *wxMsgCatalog::CreateFromData(const wxScopedCharBuffer& data,
 {
     wxScopedPtr<wxMsgCatalog> cat(new wxMsgCatalog(domain));
 
-    wxMsgCatalogFile file;
+    wxScopedPtr<wxMsgCatalogFile> file(new wxMsgCatalogFile);
+
+    // the catalog file may keep using the data after we return, but the
+    // buffer we're given doesn't necessarily own it, e.g. it may come from a
+    // resource which could be unloaded later, so make a copy of the data in
+    // this case (if it is already owned, converting it to wxCharBuffer just
+    // shares the data)
+    const wxCharBuffer dataOwned(data);
 
-    if ( !file.LoadData(data, cat->m_pluralFormsCalculator) )
+    if ( !file->LoadData(dataOwned, cat->m_pluralFormsCalculator) )
         return NULL;
 
-    if ( !file.FillHash(cat->m_messages, domain) )
+#if wxUSE_UNICODE
+    // if possible, keep the catalog data and look up the strings in it only
+    // when they're needed instead of converting all of them right now
+    if ( file->InitLookup() )
+    {
+        cat->m_file = file.release();
+        return cat.release();
+    }
+#endif // wxUSE_UNICODE
+
+    if ( !file->FillHash(cat->m_messages, domain) )
         return NULL;
 
     return cat.release();
@@ -1404,6 +1620,17 @@ const wxString *wxMsgCatalog::GetString(const wxString& str, unsigned n, const w
     {
         index = m_pluralFormsCalculator->evaluate(n);
     }
+
+#if wxUSE_UNICODE
+    if ( m_file )
+    {
+        if (context.IsEmpty())
+            return m_file->GetString(str, index);
+        else
+            return m_file->GetString(wxString(context) + wxString('\x04') + wxString(str), index);
+    }
+#endif // wxUSE_UNICODE
+
     wxStringToStringHashMap::const_iterator i;
     if (index != 0)
     {
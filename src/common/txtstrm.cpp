@@ -41,6 +41,9 @@ wxTextInputStream::wxTextInputStream(wxInputStream &s,
 #if SIZEOF_WCHAR_T == 2
     m_lastWChar = 0;
 #endif // SIZEOF_WCHAR_T == 2
+
+    m_hasLength = s.GetLength() != wxInvalidOffset;
+    m_hasDecoded = false;
 }
 #else
 wxTextInputStream::wxTextInputStream(wxInputStream &s, const wxString &sep)
@@ -139,6 +142,7 @@ wxChar wxTextInputStream::GetChar()
                 // just the first byte and keep the other ones for the next
                 // time.
                 m_validBegin = 1;
+                m_hasDecoded = true;
                 return wbuf[0];
 
 #if SIZEOF_WCHAR_T == 2
@@ -154,6 +158,7 @@ wxChar wxTextInputStream::GetChar()
 
             case 1:
                 m_validBegin = inlen + 1;
+                m_hasDecoded = true;
 
                 // we finally decoded a character
                 return wbuf[0];
@@ -299,10 +304,233 @@ double wxTextInputStream::ReadDouble()
     return wxStrtod(word.c_str(), 0);
 }
 
+#if wxUSE_UNICODE
+
+namespace
+{
+
+// Decode the given UTF-8 bytes into the output buffer, which must be at least
+// as big as the input. Returns the number of wide characters or wxCONV_FAILED
+// if the input is not valid UTF-8 or contains NUL characters, which GetChar()
+// can't return.
+size_t DecodeUTF8Line(const unsigned char* p, size_t len, wchar_t* out)
+{
+    const unsigned char* const end = p + len;
+    wchar_t* const outStart = out;
+
+    while ( p < end )
+    {
+        // Most of the text is usually ASCII, so handle it first.
+        if ( *p - 1u < 0x7f )
+        {
+            *out++ = *p++;
+            continue;
+        }
+
+        wxUint32 code;
+        wxUint32 codeMin;
+        size_t numCont;
+        if ( *p < 0xc2 )
+        {
+            // NUL, a continuation byte or an overlong 2 byte sequence.
+            return wxCONV_FAILED;
+        }
+        else if ( *p < 0xe0 )
+        {
+            code = *p & 0x1f;
+            codeMin = 0x80;
+            numCont = 1;
+        }
+        else if ( *p < 0xf0 )
+        {
+            code = *p & 0x0f;
+            codeMin = 0x800;
+            numCont = 2;
+        }
+        else if ( *p < 0xf5 )
+        {
+            code = *p & 0x07;
+            codeMin = 0x10000;
+            numCont = 3;
+        }
+        else
+        {
+            return wxCONV_FAILED;
+        }
+
+        if ( static_cast<size_t>(end - p) <= numCont )
+            return wxCONV_FAILED;
+
+        for ( size_t n = 1; n <= numCont; n++ )
+        {
+            if ( (p[n] & 0xc0) != 0x80 )
+                return wxCONV_FAILED;
+
+            code = (code << 6) | (p[n] & 0x3f);
+        }
+
+        if ( code < codeMin || code > 0x10ffff ||
+                (code >= 0xd800 && code < 0xe000) )
+            return wxCONV_FAILED;
+
+        p += numCont + 1;
+
+#if SIZEOF_WCHAR_T == 2
+        if ( code >= 0x10000 )
+        {
+            code -= 0x10000;
+            *out++ = static_cast<wchar_t>(0xd800 | (code >> 10));
+            *out++ = static_cast<wchar_t>(0xdc00 | (code & 0x3ff));
+            continue;
+        }
+#endif // SIZEOF_WCHAR_T == 2
+
+        *out++ = static_cast<wchar_t>(code);
+    }
+
+    return out - outStart;
+}
+
+} // anonymous namespace
+
+bool wxTextInputStream::ReadLineUTF8(wxString& line)
+{
+    if ( !m_hasLength || !m_hasDecoded || m_validBegin < m_validEnd )
+        return false;
+
+#if SIZEOF_WCHAR_T == 2
+    if ( m_lastWChar )
+        return false;
+#endif // SIZEOF_WCHAR_T == 2
+
+    // Check that our conversion decodes UTF-8, which is the case for UTF-8
+    // conversions themselves but also for wxConvAuto unless it found a BOM
+    // of another encoding or had to fall back to Latin-1. Any decoding
+    // errors are left to GetChar(), so we don't need to care about how
+    // exactly the conversion handles them.
+    wchar_t wc[2];
+    if ( m_conv->ToWChar(wc, WXSIZEOF(wc), "\xc3\xa9", 2) != 1 || wc[0] != 0xe9 )
+        return false;
+
+    // Read the input until the end of line or of the stream. If the line ends
+    // with CR, we also need the next byte to check if it is followed by LF.
+    static const size_t BLOCK_SIZE = 256;
+
+    wxMemoryBuffer buf(BLOCK_SIZE);
+    size_t lineLen = 0,
+           eolLen = 0;
+    bool crAtEnd = false;
+    for ( ;; )
+    {
+        char* const data = static_cast<char*>(buf.GetAppendBuf(BLOCK_SIZE));
+        m_input.Read(data, BLOCK_SIZE);
+        const size_t count = m_input.LastRead();
+        buf.UngetAppendBuf(count);
+
+        const char* const start = static_cast<const char*>(buf.GetData());
+        const size_t total = buf.GetDataLen();
+
+        for ( ; lineLen < total; lineLen++ )
+        {
+            if ( start[lineLen] == '\n' || start[lineLen] == '\r' )
+                break;
+        }
+
+        if ( lineLen < total )
+        {
+            if ( start[lineLen] == '\n' )
+            {
+                eolLen = 1;
+                break;
+            }
+
+            if ( lineLen + 1 < total )
+            {
+                eolLen = start[lineLen + 1] == '\n' ? 2 : 1;
+                break;
+            }
+
+            // CR is the last byte read so far, check what follows it.
+            if ( !count )
+            {
+                // CR at the end of the stream, GetChar() would have tried to
+                // read beyond it too, so keep the stream at EOF.
+                eolLen = 1;
+                crAtEnd = true;
+                break;
+            }
+        }
+        else if ( !count )
+        {
+            // No EOL at the end of the stream.
+            break;
+        }
+    }
+
+    const unsigned char* const
+        data = static_cast<const unsigned char*>(buf.GetData());
+    const size_t total = buf.GetDataLen();
+
+    // When the line ends with a lone CR, GetChar() would decode the next
+    // character too, which may make wxConvAuto switch to its fallback
+    // encoding or return NUL, which EatEOL() would consume, so let it deal
+    // with anything but ASCII there.
+    const size_t used = lineLen + eolLen;
+    const bool canDecode = used == total ||
+                           eolLen == 2 ||
+                           data[lineLen] != '\r' ||
+                           data[used] - 1u < 0x7f;
+
+    wxWCharBuffer wbuf(lineLen);
+    const size_t len = canDecode
+                        ? DecodeUTF8Line(data, lineLen, wbuf.data())
+                        : wxCONV_FAILED;
+    if ( len == wxCONV_FAILED )
+    {
+        // Put everything back and let GetChar() deal with it.
+        if ( total )
+            m_input.Ungetch(data, total);
+
+        return false;
+    }
+
+    line.assign(wbuf.data(), len);
+
+    m_validBegin =
+    m_validEnd = 0;
+
+    if ( used < total )
+    {
+        m_input.Ungetch(data + used, total - used);
+    }
+    else if ( !eolLen )
+    {
+        // If reading stopped because of an error and not EOF, signal it in
+        // the same way as the loop in ReadLine() below does.
+        if ( !m_input.Eof() )
+            m_input.Reset(wxSTREAM_READ_ERROR);
+    }
+    else if ( m_input.Eof() && !crAtEnd )
+    {
+        // We've read the entire line but didn't have to read beyond it, so
+        // don't report EOF yet, for consistency with GetChar().
+        m_input.Reset();
+    }
+
+    return true;
+}
+
+#endif // wxUSE_UNICODE
+
 wxString wxTextInputStream::ReadLine()
 {
     wxString line;
 
+#if wxUSE_UNICODE
+    if ( ReadLineUTF8(line) )
+        return line;
+#endif // wxUSE_UNICODE
+
     for ( ;; )
     {
         wxChar c = GetChar();
@@ -263,6 +263,80 @@ bool wxFileStream::IsOk() const
     return wxFileOutputStream::IsOk() && wxFileInputStream::IsOk();
 }
 
+// ----------------------------------------------------------------------------
+// wxMappedFileInputStream
+// ----------------------------------------------------------------------------
+
+wxMappedFileInputStream::wxMappedFileInputStream(const wxString& fileName,
+                                                 wxMappedFile::Access access)
+    : m_file(fileName, access)
+{
+    m_pos = 0;
+
+    if ( !m_file.IsOpened() )
+        m_lasterror = wxSTREAM_READ_ERROR;
+}
+
+wxFileOffset wxMappedFileInputStream::GetLength() const
+{
+    return m_file.IsOpened() ? static_cast<wxFileOffset>(m_file.GetLength())
+                             : wxInvalidOffset;
+}
+
+bool wxMappedFileInputStream::IsOk() const
+{
+    return wxInputStream::IsOk() && m_file.IsOpened();
+}
+
+size_t wxMappedFileInputStream::OnSysRead(void *buffer, size_t size)
+{
+    const size_t left = m_file.GetLength() - m_pos;
+    if ( !left )
+    {
+        m_lasterror = wxSTREAM_EOF;
+        return 0;
+    }
+
+    if ( size > left )
+        size = left;
+
+    memcpy(buffer, m_file.GetData() + m_pos, size);
+    m_pos += size;
+
+    m_lasterror = wxSTREAM_NO_ERROR;
+
+    return size;
+}
+
+wxFileOffset wxMappedFileInputStream::OnSysSeek(wxFileOffset pos, wxSeekMode mode)
+{
+    switch ( mode )
+    {
+        case wxFromStart:
+            break;
+
+        case wxFromCurrent:
+            pos += m_pos;
+            break;
+
+        case wxFromEnd:
+            pos += m_file.GetLength();
+            break;
+    }
+
+    if ( pos < 0 || pos > static_cast<wxFileOffset>(m_file.GetLength()) )
+        return wxInvalidOffset;
+
+    m_pos = static_cast<size_t>(pos);
+
+    return pos;
+}
+
+wxFileOffset wxMappedFileInputStream::OnSysTell() const
+{
+    return m_pos;
+}
+
 #endif // wxUSE_FILE
 
 #if wxUSE_FFILE
@@ -29,8 +29,16 @@
 #include "wx/mstream.h"
 #include "wx/scopedptr.h"
 #include "wx/wfstream.h"
+#include "wx/thread.h"
 #include "zlib.h"
 
+#include <algorithm>
+
+#ifdef __UNIX__
+    #include <errno.h>
+    #include <unistd.h>
+#endif
+
 // value for the 'version needed to extract' field (20 means 2.0)
 enum {
     VERSION_NEEDED_TO_EXTRACT = 20,
@@ -1617,6 +1625,7 @@ void wxZipInputStream::Init()
     m_headerSize = 0;
     m_decomp = NULL;
     m_parentSeekable = false;
+    m_randomAccess = false;
     m_weaklinks = new wxZipWeakLinks;
     m_streamlink = NULL;
     m_offsetAdjustment = 0;
@@ -1675,6 +1684,15 @@ wxZipStreamLink *wxZipInputStream::MakeLink(wxZipOutputStream *out)
     return link;
 }
 
+void wxZipInputStream::InitRandomAccess()
+{
+    // the entries are opened using the offsets from the central directory
+    // already read by wxZipIndex, so there is no need to look for it again
+    m_parentSeekable = true;
+    m_randomAccess = true;
+    m_position = 0;
+}
+
 bool wxZipInputStream::LoadEndRecord()
 {
     wxCHECK(m_position == wxInvalidOffset, false);
@@ -1972,8 +1990,13 @@ bool wxZipInputStream::DoOpen(wxZipEntry *entry, bool raw)
         m_entry = *entry;
 
     if (m_parentSeekable) {
-        if (QuietSeek(*m_parent_i_stream, m_entry.GetOffset())
-                == wxInvalidOffset)
+        // QuietSeek() changes the global log level, which must not be done
+        // when opening the entries from several threads at once, and isn't
+        // needed for the streams created by wxZipIndex anyhow
+        wxFileOffset pos = m_randomAccess
+                            ? m_parent_i_stream->SeekI(m_entry.GetOffset())
+                            : QuietSeek(*m_parent_i_stream, m_entry.GetOffset());
+        if (pos == wxInvalidOffset)
             return false;
         if (ReadSignature() != LOCAL_MAGIC) {
             wxLogError(_("bad zipfile offset to entry"));
@@ -2156,6 +2179,238 @@ size_t wxZipInputStream::OnSysRead(void *buffer, size_t size)
     return count;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// Index
+
+#if wxUSE_FILE
+
+// The archive file shared by wxZipIndex and all the streams opened by it.
+//
+class wxZipIndexFile
+{
+public:
+    wxZipIndexFile() : m_length(0) { }
+
+    bool Open(const wxString& filename)
+    {
+        if (!m_file.Open(filename))
+            return false;
+        m_length = m_file.Length();
+        return m_length != wxInvalidOffset;
+    }
+
+    wxFile& GetFile() { return m_file; }
+    wxFileOffset GetLength() const { return m_length; }
+
+    // Read from the given position without changing the file position, so
+    // that several threads can read from the same file at once. Returns the
+    // number of bytes read or wxInvalidOffset on error.
+    ssize_t ReadAt(wxFileOffset pos, void *buffer, size_t size)
+    {
+#ifdef __UNIX__
+        for (;;) {
+            ssize_t result = pread(m_file.fd(), buffer, size, pos);
+            if (result != -1 || errno != EINTR)
+                return result == -1 ? wxInvalidOffset : result;
+        }
+#else
+        wxCRIT_SECT_LOCKER(lock, m_readCS);
+
+        if (m_file.Seek(pos) == wxInvalidOffset)
+            return wxInvalidOffset;
+        return m_file.Read(buffer, size);
+#endif
+    }
+
+    // Used to serialize copying the entries, as wxZipMemory reference
+    // counting is not thread-safe.
+    wxCRIT_SECT_DECLARE_MEMBER(m_entriesCS);
+
+private:
+    wxFile m_file;
+    wxFileOffset m_length;
+
+#ifndef __UNIX__
+    wxCRIT_SECT_DECLARE_MEMBER(m_readCS);
+#endif
+
+    wxDECLARE_NO_COPY_CLASS(wxZipIndexFile);
+};
+
+// Stream reading the archive file using its own position.
+//
+class wxZipIndexInputStream : public wxInputStream
+{
+public:
+    wxZipIndexInputStream(wxZipIndexFile& file) : m_file(file), m_pos(0) { }
+
+    wxFileOffset GetLength() const wxOVERRIDE { return m_file.GetLength(); }
+    bool IsSeekable() const wxOVERRIDE { return true; }
+
+protected:
+    size_t OnSysRead(void *buffer, size_t size) wxOVERRIDE;
+    wxFileOffset OnSysSeek(wxFileOffset pos, wxSeekMode mode) wxOVERRIDE;
+    wxFileOffset OnSysTell() const wxOVERRIDE { return m_pos; }
+
+private:
+    wxZipIndexFile& m_file;
+    wxFileOffset m_pos;
+
+    wxDECLARE_NO_COPY_CLASS(wxZipIndexInputStream);
+};
+
+size_t wxZipIndexInputStream::OnSysRead(void *buffer, size_t size)
+{
+    ssize_t result = m_file.ReadAt(m_pos, buffer, size);
+
+    if (result == wxInvalidOffset) {
+        m_lasterror = wxSTREAM_READ_ERROR;
+        return 0;
+    }
+    if (result == 0 && size)
+        m_lasterror = wxSTREAM_EOF;
+
+    m_pos += result;
+    return result;
+}
+
+wxFileOffset wxZipIndexInputStream::OnSysSeek(wxFileOffset pos, wxSeekMode mode)
+{
+    switch (mode) {
+        case wxFromStart:
+            break;
+        case wxFromCurrent:
+            pos += m_pos;
+            break;
+        case wxFromEnd:
+            pos += m_file.GetLength();
+            break;
+        default:
+            wxFAIL_MSG(wxT("invalid seek mode"));
+            return wxInvalidOffset;
+    }
+
+    if (pos < 0)
+        return wxInvalidOffset;
+
+    m_pos = pos;
+    return m_pos;
+}
+
+static bool EntryLess(const wxZipEntry *a, const wxZipEntry *b)
+{
+    return a->GetInternalName() < b->GetInternalName();
+}
+
+static bool EntryNameLess(const wxZipEntry *entry, const wxString& name)
+{
+    return entry->GetInternalName() < name;
+}
+
+wxZipIndex::wxZipIndex(wxMBConv& conv /*=wxConvLocal*/)
+  : m_conv(conv),
+    m_file(NULL)
+{
+}
+
+wxZipIndex::~wxZipIndex()
+{
+    Close();
+}
+
+void wxZipIndex::Close()
+{
+    for (size_t i = 0; i < m_entries.size(); i++)
+        delete m_entries[i];
+    m_entries.clear();
+
+    wxDELETE(m_file);
+}
+
+bool wxZipIndex::Open(const wxString& filename)
+{
+    Close();
+
+    wxScopedPtr<wxZipIndexFile> file(new wxZipIndexFile);
+    if (!file->Open(filename))
+        return false;
+
+    // Read the whole central directory, this is the only time the archive
+    // is read sequentially.
+    {
+        wxFileInputStream fileStream(file->GetFile());
+        wxBufferedInputStream bufStream(fileStream);
+        wxZipInputStream zip(bufStream, m_conv);
+
+        wxZipEntry *entry;
+        while ((entry = zip.GetNextEntry()) != NULL)
+            m_entries.push_back(entry);
+
+        if (zip.GetLastError() != wxSTREAM_EOF) {
+            Close();
+            return false;
+        }
+    }
+
+    std::sort(m_entries.begin(), m_entries.end(), EntryLess);
+
+    m_file = file.release();
+    return true;
+}
+
+const wxZipEntry *wxZipIndex::Find(const wxString& name,
+                                   wxPathFormat format /*=wxPATH_NATIVE*/) const
+{
+    const wxString internal = wxZipEntry::GetInternalName(name, format);
+
+    wxVector<wxZipEntry*>::const_iterator it =
+        std::lower_bound(m_entries.begin(), m_entries.end(),
+                         internal, EntryNameLess);
+
+    if (it == m_entries.end() || (*it)->GetInternalName() != internal)
+        return NULL;
+
+    return *it;
+}
+
+wxZipInputStream *wxZipIndex::OpenEntry(const wxZipEntry& entry) const
+{
+    wxCHECK_MSG(IsOk(), NULL, wxT("zip index not opened"));
+
+    // Make a copy of the entry not sharing anything with the original one,
+    // which may be concurrently copied by the other threads.
+    wxZipEntry copy;
+    {
+        wxCRIT_SECT_LOCKER(lock, m_file->m_entriesCS);
+
+        copy = entry;
+        copy.SetExtra(entry.GetExtra(), entry.GetExtraLen());
+        copy.SetLocalExtra(entry.GetLocalExtra(), entry.GetLocalExtraLen());
+    }
+
+    wxZipInputStream *zip =
+        new wxZipInputStream(new wxZipIndexInputStream(*m_file), m_conv);
+    zip->InitRandomAccess();
+
+    if (!zip->OpenEntry(copy)) {
+        delete zip;
+        return NULL;
+    }
+
+    return zip;
+}
+
+wxZipInputStream *wxZipIndex::OpenEntry(const wxString& name,
+                                        wxPathFormat format /*=wxPATH_NATIVE*/) const
+{
+    const wxZipEntry *entry = Find(name, format);
+
+    return entry ? OpenEntry(*entry) : NULL;
+}
+
+#endif // wxUSE_FILE
+
+
 /////////////////////////////////////////////////////////////////////////////
 // Output stream
 
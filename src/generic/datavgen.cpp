@@ -46,6 +46,7 @@
 #include "wx/itemattr.h"
 #include "wx/list.h"
 #include "wx/listimpl.cpp"
+#include "wx/hashmap.h"
 #include "wx/imaglist.h"
 #include "wx/headerctrl.h"
 #include "wx/dnd.h"
@@ -458,6 +459,10 @@ class wxDataViewTreeNode;
 
 typedef wxVector<wxDataViewTreeNode*> wxDataViewTreeNodes;
 
+// Hash map used to quickly find the tree node corresponding to the given item.
+WX_DECLARE_HASH_MAP(void*, wxDataViewTreeNode*, wxPointerHash, wxPointerEqual,
+                    wxDataViewItemToNodeMap);
+
 // Note: this class is not used at all for virtual list models, so all code
 // using it, i.e. any functions taking or returning objects of this type,
 // including wxDataViewMainWindow::m_root, can only be called after checking
@@ -469,6 +474,7 @@ public:
     wxDataViewTreeNode(wxDataViewTreeNode *parent, const wxDataViewItem& item)
         : m_parent(parent),
           m_item(item),
+          m_indexInParent(0),
           m_branchData(NULL)
     {
     }
@@ -513,6 +519,12 @@ public:
         m_branchData->RemoveChild(index);
     }
 
+    // returns position of the given child node in children list or wxNOT_FOUND
+    int GetChildIndex(const wxDataViewTreeNode* node)
+    {
+        return m_branchData ? m_branchData->GetChildIndex(node) : wxNOT_FOUND;
+    }
+
     // returns position of child node for given item in children list or wxNOT_FOUND
     int FindChildByItem(const wxDataViewItem& item) const
     {
@@ -595,6 +607,9 @@ public:
 
         if ( !has )
         {
+            if ( m_branchData && m_branchData->subTreeCount )
+                InvalidateParentRowOffsets();
+
             wxDELETE(m_branchData);
         }
         else if ( m_branchData == NULL )
@@ -619,7 +634,61 @@ public:
         wxASSERT( m_branchData->subTreeCount >= 0 );
 
         if( m_parent )
+        {
+            // Notice that this must be done even if the parent is closed, as
+            // the row offsets are used for the hidden nodes too.
+            InvalidateParentRowOffsets();
+
             m_parent->ChangeSubTreeCount(num);
+        }
+    }
+
+    // Returns the row of this node, as if all its parents were expanded, or
+    // -1 for the (invisible) root node.
+    //
+    // This takes O(depth) time if the row offsets of all the parents are
+    // already cached, which is the case unless the tree was modified.
+    int GetRow()
+    {
+        int row = -1;
+        for ( wxDataViewTreeNode* node = this; node->m_parent; node = node->m_parent )
+        {
+            BranchNodeData* const data = node->m_parent->m_branchData;
+
+            const int index = data->GetChildIndex(node);
+            wxCHECK_MSG( index != wxNOT_FOUND, -1, "not our child?" );
+
+            row += 1 + data->rowOffsets[index];
+        }
+
+        return row;
+    }
+
+    // Returns the child node containing the given row in its subtree. The row
+    // is relative to the first child of this node and is updated to be
+    // relative to the returned node, i.e. it's 0 if the row corresponds to
+    // the returned node itself.
+    //
+    // The row must be less than GetSubTreeCount().
+    wxDataViewTreeNode* FindChildByRow(int& row)
+    {
+        wxCHECK_MSG( m_branchData && !m_branchData->children.empty(), NULL,
+                     "leaf node doesn't have children" );
+
+        const wxVector<int>& offsets = m_branchData->UpdateAllRowOffsets();
+
+        // Find the last child starting at or before the given row.
+        const wxVector<int>::const_iterator begin = offsets.begin();
+        const size_t index = std::upper_bound
+                             (
+                                begin,
+                                begin + m_branchData->children.size(),
+                                row
+                             ) - begin - 1;
+
+        row -= offsets[index];
+
+        return m_branchData->children[index];
     }
 
     void Resort(wxDataViewMainWindow* window);
@@ -641,29 +710,107 @@ private:
     void PutChildInSortOrder(wxDataViewMainWindow* window,
                              wxDataViewTreeNode* childNode);
 
+    // Must be called when the number of rows taken by this node changes.
+    //
+    // Notice that m_indexInParent may be stale here, but this is harmless: if
+    // it is, the offsets are either already invalid starting from this node
+    // or more of them than necessary are invalidated.
+    void InvalidateParentRowOffsets()
+    {
+        m_parent->m_branchData->InvalidateRowOffsets(m_indexInParent + 1);
+    }
+
     wxDataViewTreeNode  *m_parent;
 
     // Corresponding model item.
     wxDataViewItem       m_item;
 
+    // Cached index of this node in its parent children list, only valid if
+    // it's less than the parent BranchNodeData::validRowOffsets and the
+    // parent child at this index is this node.
+    unsigned             m_indexInParent;
+
     // Data specific to non-leaf (branch, inner) nodes. They are kept in a
     // separate struct in order to conserve memory.
     struct BranchNodeData
     {
         BranchNodeData()
             : open(false),
-              subTreeCount(0)
+              subTreeCount(0),
+              validRowOffsets(0)
         {
         }
 
         void InsertChild(wxDataViewTreeNode* node, unsigned index)
         {
             children.insert(children.begin() + index, node);
+
+            node->m_indexInParent = index;
+            InvalidateRowOffsets(index);
         }
 
         void RemoveChild(unsigned index)
         {
             children.erase(children.begin() + index);
+
+            InvalidateRowOffsets(index);
+        }
+
+        // Must be called when the children are reordered or the number of
+        // rows taken by any of them, starting from the given one, changes.
+        void InvalidateRowOffsets(unsigned index = 0)
+        {
+            if ( index < validRowOffsets )
+                validRowOffsets = index;
+        }
+
+        // Make the row offsets valid up to and including the given index.
+        void UpdateRowOffsets(unsigned index)
+        {
+            if ( rowOffsets.size() < children.size() )
+                rowOffsets.resize(children.size());
+
+            for ( ; validRowOffsets <= index; validRowOffsets++ )
+            {
+                const unsigned n = validRowOffsets;
+                rowOffsets[n] = n ? rowOffsets[n - 1] + 1 +
+                                        children[n - 1]->GetSubTreeCount()
+                                  : 0;
+                children[n]->m_indexInParent = n;
+            }
+        }
+
+        const wxVector<int>& UpdateAllRowOffsets()
+        {
+            if ( !children.empty() )
+                UpdateRowOffsets(children.size() - 1);
+
+            return rowOffsets;
+        }
+
+        // Returns the index of the given child or wxNOT_FOUND. The row offset
+        // of the child is guaranteed to be valid if it is found.
+        int GetChildIndex(const wxDataViewTreeNode* node)
+        {
+            // The indices of all the children before the first invalid offset
+            // are up to date, but the index cached in a node after it may be
+            // stale and happen to be less than validRowOffsets too, e.g. after
+            // inserting another child before it, so check that it is really
+            // this node which is found at this position.
+            const unsigned index = node->m_indexInParent;
+            if ( index < validRowOffsets && children[index] == node )
+                return index;
+
+            // Otherwise the node must be after the last valid offset, compute
+            // them until we find it.
+            for ( unsigned n = validRowOffsets; n < children.size(); n++ )
+            {
+                UpdateRowOffsets(n);
+                if ( children[n] == node )
+                    return n;
+            }
+
+            return wxNOT_FOUND;
         }
 
         // Child nodes. Note that this may be empty even if m_hasChildren in
@@ -681,6 +828,13 @@ private:
         // 0 for leaves and is the number of rows the subtree occupies for
         // branch nodes.
         int                  subTreeCount;
+
+        // Offsets of the rows of the children relative to the row of the
+        // first child, i.e. the number of rows taken by all the children
+        // preceding the given one. These offsets are computed on demand and
+        // only the first validRowOffsets of them are up to date.
+        wxVector<int>        rowOffsets;
+        unsigned             validRowOffsets;
     };
 
     BranchNodeData *m_branchData;
@@ -730,6 +884,14 @@ public:
             m_rowHeightCache->Clear();
     }
 
+    // Batch notifications support: while in a batch, the notification
+    // handlers above only update the tree structure and defer updating the
+    // selection, the current row, the row heights and the column widths until
+    // EndBatch() is called.
+    void BeginBatch();
+    void EndBatch();
+    bool IsInBatch() const { return m_batchLevel != 0; }
+
     SortOrder GetSortOrder() const
     {
         wxDataViewColumn* const col = GetOwner()->GetSortingColumn();
@@ -849,6 +1011,21 @@ public:
     // We did not need this temporarily
     // wxDataViewTreeNode * GetTreeNodeByItem( const wxDataViewItem & item );
 
+    // Maintain the index of the tree nodes by their items: these functions
+    // must be called whenever a node is added to the tree or removed from it,
+    // the latter one also removes all the children of the node from the index.
+    void AddToNodeIndex(wxDataViewTreeNode* node);
+    void RemoveFromNodeIndex(wxDataViewTreeNode* node);
+
+    // Return true if the item is the one of the given node or of one of its
+    // children, at any depth.
+    bool IsItemInSubtree(const wxDataViewItem& item,
+                         const wxDataViewTreeNode* node) const;
+
+    // Remove the items of the given node and all its children from the
+    // selection and the current item saved by BeginBatch().
+    void ForgetBatchItems(const wxDataViewTreeNode* node);
+
     // Methods for building the mapping tree
     void BuildTree( wxDataViewModel  * model );
     void DestroyTree();
@@ -895,6 +1072,9 @@ private:
 
     int RecalculateCount() const;
 
+    // Return the row of the item if it is shown in the tree or -1 otherwise.
+    int GetVisibleRowByItem(const wxDataViewItem& item) const;
+
     // Return false only if the event was vetoed by its handler.
     bool SendExpanderEvent(wxEventType type, const wxDataViewItem& item);
 
@@ -952,9 +1132,20 @@ private:
     wxDataViewTreeNode * m_root;
     int m_count;
 
+    // Index of all the nodes of the tree above by their items, allowing to
+    // find them without walking the tree.
+    wxDataViewItemToNodeMap m_nodeIndex;
+
     // This is the tree node under the cursor
     wxDataViewTreeNode * m_underMouse;
 
+    // The nesting level of BeginBatch() calls and the selected and current
+    // items saved when the outermost batch started, as the row numbers can't
+    // be kept up to date while in a batch.
+    int m_batchLevel;
+    wxDataViewItemArray m_batchSelection;
+    wxDataViewItem m_batchCurrentItem;
+
     // The control used for editing or NULL.
     wxWeakRef<wxWindow> m_editorCtrl;
 
@@ -989,6 +1180,34 @@ public:
     virtual void Resort() wxOVERRIDE
         { m_mainWindow->Resort(); }
 
+    virtual void BeginBatch() wxOVERRIDE
+        { m_mainWindow->BeginBatch(); }
+    virtual void EndBatch() wxOVERRIDE
+        { m_mainWindow->EndBatch(); }
+
+    // Process the notifications about several items as a single batch.
+    virtual bool ItemsAdded( const wxDataViewItem &parent, const wxDataViewItemArray &items ) wxOVERRIDE
+    {
+        m_mainWindow->BeginBatch();
+        const bool rc = wxDataViewModelNotifier::ItemsAdded(parent, items);
+        m_mainWindow->EndBatch();
+        return rc;
+    }
+    virtual bool ItemsDeleted( const wxDataViewItem &parent, const wxDataViewItemArray &items ) wxOVERRIDE
+    {
+        m_mainWindow->BeginBatch();
+        const bool rc = wxDataViewModelNotifier::ItemsDeleted(parent, items);
+        m_mainWindow->EndBatch();
+        return rc;
+    }
+    virtual bool ItemsChanged( const wxDataViewItemArray &items ) wxOVERRIDE
+    {
+        m_mainWindow->BeginBatch();
+        const bool rc = wxDataViewModelNotifier::ItemsChanged(items);
+        m_mainWindow->EndBatch();
+        return rc;
+    }
+
     wxDataViewMainWindow    *m_mainWindow;
 };
 
@@ -1712,6 +1931,8 @@ void wxDataViewTreeNode::InsertChild(wxDataViewMainWindow* window,
     if (!m_branchData)
         m_branchData = new BranchNodeData;
 
+    window->AddToNodeIndex(node);
+
     const SortOrder sortOrder = window->GetSortOrder();
 
     // Flag indicating whether we should retain existing sorted list when
@@ -1815,6 +2036,7 @@ void wxDataViewTreeNode::Resort(wxDataViewMainWindow* window)
                       wxGenericTreeModelNodeCmp(window, sortOrder));
 
             m_branchData->sortOrder = sortOrder;
+            m_branchData->InvalidateRowOffsets();
         }
 
         // There may be open child nodes that also need a resort.
@@ -1853,17 +2075,8 @@ wxDataViewTreeNode::PutChildInSortOrder(wxDataViewMainWindow* window,
     wxASSERT(m_branchData->sortOrder == window->GetSortOrder());
 
     // First find the node in the current child list
-    int hi = nodes.size();
-    int oldLocation = wxNOT_FOUND;
-    for ( int index = 0; index < hi; ++index )
-    {
-        if ( nodes[index] == childNode )
-        {
-            oldLocation = index;
-            break;
-        }
-    }
-    wxCHECK_RET( oldLocation >= 0, "not our child?" );
+    const int oldLocation = m_branchData->GetChildIndex(childNode);
+    wxCHECK_RET( oldLocation != wxNOT_FOUND, "not our child?" );
 
     wxGenericTreeModelNodeCmp cmp(window, m_branchData->sortOrder);
 
@@ -1889,7 +2102,7 @@ wxDataViewTreeNode::PutChildInSortOrder(wxDataViewMainWindow* window,
 
     // Remove and reinsert the node in the child list
     m_branchData->RemoveChild(oldLocation);
-    hi = nodes.size();
+    int hi = nodes.size();
     int lo = 0;
     while ( lo < hi )
     {
@@ -2001,6 +2214,8 @@ wxDataViewMainWindow::wxDataViewMainWindow( wxDataViewCtrl *parent, wxWindowID i
     m_count = -1;
     m_underMouse = NULL;
 
+    m_batchLevel = 0;
+
     UpdateDisplay();
 }
 
@@ -2723,56 +2938,6 @@ void wxDataViewHeaderWindow::FinishEditing()
     win->FinishEditing();
 }
 
-//-----------------------------------------------------------------------------
-// Helper class for do operation on the tree node
-//-----------------------------------------------------------------------------
-class DoJob
-{
-public:
-    DoJob() { }
-    virtual ~DoJob() { }
-
-    // The return value control how the tree-walker tranverse the tree
-    enum
-    {
-        DONE,          // Job done, stop traversing and return
-        SKIP_SUBTREE,  // Ignore the current node's subtree and continue
-        CONTINUE       // Job not done, continue
-    };
-
-    virtual int operator() ( wxDataViewTreeNode * node ) = 0;
-};
-
-bool Walker( wxDataViewTreeNode * node, DoJob & func )
-{
-    wxCHECK_MSG( node, false, "can't walk NULL node" );
-
-    switch( func( node ) )
-    {
-        case DoJob::DONE:
-            return true;
-        case DoJob::SKIP_SUBTREE:
-            return false;
-        case DoJob::CONTINUE:
-            break;
-    }
-
-    if ( node->HasChildren() )
-    {
-        const wxDataViewTreeNodes& nodes = node->GetChildNodes();
-
-        for ( wxDataViewTreeNodes::const_iterator i = nodes.begin();
-              i != nodes.end();
-              ++i )
-        {
-            if ( Walker(*i, func) )
-                return true;
-        }
-    }
-
-    return false;
-}
-
 bool wxDataViewMainWindow::ItemAdded(const wxDataViewItem & parent, const wxDataViewItem & item)
 {
     if (IsVirtualList())
@@ -2783,8 +2948,10 @@ bool wxDataViewMainWindow::ItemAdded(const wxDataViewItem & parent, const wxData
     }
     else
     {
-        // specific position (row) is unclear, so clear whole height cache
-        ClearRowHeightCache();
+        // specific position (row) is unclear, so clear whole height cache,
+        // unless we're going to do it at the end of the batch anyhow
+        if ( !IsInBatch() )
+            ClearRowHeightCache();
 
         wxDataViewTreeNode *parentNode = FindNode(parent);
 
@@ -2867,9 +3034,14 @@ bool wxDataViewMainWindow::ItemAdded(const wxDataViewItem & parent, const wxData
         InvalidateCount();
     }
 
-    m_selection.OnItemsInserted(GetRowByItem(item), 1);
+    // When in batch mode, the selection is restored in EndBatch() for the
+    // tree models, while the columns widths and the display are updated
+    // there in any case.
+    if ( IsVirtualList() || !IsInBatch() )
+        m_selection.OnItemsInserted(GetRowByItem(item), 1);
 
-    GetOwner()->InvalidateColBestWidths();
+    if ( !IsInBatch() )
+        GetOwner()->InvalidateColBestWidths();
     UpdateDisplay();
 
     return true;
@@ -2898,28 +3070,24 @@ bool wxDataViewMainWindow::ItemDeleted(const wxDataViewItem& parent,
             return true;
 
         wxCHECK_MSG( parentNode->HasChildren(), false, "parent node doesn't have children?" );
-        const wxDataViewTreeNodes& parentsChildren = parentNode->GetChildNodes();
 
         // We can't use FindNode() to find 'item', because it was already
         // removed from the model by the time ItemDeleted() is called, so we
-        // have to do it manually. We keep track of its position as well for
-        // later use.
-        int itemPosInNode = 0;
+        // have to look it up in the index directly. We need its position as
+        // well for later use.
+        int itemPosInNode = wxNOT_FOUND;
         wxDataViewTreeNode *itemNode = NULL;
-        for ( wxDataViewTreeNodes::const_iterator i = parentsChildren.begin();
-              i != parentsChildren.end();
-              ++i, ++itemPosInNode )
+
+        wxDataViewItemToNodeMap::const_iterator it = m_nodeIndex.find(item.GetID());
+        if ( it != m_nodeIndex.end() && it->second->GetParent() == parentNode )
         {
-            if( (*i)->GetItem() == item )
-            {
-                itemNode = *i;
-                break;
-            }
+            itemNode = it->second;
+            itemPosInNode = parentNode->GetChildIndex(itemNode);
         }
 
         // If the parent wasn't expanded, it's possible that we didn't have a
         // node corresponding to 'item' and so there's nothing left to do.
-        if ( !itemNode )
+        if ( itemPosInNode == wxNOT_FOUND )
         {
             // If this was the last child to be removed, it's possible the parent
             // node became a leaf. Let's ask the model about it.
@@ -2929,13 +3097,23 @@ bool wxDataViewMainWindow::ItemDeleted(const wxDataViewItem& parent,
             return true;
         }
 
-        if ( m_rowHeightCache )
+        if ( m_rowHeightCache && !IsInBatch() )
             m_rowHeightCache->Remove(GetRowByItem(parent) + itemPosInNode);
 
+        // We can't call GetRowByItem() on 'item' after deleting it, so
+        // remember its row now, while its node is still in the tree.
+        const int itemRow = itemNode->GetRow();
+
+        // The deleted items must not be restored in EndBatch(), as their IDs
+        // could be reused by the items added later.
+        if ( IsInBatch() )
+            ForgetBatchItems(itemNode);
+
         // Delete the item from wxDataViewTreeNode representation:
         const int itemsDeleted = 1 + itemNode->GetSubTreeCount();
 
         parentNode->RemoveChild(itemPosInNode);
+        RemoveFromNodeIndex(itemNode);
         delete itemNode;
         parentNode->ChangeSubTreeCount(-itemsDeleted);
 
@@ -2957,31 +3135,21 @@ bool wxDataViewMainWindow::ItemDeleted(const wxDataViewItem& parent,
             }
         }
 
-        // Update selection by removing 'item' and its entire children tree from the selection.
-        if ( !m_selection.IsEmpty() )
+        // Update selection by removing 'item' and its entire children tree
+        // from the selection, unless it will be restored in EndBatch().
+        if ( !m_selection.IsEmpty() && !IsInBatch() )
         {
-            // we can't call GetRowByItem() on 'item', as it's already deleted, so compute it from
-            // the parent ('parentNode') and position in its list of children
-            int itemRow;
-            if ( itemPosInNode == 0 )
-            {
-                // 1st child, row number is that of the parent parentNode + 1
-                itemRow = GetRowByItem(parentNode->GetItem()) + 1;
-            }
-            else
-            {
-                // row number is that of the sibling above 'item' + its subtree if any + 1
-                const wxDataViewTreeNode *siblingNode = parentNode->GetChildNodes()[itemPosInNode - 1];
-
-                itemRow = GetRowByItem(siblingNode->GetItem()) +
-                          siblingNode->GetSubTreeCount() +
-                          1;
-            }
-
             m_selection.OnItemsDeleted(itemRow, itemsDeleted);
         }
     }
 
+    // All the rest is done once in EndBatch() when in batch mode.
+    if ( IsInBatch() )
+    {
+        UpdateDisplay();
+        return true;
+    }
+
     // Change the current row to the last row if the current exceed the max row number
     if ( m_currentRow >= GetRowCount() )
         ChangeCurrentRow(m_count - 1);
@@ -2996,7 +3164,7 @@ bool wxDataViewMainWindow::DoItemChanged(const wxDataViewItem & item, int view_c
 {
     if ( !IsVirtualList() )
     {
-        if ( m_rowHeightCache )
+        if ( m_rowHeightCache && !IsInBatch() )
             m_rowHeightCache->Remove(GetRowByItem(item));
 
         // Move this node to its new correct place after it was updated.
@@ -3012,20 +3180,21 @@ bool wxDataViewMainWindow::DoItemChanged(const wxDataViewItem & item, int view_c
         node->PutInSortOrder(this);
     }
 
-    wxDataViewColumn* column;
-    if ( view_column == wxNOT_FOUND )
-    {
-        column = NULL;
-        GetOwner()->InvalidateColBestWidths();
-    }
-    else
+    wxDataViewColumn* const
+        column = view_column == wxNOT_FOUND ? NULL
+                                            : m_owner->GetColumn(view_column);
+
+    // When in batch mode, the entire window is refreshed in EndBatch().
+    if ( !IsInBatch() )
     {
-        column = m_owner->GetColumn(view_column);
-        GetOwner()->InvalidateColBestWidth(view_column);
-    }
+        if ( column )
+            GetOwner()->InvalidateColBestWidth(view_column);
+        else
+            GetOwner()->InvalidateColBestWidths();
 
-    // Update the displayed value(s).
-    RefreshRow(GetRowByItem(item));
+        // Update the displayed value(s).
+        RefreshRow(GetRowByItem(item));
+    }
 
     // Send event
     wxDataViewEvent le(wxEVT_DATAVIEW_ITEM_VALUE_CHANGED, m_owner, column, item);
@@ -3049,6 +3218,10 @@ bool wxDataViewMainWindow::Cleared()
     m_selection.Clear();
     m_currentRow = (unsigned)-1;
 
+    // Don't restore the selection in EndBatch() neither.
+    m_batchSelection.clear();
+    m_batchCurrentItem = wxDataViewItem();
+
     ClearRowHeightCache();
 
     if (GetModel())
@@ -3066,6 +3239,123 @@ bool wxDataViewMainWindow::Cleared()
     return true;
 }
 
+void wxDataViewMainWindow::BeginBatch()
+{
+    if ( m_batchLevel++ )
+        return;
+
+    // For the tree models, the selection and the current row are stored as
+    // row numbers which change when the items are added or removed, so
+    // remember the items themselves to be able to restore them later.
+    if ( !IsVirtualList() )
+    {
+        wxSelectionStore::IterationState cookie;
+        for ( unsigned row = m_selection.GetFirstSelectedItem(cookie);
+              row != wxSelectionStore::NO_SELECTION;
+              row = m_selection.GetNextSelectedItem(cookie) )
+        {
+            m_batchSelection.push_back(GetItemByRow(row));
+        }
+
+        if ( m_currentRow != (unsigned)-1 )
+            m_batchCurrentItem = GetItemByRow(m_currentRow);
+    }
+}
+
+void wxDataViewMainWindow::EndBatch()
+{
+    wxCHECK_RET( m_batchLevel > 0, "EndBatch() without matching BeginBatch()" );
+
+    if ( --m_batchLevel )
+        return;
+
+    ClearRowHeightCache();
+
+    if ( !IsVirtualList() )
+    {
+        InvalidateCount();
+
+        m_selection.Clear();
+        m_selection.SetItemCount(GetRowCount());
+
+        for ( size_t n = 0; n < m_batchSelection.size(); n++ )
+        {
+            const int row = GetVisibleRowByItem(m_batchSelection[n]);
+            if ( row != -1 )
+                m_selection.SelectItem(row);
+        }
+
+        m_batchSelection.clear();
+
+        if ( m_batchCurrentItem.IsOk() )
+        {
+            const int row = GetVisibleRowByItem(m_batchCurrentItem);
+            if ( row != -1 )
+                m_currentRow = row;
+
+            m_batchCurrentItem = wxDataViewItem();
+        }
+    }
+
+    // Change the current row to the last row if the current exceed the max row number
+    if ( m_currentRow != (unsigned)-1 && m_currentRow >= GetRowCount() )
+        ChangeCurrentRow(GetRowCount() - 1);
+
+    GetOwner()->InvalidateColBestWidths();
+    UpdateDisplay();
+    Refresh();
+}
+
+bool
+wxDataViewMainWindow::IsItemInSubtree(const wxDataViewItem& item,
+                                      const wxDataViewTreeNode* node) const
+{
+    wxDataViewItemToNodeMap::const_iterator it = m_nodeIndex.find(item.GetID());
+    if ( it == m_nodeIndex.end() )
+        return false;
+
+    for ( const wxDataViewTreeNode* n = it->second; n; n = n->GetParent() )
+    {
+        if ( n == node )
+            return true;
+    }
+
+    return false;
+}
+
+void wxDataViewMainWindow::ForgetBatchItems(const wxDataViewTreeNode* node)
+{
+    for ( size_t n = 0; n < m_batchSelection.size(); )
+    {
+        if ( IsItemInSubtree(m_batchSelection[n], node) )
+            m_batchSelection.RemoveAt(n);
+        else
+            n++;
+    }
+
+    if ( m_batchCurrentItem.IsOk() && IsItemInSubtree(m_batchCurrentItem, node) )
+        m_batchCurrentItem = wxDataViewItem();
+}
+
+int wxDataViewMainWindow::GetVisibleRowByItem(const wxDataViewItem& item) const
+{
+    wxDataViewItemToNodeMap::const_iterator it = m_nodeIndex.find(item.GetID());
+    if ( it == m_nodeIndex.end() )
+        return -1;
+
+    // The item may have been hidden by collapsing its parent.
+    wxDataViewTreeNode* const node = it->second;
+    for ( wxDataViewTreeNode* parent = node->GetParent();
+          parent && parent->GetParent();
+          parent = parent->GetParent() )
+    {
+        if ( !parent->IsOpen() )
+            return -1;
+    }
+
+    return node->GetRow();
+}
+
 void wxDataViewMainWindow::UpdateDisplay()
 {
     m_dirty = true;
@@ -3510,58 +3800,6 @@ int wxDataViewMainWindow::QueryAndCacheLineHeight(unsigned int row, wxDataViewIt
 }
 
 
-class RowToTreeNodeJob: public DoJob
-{
-public:
-    // Note that we initialize m_current to -1 because the first node passed to
-    // our operator() will be the root node, which doesn't appear in the window
-    // and so doesn't count as a real row.
-    explicit RowToTreeNodeJob(int row)
-        : m_row(row), m_current(-1), m_ret(NULL)
-    {
-    }
-
-    virtual int operator() ( wxDataViewTreeNode * node ) wxOVERRIDE
-    {
-        if( m_current == m_row)
-        {
-            m_ret = node;
-            return DoJob::DONE;
-        }
-
-        if( node->GetSubTreeCount() + m_current < m_row )
-        {
-            m_current += node->GetSubTreeCount() + 1;
-            return  DoJob::SKIP_SUBTREE;
-        }
-        else
-        {
-            // If the current node has only leaf children, we can find the
-            // desired node directly. This can speed up finding the node
-            // in some cases, and will have a very good effect for list views.
-            if ( node->HasChildren() &&
-                 (int)node->GetChildNodes().size() == node->GetSubTreeCount() )
-            {
-                const int index = m_row - m_current - 1;
-                m_ret = node->GetChildNodes()[index];
-                return DoJob::DONE;
-            }
-
-            m_current++;
-
-            return DoJob::CONTINUE;
-        }
-    }
-
-    wxDataViewTreeNode * GetResult() const
-        { return m_ret; }
-
-private:
-    const int m_row;
-    int m_current;
-    wxDataViewTreeNode* m_ret;
-};
-
 wxDataViewTreeNode * wxDataViewMainWindow::GetTreeNodeByRow(unsigned int row) const
 {
     wxASSERT( !IsVirtualList() );
@@ -3569,9 +3807,23 @@ wxDataViewTreeNode * wxDataViewMainWindow::GetTreeNodeByRow(unsigned int row) co
     if ( row == (unsigned)-1 )
         return NULL;
 
-    RowToTreeNodeJob job(static_cast<int>(row));
-    Walker( m_root , job );
-    return job.GetResult();
+    // Descend the tree using the cached row offsets of the children of each
+    // node to find the child containing the row at each level.
+    wxDataViewTreeNode* node = m_root;
+    int rowInNode = static_cast<int>(row);
+    for ( ;; )
+    {
+        // This also takes care of closed nodes, as their count is 0.
+        if ( rowInNode >= node->GetSubTreeCount() )
+            return NULL;
+
+        node = node->FindChildByRow(rowInNode);
+        if ( !node || !rowInNode )
+            return node;
+
+        // Skip the row of the child node itself.
+        rowInNode--;
+    }
 }
 
 wxDataViewItem wxDataViewMainWindow::GetItemByRow(unsigned int row) const
@@ -3757,6 +4009,14 @@ wxDataViewTreeNode * wxDataViewMainWindow::FindNode( const wxDataViewItem & item
     if (!item.IsOk())
         return m_root;
 
+    // Check if we already have a node for this item.
+    wxDataViewItemToNodeMap::const_iterator itNode = m_nodeIndex.find(item.GetID());
+    if ( itNode != m_nodeIndex.end() )
+        return itNode->second;
+
+    // Otherwise we need to realize the subtrees containing the item, if it's
+    // not shown yet because its parents had never been expanded.
+
     // Compose the parent-chain for the item we are looking for
     wxVector<wxDataViewItem> parentChain;
     wxDataViewItem it( item );
@@ -3924,55 +4184,6 @@ int wxDataViewMainWindow::RecalculateCount() const
     }
 }
 
-class ItemToRowJob : public DoJob
-{
-public:
-    // As with RowToTreeNodeJob above, we initialize m_current to -1 because
-    // the first node passed to our operator() is the root node which is not
-    // visible on screen and so we should return 0 for its first child node and
-    // not for the root itself.
-    ItemToRowJob(const wxDataViewItem& item, wxVector<wxDataViewItem>::reverse_iterator iter)
-        : m_item(item), m_iter(iter), m_current(-1)
-    {
-    }
-
-    // Maybe binary search will help to speed up this process
-    virtual int operator() ( wxDataViewTreeNode * node) wxOVERRIDE
-    {
-        if( node->GetItem() == m_item )
-        {
-            return DoJob::DONE;
-        }
-
-        // Is this node the next (grand)parent of the item we're looking for?
-        if( node->GetItem() == *m_iter )
-        {
-            // Search for the next (grand)parent now and skip this item itself.
-            ++m_iter;
-            ++m_current;
-            return DoJob::CONTINUE;
-        }
-        else
-        {
-            // Skip this node and all its currently visible children.
-            m_current += node->GetSubTreeCount() + 1;
-            return DoJob::SKIP_SUBTREE;
-        }
-
-    }
-
-    int GetResult() const
-        { return m_current; }
-
-private:
-    const wxDataViewItem m_item;
-    wxVector<wxDataViewItem>::reverse_iterator m_iter;
-
-    // The row corresponding to the last node seen in our operator().
-    int m_current;
-
-};
-
 int wxDataViewMainWindow::GetRowByItem(const wxDataViewItem & item) const
 {
     const wxDataViewModel * model = GetModel();
@@ -3988,25 +4199,37 @@ int wxDataViewMainWindow::GetRowByItem(const wxDataViewItem & item) const
         if( !item.IsOk() )
             return -1;
 
-        // Compose the parent-chain of the item we are looking for
-        wxVector<wxDataViewItem> parentChain;
-        wxDataViewItem it( item );
-        while( it.IsOk() )
-        {
-            parentChain.push_back(it);
-            it = model->GetParent(it);
-        }
+        wxDataViewItemToNodeMap::const_iterator it = m_nodeIndex.find(item.GetID());
+        if ( it == m_nodeIndex.end() )
+            return -1;
 
-        // add an 'invalid' item to represent our 'invisible' root node
-        parentChain.push_back(wxDataViewItem());
+        return it->second->GetRow();
+    }
+}
 
-        // the parent chain was created by adding the deepest parent first.
-        // so if we want to start at the root node, we have to iterate backwards through the vector
-        ItemToRowJob job( item, parentChain.rbegin() );
-        if ( !Walker( m_root, job ) )
-            return -1;
+void wxDataViewMainWindow::AddToNodeIndex(wxDataViewTreeNode* node)
+{
+    m_nodeIndex[node->GetItem().GetID()] = node;
+}
+
+void wxDataViewMainWindow::RemoveFromNodeIndex(wxDataViewTreeNode* node)
+{
+    // Only remove the node if it is the one in the index: this shouldn't be
+    // necessary, but be careful not to leave a dangling pointer in the index
+    // if ItemAdded() was mistakenly called for an item which already existed.
+    wxDataViewItemToNodeMap::iterator it = m_nodeIndex.find(node->GetItem().GetID());
+    if ( it != m_nodeIndex.end() && it->second == node )
+        m_nodeIndex.erase(it);
 
-        return job.GetResult();
+    if ( node->HasChildren() )
+    {
+        const wxDataViewTreeNodes& nodes = node->GetChildNodes();
+        for ( wxDataViewTreeNodes::const_iterator i = nodes.begin();
+              i != nodes.end();
+              ++i )
+        {
+            RemoveFromNodeIndex(*i);
+        }
     }
 }
 
@@ -4056,6 +4279,7 @@ void wxDataViewMainWindow::DestroyTree()
     if (!IsVirtualList())
     {
         wxDELETE(m_root);
+        m_nodeIndex.clear();
         m_count = 0;
     }
 }
@@ -114,11 +114,6 @@ namespace
         return alpha ? (data * alpha) / 0xff : data;
     }
 
-    inline unsigned char Unpremultiply(unsigned char alpha, unsigned char data)
-    {
-        return alpha ? (data * 0xff) / alpha : data;
-    }
-
 } // anonymous namespace
 
 class WXDLLIMPEXP_CORE wxCairoPathData : public wxGraphicsPathData
@@ -1718,72 +1713,36 @@ wxCairoBitmapData::wxCairoBitmapData(wxGraphicsRenderer* renderer,
 
     int stride = InitBuffer(image.GetWidth(), image.GetHeight(), bufferFormat);
 
-    // Copy wxImage data into the buffer. Notice that we work with wxUint32
-    // values and not bytes becase Cairo always works with buffers in native
-    // endianness.
-    wxUint32* dst = reinterpret_cast<wxUint32*>(m_buffer);
-    const unsigned char* src = image.GetData();
-
-    if ( bufferFormat == CAIRO_FORMAT_ARGB32 )
-    {
-        const unsigned char* alpha = image.GetAlpha();
-
-        for ( int y = 0; y < m_height; y++ )
-        {
-            wxUint32* const rowStartDst = dst;
-
-            for ( int x = 0; x < m_width; x++ )
-            {
-                const unsigned char a = *alpha++;
-
-                *dst++ = a                      << 24 |
-                         Premultiply(a, src[0]) << 16 |
-                         Premultiply(a, src[1]) <<  8 |
-                         Premultiply(a, src[2]);
-                src += 3;
-            }
-
-            dst = rowStartDst + stride / 4;
-        }
-    }
-    else // RGB
-    {
-        for ( int y = 0; y < m_height; y++ )
-        {
-            wxUint32* const rowStartDst = dst;
-
-            for ( int x = 0; x < m_width; x++ )
-            {
-                *dst++ = src[0] << 16 |
-                         src[1] <<  8 |
-                         src[2];
-                src += 3;
-            }
-
-            dst = rowStartDst + stride / 4;
-        }
-    }
+    // Cairo uses pre-multiplied native endian ARGB values for both formats,
+    // just ignoring alpha for RGB24.
+    image.ExportPixels(m_buffer, stride, wxIMAGE_PIXEL_ARGB32,
+                       bufferFormat == CAIRO_FORMAT_ARGB32
+                            ? wxIMAGE_PIXEL_PREMULTIPLIED
+                            : wxIMAGE_PIXEL_NO_ALPHA);
 
     InitSurface(bufferFormat, stride);
 }
 
 wxImage wxCairoBitmapData::ConvertToImage() const
 {
-    wxImage image(m_width, m_height, false /* don't clear */);
-
     // Get the surface type and format.
     wxCHECK_MSG( cairo_surface_get_type(m_surface) == CAIRO_SURFACE_TYPE_IMAGE,
                  wxNullImage,
                  wxS("Can't convert non-image surface to image.") );
 
+    int flags;
     switch ( cairo_image_surface_get_format(m_surface) )
     {
         case CAIRO_FORMAT_ARGB32:
-            image.SetAlpha();
+            // We need to also copy alpha and undo the pre-multiplication as
+            // Cairo stores pre-multiplied values in this format while wxImage
+            // does not.
+            flags = wxIMAGE_PIXEL_PREMULTIPLIED;
             break;
 
         case CAIRO_FORMAT_RGB24:
-            // Nothing to do, we don't use alpha by default.
+            // We don't use alpha by default.
+            flags = wxIMAGE_PIXEL_NO_ALPHA;
             break;
 
         case CAIRO_FORMAT_A8:
@@ -1798,62 +1757,16 @@ wxImage wxCairoBitmapData::ConvertToImage() const
 
     // Prepare for copying data.
     cairo_surface_flush(m_surface);
-    const wxUint32* src = (wxUint32*)cairo_image_surface_get_data(m_surface);
+    const unsigned char* src = cairo_image_surface_get_data(m_surface);
     wxCHECK_MSG( src, wxNullImage, wxS("Failed to get Cairo surface data.") );
 
-    int stride = cairo_image_surface_get_stride(m_surface);
+    const int stride = cairo_image_surface_get_stride(m_surface);
     wxCHECK_MSG( stride > 0, wxNullImage,
                  wxS("Failed to get Cairo surface stride.") );
 
-    // As we work with wxUint32 pointers and not char ones, we need to adjust
-    // the stride accordingly. This should be lossless as the stride must be a
-    // multiple of pixel size.
-    wxASSERT_MSG( !(stride % sizeof(wxUint32)), wxS("Unexpected stride.") );
-    stride /= sizeof(wxUint32);
-
-    unsigned char* dst = image.GetData();
-    unsigned char *alpha = image.GetAlpha();
-    if ( alpha )
-    {
-        // We need to also copy alpha and undo the pre-multiplication as Cairo
-        // stores pre-multiplied values in this format while wxImage does not.
-        for ( int y = 0; y < m_height; y++ )
-        {
-            const wxUint32* const rowStart = src;
-            for ( int x = 0; x < m_width; x++ )
-            {
-                const wxUint32 argb = *src++;
-
-                const unsigned char a = argb >> 24;
-                *alpha++ = a;
-
-                // Copy the RGB data undoing the pre-multiplication.
-                *dst++ = Unpremultiply(a, argb >> 16);
-                *dst++ = Unpremultiply(a, argb >>  8);
-                *dst++ = Unpremultiply(a, argb);
-            }
-
-            src = rowStart + stride;
-        }
-    }
-    else // RGB
-    {
-        // Things are pretty simple in this case, just copy RGB bytes.
-        for ( int y = 0; y < m_height; y++ )
-        {
-            const wxUint32* const rowStart = src;
-            for ( int x = 0; x < m_width; x++ )
-            {
-                const wxUint32 argb = *src++;
-
-                *dst++ = (argb & 0x00ff0000) >> 16;
-                *dst++ = (argb & 0x0000ff00) >>  8;
-                *dst++ = (argb & 0x000000ff);
-            }
-
-            src = rowStart + stride;
-        }
-    }
+    wxImage image;
+    image.ImportPixels(m_width, m_height, src, stride,
+                       wxIMAGE_PIXEL_ARGB32, flags);
 
     return image;
 }
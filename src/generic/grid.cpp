@@ -122,7 +122,6 @@ const int GRID_TEXT_MARGIN = 1;
 #include "wx/arrimpl.cpp"
 
 WX_DEFINE_OBJARRAY(wxGridCellCoordsArray)
-WX_DEFINE_OBJARRAY(wxGridCellWithAttrArray)
 
 // ----------------------------------------------------------------------------
 // events
@@ -750,131 +749,220 @@ wxGridCellEditor* wxGridCellAttr::GetEditor(const wxGrid* grid, int row, int col
 // wxGridCellAttrData
 // ----------------------------------------------------------------------------
 
+wxGridCellAttrData::~wxGridCellAttrData()
+{
+    for ( wxGridCellCoordsToAttrMap::iterator it = m_attrs.begin();
+          it != m_attrs.end();
+          ++it )
+    {
+        it->second->DecRef();
+    }
+
+    for ( size_t n = 0; n < m_blockAttrs.size(); n++ )
+    {
+        m_blockAttrs[n].attr->DecRef();
+    }
+}
+
 void wxGridCellAttrData::SetAttr(wxGridCellAttr *attr, int row, int col)
 {
-    // Note: contrary to wxGridRowOrColAttrData::SetAttr, we must not
-    //       touch attribute's reference counting explicitly, since this
-    //       is managed by class wxGridCellWithAttr
-    int n = FindIndex(row, col);
-    if ( n == wxNOT_FOUND )
+    const wxGridCellCoords coords(row, col);
+
+    wxGridCellCoordsToAttrMap::iterator it = m_attrs.find(coords);
+    if ( it == m_attrs.end() )
     {
         if ( attr )
         {
-            // add the attribute
-            m_attrs.Add(new wxGridCellWithAttr(row, col, attr));
+            // store the new attribute, taking its ownership
+            m_attrs[coords] = attr;
         }
         //else: nothing to do
     }
     else // we already have an attribute for this cell
     {
+        // as in wxGridRowOrColAttrData::SetAttr(), this works correctly even
+        // if the new attribute is the same as the old one
+        it->second->DecRef();
+
         if ( attr )
         {
             // change the attribute
-            m_attrs[(size_t)n].ChangeAttr(attr);
+            it->second = attr;
         }
         else
         {
             // remove this attribute
-            m_attrs.RemoveAt((size_t)n);
+            m_attrs.erase(it);
         }
     }
 }
 
-wxGridCellAttr *wxGridCellAttrData::GetAttr(int row, int col) const
+void wxGridCellAttrData::SetBlockAttr(wxGridCellAttr *attr,
+                                      int topRow, int leftCol,
+                                      int bottomRow, int rightCol)
 {
-    wxGridCellAttr *attr = NULL;
-
-    int n = FindIndex(row, col);
-    if ( n != wxNOT_FOUND )
+    for ( size_t n = 0; n < m_blockAttrs.size(); n++ )
     {
-        attr = m_attrs[(size_t)n].attr;
-        attr->IncRef();
+        wxGridCellBlockWithAttr& block = m_blockAttrs[n];
+        if ( !block.SameBlock(topRow, leftCol, bottomRow, rightCol) )
+            continue;
+
+        block.attr->DecRef();
+
+        // always remove the existing block, even if we're going to add it
+        // back, as the block which was set last must take precedence
+        m_blockAttrs.erase(m_blockAttrs.begin() + n);
+        break;
     }
 
-    return attr;
+    if ( attr )
+    {
+        m_blockAttrs.push_back(wxGridCellBlockWithAttr(topRow, leftCol,
+                                                       bottomRow, rightCol,
+                                                       attr));
+    }
 }
 
-void wxGridCellAttrData::UpdateAttrRows( size_t pos, int numRows )
+wxGridCellAttr *wxGridCellAttrData::GetAttr(int row, int col) const
 {
-    size_t count = m_attrs.GetCount();
-    for ( size_t n = 0; n < count; n++ )
+    wxGridCellAttr *attr = NULL;
+
+    wxGridCellCoordsToAttrMap::const_iterator it =
+        m_attrs.find(wxGridCellCoords(row, col));
+    if ( it != m_attrs.end() )
+    {
+        attr = it->second;
+    }
+    else
     {
-        wxGridCellCoords& coords = m_attrs[n].coords;
-        wxCoord row = coords.GetRow();
-        if ((size_t)row >= pos)
+        // attributes of the individual cells take precedence over the block
+        // ones, which are only checked if there is no cell attribute
+        for ( size_t n = m_blockAttrs.size(); n > 0; n-- )
         {
-            if (numRows > 0)
+            const wxGridCellBlockWithAttr& block = m_blockAttrs[n - 1];
+            if ( block.Contains(row, col) )
             {
-                // If rows inserted, increment row counter where necessary
-                coords.SetRow(row + numRows);
-            }
-            else if (numRows < 0)
-            {
-                // If rows deleted ...
-                if ((size_t)row >= pos - numRows)
-                {
-                    // ...either decrement row counter (if row still exists)...
-                    coords.SetRow(row + numRows);
-                }
-                else
-                {
-                    // ...or remove the attribute
-                    m_attrs.RemoveAt(n);
-                    n--;
-                    count--;
-                }
+                attr = block.attr;
+                break;
             }
         }
     }
+
+    if ( attr )
+        attr->IncRef();
+
+    return attr;
+}
+
+void wxGridCellAttrData::UpdateAttrRows( size_t pos, int numRows )
+{
+    UpdateCellAttrs(pos, numRows, true /* rows */);
+    UpdateBlockAttrs(pos, numRows, true /* rows */);
 }
 
 void wxGridCellAttrData::UpdateAttrCols( size_t pos, int numCols )
 {
-    size_t count = m_attrs.GetCount();
-    for ( size_t n = 0; n < count; n++ )
+    UpdateCellAttrs(pos, numCols, false /* columns */);
+    UpdateBlockAttrs(pos, numCols, false /* columns */);
+}
+
+/* static */
+bool
+wxGridCellAttrData::UpdateRange(int& first, int& last,
+                                size_t pos, int numRowsOrCols)
+{
+    if ( numRowsOrCols > 0 )
+    {
+        // If rows/cols inserted, shift the start of the range if it's after
+        // the insertion point and its end, which can be affected even if the
+        // start isn't, if the insertion point is inside the range.
+        if ( (size_t)first >= pos )
+            first += numRowsOrCols;
+        if ( (size_t)last >= pos )
+            last += numRowsOrCols;
+    }
+    else if ( numRowsOrCols < 0 )
+    {
+        // If rows/cols deleted, clamp the range bounds falling inside the
+        // deleted range to it and shift the ones after it.
+        const size_t posEnd = pos - numRowsOrCols;
+
+        if ( (size_t)first >= posEnd )
+            first += numRowsOrCols;
+        else if ( (size_t)first >= pos )
+            first = pos;
+
+        if ( (size_t)last >= posEnd )
+            last += numRowsOrCols;
+        else if ( (size_t)last >= pos )
+            last = pos - 1;
+
+        if ( last < first )
+            return false;
+    }
+
+    return true;
+}
+
+void wxGridCellAttrData::UpdateCellAttrs(size_t pos, int numRowsOrCols, bool rows)
+{
+    if ( !numRowsOrCols || m_attrs.empty() )
+        return;
+
+    // The keys of the hash map can't be changed in place, so rebuild it
+    // entirely: this is linear in the number of attributes, but so is any
+    // insertion or deletion of rows or columns anyhow.
+    wxGridCellCoordsToAttrMap attrs(m_attrs.size());
+    for ( wxGridCellCoordsToAttrMap::iterator it = m_attrs.begin();
+          it != m_attrs.end();
+          ++it )
     {
-        wxGridCellCoords& coords = m_attrs[n].coords;
-        wxCoord col = coords.GetCol();
-        if ( (size_t)col >= pos )
+        wxGridCellCoords coords = it->first;
+
+        int first = rows ? coords.GetRow() : coords.GetCol(),
+            last = first;
+        if ( UpdateRange(first, last, pos, numRowsOrCols) )
         {
-            if ( numCols > 0 )
-            {
-                // If cols inserted, increment col counter where necessary
-                coords.SetCol(col + numCols);
-            }
-            else if (numCols < 0)
-            {
-                // If cols deleted ...
-                if ((size_t)col >= pos - numCols)
-                {
-                    // ...either decrement col counter (if col still exists)...
-                    coords.SetCol(col + numCols);
-                }
-                else
-                {
-                    // ...or remove the attribute
-                    m_attrs.RemoveAt(n);
-                    n--;
-                    count--;
-                }
-            }
+            if ( rows )
+                coords.SetRow(first);
+            else
+                coords.SetCol(first);
+
+            attrs[coords] = it->second;
+        }
+        else // this row or column was deleted, remove its attribute
+        {
+            it->second->DecRef();
         }
     }
+
+    m_attrs = attrs;
 }
 
-int wxGridCellAttrData::FindIndex(int row, int col) const
+void wxGridCellAttrData::UpdateBlockAttrs(size_t pos, int numRowsOrCols, bool rows)
 {
-    size_t count = m_attrs.GetCount();
-    for ( size_t n = 0; n < count; n++ )
+    for ( size_t n = 0; n < m_blockAttrs.size(); )
     {
-        const wxGridCellCoords& coords = m_attrs[n].coords;
-        if ( (coords.GetRow() == row) && (coords.GetCol() == col) )
+        wxGridCellBlockWithAttr& block = m_blockAttrs[n];
+
+        bool stillExists;
+        if ( rows )
+            stillExists = UpdateRange(block.topRow, block.bottomRow,
+                                      pos, numRowsOrCols);
+        else
+            stillExists = UpdateRange(block.leftCol, block.rightCol,
+                                      pos, numRowsOrCols);
+
+        if ( stillExists )
         {
-            return n;
+            n++;
+        }
+        else // the block was entirely deleted
+        {
+            block.attr->DecRef();
+            m_blockAttrs.erase(m_blockAttrs.begin() + n);
         }
     }
-
-    return wxNOT_FOUND;
 }
 
 // ----------------------------------------------------------------------------
@@ -1107,6 +1195,27 @@ void wxGridCellAttrProvider::SetColAttr(wxGridCellAttr *attr, int col)
     m_data->m_colAttrs.SetAttr(attr, col);
 }
 
+void wxGridCellAttrProvider::SetBlockAttr(wxGridCellAttr *attr,
+                                          int topRow, int leftCol,
+                                          int bottomRow, int rightCol)
+{
+    if ( topRow < 0 || leftCol < 0 || topRow > bottomRow || leftCol > rightCol )
+    {
+        wxFAIL_MSG( wxS("Invalid cells block") );
+
+        // we still must release the attribute as we take ownership of it
+        if ( attr )
+            attr->DecRef();
+
+        return;
+    }
+
+    if ( !m_data )
+        InitData();
+
+    m_data->m_cellAttrs.SetBlockAttr(attr, topRow, leftCol, bottomRow, rightCol);
+}
+
 void wxGridCellAttrProvider::UpdateAttrRows( size_t pos, int numRows )
 {
     if ( m_data )
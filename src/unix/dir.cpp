@@ -30,7 +30,6 @@
 
 #include "wx/dir.h"
 #include "wx/filefn.h"          // for wxMatchWild
-#include "wx/filename.h"
 
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -66,6 +65,16 @@ public:
     const wxString& GetName() const { return m_dirname; }
 
 private:
+    enum EntryType
+    {
+        Entry_Unknown,  // must be checked using stat()
+        Entry_Dir,
+        Entry_NotDir
+    };
+
+    // get the type of the entry if it can be determined without stat()
+    EntryType GetEntryType(const dirent *de) const;
+
     DIR     *m_dir;
 
     wxString m_dirname;
@@ -113,6 +122,37 @@ wxDirData::~wxDirData()
     }
 }
 
+wxDirData::EntryType wxDirData::GetEntryType(const dirent *de) const
+{
+#ifdef DT_UNKNOWN
+    // Use the type returned by readdir(), if available, to avoid calling
+    // stat() for each entry, which is much slower.
+    switch ( de->d_type )
+    {
+        case DT_DIR:
+            return Entry_Dir;
+
+        case DT_LNK:
+            // We need to check what the link points to, unless we don't
+            // follow the links at all.
+            if ( m_flags & wxDIR_NO_FOLLOW )
+                return Entry_NotDir;
+            break;
+
+        case DT_UNKNOWN:
+            // The file system doesn't support returning the type.
+            break;
+
+        default:
+            return Entry_NotDir;
+    }
+#else // !DT_UNKNOWN
+    wxUnusedVar(de);
+#endif // DT_UNKNOWN/!DT_UNKNOWN
+
+    return Entry_Unknown;
+}
+
 bool wxDirData::Read(wxString *filename)
 {
     dirent *de = NULL;    // just to silence compiler warnings
@@ -149,36 +189,58 @@ bool wxDirData::Read(wxString *filename)
             break;
         }
 
-        // check the type now: notice that we may want to check the type of
-        // the path itself and not whatever it points to in case of a symlink
-        wxFileName fn = wxFileName::DirName(path + de_d_name);
-        if ( m_flags & wxDIR_NO_FOLLOW )
-        {
-            fn.DontFollowLink();
-        }
-
-        if ( !(m_flags & wxDIR_FILES) && !fn.DirExists() )
-        {
-            // it's a file, but we don't want them
-            continue;
-        }
-        else if ( !(m_flags & wxDIR_DIRS) && fn.DirExists() )
-        {
-            // it's a dir, and we don't want it
-            continue;
-        }
-
-        // finally, check the name
+        // check the name first as it's cheaper than checking the type
         if ( m_filespec.empty() )
         {
-            matches = m_flags & wxDIR_HIDDEN ? true : de->d_name[0] != '.';
+            if ( !(m_flags & wxDIR_HIDDEN) && de->d_name[0] == '.' )
+                continue;
         }
         else
         {
             // test against the pattern
-            matches = wxMatchWild(m_filespec, de_d_name,
-                                  !(m_flags & wxDIR_HIDDEN));
+            if ( !wxMatchWild(m_filespec, de_d_name,
+                              !(m_flags & wxDIR_HIDDEN)) )
+                continue;
         }
+
+        // we don't need to check the type if we want everything
+        if ( (m_flags & (wxDIR_FILES | wxDIR_DIRS)) != (wxDIR_FILES | wxDIR_DIRS) )
+        {
+            bool isDir;
+
+            switch ( GetEntryType(de) )
+            {
+                case Entry_Dir:
+                    isDir = true;
+                    break;
+
+                case Entry_NotDir:
+                    isDir = false;
+                    break;
+
+                default:
+                    {
+                        // notice that we may want to check the type of the
+                        // path itself and not whatever it points to in case
+                        // of a symlink
+                        wxStructStat st;
+                        const wxString fullname = path + de_d_name;
+                        const int rc = m_flags & wxDIR_NO_FOLLOW
+                                        ? wxLstat(fullname, &st)
+                                        : wxStat(fullname, &st);
+
+                        isDir = rc == 0 && S_ISDIR(st.st_mode);
+                    }
+            }
+
+            if ( !(m_flags & (isDir ? wxDIR_DIRS : wxDIR_FILES)) )
+            {
+                // it's a dir but we don't want them or vice versa
+                continue;
+            }
+        }
+
+        matches = true;
     }
 
     *filename = de_d_name;
@@ -23,7 +23,6 @@
     #include "wx/log.h"
     #include "wx/module.h"
     #include "wx/app.h"
-    #include "wx/list.h"
     #include "wx/hashmap.h"
     #include "wx/event.h"
 #endif
@@ -38,9 +37,6 @@
 
 #include "wx/unix/private/timer.h"
 
-#include "wx/listimpl.cpp"
-WX_DEFINE_LIST(wxTimerList)
-
 // trace mask for the debugging messages used here
 #define wxTrace_Timer wxT("timer")
 
@@ -52,11 +48,9 @@ wxTimerScheduler *wxTimerScheduler::ms_instance = NULL;
 
 wxTimerScheduler::~wxTimerScheduler()
 {
-    for ( wxTimerList::iterator node = m_timers.begin();
-          node != m_timers.end();
-          ++node )
+    for ( Schedules::iterator i = m_timers.begin(); i != m_timers.end(); ++i )
     {
-        delete *node;
+        delete *i;
     }
 }
 
@@ -67,18 +61,14 @@ void wxTimerScheduler::AddTimer(wxUnixTimerImpl *timer, wxUsecClock_t expiration
 
 void wxTimerScheduler::DoAddTimer(wxTimerSchedule *s)
 {
-    // do an insertion sort to keep the list sorted in expiration order
-    wxTimerList::iterator node;
-    for ( node = m_timers.begin(); node != m_timers.end(); ++node )
-    {
-        wxASSERT_MSG( (*node)->m_timer != s->m_timer,
-                      wxT("adding the same timer twice?") );
+    wxASSERT_MSG( !s->m_timer->m_schedule || s->m_timer->m_schedule == s,
+                  wxT("adding the same timer twice?") );
 
-        if ( (*node)->m_expiration > s->m_expiration )
-            break;
-    }
+    s->m_timer->m_schedule = s;
+    s->m_order = m_nextOrder++;
 
-    m_timers.insert(node, s);
+    m_timers.push_back(s);
+    SiftUp(m_timers.size() - 1);
 
     wxLogTrace(wxTrace_Timer, wxT("Inserted timer %d expiring at %s"),
                s->m_timer->GetId(),
@@ -89,19 +79,72 @@ void wxTimerScheduler::RemoveTimer(wxUnixTimerImpl *timer)
 {
     wxLogTrace(wxTrace_Timer, wxT("Removing timer %d"), timer->GetId());
 
-    for ( wxTimerList::iterator node = m_timers.begin();
-          node != m_timers.end();
-          ++node )
+    wxTimerSchedule * const s = timer->m_schedule;
+    wxCHECK_RET( s && s->m_heapIndex < m_timers.size() &&
+                    m_timers[s->m_heapIndex] == s,
+                 wxT("removing inexistent timer?") );
+
+    delete DoRemoveAt(s->m_heapIndex);
+    timer->m_schedule = NULL;
+}
+
+wxTimerSchedule *wxTimerScheduler::DoRemoveAt(size_t n)
+{
+    wxTimerSchedule * const s = m_timers[n];
+
+    // replace the removed element with the last one and move it to its
+    // correct position, which may be either above or below this one
+    wxTimerSchedule * const last = m_timers.back();
+    m_timers.pop_back();
+
+    if ( last != s )
     {
-        if ( (*node)->m_timer == timer )
-        {
-            delete *node;
-            m_timers.erase(node);
-            return;
-        }
+        PutAt(n, last);
+        SiftUp(n);
+        SiftDown(last->m_heapIndex);
+    }
+
+    return s;
+}
+
+void wxTimerScheduler::SiftUp(size_t n)
+{
+    wxTimerSchedule * const s = m_timers[n];
+    while ( n > 0 )
+    {
+        const size_t parent = (n - 1) / 2;
+        if ( !s->IsBefore(*m_timers[parent]) )
+            break;
+
+        PutAt(n, m_timers[parent]);
+        n = parent;
     }
 
-    wxFAIL_MSG( wxT("removing inexistent timer?") );
+    PutAt(n, s);
+}
+
+void wxTimerScheduler::SiftDown(size_t n)
+{
+    const size_t count = m_timers.size();
+    wxTimerSchedule * const s = m_timers[n];
+    for ( ;; )
+    {
+        size_t child = 2*n + 1;
+        if ( child >= count )
+            break;
+
+        // choose the earliest of the two children
+        if ( child + 1 < count && m_timers[child + 1]->IsBefore(*m_timers[child]) )
+            child++;
+
+        if ( !m_timers[child]->IsBefore(*s) )
+            break;
+
+        PutAt(n, m_timers[child]);
+        n = child;
+    }
+
+    PutAt(n, s);
 }
 
 bool wxTimerScheduler::GetNext(wxUsecClock_t *remaining) const
@@ -111,7 +154,7 @@ bool wxTimerScheduler::GetNext(wxUsecClock_t *remaining) const
 
     wxCHECK_MSG( remaining, false, wxT("NULL pointer") );
 
-    *remaining = (*m_timers.begin())->m_expiration - wxGetUTCTimeUSec();
+    *remaining = m_timers[0]->m_expiration - wxGetUTCTimeUSec();
     if ( *remaining < 0 )
     {
         // timer already expired, don't wait at all before notifying it
@@ -130,30 +173,33 @@ bool wxTimerScheduler::NotifyExpired()
 
     typedef wxVector<wxUnixTimerImpl *> TimerImpls;
     TimerImpls toNotify;
-    for ( wxTimerList::iterator next,
-            cur = m_timers.begin(); cur != m_timers.end(); cur = next )
+
+    // the schedules of the periodic timers are only added back to the heap
+    // after taking all the expired timers from it, as otherwise a timer with
+    // 0 interval would be found expired again and again
+    Schedules toReschedule;
+
+    while ( !m_timers.empty() )
     {
-        wxTimerSchedule * const s = *cur;
+        wxTimerSchedule * const s = m_timers[0];
         if ( s->m_expiration > now )
         {
-            // as the list is sorted by expiration time, we can skip the rest
+            // as the first timer in the heap is the next one to expire, all
+            // the remaining ones are still in the future
             break;
         }
 
-        // remember next as we will delete the node pointed to by cur
-        next = cur;
-        ++next;
-
-        m_timers.erase(cur);
+        DoRemoveAt(0);
 
         // check whether we need to keep this timer
         wxUnixTimerImpl * const timer = s->m_timer;
         if ( timer->IsOneShot() )
         {
             // the timer needs to be stopped but don't call its Stop() from
-            // here as it would attempt to remove the timer from our list and
+            // here as it would attempt to remove the timer from our heap and
             // we had already done it, so we just need to reset its state
             timer->MarkStopped();
+            timer->m_schedule = NULL;
 
             // don't need it any more
             delete s;
@@ -165,16 +211,24 @@ bool wxTimerScheduler::NotifyExpired()
             // expiration time because it could happen that we're late and the
             // current expiration time is (far) in the past
             s->m_expiration = now + timer->GetInterval()*1000;
-            DoAddTimer(s);
+            toReschedule.push_back(s);
         }
 
         // we can't notify the timer from this loop as the timer event handler
         // could modify m_timers (for example, but not only, by stopping this
-        // timer) which would render our iterators invalid, so do it after the
-        // loop end
+        // timer) which would invalidate the schedules we're working with, so
+        // do it after the loop end
         toNotify.push_back(timer);
     }
 
+    for ( Schedules::const_iterator i = toReschedule.begin(),
+                                    end = toReschedule.end();
+          i != end;
+          ++i )
+    {
+        DoAddTimer(*i);
+    }
+
     if ( toNotify.empty() )
         return false;
 
@@ -197,6 +251,7 @@ wxUnixTimerImpl::wxUnixTimerImpl(wxTimer* timer)
                : wxTimerImpl(timer)
 {
     m_isRunning = false;
+    m_schedule = NULL;
 }
 
 bool wxUnixTimerImpl::Start(int milliseconds, bool oneShot)
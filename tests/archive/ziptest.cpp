@@ -19,6 +19,9 @@
 #if wxUSE_STREAMS && wxUSE_ZIPSTREAM
 
 #include "archivetest.h"
+#include "testfile.h"
+#include "wx/scopedptr.h"
+#include "wx/wfstream.h"
 #include "wx/zipstrm.h"
 
 using std::string;
@@ -252,4 +255,87 @@ CppUnit::Test *ziptest::makeTest(
 CPPUNIT_TEST_SUITE_REGISTRATION(ziptest);
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(ziptest, "archive/zip");
 
+#if wxUSE_FILE
+
+// ----------------------------------------------------------------------------
+// wxZipIndex test
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+wxString ReadAll(wxInputStream& in)
+{
+    wxString s;
+    char buf[256];
+    while ( in.Read(buf, sizeof(buf)).LastRead() )
+        s += wxString::FromAscii(buf, in.LastRead());
+    return s;
+}
+
+wxString GetEntryData(int n)
+{
+    return wxString::Format("Contents of the entry number %d\n", n);
+}
+
+} // anonymous namespace
+
+TEST_CASE("wxZipIndex", "[archive][zip]")
+{
+    TempFile tmp("zipindextest.zip");
+
+    // Create an archive with the entries added in non-sorted order.
+    const int NUM_ENTRIES = 100;
+    {
+        wxFileOutputStream out(tmp.GetName());
+        wxZipOutputStream zip(out);
+        for ( int n = NUM_ENTRIES - 1; n >= 0; n-- )
+        {
+            zip.PutNextEntry(wxString::Format("dir/file%02d.txt", n));
+            zip.Write(GetEntryData(n).ToAscii(), GetEntryData(n).length());
+        }
+
+        REQUIRE( zip.Close() );
+    }
+
+    wxZipIndex index;
+    REQUIRE( index.Open(tmp.GetName()) );
+    CHECK( index.IsOk() );
+    REQUIRE( index.GetCount() == NUM_ENTRIES );
+    CHECK( index.GetEntry(0).GetInternalName() == "dir/file00.txt" );
+    CHECK( index.GetEntry(NUM_ENTRIES - 1).GetInternalName() == "dir/file99.txt" );
+
+    CHECK( !index.Find("dir/file100.txt", wxPATH_UNIX) );
+    CHECK( !index.OpenEntry("nosuchfile") );
+
+    const wxZipEntry* const entry = index.Find("./dir/file42.txt", wxPATH_UNIX);
+    REQUIRE( entry );
+    CHECK( entry->GetSize() == static_cast<wxFileOffset>(GetEntryData(42).length()) );
+
+    // Open several entries at once and read them in an arbitrary order.
+    {
+        wxScopedPtr<wxZipInputStream> in42(index.OpenEntry(*entry));
+        wxScopedPtr<wxZipInputStream> in7(index.OpenEntry("dir/file07.txt",
+                                                          wxPATH_UNIX));
+        REQUIRE( in42 );
+        REQUIRE( in7 );
+        CHECK( ReadAll(*in7) == GetEntryData(7) );
+        CHECK( ReadAll(*in42) == GetEntryData(42) );
+        CHECK( in42->GetLastError() == wxSTREAM_EOF );
+    }
+
+    for ( size_t n = 0; n < index.GetCount(); n++ )
+    {
+        wxScopedPtr<wxZipInputStream> in(index.OpenEntry(index.GetEntry(n)));
+        REQUIRE( in );
+        CHECK( ReadAll(*in) == GetEntryData(n) );
+    }
+
+    index.Close();
+    CHECK( !index.IsOk() );
+    CHECK( index.GetCount() == 0 );
+}
+
+#endif // wxUSE_FILE
+
 #endif // wxUSE_STREAMS && wxUSE_ZIPSTREAM
@@ -0,0 +1,161 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/datastream.cpp
+// Purpose:     wxDataInputStream and wxDataOutputStream benchmarks
+// Author:      wxWidgets team
+// Created:     2020-03-28
+// Copyright:   (c) 2020 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "bench.h"
+
+#include "wx/datstrm.h"
+#include "wx/mstream.h"
+#include "wx/vector.h"
+
+// All the benchmarks here read or write an array of floating point numbers
+// occupying as many MB as the numeric parameter value (1 by default), so the
+// throughput in MB/s is 1000*parameter/(average time in ms).
+
+namespace
+{
+
+size_t GetDataSize()
+{
+    long num = Bench::GetNumericParameter();
+    if ( num <= 0 )
+        num = 1;
+
+    return num*1024*1024;
+}
+
+// Whether the data is in big endian order, requiring swapping the bytes on
+// little endian machines, or in the native one.
+bool UseBigEndian(bool swap)
+{
+    return swap == (wxBYTE_ORDER == wxLITTLE_ENDIAN);
+}
+
+template <typename T>
+const wxVector<T>& GetValues()
+{
+    static wxVector<T> s_values;
+    if ( s_values.empty() )
+    {
+        s_values.resize(GetDataSize() / sizeof(T));
+        for ( size_t n = 0; n < s_values.size(); n++ )
+            s_values[n] = static_cast<T>(n*0.125 - 1000.5);
+    }
+
+    return s_values;
+}
+
+void WriteValues(wxDataOutputStream& dos, const wxVector<float>& values)
+{
+    dos.WriteFloat(&values[0], values.size());
+}
+
+void WriteValues(wxDataOutputStream& dos, const wxVector<double>& values)
+{
+    dos.WriteDouble(&values[0], values.size());
+}
+
+void ReadValues(wxDataInputStream& dis, wxVector<float>& values)
+{
+    dis.ReadFloat(&values[0], values.size());
+}
+
+void ReadValues(wxDataInputStream& dis, wxVector<double>& values)
+{
+    dis.ReadDouble(&values[0], values.size());
+}
+
+template <typename T>
+bool DoWrite(bool swap)
+{
+    // Reuse the same stream to avoid measuring the time needed to grow it.
+    static wxMemoryOutputStream s_mos;
+    s_mos.SeekO(0);
+
+    const wxVector<T>& values = GetValues<T>();
+
+    wxDataOutputStream dos(s_mos);
+    dos.BigEndianOrdered(UseBigEndian(swap));
+    dos.UseBasicPrecisions();
+
+    WriteValues(dos, values);
+
+    return s_mos.TellO() == static_cast<wxFileOffset>(GetDataSize());
+}
+
+template <typename T>
+bool DoRead(bool swap)
+{
+    static wxVector<char> s_data[2];
+    wxVector<char>& data = s_data[swap];
+    if ( data.empty() )
+    {
+        wxMemoryOutputStream mos;
+        wxDataOutputStream dos(mos);
+        dos.BigEndianOrdered(UseBigEndian(swap));
+        dos.UseBasicPrecisions();
+        WriteValues(dos, GetValues<T>());
+
+        data.resize(mos.GetLength());
+        mos.CopyTo(&data[0], data.size());
+    }
+
+    wxMemoryInputStream mis(&data[0], data.size());
+    wxDataInputStream dis(mis);
+    dis.BigEndianOrdered(UseBigEndian(swap));
+    dis.UseBasicPrecisions();
+
+    static wxVector<T> s_values;
+    s_values.resize(GetValues<T>().size());
+    ReadValues(dis, s_values);
+
+    return mis.TellI() == static_cast<wxFileOffset>(GetDataSize()) &&
+            s_values.back() == GetValues<T>().back();
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC(DataStreamWriteFloat)
+{
+    return DoWrite<float>(false);
+}
+
+BENCHMARK_FUNC(DataStreamWriteFloatSwapped)
+{
+    return DoWrite<float>(true);
+}
+
+BENCHMARK_FUNC(DataStreamWriteDouble)
+{
+    return DoWrite<double>(false);
+}
+
+BENCHMARK_FUNC(DataStreamWriteDoubleSwapped)
+{
+    return DoWrite<double>(true);
+}
+
+BENCHMARK_FUNC(DataStreamReadFloat)
+{
+    return DoRead<float>(false);
+}
+
+BENCHMARK_FUNC(DataStreamReadFloatSwapped)
+{
+    return DoRead<float>(true);
+}
+
+BENCHMARK_FUNC(DataStreamReadDouble)
+{
+    return DoRead<double>(false);
+}
+
+BENCHMARK_FUNC(DataStreamReadDoubleSwapped)
+{
+    return DoRead<double>(true);
+}
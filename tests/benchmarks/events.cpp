@@ -0,0 +1,219 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/events.cpp
+// Purpose:     Event-related benchmarks
+// Author:      wxWidgets team
+// Created:     2020-03-16
+// Copyright:   (c) 2020 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "bench.h"
+
+#include "wx/app.h"
+#include "wx/event.h"
+#include "wx/thread.h"
+#include "wx/vector.h"
+
+namespace
+{
+
+// Handler simply counting the thread events it gets.
+class CountingHandler : public wxEvtHandler
+{
+public:
+    CountingHandler()
+    {
+        m_count = 0;
+
+        Bind(wxEVT_THREAD, &CountingHandler::OnThreadEvent, this);
+    }
+
+    int m_count;
+
+private:
+    void OnThreadEvent(wxThreadEvent& WXUNUSED(event))
+    {
+        m_count++;
+    }
+
+    wxDECLARE_NO_COPY_CLASS(CountingHandler);
+};
+
+// Process the pending events until the handler gets the given number of them.
+bool ProcessEventsUntil(const CountingHandler& handler, int count)
+{
+    while ( handler.m_count < count )
+    {
+        if ( !wxTheApp->HasPendingEvents() )
+        {
+            wxThread::Yield();
+            continue;
+        }
+
+        wxTheApp->ProcessPendingEvents();
+    }
+
+    return handler.m_count == count;
+}
+
+// Return the number of events to post from each thread or handler.
+int GetNumEvents()
+{
+    const long n = Bench::GetNumericParameter();
+
+    return n ? n : 100;
+}
+
+} // anonymous namespace
+
+// Queue events to a single handler from the main thread only.
+BENCHMARK_FUNC(QueueEvent)
+{
+    CountingHandler handler;
+
+    const int numEvents = GetNumEvents();
+    for ( int n = 0; n < numEvents; n++ )
+        handler.QueueEvent(new wxThreadEvent);
+
+    return ProcessEventsUntil(handler, numEvents);
+}
+
+// Queue events to many different handlers: this measures the cost of keeping
+// track of the handlers with pending events.
+BENCHMARK_FUNC(QueueEventManyHandlers)
+{
+    const int numHandlers = GetNumEvents();
+
+    wxVector<CountingHandler*> handlers(numHandlers);
+    for ( int n = 0; n < numHandlers; n++ )
+    {
+        handlers[n] = new CountingHandler;
+        handlers[n]->QueueEvent(new wxThreadEvent);
+    }
+
+    wxTheApp->ProcessPendingEvents();
+
+    bool ok = true;
+    for ( int n = 0; n < numHandlers; n++ )
+    {
+        if ( handlers[n]->m_count != 1 )
+            ok = false;
+
+        delete handlers[n];
+    }
+
+    return ok;
+}
+
+namespace
+{
+
+wxEvtHandler* gs_handlerWithMany = NULL;
+
+const wxEventTypeTag<wxThreadEvent> wxEVT_BENCH_TARGET(wxNewEventType());
+
+void OnBenchEvent(wxThreadEvent& WXUNUSED(event))
+{
+}
+
+// Create a handler with many handlers bound to it for different events.
+bool InitHandlerWithMany()
+{
+    gs_handlerWithMany = new wxEvtHandler;
+
+    // Bind the handler for the event we're going to send first, so that it
+    // is found last when searching the handlers.
+    gs_handlerWithMany->Bind(wxEVT_BENCH_TARGET, OnBenchEvent);
+
+    const long n = Bench::GetNumericParameter();
+    const int numOthers = n ? n : 500;
+    for ( int i = 0; i < numOthers; i++ )
+    {
+        const wxEventTypeTag<wxThreadEvent> eventType(wxNewEventType());
+        gs_handlerWithMany->Bind(eventType, OnBenchEvent);
+    }
+
+    return true;
+}
+
+void DoneHandlerWithMany()
+{
+    delete gs_handlerWithMany;
+    gs_handlerWithMany = NULL;
+}
+
+} // anonymous namespace
+
+// Process an event in a handler with many handlers bound to other events.
+BENCHMARK_FUNC_WITH_INIT(ProcessEventManyBound,
+                         InitHandlerWithMany, DoneHandlerWithMany)
+{
+    wxThreadEvent event(wxEVT_BENCH_TARGET);
+
+    return gs_handlerWithMany->ProcessEvent(event);
+}
+
+#if wxUSE_THREADS
+
+namespace
+{
+
+// Thread posting the given number of events to the handler.
+class PostingThread : public wxThread
+{
+public:
+    PostingThread(wxEvtHandler& handler, int numEvents)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_handler(handler),
+          m_numEvents(numEvents)
+    {
+    }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        for ( int n = 0; n < m_numEvents; n++ )
+            m_handler.QueueEvent(new wxThreadEvent);
+
+        return 0;
+    }
+
+private:
+    wxEvtHandler& m_handler;
+    const int m_numEvents;
+
+    wxDECLARE_NO_COPY_CLASS(PostingThread);
+};
+
+const int NUM_THREADS = 4;
+
+} // anonymous namespace
+
+// Queue events to a single handler from several worker threads while
+// processing them in the main thread.
+BENCHMARK_FUNC(QueueEventFromThreads)
+{
+    CountingHandler handler;
+
+    const int numEvents = GetNumEvents();
+
+    PostingThread* threads[NUM_THREADS];
+    for ( int n = 0; n < NUM_THREADS; n++ )
+    {
+        threads[n] = new PostingThread(handler, numEvents);
+        if ( threads[n]->Run() != wxTHREAD_NO_ERROR )
+            return false;
+    }
+
+    const bool ok = ProcessEventsUntil(handler, NUM_THREADS*numEvents);
+
+    for ( int n = 0; n < NUM_THREADS; n++ )
+    {
+        threads[n]->Wait();
+        delete threads[n];
+    }
+
+    return ok;
+}
+
+#endif // wxUSE_THREADS
@@ -0,0 +1,116 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/grid.cpp
+// Purpose:     wxGrid benchmarks
+// Author:      wxWidgets team
+// Created:     2020-03-14
+// Copyright:   (c) 2020 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/bitmap.h"
+#include "wx/dcmemory.h"
+#include "wx/grid.h"
+
+#include "bench.h"
+
+#if wxUSE_GRID
+
+namespace
+{
+
+// Number of rows and columns in the grid: together they give 10^5 cells.
+const int NUM_ROWS = 10000;
+const int NUM_COLS = 10;
+
+wxGrid* gs_grid = NULL;
+
+// Create the grid with all of its cells having their own attributes.
+bool InitStyledGrid()
+{
+    gs_grid = new wxGrid(wxTheApp->GetTopWindow(), wxID_ANY);
+    gs_grid->CreateGrid(NUM_ROWS, NUM_COLS);
+
+    for ( int row = 0; row < NUM_ROWS; row++ )
+    {
+        for ( int col = 0; col < NUM_COLS; col++ )
+        {
+            gs_grid->SetCellBackgroundColour(row, col,
+                                             (row + col) % 2 ? *wxLIGHT_GREY
+                                                             : *wxWHITE);
+        }
+    }
+
+    return true;
+}
+
+// Same grid, but styled using a single block attribute.
+bool InitBlockStyledGrid()
+{
+    gs_grid = new wxGrid(wxTheApp->GetTopWindow(), wxID_ANY);
+    gs_grid->CreateGrid(NUM_ROWS, NUM_COLS);
+
+    wxGridCellAttr* const attr = new wxGridCellAttr;
+    attr->SetBackgroundColour(*wxLIGHT_GREY);
+    gs_grid->GetTable()->GetAttrProvider()->SetBlockAttr(attr,
+                                                         0, 0,
+                                                         NUM_ROWS - 1,
+                                                         NUM_COLS - 1);
+
+    return true;
+}
+
+void DoneGrid()
+{
+    delete gs_grid;
+    gs_grid = NULL;
+}
+
+// Paint the cells in the middle of the grid, i.e. the part that would be
+// visible on screen after scrolling to it.
+bool PaintGrid()
+{
+    wxBitmap bmp(800, 600);
+    wxMemoryDC dc(bmp);
+
+    const int topRow = NUM_ROWS / 2;
+    gs_grid->Render(dc, wxPoint(0, 0), bmp.GetSize(),
+                    wxGridCellCoords(topRow, 0),
+                    wxGridCellCoords(topRow + 30, NUM_COLS - 1));
+
+    return true;
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC_WITH_INIT(GridPaintStyledCells, InitStyledGrid, DoneGrid)
+{
+    return PaintGrid();
+}
+
+BENCHMARK_FUNC_WITH_INIT(GridPaintStyledBlock, InitBlockStyledGrid, DoneGrid)
+{
+    return PaintGrid();
+}
+
+BENCHMARK_FUNC_WITH_INIT(GridGetStyledCellAttr, InitStyledGrid, DoneGrid)
+{
+    // Look up the attributes of all the cells of a screenful of rows, as done
+    // when drawing them, but without the overhead of actually drawing them.
+    const wxGridTableBase* const table = gs_grid->GetTable();
+
+    const int topRow = NUM_ROWS / 2;
+    for ( int row = topRow; row < topRow + 30; row++ )
+    {
+        for ( int col = 0; col < NUM_COLS; col++ )
+        {
+            if ( !table->GetAttrProvider()->GetAttrPtr(row, col,
+                                                       wxGridCellAttr::Any) )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+#endif // wxUSE_GRID
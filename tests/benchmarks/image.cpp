@@ -8,6 +8,10 @@
 /////////////////////////////////////////////////////////////////////////////
 
 #include "wx/image.h"
+#include "wx/imageloader.h"
+#include "wx/math.h"
+#include "wx/quantize.h"
+#include "wx/vector.h"
 
 #include "bench.h"
 
@@ -58,6 +62,58 @@ BENCHMARK_FUNC(LoadTIFF)
 }
 #endif // wxUSE_LIBTIFF
 
+// Batch loading benchmarks: each iteration loads the same number of PNG and
+// JPEG images, so the number of images loaded per second is 64 divided by the
+// time taken by a single iteration.
+namespace
+{
+
+const int BATCH_SIZE = 64;
+
+const char* GetBatchFile(int n)
+{
+    static bool s_handlersAdded = false;
+    if ( !s_handlersAdded )
+    {
+        s_handlersAdded = true;
+        wxImage::AddHandler(new wxJPEGHandler);
+        wxImage::AddHandler(new wxPNGHandler);
+    }
+
+    return n % 2 ? "horse.jpg" : "horse.png";
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC(LoadBatchSerial)
+{
+    for ( int n = 0; n < BATCH_SIZE; n++ )
+    {
+        wxImage image;
+        if ( !image.LoadFile(GetBatchFile(n)) )
+            return false;
+    }
+
+    return true;
+}
+
+#if wxUSE_THREADS
+BENCHMARK_FUNC(LoadBatchLoader)
+{
+    wxImageLoader loader;
+    for ( int n = 0; n < BATCH_SIZE; n++ )
+        loader.Load(GetBatchFile(n));
+
+    for ( int n = 0; n < BATCH_SIZE; n++ )
+    {
+        if ( !loader.GetImage(n).IsOk() )
+            return false;
+    }
+
+    return true;
+}
+#endif // wxUSE_THREADS
+
 static const wxImage& GetTestImage()
 {
     static wxImage s_image;
@@ -90,3 +146,233 @@ BENCHMARK_FUNC(ShrinkHighQuality)
 {
     return GetTestImage().Scale(50, 50, wxIMAGE_QUALITY_HIGH).IsOk();
 }
+
+// Resampling benchmarks using a big image, whose width may be specified using
+// the numeric parameter, with all the available threads and with a single one,
+// i.e. in the same way as before resampling could use several threads.
+namespace
+{
+
+const wxImage& GetBigImage()
+{
+    static wxImage s_image;
+    if ( !s_image.IsOk() )
+    {
+        const long param = Bench::GetNumericParameter();
+        const int width = param ? param : 4000;
+        const int height = (width*3)/4;
+
+        s_image.Create(width, height, false);
+
+        unsigned char* data = s_image.GetData();
+        for ( int y = 0; y < height; y++ )
+        {
+            for ( int x = 0; x < width; x++ )
+            {
+                *data++ = x;
+                *data++ = y;
+                *data++ = x ^ y;
+            }
+        }
+    }
+
+    return s_image;
+}
+
+bool DoResample(wxImageResizeQuality quality, double scale, int numThreads)
+{
+    const wxImage& image = GetBigImage();
+
+    wxImage::SetMaxThreads(numThreads);
+    const wxImage scaled = image.Scale(wxRound(image.GetWidth()*scale),
+                                       wxRound(image.GetHeight()*scale),
+                                       quality);
+    wxImage::SetMaxThreads(0);
+
+    return scaled.IsOk();
+}
+
+bool DoBlur(wxImageBlurMode mode, int radius, int numThreads)
+{
+    wxImage::SetMaxThreads(numThreads);
+    const wxImage blurred = GetBigImage().Blur(radius, mode);
+    wxImage::SetMaxThreads(0);
+
+    return blurred.IsOk();
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC(ResampleBilinearThumbnail)
+{
+    return DoResample(wxIMAGE_QUALITY_BILINEAR, 0.05, 0);
+}
+
+BENCHMARK_FUNC(ResampleBilinearThumbnailSingleThread)
+{
+    return DoResample(wxIMAGE_QUALITY_BILINEAR, 0.05, 1);
+}
+
+BENCHMARK_FUNC(ResampleBilinearHalf)
+{
+    return DoResample(wxIMAGE_QUALITY_BILINEAR, 0.5, 0);
+}
+
+BENCHMARK_FUNC(ResampleBilinearHalfSingleThread)
+{
+    return DoResample(wxIMAGE_QUALITY_BILINEAR, 0.5, 1);
+}
+
+BENCHMARK_FUNC(ResampleBicubicThumbnail)
+{
+    return DoResample(wxIMAGE_QUALITY_BICUBIC, 0.05, 0);
+}
+
+BENCHMARK_FUNC(ResampleBicubicThumbnailSingleThread)
+{
+    return DoResample(wxIMAGE_QUALITY_BICUBIC, 0.05, 1);
+}
+
+BENCHMARK_FUNC(ResampleBicubicHalf)
+{
+    return DoResample(wxIMAGE_QUALITY_BICUBIC, 0.5, 0);
+}
+
+BENCHMARK_FUNC(ResampleBicubicHalfSingleThread)
+{
+    return DoResample(wxIMAGE_QUALITY_BICUBIC, 0.5, 1);
+}
+
+BENCHMARK_FUNC(ResampleBicubicEnlarge)
+{
+    return DoResample(wxIMAGE_QUALITY_BICUBIC, 1.5, 0);
+}
+
+BENCHMARK_FUNC(ResampleBicubicEnlargeSingleThread)
+{
+    return DoResample(wxIMAGE_QUALITY_BICUBIC, 1.5, 1);
+}
+
+BENCHMARK_FUNC(ResampleBoxThumbnail)
+{
+    return DoResample(wxIMAGE_QUALITY_BOX_AVERAGE, 0.05, 0);
+}
+
+BENCHMARK_FUNC(ResampleBoxThumbnailSingleThread)
+{
+    return DoResample(wxIMAGE_QUALITY_BOX_AVERAGE, 0.05, 1);
+}
+
+BENCHMARK_FUNC(ResampleBoxHalf)
+{
+    return DoResample(wxIMAGE_QUALITY_BOX_AVERAGE, 0.5, 0);
+}
+
+BENCHMARK_FUNC(ResampleBoxHalfSingleThread)
+{
+    return DoResample(wxIMAGE_QUALITY_BOX_AVERAGE, 0.5, 1);
+}
+
+BENCHMARK_FUNC(Rotate)
+{
+    return GetBigImage().Rotate(0.3, wxPoint(0, 0)).IsOk();
+}
+
+BENCHMARK_FUNC(RotateInterpolating)
+{
+    return GetBigImage().Rotate(0.3, wxPoint(0, 0), true).IsOk();
+}
+
+BENCHMARK_FUNC(BlurBox2)
+{
+    return DoBlur(wxIMAGE_BLUR_BOX, 2, 0);
+}
+
+BENCHMARK_FUNC(BlurBox16)
+{
+    return DoBlur(wxIMAGE_BLUR_BOX, 16, 0);
+}
+
+BENCHMARK_FUNC(BlurBox64)
+{
+    return DoBlur(wxIMAGE_BLUR_BOX, 64, 0);
+}
+
+BENCHMARK_FUNC(BlurBox16SingleThread)
+{
+    return DoBlur(wxIMAGE_BLUR_BOX, 16, 1);
+}
+
+BENCHMARK_FUNC(BlurGaussian2)
+{
+    return DoBlur(wxIMAGE_BLUR_GAUSSIAN, 2, 0);
+}
+
+BENCHMARK_FUNC(BlurGaussian16)
+{
+    return DoBlur(wxIMAGE_BLUR_GAUSSIAN, 16, 0);
+}
+
+BENCHMARK_FUNC(BlurGaussian64)
+{
+    return DoBlur(wxIMAGE_BLUR_GAUSSIAN, 64, 0);
+}
+
+BENCHMARK_FUNC(BlurGaussian16SingleThread)
+{
+    return DoBlur(wxIMAGE_BLUR_GAUSSIAN, 16, 1);
+}
+
+BENCHMARK_FUNC(ExportPixelsPremultiplied)
+{
+    static wxImage s_image;
+    if ( !s_image.IsOk() )
+    {
+        s_image = GetBigImage();
+        s_image.InitAlpha();
+    }
+
+    static wxVector<unsigned char> s_buffer;
+    s_buffer.resize(4*s_image.GetWidth()*s_image.GetHeight());
+
+    return s_image.ExportPixels(&s_buffer[0], 4*s_image.GetWidth(),
+                                wxIMAGE_PIXEL_ARGB32,
+                                wxIMAGE_PIXEL_PREMULTIPLIED);
+}
+
+BENCHMARK_FUNC(Quantize)
+{
+    wxImage dest;
+    return wxQuantize::Quantize(GetBigImage(), dest, 256, NULL,
+                                wxQUANTIZE_FILL_DESTINATION_IMAGE);
+}
+
+static bool DoQuantizerMap(int bandHeight)
+{
+    static wxQuantizer s_quantizer;
+    static bool s_initialized = false;
+    if ( !s_initialized )
+    {
+        s_initialized = true;
+        s_quantizer.AddImage(GetBigImage());
+        s_quantizer.CreatePalette();
+    }
+
+    const wxImage& image = GetBigImage();
+
+    static wxVector<unsigned char> s_indices;
+    s_indices.resize(image.GetWidth()*image.GetHeight());
+
+    s_quantizer.SetBandHeight(bandHeight);
+    return s_quantizer.MapImage(image, &s_indices[0]);
+}
+
+BENCHMARK_FUNC(QuantizerMap)
+{
+    return DoQuantizerMap(0);
+}
+
+BENCHMARK_FUNC(QuantizerMapBands)
+{
+    return DoQuantizerMap(64);
+}
@@ -106,3 +106,115 @@ BENCHMARK_FUNC(LogTraceInactive)
 
     return true;
 }
+
+#if wxUSE_THREADS
+
+#include "wx/thread.h"
+
+namespace
+{
+
+// Log target simply throwing away all the messages, unlike NulLog above it
+// doesn't install itself as the active target.
+class DiscardingLog : public wxLog
+{
+public:
+    DiscardingLog() { }
+
+protected:
+    virtual void DoLogTextAtLevel(wxLogLevel, const wxString&) wxOVERRIDE
+    {
+    }
+
+    wxDECLARE_NO_COPY_CLASS(DiscardingLog);
+};
+
+// Thread logging the given number of messages.
+class LoggingThread : public wxThread
+{
+public:
+    explicit LoggingThread(int numMessages)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_numMessages(numMessages)
+    {
+    }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        for ( int n = 0; n < m_numMessages; n++ )
+            wxLogMessage("Message %d from a worker thread", n);
+
+        return 0;
+    }
+
+private:
+    const int m_numMessages;
+
+    wxDECLARE_NO_COPY_CLASS(LoggingThread);
+};
+
+const int NUM_THREADS = 4;
+
+wxLog* gs_logOld = NULL;
+
+bool InitDiscardingLog()
+{
+    gs_logOld = wxLog::SetActiveTarget(new DiscardingLog);
+
+    return true;
+}
+
+bool InitAsyncLog()
+{
+    // Use a big enough buffer to avoid dropping any messages.
+    gs_logOld = wxLog::SetActiveTarget(new wxLogAsync(new DiscardingLog,
+                                                      1000000));
+
+    return true;
+}
+
+void DoneLog()
+{
+    delete wxLog::SetActiveTarget(gs_logOld);
+    gs_logOld = NULL;
+}
+
+// Log messages from several threads simultaneously and flush them.
+bool DoLogFromThreads()
+{
+    const long n = Bench::GetNumericParameter();
+    const int numMessages = n ? n : 1000;
+
+    LoggingThread* threads[NUM_THREADS];
+    for ( int i = 0; i < NUM_THREADS; i++ )
+    {
+        threads[i] = new LoggingThread(numMessages);
+        if ( threads[i]->Run() != wxTHREAD_NO_ERROR )
+            return false;
+    }
+
+    for ( int i = 0; i < NUM_THREADS; i++ )
+    {
+        threads[i]->Wait();
+        delete threads[i];
+    }
+
+    wxLog::FlushActive();
+
+    return true;
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC_WITH_INIT(LogFromThreads, InitDiscardingLog, DoneLog)
+{
+    return DoLogFromThreads();
+}
+
+BENCHMARK_FUNC_WITH_INIT(LogAsyncFromThreads, InitAsyncLog, DoneLog)
+{
+    return DoLogFromThreads();
+}
+
+#endif // wxUSE_THREADS
@@ -42,6 +42,40 @@ bool ConvertToMB(const wxMBConv& conv)
     return conv.FromWChar(buf.data(), outlen, TEST_STRING) == outlen;
 }
 
+// return a string of several megabytes, either pure ASCII or containing a
+// mix of ASCII, other BMP and non-BMP characters
+const wxString& GetBigString(bool ascii)
+{
+    static wxString s_ascii, s_mixed;
+    wxString& s = ascii ? s_ascii : s_mixed;
+    if ( s.empty() )
+    {
+        long num = Bench::GetNumericParameter();
+        if ( !num )
+            num = 1;
+
+        const wxString mixed = wxString::FromUTF8(
+            "\xD0\xA6\xD0\xB5\xD0\xBB\xD0\xBE\xD0\xB5 \xE2\x82\xAC "
+            "\xF0\x9F\x98\x80 ");
+        for ( long n = 0; n < 10000*num; n++ )
+        {
+            s += TEST_STRING;
+            if ( !ascii )
+                s += mixed;
+        }
+    }
+
+    return s;
+}
+
+// convert the big string to the multibyte encoding and back
+bool ConvertBig(const wxMBConv& conv, bool ascii)
+{
+    const wxString& s = GetBigString(ascii);
+    const wxCharBuffer buf = s.mb_str(conv);
+    return wxString(buf, conv, buf.length()) == s;
+}
+
 } // anonymous namespace
 
 BENCHMARK_FUNC(UTF16InitWX)
@@ -76,3 +110,28 @@ BENCHMARK_FUNC(UTF16Sys)
     return ConvertToMB(wxCSConv("UTF-16LE"));
 }
 
+
+BENCHMARK_FUNC(UTF8BigASCII)
+{
+    return ConvertBig(wxMBConvStrictUTF8(), true);
+}
+
+BENCHMARK_FUNC(UTF8Big)
+{
+    return ConvertBig(wxMBConvStrictUTF8(), false);
+}
+
+BENCHMARK_FUNC(UTF16BigASCII)
+{
+    return ConvertBig(wxMBConvUTF16LE(), true);
+}
+
+BENCHMARK_FUNC(UTF16Big)
+{
+    return ConvertBig(wxMBConvUTF16LE(), false);
+}
+
+BENCHMARK_FUNC(UTF16BEBig)
+{
+    return ConvertBig(wxMBConvUTF16BE(), false);
+}
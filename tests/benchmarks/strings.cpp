@@ -9,6 +9,10 @@
 
 #include "wx/string.h"
 #include "wx/ffile.h"
+#include "wx/mstream.h"
+#include "wx/textfile.h"
+#include "wx/txtstrm.h"
+#include "wx/wfstream.h"
 
 #include "bench.h"
 #include "htmlparser/htmlpars.h"
@@ -115,6 +119,50 @@ BENCHMARK_FUNC(FromUTF8WithLen)
     return true;
 }
 
+// the same as above but with strings of several megabytes
+static const wxCharBuffer& GetBigUTF8(const char* str)
+{
+    static wxCharBuffer s_ascii, s_utf8;
+    wxCharBuffer& buf = str == asciistr ? s_ascii : s_utf8;
+    if ( !buf.length() )
+    {
+        long num = Bench::GetNumericParameter();
+        if ( !num )
+            num = 1;
+
+        const size_t len = strlen(str);
+        buf = wxCharBuffer(10000*num*len);
+        for ( long n = 0; n < 10000*num; n++ )
+            memcpy(buf.data() + n*len, str, len);
+    }
+
+    return buf;
+}
+
+BENCHMARK_FUNC(FromUTF8Big)
+{
+    const wxCharBuffer& buf = GetBigUTF8(utf8str);
+    return !wxString::FromUTF8(buf.data(), buf.length()).empty();
+}
+
+BENCHMARK_FUNC(FromUTF8BigASCII)
+{
+    const wxCharBuffer& buf = GetBigUTF8(asciistr);
+    return !wxString::FromUTF8(buf.data(), buf.length()).empty();
+}
+
+BENCHMARK_FUNC(ToUTF8Big)
+{
+    static const wxString s = wxString::FromUTF8(GetBigUTF8(utf8str).data());
+    return s.utf8_str().length() == GetBigUTF8(utf8str).length();
+}
+
+BENCHMARK_FUNC(ToUTF8BigASCII)
+{
+    static const wxString s = wxString::FromUTF8(GetBigUTF8(asciistr).data());
+    return s.utf8_str().length() == GetBigUTF8(asciistr).length();
+}
+
 // ----------------------------------------------------------------------------
 // FromUTF8Unchecked() benchmarks
 // ----------------------------------------------------------------------------
@@ -453,3 +501,77 @@ BENCHMARK_FUNC(ParseHTML)
 
     return true;
 }
+
+
+// ----------------------------------------------------------------------------
+// wxTextInputStream::ReadLine() - read large text line by line
+// ----------------------------------------------------------------------------
+
+static const wxCharBuffer& GetTestLines(const char* line)
+{
+    static wxCharBuffer s_ascii, s_utf8;
+    wxCharBuffer& buf = line == asciistr ? s_ascii : s_utf8;
+    if ( !buf.length() )
+    {
+        long num = Bench::GetNumericParameter();
+        if ( !num )
+            num = 1;
+
+        wxString text;
+        for ( long n = 0; n < 1000*num; n++ )
+        {
+            text += wxString::FromUTF8(line);
+            text += '\n';
+        }
+
+        buf = text.utf8_str();
+    }
+
+    return buf;
+}
+
+static bool ReadLines(wxInputStream& stream)
+{
+    wxTextInputStream text(stream);
+    while ( !stream.Eof() )
+        text.ReadLine();
+
+    return true;
+}
+
+BENCHMARK_FUNC(ReadLineASCII)
+{
+    const wxCharBuffer& buf = GetTestLines(asciistr);
+    wxMemoryInputStream stream(buf.data(), buf.length());
+    return ReadLines(stream);
+}
+
+BENCHMARK_FUNC(ReadLineUTF8)
+{
+    const wxCharBuffer& buf = GetTestLines(utf8str);
+    wxMemoryInputStream stream(buf.data(), buf.length());
+    return ReadLines(stream);
+}
+
+BENCHMARK_FUNC(ReadLineFile)
+{
+    wxFileInputStream stream("htmltest.html");
+    return stream.IsOk() && ReadLines(stream);
+}
+
+// ----------------------------------------------------------------------------
+// wxTextFile::Open() - load the entire text file
+// ----------------------------------------------------------------------------
+
+BENCHMARK_FUNC(TextFileOpen)
+{
+    wxTextFile file;
+    return file.Open("htmltest.html") && file.GetLineCount() > 0;
+}
+
+BENCHMARK_FUNC(TextFileOpenLazy)
+{
+    wxTextFile file;
+    file.SetLazyLoading();
+    return file.Open("htmltest.html") && file.GetLineCount() > 0;
+}
@@ -191,6 +191,102 @@ TEST_CASE_METHOD(MultiSelectDataViewCtrlTestCase,
 #endif
 }
 
+TEST_CASE_METHOD(MultiSelectDataViewCtrlTestCase,
+                 "wxDVC::BatchChanges",
+                 "[wxDataViewCtrl][delete][batch]")
+{
+    m_dvc->Expand(m_child1);
+
+    wxDataViewItemArray sel;
+    sel.push_back(m_grandchild);
+    sel.push_back(m_child2);
+    m_dvc->SetSelections(sel);
+
+    wxDataViewModel* const model = m_dvc->GetModel();
+    model->BeginBatch();
+    CHECK( model->IsInBatch() );
+
+    // Add some items before the selected ones and delete a selected item.
+    const wxDataViewItem first = m_dvc->PrependItem(m_root, "first");
+    m_dvc->PrependItem(m_child1, "grandchild0");
+    m_dvc->DeleteItem(m_grandchild);
+    m_dvc->AppendItem(m_root, "last");
+
+    model->EndBatch();
+    CHECK( !model->IsInBatch() );
+
+    // The selection must have been updated to account for all the changes.
+    m_dvc->GetSelections(sel);
+    REQUIRE( sel.size() == 1 );
+    CHECK( sel[0] == m_child2 );
+
+    CHECK( m_dvc->GetChildCount(m_root) == 4 );
+    CHECK( m_dvc->GetChildCount(m_child1) == 1 );
+
+    m_dvc->Select(first);
+    CHECK( m_dvc->GetSelectedItemsCount() == 2 );
+}
+
+namespace
+{
+
+// Notifier doing nothing except keeping track of the batch nesting level.
+class BatchLevelNotifier : public wxDataViewModelNotifier
+{
+public:
+    explicit BatchLevelNotifier(int& level) : m_level(level) { }
+
+    virtual bool ItemAdded(const wxDataViewItem&,
+                           const wxDataViewItem&) wxOVERRIDE { return true; }
+    virtual bool ItemDeleted(const wxDataViewItem&,
+                             const wxDataViewItem&) wxOVERRIDE { return true; }
+    virtual bool ItemChanged(const wxDataViewItem&) wxOVERRIDE { return true; }
+    virtual bool ValueChanged(const wxDataViewItem&,
+                              unsigned int) wxOVERRIDE { return true; }
+    virtual bool Cleared() wxOVERRIDE { return true; }
+    virtual void Resort() wxOVERRIDE { }
+
+    virtual void BeginBatch() wxOVERRIDE { m_level++; }
+    virtual void EndBatch() wxOVERRIDE { m_level--; }
+
+private:
+    int& m_level;
+};
+
+} // anonymous namespace
+
+TEST_CASE_METHOD(SingleSelectDataViewCtrlTestCase,
+                 "wxDVC::BatchNotifiers",
+                 "[wxDataViewCtrl][batch]")
+{
+    wxDataViewModel* const model = m_dvc->GetModel();
+
+    int level = 0;
+    BatchLevelNotifier* const notifier = new BatchLevelNotifier(level);
+    model->AddNotifier(notifier);
+
+    model->BeginBatch();
+    CHECK( level == 1 );
+
+    // Removing the notifier during the batch must end it for this notifier.
+    model->RemoveNotifier(notifier);
+    CHECK( level == 0 );
+
+    model->EndBatch();
+    CHECK( level == 0 );
+
+    // And adding it during the batch must start it.
+    BatchLevelNotifier* const notifier2 = new BatchLevelNotifier(level);
+    model->BeginBatch();
+    model->AddNotifier(notifier2);
+    CHECK( level == 1 );
+
+    model->EndBatch();
+    CHECK( level == 0 );
+
+    model->RemoveNotifier(notifier2);
+}
+
 void DataViewCtrlTestCase::TestSelectionFor0and1()
 {
     wxDataViewItemArray selections;
@@ -309,6 +405,87 @@ TEST_CASE_METHOD(SingleSelectDataViewCtrlTestCase,
     CHECK( rectRoot == wxRect() );
 }
 
+TEST_CASE_METHOD(SingleSelectDataViewCtrlTestCase,
+                 "wxDVC::ItemRectAfterChanges",
+                 "[wxDataViewCtrl][item]")
+{
+    m_dvc->Expand(m_child1);
+
+#ifdef __WXGTK__
+    wxYield();
+#endif // __WXGTK__
+
+    const wxRect rectChild1 = m_dvc->GetItemRect(m_child1);
+    const wxRect rectGrandchild = m_dvc->GetItemRect(m_grandchild);
+    const wxRect rectChild2 = m_dvc->GetItemRect(m_child2);
+
+    REQUIRE( rectGrandchild != wxRect() );
+    CHECK( rectChild1.y < rectGrandchild.y );
+    CHECK( rectGrandchild.y < rectChild2.y );
+
+    // Adding a child to the first item must shift the second one down.
+    const wxDataViewItem
+        grandchild2 = m_dvc->AppendItem(m_child1, "grandchild2");
+
+#ifdef __WXGTK__
+    wxYield();
+#endif // __WXGTK__
+
+    CHECK( m_dvc->GetItemRect(grandchild2).y == rectChild2.y );
+    CHECK( m_dvc->GetItemRect(m_child2).y > rectChild2.y );
+
+    // And deleting a subtree must move the items after it up.
+    m_dvc->DeleteItem(m_child1);
+
+#ifdef __WXGTK__
+    wxYield();
+#endif // __WXGTK__
+
+    CHECK( m_dvc->GetItemRect(m_child2).y == rectChild1.y );
+}
+
+TEST_CASE_METHOD(SingleSelectDataViewCtrlTestCase,
+                 "wxDVC::InsertBeforeAndDelete",
+                 "[wxDataViewCtrl][item][delete]")
+{
+    wxDataViewItem items[5];
+    for ( size_t n = 0; n < WXSIZEOF(items); n++ )
+        items[n] = m_dvc->AppendItem(m_root, wxString::Format("item%d", static_cast<int>(n)));
+
+#ifdef __WXGTK__
+    wxYield();
+#endif // __WXGTK__
+
+    // Compute the positions of all items before changing anything.
+    const int yLast = m_dvc->GetItemRect(items[4]).y;
+    REQUIRE( yLast > m_dvc->GetItemRect(items[3]).y );
+
+    // Insert an item before all the others and check that the position of
+    // the item before the last one is the old position of the last one and
+    // that the last item itself is still below it.
+    m_dvc->PrependItem(m_root, "first");
+
+#ifdef __WXGTK__
+    wxYield();
+#endif // __WXGTK__
+
+    CHECK( m_dvc->GetItemRect(items[3]).y == yLast );
+    CHECK( m_dvc->GetItemRect(items[4]).y > yLast );
+
+    // Deleting the last item must delete it and not any other one.
+    m_dvc->DeleteItem(items[4]);
+
+    REQUIRE( m_dvc->GetChildCount(m_root) == 7 );
+    CHECK( m_dvc->GetNthChild(m_root, 0) != items[4] );
+    CHECK( m_dvc->GetNthChild(m_root, 6) == items[3] );
+
+#ifdef __WXGTK__
+    wxYield();
+#endif // __WXGTK__
+
+    CHECK( m_dvc->GetItemRect(items[3]).y == yLast );
+}
+
 TEST_CASE_METHOD(SingleSelectDataViewCtrlTestCase,
                  "wxDVC::DeleteAllItems",
                  "[wxDataViewCtrl][delete]")
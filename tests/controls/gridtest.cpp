@@ -927,6 +927,76 @@ TEST_CASE_METHOD(GridTestCase, "Grid::GetNonDefaultAlignment", "[grid]")
     CHECK( vAlign == wxALIGN_CENTRE_VERTICAL );
 }
 
+TEST_CASE("Grid::CellAttrProvider", "[grid]")
+{
+    wxGridCellAttrProvider provider;
+
+    wxGridCellAttr* const attrCell = new wxGridCellAttr;
+    wxGridCellAttr* const attrBlock = new wxGridCellAttr;
+    wxGridCellAttr* const attrInner = new wxGridCellAttr;
+
+    provider.SetAttr(attrCell, 5, 5);
+    provider.SetBlockAttr(attrBlock, 2, 2, 7, 3);
+    provider.SetBlockAttr(attrInner, 3, 2, 3, 2);
+
+    CHECK( provider.GetAttrPtr(5, 5, wxGridCellAttr::Cell).get() == attrCell );
+    CHECK( provider.GetAttrPtr(2, 2, wxGridCellAttr::Cell).get() == attrBlock );
+    CHECK( provider.GetAttrPtr(7, 3, wxGridCellAttr::Cell).get() == attrBlock );
+    CHECK( !provider.GetAttrPtr(7, 4, wxGridCellAttr::Cell) );
+    CHECK( !provider.GetAttrPtr(8, 3, wxGridCellAttr::Cell) );
+
+    // The block set last takes precedence.
+    CHECK( provider.GetAttrPtr(3, 2, wxGridCellAttr::Cell).get() == attrInner );
+
+    // And cell attribute takes precedence over any block.
+    attrCell->IncRef();
+    provider.SetAttr(attrCell, 4, 2);
+    CHECK( provider.GetAttrPtr(4, 2, wxGridCellAttr::Any).get() == attrCell );
+
+    // Removing the cell attribute uncovers the block one again.
+    provider.SetAttr(NULL, 4, 2);
+    CHECK( provider.GetAttrPtr(4, 2, wxGridCellAttr::Any).get() == attrBlock );
+
+    SECTION("Insert rows")
+    {
+        provider.UpdateAttrRows(3, 2);
+
+        CHECK( provider.GetAttrPtr(7, 5, wxGridCellAttr::Cell).get() == attrCell );
+        CHECK( !provider.GetAttrPtr(5, 5, wxGridCellAttr::Cell) );
+        CHECK( provider.GetAttrPtr(2, 2, wxGridCellAttr::Cell).get() == attrBlock );
+        CHECK( provider.GetAttrPtr(9, 3, wxGridCellAttr::Cell).get() == attrBlock );
+        CHECK( provider.GetAttrPtr(5, 2, wxGridCellAttr::Cell).get() == attrInner );
+    }
+
+    SECTION("Delete rows")
+    {
+        provider.UpdateAttrRows(3, -3);
+
+        CHECK( !provider.GetAttrPtr(5, 5, wxGridCellAttr::Cell) );
+        CHECK( provider.GetAttrPtr(2, 2, wxGridCellAttr::Cell).get() == attrBlock );
+        CHECK( provider.GetAttrPtr(4, 3, wxGridCellAttr::Cell).get() == attrBlock );
+        CHECK( !provider.GetAttrPtr(5, 3, wxGridCellAttr::Cell) );
+        CHECK( provider.GetAttrPtr(3, 2, wxGridCellAttr::Cell).get() == attrBlock );
+    }
+
+    SECTION("Delete columns")
+    {
+        provider.UpdateAttrCols(2, -1);
+
+        CHECK( provider.GetAttrPtr(5, 4, wxGridCellAttr::Cell).get() == attrCell );
+        CHECK( provider.GetAttrPtr(3, 2, wxGridCellAttr::Cell).get() == attrBlock );
+        CHECK( !provider.GetAttrPtr(3, 3, wxGridCellAttr::Cell) );
+    }
+
+    SECTION("Remove block")
+    {
+        provider.SetBlockAttr(NULL, 2, 2, 7, 3);
+
+        CHECK( !provider.GetAttrPtr(2, 2, wxGridCellAttr::Cell) );
+        CHECK( provider.GetAttrPtr(3, 2, wxGridCellAttr::Cell).get() == attrInner );
+    }
+}
+
 TEST_CASE_METHOD(GridTestCase, "Grid::Editable", "[grid]")
 {
 #if wxUSE_UIACTIONSIMULATOR
@@ -17,6 +17,8 @@
 #endif
 
 #include "wx/event.h"
+#include "wx/evtprofiler.h"
+#include "wx/thread.h"
 
 // ----------------------------------------------------------------------------
 // test events and their handlers
@@ -172,6 +174,11 @@ private:
         CPPUNIT_TEST( BindNonHandler );
         CPPUNIT_TEST( InvalidBind );
         CPPUNIT_TEST( UnbindFromHandler );
+        CPPUNIT_TEST( BindMany );
+        CPPUNIT_TEST( UnbindManyFromHandler );
+#if wxUSE_STOPWATCH
+        CPPUNIT_TEST( ProfileEvents );
+#endif // wxUSE_STOPWATCH
     CPPUNIT_TEST_SUITE_END();
 
     void BuiltinConnect();
@@ -187,6 +194,11 @@ private:
     void BindNonHandler();
     void InvalidBind();
     void UnbindFromHandler();
+    void BindMany();
+    void UnbindManyFromHandler();
+#if wxUSE_STOPWATCH
+    void ProfileEvents();
+#endif // wxUSE_STOPWATCH
 
 
     // these member variables exceptionally don't use "m_" prefix because
@@ -517,6 +529,265 @@ void EvtHandlerTestCase::UnbindFromHandler()
     handler.ProcessEvent(e);
 }
 
+void EvtHandlerTestCase::BindMany()
+{
+    // Bind enough handlers for other events to make searching for the event
+    // handlers use the index of the dynamic event table.
+    for ( int n = 0; n < 100; n++ )
+        handler.Bind(wxEVT_IDLE, &MyHandler::OnIdle, &handler, n);
+
+    g_called.Reset();
+    handler.Bind(MyEventType, &MyHandler::OnMyEvent, &handler);
+    handler.ProcessEvent(e);
+    CPPUNIT_ASSERT( g_called.method );
+
+    g_called.Reset();
+    handler.Unbind(MyEventType, &MyHandler::OnMyEvent, &handler);
+    handler.ProcessEvent(e);
+    CPPUNIT_ASSERT( !g_called.method );
+
+    // Binding more handlers after the index was created must work too.
+    wxIdleEvent eIdle;
+    eIdle.SetId(100);
+    g_called.Reset();
+    handler.ProcessEvent(eIdle);
+    CPPUNIT_ASSERT( !g_called.method );
+
+    handler.Bind(wxEVT_IDLE, &MyHandler::OnIdle, &handler, 100);
+    handler.ProcessEvent(eIdle);
+    CPPUNIT_ASSERT( g_called.method );
+
+    // Check that unbinding a handler from another one still works too.
+    Handler1 h1;
+    handler.Bind(MyEventType, &Handler1::OnDontCall, &h1);
+
+    Handler2 h2(handler, h1);
+    handler.Bind(MyEventType, &Handler2::OnUnbind, &h2);
+
+    handler.ProcessEvent(e);
+
+    handler.Unbind(MyEventType, &Handler2::OnUnbind, &h2);
+}
+
+// Counts the events it gets and lets the other handlers process them too.
+struct CountingSink
+{
+    CountingSink() : count(0) { }
+
+    void OnMyEvent(MyEvent& e)
+    {
+        count++;
+        e.Skip();
+    }
+
+    int count;
+};
+
+// Unbinds the given sinks when processing the event.
+class UnbindingSink
+{
+public:
+    UnbindingSink(MyHandler& handler, CountingSink* sinks, int numSinks)
+        : m_handler(handler),
+          m_sinks(sinks),
+          m_numSinks(numSinks)
+    {
+    }
+
+    void OnMyEvent(MyEvent& e)
+    {
+        for ( int n = 0; n < m_numSinks; n++ )
+            m_handler.Unbind(MyEventType, &CountingSink::OnMyEvent, &m_sinks[n]);
+
+        e.Skip();
+    }
+
+private:
+    MyHandler& m_handler;
+    CountingSink* const m_sinks;
+    const int m_numSinks;
+
+    wxDECLARE_NO_COPY_CLASS(UnbindingSink);
+};
+
+void EvtHandlerTestCase::UnbindManyFromHandler()
+{
+    // Repeatedly binding and unbinding a handler for an event which is never
+    // processed mustn't leave the unbound entries in the table forever, check
+    // at least that the other handlers still work after doing it.
+    for ( int n = 0; n < 100; n++ )
+        handler.Bind(wxEVT_IDLE, &MyHandler::OnIdle, &handler, n);
+
+    for ( int n = 0; n < 1000; n++ )
+    {
+        handler.Bind(wxEVT_IDLE, &MyHandler::OnIdle, &handler, 100);
+        handler.Unbind(wxEVT_IDLE, &MyHandler::OnIdle, &handler, 100);
+    }
+
+    wxIdleEvent eIdle;
+    eIdle.SetId(99);
+    g_called.Reset();
+    handler.ProcessEvent(eIdle);
+    CPPUNIT_ASSERT( g_called.method );
+
+    // Unbinding most of the handlers from another one must not prevent the
+    // remaining ones from being called exactly once, even if the unbound
+    // entries are pruned.
+    CountingSink sinks[200];
+    for ( size_t n = 0; n < WXSIZEOF(sinks); n++ )
+        handler.Bind(MyEventType, &CountingSink::OnMyEvent, &sinks[n]);
+
+    // The handler bound last is called first.
+    UnbindingSink unbinder(handler, sinks + 10, WXSIZEOF(sinks) - 10);
+    handler.Bind(MyEventType, &UnbindingSink::OnMyEvent, &unbinder);
+
+    handler.ProcessEvent(e);
+    handler.ProcessEvent(e);
+
+    for ( size_t n = 0; n < WXSIZEOF(sinks); n++ )
+    {
+        CPPUNIT_ASSERT_EQUAL( n < 10 ? 2 : 0, sinks[n].count );
+    }
+
+    handler.Unbind(MyEventType, &UnbindingSink::OnMyEvent, &unbinder);
+    for ( size_t n = 0; n < 10; n++ )
+        handler.Unbind(MyEventType, &CountingSink::OnMyEvent, &sinks[n]);
+}
+
+#if wxUSE_STOPWATCH
+
+#if wxUSE_THREADS
+
+// Processes the given number of events in another thread.
+class EventsThread : public wxThread
+{
+public:
+    explicit EventsThread(int numEvents)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_numEvents(numEvents)
+    {
+    }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        CountingSink sink;
+
+        wxEvtHandler handler;
+        handler.Bind(MyEventType, &CountingSink::OnMyEvent, &sink);
+
+        MyEvent e;
+        for ( int n = 0; n < m_numEvents; n++ )
+            handler.ProcessEvent(e);
+
+        return 0;
+    }
+
+private:
+    const int m_numEvents;
+};
+
+#endif // wxUSE_THREADS
+
+void EvtHandlerTestCase::ProfileEvents()
+{
+    // Bind two different handlers for the same event to the same object,
+    // they must be profiled separately.
+    CountingSink sinks[2];
+    handler.Bind(MyEventType, &CountingSink::OnMyEvent, &sinks[0]);
+    handler.Bind(MyEventType, &CountingSink::OnMyEvent, &sinks[1]);
+
+    // Events processed before starting the profiler are not counted.
+    handler.ProcessEvent(e);
+
+    wxEventProfiler::Reset();
+    wxEventProfiler::Start(2);
+    CPPUNIT_ASSERT( wxEventProfiler::IsRunning() );
+
+    for ( int n = 0; n < 3; n++ )
+        handler.ProcessEvent(e);
+
+    wxEventProfiler::Stop();
+    CPPUNIT_ASSERT( !wxEventProfiler::IsRunning() );
+
+    // And neither are the events processed after stopping it.
+    handler.ProcessEvent(e);
+
+    wxVector<wxEventProfiler::Stats> stats;
+    wxEventProfiler::GetStats(stats);
+    CPPUNIT_ASSERT_EQUAL( 2, stats.size() );
+    for ( size_t n = 0; n < stats.size(); n++ )
+    {
+        CPPUNIT_ASSERT_EQUAL( MyEventType, stats[n].eventType );
+        CPPUNIT_ASSERT_EQUAL( "wxEvtHandler", stats[n].handlerClass );
+        CPPUNIT_ASSERT_EQUAL( 3, stats[n].count );
+        CPPUNIT_ASSERT( stats[n].maxTime <= stats[n].totalTime );
+    }
+
+    CPPUNIT_ASSERT( stats[0].handlerId != stats[1].handlerId );
+
+    // Only the last 2 calls are remembered: they're the calls of both
+    // handlers for the last event.
+    wxVector<wxEventProfiler::Call> calls;
+    wxEventProfiler::GetRecentCalls(calls);
+    CPPUNIT_ASSERT_EQUAL( 2, calls.size() );
+    CPPUNIT_ASSERT_EQUAL( MyEventType, calls[1].eventType );
+    CPPUNIT_ASSERT( calls[0].handlerId != calls[1].handlerId );
+
+    CPPUNIT_ASSERT( !wxEventProfiler::GetReport().empty() );
+
+    wxEventProfiler::Reset();
+    wxEventProfiler::GetStats(stats);
+    CPPUNIT_ASSERT( stats.empty() );
+    wxEventProfiler::GetRecentCalls(calls);
+    CPPUNIT_ASSERT( calls.empty() );
+
+    // A handler bound again after being unbound is a different handler, even
+    // if its functor happens to reuse the memory of the old one.
+    wxEventProfiler::Start();
+    handler.ProcessEvent(e);
+    handler.Unbind(MyEventType, &CountingSink::OnMyEvent, &sinks[1]);
+    handler.Bind(MyEventType, &CountingSink::OnMyEvent, &sinks[1]);
+    handler.ProcessEvent(e);
+    wxEventProfiler::Stop();
+
+    wxEventProfiler::GetStats(stats);
+    CPPUNIT_ASSERT_EQUAL( 3, stats.size() );
+
+    wxEventProfiler::Reset();
+
+#if wxUSE_THREADS
+    // Check that the events handled in other threads are counted too.
+    wxEventProfiler::Start();
+
+    EventsThread thread1(5),
+                 thread2(7);
+    CPPUNIT_ASSERT_EQUAL( wxTHREAD_NO_ERROR, thread1.Run() );
+    CPPUNIT_ASSERT_EQUAL( wxTHREAD_NO_ERROR, thread2.Run() );
+    thread1.Wait();
+    thread2.Wait();
+
+    handler.ProcessEvent(e);
+
+    wxEventProfiler::Stop();
+
+    wxEventProfiler::GetStats(stats);
+    CPPUNIT_ASSERT_EQUAL( 4, stats.size() );
+
+    unsigned long total = 0;
+    for ( size_t n = 0; n < stats.size(); n++ )
+        total += stats[n].count;
+    CPPUNIT_ASSERT_EQUAL( 14, total );
+
+    wxEventProfiler::GetRecentCalls(calls);
+    CPPUNIT_ASSERT_EQUAL( 14, calls.size() );
+
+    wxEventProfiler::Reset();
+#endif // wxUSE_THREADS
+}
+
+#endif // wxUSE_STOPWATCH
+
 // This is a compilation-time-only test: just check that a class inheriting
 // from wxEvtHandler non-publicly can use Bind() with its method, this used to
 // result in compilation errors.
@@ -23,6 +23,7 @@
 
 #include "wx/evtloop.h"
 #include "wx/timer.h"
+#include "wx/vector.h"
 
 // --------------------------------------------------------------------------
 // helper class counting the number of timer events
@@ -68,10 +69,12 @@ private:
     CPPUNIT_TEST_SUITE( TimerEventTestCase );
         CPPUNIT_TEST( OneShot );
         CPPUNIT_TEST( Multiple );
+        CPPUNIT_TEST( Order );
     CPPUNIT_TEST_SUITE_END();
 
     void OneShot();
     void Multiple();
+    void Order();
 
     wxDECLARE_NO_COPY_CLASS(TimerEventTestCase);
 };
@@ -145,3 +148,65 @@ void TimerEventTestCase::Multiple()
     CPPUNIT_ASSERT( numTicks > 1 );
 #endif // !(wxGTK Unicode)
 }
+
+void TimerEventTestCase::Order()
+{
+    // This handler remembers the IDs of the timers in the order in which they
+    // expired and exits the loop after getting the given number of events.
+    class OrderHandler : public wxEvtHandler
+    {
+    public:
+        OrderHandler(wxEventLoopBase& loop, size_t numExpected)
+            : m_loop(loop),
+              m_numExpected(numExpected)
+        {
+            Bind(wxEVT_TIMER, &OrderHandler::OnTimer, this);
+        }
+
+        wxVector<int> m_ids;
+
+    private:
+        void OnTimer(wxTimerEvent& event)
+        {
+            m_ids.push_back(event.GetId());
+            if ( m_ids.size() == m_numExpected )
+                m_loop.Exit();
+        }
+
+        wxEventLoopBase& m_loop;
+        const size_t m_numExpected;
+    };
+
+    wxEventLoop loop;
+
+    OrderHandler handler(loop, 5);
+
+    // Start the timers in an order different from their expiration order.
+    static const int ids[] = { 4, 1, 6, 0, 3, 5, 2 };
+    wxTimer* timers[WXSIZEOF(ids)];
+    for ( size_t n = 0; n < WXSIZEOF(ids); n++ )
+    {
+        const int id = ids[n];
+        timers[id] = new wxTimer(&handler, id);
+        timers[id]->StartOnce(50*(id + 1));
+    }
+
+    // Stopping some timers must not affect the other ones.
+    timers[2]->Stop();
+    timers[5]->Stop();
+
+    // And restarting a timer must move it to the end.
+    timers[0]->StartOnce(500);
+
+    loop.Run();
+
+    CPPUNIT_ASSERT_EQUAL( 5, (int)handler.m_ids.size() );
+    CPPUNIT_ASSERT_EQUAL( 1, handler.m_ids[0] );
+    CPPUNIT_ASSERT_EQUAL( 3, handler.m_ids[1] );
+    CPPUNIT_ASSERT_EQUAL( 4, handler.m_ids[2] );
+    CPPUNIT_ASSERT_EQUAL( 6, handler.m_ids[3] );
+    CPPUNIT_ASSERT_EQUAL( 0, handler.m_ids[4] );
+
+    for ( size_t n = 0; n < WXSIZEOF(timers); n++ )
+        delete timers[n];
+}
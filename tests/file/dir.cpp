@@ -39,12 +39,14 @@ private:
     CPPUNIT_TEST_SUITE( DirTestCase );
         CPPUNIT_TEST( DirExists );
         CPPUNIT_TEST( Traverse );
+        CPPUNIT_TEST( TraverseParallel );
         CPPUNIT_TEST( Enum );
         CPPUNIT_TEST( GetName );
     CPPUNIT_TEST_SUITE_END();
 
     void DirExists();
     void Traverse();
+    void TraverseParallel();
     void Enum();
     void GetName();
 
@@ -145,7 +147,10 @@ void DirTestCase::Enum()
 class TestDirTraverser : public wxDirTraverser
 {
 public:
+    TestDirTraverser() : numOpenErrors(0) { }
+
     wxArrayString dirs;
+    size_t numOpenErrors;
 
     virtual wxDirTraverseResult OnFile(const wxString& WXUNUSED(filename)) wxOVERRIDE
     {
@@ -157,6 +162,31 @@ public:
         dirs.push_back(dirname);
         return wxDIR_CONTINUE;
     }
+
+    virtual wxDirTraverseResult OnOpenError(const wxString& WXUNUSED(dirname)) wxOVERRIDE
+    {
+        numOpenErrors++;
+        return wxDIR_IGNORE;
+    }
+};
+
+class StopDirTraverser : public wxDirTraverser
+{
+public:
+    StopDirTraverser() : numFiles(0) { }
+
+    size_t numFiles;
+
+    virtual wxDirTraverseResult OnFile(const wxString& WXUNUSED(filename)) wxOVERRIDE
+    {
+        numFiles++;
+        return wxDIR_STOP;
+    }
+
+    virtual wxDirTraverseResult OnDir(const wxString& WXUNUSED(dirname)) wxOVERRIDE
+    {
+        return wxDIR_CONTINUE;
+    }
 };
 
 void DirTestCase::Traverse()
@@ -173,6 +203,63 @@ void DirTestCase::Traverse()
     TestDirTraverser traverser;
     dir.Traverse(traverser, wxEmptyString, wxDIR_DIRS | wxDIR_HIDDEN);
     CPPUNIT_ASSERT_EQUAL(6, traverser.dirs.size());
+
+    // returning wxDIR_STOP stops the entire traversal and not just the
+    // traversal of the current directory
+    StopDirTraverser traverserStop;
+    CPPUNIT_ASSERT_EQUAL(0, dir.Traverse(traverserStop));
+    CPPUNIT_ASSERT_EQUAL(1, traverserStop.numFiles);
+}
+
+void DirTestCase::TraverseParallel()
+{
+    // the same files must be found as with the sequential traversal, even if
+    // in a different order
+    wxArrayString files, filesParallel;
+    CPPUNIT_ASSERT_EQUAL(4, wxDir::GetAllFiles(DIRTEST_FOLDER, &files));
+    CPPUNIT_ASSERT_EQUAL(4, wxDir::GetAllFiles(DIRTEST_FOLDER, &filesParallel,
+                                               wxEmptyString,
+                                               wxDIR_DEFAULT | wxDIR_PARALLEL));
+    files.Sort();
+    filesParallel.Sort();
+    CPPUNIT_ASSERT( files == filesParallel );
+
+    filesParallel.clear();
+    CPPUNIT_ASSERT_EQUAL(1, wxDir::GetAllFiles(DIRTEST_FOLDER, &filesParallel,
+                                               "*.foo",
+                                               wxDIR_DEFAULT | wxDIR_PARALLEL));
+    CPPUNIT_ASSERT_EQUAL( DIRTEST_FOLDER + SEP + "folder3" + SEP +
+                          "subfolder1" + SEP + "dummy.foo", filesParallel[0] );
+
+    wxDir dir(DIRTEST_FOLDER);
+    TestDirTraverser traverser;
+    dir.Traverse(traverser, wxEmptyString,
+                 wxDIR_DIRS | wxDIR_HIDDEN | wxDIR_PARALLEL);
+    CPPUNIT_ASSERT_EQUAL(6, traverser.dirs.size());
+
+    // returning wxDIR_STOP stops the entire traversal
+    StopDirTraverser traverserStop;
+    CPPUNIT_ASSERT_EQUAL(0, dir.Traverse(traverserStop, wxEmptyString,
+                                         wxDIR_DEFAULT | wxDIR_PARALLEL));
+    CPPUNIT_ASSERT_EQUAL(1, traverserStop.numFiles);
+
+    CPPUNIT_ASSERT( !wxDir::FindFirst(DIRTEST_FOLDER, "*.bar",
+                                      wxDIR_DEFAULT | wxDIR_PARALLEL).empty() );
+
+#ifdef __UNIX__
+    // the already opened directory is not opened again, so no error is
+    // reported for it even if it was removed in the meanwhile
+    const wxString removed = DIRTEST_FOLDER + SEP + "removed";
+    CPPUNIT_ASSERT( wxDir::Make(removed) );
+    wxDir dirRemoved(removed);
+    CPPUNIT_ASSERT( dirRemoved.IsOpened() );
+    CPPUNIT_ASSERT( wxDir::Remove(removed) );
+
+    TestDirTraverser traverserRemoved;
+    CPPUNIT_ASSERT_EQUAL(0, dirRemoved.Traverse(traverserRemoved, wxEmptyString,
+                                                wxDIR_DEFAULT | wxDIR_PARALLEL));
+    CPPUNIT_ASSERT_EQUAL(0, traverserRemoved.numOpenErrors);
+#endif // __UNIX__
 }
 
 void DirTestCase::DirExists()
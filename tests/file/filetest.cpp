@@ -19,6 +19,7 @@
 #if wxUSE_FILE
 
 #include "wx/file.h"
+#include "wx/log.h"
 
 #include "testfile.h"
 
@@ -139,6 +140,65 @@ void FileTestCase::TempFile()
     CPPUNIT_ASSERT( wxRemoveFile(wxT("test2")) );
 }
 
+TEST_CASE("wxMappedFile", "[file][mmap]")
+{
+    TestFile tf;
+
+    SECTION("Data")
+    {
+        const char* text = "Ream\nde";
+
+        {
+            wxFile fout(tf.GetName(), wxFile::write);
+            REQUIRE( fout.IsOpened() );
+            fout.Write(text, strlen(text));
+        }
+
+        wxMappedFile mf(tf.GetName());
+        REQUIRE( mf.IsOpened() );
+        CHECK( mf.GetLength() == strlen(text) );
+        CHECK( memcmp(mf.GetData(), text, strlen(text)) == 0 );
+
+        mf.Close();
+        CHECK( !mf.IsOpened() );
+        CHECK( mf.GetLength() == 0 );
+    }
+
+    SECTION("Empty")
+    {
+        {
+            wxFile fout(tf.GetName(), wxFile::write);
+            REQUIRE( fout.IsOpened() );
+        }
+
+        wxMappedFile mf;
+        REQUIRE( mf.Open(tf.GetName()) );
+        CHECK( mf.IsOpened() );
+        CHECK( mf.GetLength() == 0 );
+    }
+
+    SECTION("Opened")
+    {
+        wxFile file(tf.GetName());
+        REQUIRE( file.IsOpened() );
+
+        wxMappedFile mf;
+        REQUIRE( mf.Open(file, wxMappedFile::Access_Random) );
+
+        // The mapping must remain valid after closing the file.
+        file.Close();
+        CHECK( wxString(mf.GetData(), mf.GetLength()) == "Before" );
+    }
+
+    SECTION("Missing")
+    {
+        wxLogNull noLog;
+
+        wxMappedFile mf("no-such-file");
+        CHECK( !mf.IsOpened() );
+    }
+}
+
 #ifdef __LINUX__
 
 // Check that GetSize() works correctly for special files.
@@ -164,6 +224,15 @@ TEST_CASE("wxFile::Special", "[file][linux][special-file]")
     CHECK( fileSys.ReadAll(&s) );
     CHECK( !s.empty() );
     CHECK( s.length() < 4096 );
+
+    // The special files can't be mapped, but must still be read.
+    wxMappedFile mappedProc("/proc/diskstats");
+    CHECK( mappedProc.IsOpened() );
+    CHECK( mappedProc.GetLength() > 0 );
+
+    wxMappedFile mappedSys("/sys/power/state");
+    CHECK( mappedSys.IsOpened() );
+    CHECK( mappedSys.GetLength() == s.length() );
 }
 
 #endif // __LINUX__
@@ -23,12 +23,17 @@
 #endif // WX_PRECOMP
 
 #include "wx/anidecod.h" // wxImageArray
+#include "wx/gifdecod.h"
 #include "wx/palette.h"
 #include "wx/url.h"
 #include "wx/log.h"
 #include "wx/mstream.h"
 #include "wx/zstream.h"
 #include "wx/wfstream.h"
+#include "wx/imageloader.h"
+#include "wx/math.h"
+#include "wx/quantize.h"
+#include "wx/vector.h"
 
 #include "testimage.h"
 
@@ -1452,6 +1457,977 @@ void ImageTestCase::ScaleCompare()
                                "image/cross_nearest_neighb_256x256.png");
 }
 
+// Create an image big enough for the work on it to be split between threads.
+static wxImage CreateImageForThreads(bool withAlpha = true)
+{
+    const int width = 640,
+              height = 480;
+    wxImage image(width, height, false);
+    image.SetAlpha();
+
+    unsigned char* data = image.GetData();
+    unsigned char* alpha = image.GetAlpha();
+    for ( int y = 0; y < height; y++ )
+    {
+        for ( int x = 0; x < width; x++ )
+        {
+            *data++ = x;
+            *data++ = y;
+            *data++ = x*y;
+            *alpha++ = x + y;
+        }
+    }
+
+    if ( !withAlpha )
+        image.ClearAlpha();
+
+    return image;
+}
+
+// Operation on an image which may use several threads.
+class ImageOperation
+{
+public:
+    virtual wxImage Apply(const wxImage& image) const = 0;
+
+    virtual ~ImageOperation() { }
+};
+
+// Check that the given operation gives the same result when using a single
+// thread and several of them.
+static void CheckSameWithThreads(const ImageOperation& op, const wxImage& image)
+{
+    const int maxThreadsOrig = wxImage::GetMaxThreads();
+
+    wxImage::SetMaxThreads(1);
+    const wxImage result1 = op.Apply(image);
+
+    wxImage::SetMaxThreads(4);
+    const wxImage result4 = op.Apply(image);
+
+    wxImage::SetMaxThreads(maxThreadsOrig);
+
+    CHECK_THAT( result4, RGBSameAs(result1) );
+
+    REQUIRE( result4.HasAlpha() == result1.HasAlpha() );
+    if ( result1.HasAlpha() )
+    {
+        CHECK( memcmp(result4.GetAlpha(), result1.GetAlpha(),
+                      result1.GetWidth()*result1.GetHeight()) == 0 );
+    }
+}
+
+class ScaleOperation : public ImageOperation
+{
+public:
+    ScaleOperation(int width, int height, wxImageResizeQuality quality)
+        : m_width(width), m_height(height), m_quality(quality)
+    {
+    }
+
+    virtual wxImage Apply(const wxImage& image) const wxOVERRIDE
+    {
+        return image.Scale(m_width, m_height, m_quality);
+    }
+
+private:
+    const int m_width,
+              m_height;
+    const wxImageResizeQuality m_quality;
+};
+
+TEST_CASE("wxImage::Scale::Threads", "[image][scale]")
+{
+    const wxImageResizeQuality qualities[] =
+    {
+        wxIMAGE_QUALITY_BILINEAR,
+        wxIMAGE_QUALITY_BICUBIC,
+        wxIMAGE_QUALITY_BOX_AVERAGE,
+    };
+
+    for ( size_t n = 0; n < WXSIZEOF(qualities); n++ )
+    {
+        INFO("Quality " << qualities[n]);
+
+        for ( int withAlpha = 0; withAlpha < 2; withAlpha++ )
+        {
+            INFO("With alpha: " << withAlpha);
+
+            const wxImage image = CreateImageForThreads(withAlpha != 0);
+            const int width = image.GetWidth(),
+                      height = image.GetHeight();
+
+            CheckSameWithThreads(ScaleOperation(width/3, height/3, qualities[n]),
+                                 image);
+            CheckSameWithThreads(ScaleOperation(width*2, height*2, qualities[n]),
+                                 image);
+        }
+    }
+}
+
+class BlurOperation : public ImageOperation
+{
+public:
+    BlurOperation(int radius, wxImageBlurMode mode)
+        : m_radius(radius), m_mode(mode)
+    {
+    }
+
+    virtual wxImage Apply(const wxImage& image) const wxOVERRIDE
+    {
+        return image.Blur(m_radius, m_mode);
+    }
+
+private:
+    const int m_radius;
+    const wxImageBlurMode m_mode;
+};
+
+TEST_CASE("wxImage::Blur", "[image][blur]")
+{
+    SECTION("Box")
+    {
+        wxImage image(3, 1, false);
+        unsigned char* data = image.GetData();
+        for ( int x = 0; x < 3; x++ )
+        {
+            *data++ = 30*x;
+            *data++ = 60*x;
+            *data++ = 90*x;
+        }
+
+        const wxImage blurred = image.BlurHorizontal(1);
+        CHECK( blurred.GetRed(0, 0) == 10 );
+        CHECK( blurred.GetRed(1, 0) == 30 );
+        CHECK( blurred.GetRed(2, 0) == 50 );
+        CHECK( blurred.GetBlue(2, 0) == 150 );
+
+        // The radius bigger than the image size must work too, the edge pixels
+        // are duplicated as many times as needed: (0 + 30 + 4*60)/11 here.
+        CHECK( image.BlurHorizontal(5).GetRed(0, 0) == 24 );
+        CHECK( image.Rotate90().BlurVertical(5).GetRed(0, 0) == 24 );
+
+        // Blurring in one direction doesn't affect the other one.
+        CHECK_THAT( image.BlurVertical(3), RGBSameAs(image) );
+    }
+
+    SECTION("Gaussian")
+    {
+        wxImage image(50, 40, false);
+        image.Clear(100);
+
+        // Uniform image must remain uniform.
+        CHECK_THAT( image.Blur(5, wxIMAGE_BLUR_GAUSSIAN), RGBSameAs(image) );
+
+        // And a single point must be spread around symmetrically.
+        image.SetRGB(25, 20, 255, 255, 255);
+        const wxImage blurred = image.Blur(2, wxIMAGE_BLUR_GAUSSIAN);
+        CHECK( blurred.GetRed(25, 20) > blurred.GetRed(26, 20) );
+        CHECK( blurred.GetRed(26, 20) > blurred.GetRed(28, 20) );
+        CHECK( blurred.GetRed(28, 20) > 100 );
+        CHECK( blurred.GetRed(22, 20) == blurred.GetRed(28, 20) );
+        CHECK( blurred.GetRed(25, 17) == blurred.GetRed(25, 23) );
+        CHECK( blurred.GetRed(0, 0) == 100 );
+    }
+
+    SECTION("Threads")
+    {
+        const wxImage image = CreateImageForThreads();
+
+        const wxImageBlurMode modes[] = { wxIMAGE_BLUR_BOX, wxIMAGE_BLUR_GAUSSIAN };
+        for ( size_t n = 0; n < WXSIZEOF(modes); n++ )
+        {
+            INFO("Mode " << modes[n]);
+
+            CheckSameWithThreads(BlurOperation(7, modes[n]), image);
+        }
+    }
+}
+
+// Consumer reassembling the image from the rows passed to it.
+class RowsCollector : public wxImageRowsConsumer
+{
+public:
+    explicit RowsCollector(int bandHeight, int maxBands = -1)
+        : m_bandHeight(bandHeight),
+          m_maxBands(maxBands),
+          m_numBands(0),
+          m_nextRow(0)
+    {
+    }
+
+    virtual bool OnStart(int width, int height, bool hasAlpha) wxOVERRIDE
+    {
+        m_image.Create(width, height, false);
+        if ( hasAlpha )
+            m_image.SetAlpha();
+
+        return true;
+    }
+
+    virtual bool OnRows(int firstRow, const wxImage& rows) wxOVERRIDE
+    {
+        CHECK( firstRow == m_nextRow );
+        CHECK( rows.GetWidth() == m_image.GetWidth() );
+        CHECK( rows.GetHeight() <= m_bandHeight );
+        CHECK( rows.HasAlpha() == m_image.HasAlpha() );
+
+        const size_t offset = static_cast<size_t>(firstRow)*rows.GetWidth();
+        const size_t count = static_cast<size_t>(rows.GetHeight())*rows.GetWidth();
+        memcpy(m_image.GetData() + 3*offset, rows.GetData(), 3*count);
+        if ( rows.HasAlpha() )
+            memcpy(m_image.GetAlpha() + offset, rows.GetAlpha(), count);
+
+        m_nextRow += rows.GetHeight();
+
+        return ++m_numBands != m_maxBands;
+    }
+
+    const wxImage& GetImage() const { return m_image; }
+    int GetNumBands() const { return m_numBands; }
+    int GetNextRow() const { return m_nextRow; }
+
+private:
+    const int m_bandHeight;
+    const int m_maxBands;
+    int m_numBands;
+    int m_nextRow;
+    wxImage m_image;
+};
+
+static void CheckLoadRows(wxImageHandler& handler, const char* file)
+{
+    INFO("File " << file);
+
+    wxImage image;
+    {
+        wxFileInputStream stream(file);
+        REQUIRE( handler.LoadFile(&image, stream) );
+    }
+
+    const int bandHeights[] = { 1, 7, 64, 10000 };
+    for ( size_t n = 0; n < WXSIZEOF(bandHeights); n++ )
+    {
+        INFO("Band height " << bandHeights[n]);
+
+        wxFileInputStream stream(file);
+        RowsCollector collector(bandHeights[n]);
+        REQUIRE( handler.LoadRows(stream, collector, bandHeights[n]) );
+
+        const wxImage& rows = collector.GetImage();
+        CHECK( collector.GetNextRow() == image.GetHeight() );
+        CHECK_THAT( rows, RGBSameAs(image) );
+
+        // The handler may not know in advance whether all pixels are opaque.
+        if ( image.HasAlpha() )
+        {
+            REQUIRE( rows.HasAlpha() );
+            CHECK( memcmp(rows.GetAlpha(), image.GetAlpha(),
+                          image.GetWidth()*image.GetHeight()) == 0 );
+        }
+    }
+
+    // Check that loading stops when the consumer asks for it.
+    wxFileInputStream stream(file);
+    RowsCollector collector(10, 2);
+    CHECK( !handler.LoadRows(stream, collector, 10) );
+    CHECK( collector.GetNumBands() == 2 );
+}
+
+TEST_CASE("wxImage::LoadRows", "[image][load]")
+{
+    SECTION("PNG")
+    {
+        wxPNGHandler handler;
+        CheckLoadRows(handler, "horse.png");
+        CheckLoadRows(handler, "image/cross_bicubic_256x256.png");
+    }
+
+    SECTION("JPEG")
+    {
+        wxJPEGHandler handler;
+        CheckLoadRows(handler, "horse.jpg");
+    }
+
+#if wxUSE_LIBTIFF
+    SECTION("TIFF")
+    {
+        wxTIFFHandler handler;
+        CheckLoadRows(handler, "horse.tif");
+    }
+#endif // wxUSE_LIBTIFF
+
+    SECTION("Default")
+    {
+        wxBMPHandler handler;
+        CheckLoadRows(handler, "horse.bmp");
+    }
+}
+
+// Check that the image loaded with the given maximal size is the same as the
+// full image scaled down.
+static void
+CheckLoadMaxSize(const wxImage& full, wxInputStream& stream, wxBitmapType type,
+                 int maxWidth, int maxHeight)
+{
+    wxImage image;
+    image.SetOption(wxIMAGE_OPTION_MAX_WIDTH, maxWidth);
+    image.SetOption(wxIMAGE_OPTION_MAX_HEIGHT, maxHeight);
+    REQUIRE( image.LoadFile(stream, type) );
+
+    const int width = full.GetWidth(),
+              height = full.GetHeight();
+    CHECK( image.GetOptionInt(wxIMAGE_OPTION_ORIGINAL_WIDTH) == width );
+    CHECK( image.GetOptionInt(wxIMAGE_OPTION_ORIGINAL_HEIGHT) == height );
+
+    // The size is halved until it fits, but never becomes 0.
+    int newWidth = width,
+        newHeight = height;
+    while ( (maxWidth && newWidth > maxWidth) ||
+                (maxHeight && newHeight > maxHeight) )
+    {
+        newWidth = wxMax(newWidth / 2, 1);
+        newHeight = wxMax(newHeight / 2, 1);
+    }
+
+    CHECK_THAT( image, RGBSameAs(full.Scale(newWidth, newHeight,
+                                            wxIMAGE_QUALITY_BOX_AVERAGE)) );
+}
+
+TEST_CASE("wxImage::LoadFile::MaxSize", "[image][load]")
+{
+    wxImage::AddHandler(new wxPNGHandler);
+#if wxUSE_LIBTIFF
+    wxImage::AddHandler(new wxTIFFHandler);
+#endif // wxUSE_LIBTIFF
+
+    SECTION("Files")
+    {
+        const struct
+        {
+            const char* file;
+            wxBitmapType type;
+        } files[] =
+        {
+            { "horse.png",                          wxBITMAP_TYPE_PNG  },
+            { "image/cross_bicubic_256x256.png",    wxBITMAP_TYPE_PNG  },
+#if wxUSE_LIBTIFF
+            { "horse.tif",                          wxBITMAP_TYPE_TIFF },
+#endif // wxUSE_LIBTIFF
+            { "horse.bmp",                          wxBITMAP_TYPE_BMP  },
+        };
+
+        for ( size_t n = 0; n < WXSIZEOF(files); n++ )
+        {
+            INFO("File " << files[n].file);
+
+            wxImage full;
+            REQUIRE( full.LoadFile(files[n].file, files[n].type) );
+
+            wxFileInputStream stream(files[n].file);
+            CheckLoadMaxSize(full, stream, files[n].type, 90, 70);
+        }
+    }
+
+    // When one of the image dimensions is already 1, it can't be halved, so
+    // the image is only shrunk in the other direction.
+    SECTION("Elongated")
+    {
+        wxImage full(400, 1, false);
+        unsigned char* data = full.GetData();
+        for ( int x = 0; x < full.GetWidth(); x++ )
+        {
+            *data++ = x;
+            *data++ = 2*x;
+            *data++ = 3*x;
+        }
+
+        const wxBitmapType types[] =
+        {
+            wxBITMAP_TYPE_PNG,
+#if wxUSE_LIBTIFF
+            wxBITMAP_TYPE_TIFF,
+#endif // wxUSE_LIBTIFF
+            wxBITMAP_TYPE_BMP,
+        };
+
+        for ( size_t n = 0; n < WXSIZEOF(types); n++ )
+        {
+            INFO("Type " << types[n]);
+
+            wxMemoryOutputStream memOut;
+            REQUIRE( full.SaveFile(memOut, types[n]) );
+
+            wxMemoryInputStream memIn(memOut);
+            CheckLoadMaxSize(full, memIn, types[n], 90, 0);
+        }
+    }
+}
+
+TEST_CASE("wxImage::Rotate", "[image][rotate]")
+{
+    wxImage image("horse.png");
+    REQUIRE( image.IsOk() );
+    image = image.GetSubImage(wxRect(0, 0, 200, 150));
+
+    for ( int interpolating = 0; interpolating < 2; interpolating++ )
+    {
+        INFO("Interpolating: " << interpolating);
+
+        wxPoint offset;
+        wxImage rotated = image.Rotate(0, wxPoint(0, 0), interpolating != 0,
+                                       &offset);
+        CHECK( rotated.GetSize() == wxSize(201, 151) );
+        CHECK( offset == wxPoint(0, 0) );
+        CHECK_THAT( rotated.GetSubImage(wxRect(0, 0, 200, 150)),
+                    RGBSameAs(image) );
+
+        // Pixels of the image rotated by exactly 90 degrees are at integer
+        // positions, so interpolation must not change them.
+        rotated = image.Rotate(M_PI/2, wxPoint(0, 0), interpolating != 0,
+                               &offset);
+        CHECK( rotated.GetSize() == wxSize(151, 202) );
+        CHECK( offset == wxPoint(0, -200) );
+        CHECK_THAT( rotated.GetSubImage(wxRect(0, 1, 150, 200)),
+                    RGBSameAs(image.Rotate90(false)) );
+    }
+
+    // Rotating a uniformly coloured image must not change the colour of its
+    // pixels, except near the borders.
+    wxImage red(100, 100);
+    red.SetRGB(wxRect(0, 0, 100, 100), 0xff, 0, 0);
+    red.InitAlpha();
+
+    const wxImage rotated = red.Rotate(0.3, wxPoint(50, 50), true);
+    CHECK( rotated.GetRed(rotated.GetWidth() / 2, rotated.GetHeight() / 2) == 0xff );
+    CHECK( rotated.GetGreen(rotated.GetWidth() / 2, rotated.GetHeight() / 2) == 0 );
+    CHECK( rotated.GetAlpha(rotated.GetWidth() / 2, rotated.GetHeight() / 2) == wxIMAGE_ALPHA_OPAQUE );
+    CHECK( rotated.GetAlpha(0, 0) == wxIMAGE_ALPHA_TRANSPARENT );
+}
+
+TEST_CASE("wxImage::ExportPixels", "[image][pixels]")
+{
+    wxImage image(3, 2);
+    unsigned char* data = image.GetData();
+    for ( int n = 0; n < 3*3*2; n++ )
+        data[n] = 10*n;
+
+    const int stride = 4*3 + 4;
+    unsigned char buffer[stride*2];
+
+    SECTION("RGB")
+    {
+        REQUIRE( image.ExportPixels(buffer, stride) );
+        CHECK( buffer[0] == 0 );
+        CHECK( buffer[1] == 10 );
+        CHECK( buffer[2] == 20 );
+        CHECK( buffer[3] == wxIMAGE_ALPHA_OPAQUE );
+        CHECK( buffer[stride + 8] == 150 );
+        CHECK( buffer[stride + 11] == wxIMAGE_ALPHA_OPAQUE );
+
+        wxImage copy;
+        REQUIRE( copy.ImportPixels(3, 2, buffer, stride, wxIMAGE_PIXEL_RGBA,
+                                   wxIMAGE_PIXEL_NO_ALPHA) );
+        CHECK( !copy.HasAlpha() );
+        CHECK_THAT( copy, RGBSameAs(image) );
+    }
+
+    SECTION("BGRA")
+    {
+        image.SetAlpha();
+        unsigned char* const alpha = image.GetAlpha();
+        for ( int n = 0; n < 3*2; n++ )
+            alpha[n] = 50*n;
+
+        REQUIRE( image.ExportPixels(buffer, stride, wxIMAGE_PIXEL_BGRA) );
+        CHECK( buffer[4] == 50 );
+        CHECK( buffer[5] == 40 );
+        CHECK( buffer[6] == 30 );
+        CHECK( buffer[7] == 50 );
+
+        wxImage copy;
+        REQUIRE( copy.ImportPixels(3, 2, buffer, stride, wxIMAGE_PIXEL_BGRA) );
+        REQUIRE( copy.HasAlpha() );
+        CHECK_THAT( copy, RGBSameAs(image) );
+        CHECK( memcmp(copy.GetAlpha(), alpha, 3*2) == 0 );
+    }
+
+    SECTION("ARGB32")
+    {
+        image.SetAlpha();
+        unsigned char* const alpha = image.GetAlpha();
+        for ( int n = 0; n < 3*2; n++ )
+            alpha[n] = 0xff - 51*n;
+
+        REQUIRE( image.ExportPixels(buffer, stride, wxIMAGE_PIXEL_ARGB32,
+                                    wxIMAGE_PIXEL_PREMULTIPLIED) );
+
+        wxUint32 argb;
+        memcpy(&argb, buffer, 4);
+        CHECK( argb == 0xff000a14 );
+
+        // Colour components are premultiplied by alpha == 0xcc.
+        memcpy(&argb, buffer + 4, 4);
+        CHECK( argb == 0xcc182028 );
+
+        // The colour of fully transparent pixels is preserved.
+        memcpy(&argb, buffer + stride + 8, 4);
+        CHECK( argb == 0x0096a0aa );
+
+        wxImage copy;
+        REQUIRE( copy.ImportPixels(3, 2, buffer, stride, wxIMAGE_PIXEL_ARGB32,
+                                   wxIMAGE_PIXEL_PREMULTIPLIED) );
+        CHECK( memcmp(copy.GetAlpha(), alpha, 3*2) == 0 );
+
+        // Premultiplying loses some precision, so compare the values after
+        // undoing it with the expected ones computed in the same way.
+        const unsigned char* const copyData = copy.GetData();
+        for ( int n = 0; n < 3*3*2; n++ )
+        {
+            const int a = alpha[n / 3];
+            const int expected = a ? ((data[n]*a)/255*255)/a : data[n];
+            CHECK( copyData[n] == expected );
+        }
+    }
+}
+
+namespace
+{
+
+class TestDataReleaser : public wxImageDataReleaser
+{
+public:
+    explicit TestDataReleaser(int& count) : m_count(count) { }
+
+    virtual void Release(unsigned char* data, unsigned char* alpha) wxOVERRIDE
+    {
+        m_count++;
+
+        delete [] data;
+        delete [] alpha;
+    }
+
+private:
+    int& m_count;
+};
+
+} // anonymous namespace
+
+TEST_CASE("wxImage::CreateFromExternal", "[image][create]")
+{
+    const int w = 4;
+    const int h = 6;
+
+    unsigned char* const data = new unsigned char[3*w*h];
+    unsigned char* const alpha = new unsigned char[w*h];
+    for ( int n = 0; n < w*h; n++ )
+    {
+        data[3*n] = data[3*n + 1] = data[3*n + 2] = n;
+        alpha[n] = wxIMAGE_ALPHA_OPAQUE;
+    }
+
+    int released = 0;
+
+    {
+        wxImage image;
+        REQUIRE( image.CreateFromExternal(w, h, data, alpha,
+                                          new TestDataReleaser(released)) );
+        CHECK( image.GetData() == data );
+        CHECK( image.GetAlpha() == alpha );
+
+        // Modifying a copy must not change the external data.
+        wxImage copy = image;
+        copy.SetRGB(0, 0, 255, 255, 255);
+        CHECK( copy.GetData() != data );
+        CHECK( data[0] == 0 );
+        CHECK( released == 0 );
+
+        SECTION("GetRowsView")
+        {
+            wxImage view = image.GetRowsView(2, 3);
+            REQUIRE( view.IsOk() );
+            CHECK( view.GetWidth() == w );
+            CHECK( view.GetHeight() == 3 );
+            CHECK( view.GetData() == data + 3*2*w );
+            CHECK( view.GetAlpha() == alpha + 2*w );
+            CHECK( view.GetRed(0, 0) == 2*w );
+
+            // The view must keep the data alive.
+            image.Destroy();
+            CHECK( released == 0 );
+
+            // And modifying it must change the original data.
+            view.SetRGB(1, 0, 1, 2, 3);
+            CHECK( data[3*(2*w + 1)] == 1 );
+
+            WX_ASSERT_FAILS_WITH_ASSERT( view.GetRowsView(2, 2) );
+        }
+    }
+
+    CHECK( released == 1 );
+
+#if wxDEBUG_LEVEL
+    // The releaser must be called, e.g. to free the alpha, and deleted even
+    // if creating the image fails.
+    int releasedInvalid = 0;
+    wxImage invalid;
+    WX_ASSERT_FAILS_WITH_ASSERT
+    (
+        invalid.CreateFromExternal(w, h, NULL, new unsigned char[w*h],
+                                   new TestDataReleaser(releasedInvalid))
+    );
+    CHECK( releasedInvalid == 1 );
+    CHECK( !invalid.IsOk() );
+#endif // wxDEBUG_LEVEL
+}
+
+#if wxUSE_GIF && wxUSE_PALETTE
+
+TEST_CASE("wxGIFDecoder::Frames", "[image][gif]")
+{
+    wxImage image("horse.gif");
+    REQUIRE( image.IsOk() );
+
+    // Use more frames than are kept decoded by wxGIFDecoder to check that
+    // the frames are correctly decoded again when needed.
+    wxImageArray images;
+    images.Add(image);
+    for ( int i = 0; i < 9; ++i )
+    {
+        images.Add( images[i].Mirror(i % 2 == 0) );
+        images[i+1].SetPalette(images[0].GetPalette());
+    }
+
+    wxMemoryOutputStream memOut;
+    REQUIRE( wxGIFHandler().SaveAnimation(images, &memOut) );
+
+    wxMemoryInputStream memIn(memOut);
+    wxGIFDecoder decoder;
+    REQUIRE( decoder.LoadGIF(memIn) == wxGIF_OK );
+    REQUIRE( decoder.GetFrameCount() == images.size() );
+
+    // Access the frames in non sequential order.
+    for ( size_t n = 0; n < 2*images.size(); n++ )
+    {
+        const size_t i = (n * 7) % images.size();
+        INFO("Frame " << i);
+
+        wxImage frame;
+        REQUIRE( decoder.ConvertToImage(i, &frame) );
+        CHECK_THAT( frame, RGBSameAs(images[i]) );
+    }
+}
+
+#endif // wxUSE_GIF && wxUSE_PALETTE
+
+TEST_CASE("wxQuantizer", "[image][quantize]")
+{
+    wxImage image;
+    REQUIRE( image.LoadFile("horse.png") );
+
+    const int w = image.GetWidth();
+    const int h = image.GetHeight();
+
+    // Reference result obtained using the static wxQuantize function.
+    wxVector<unsigned char*> inRows(h), outRows(h);
+    wxVector<unsigned char> expected(w*h);
+    for ( int y = 0; y < h; y++ )
+    {
+        inRows[y] = image.GetData() + 3*w*y;
+        outRows[y] = &expected[w*y];
+    }
+
+    unsigned char palette[3*256];
+    wxQuantize::DoQuantize(w, h, &inRows[0], &outRows[0], palette, 64);
+
+    wxQuantizer quantizer(64);
+    REQUIRE( quantizer.AddImage(image) );
+    REQUIRE( quantizer.CreatePalette() );
+    WX_ASSERT_FAILS_WITH_ASSERT( quantizer.AddImage(image) );
+
+    const int numColours = quantizer.GetPaletteSize();
+    REQUIRE( numColours > 0 );
+    CHECK( numColours <= 64 );
+    CHECK( memcmp(quantizer.GetPaletteData(), palette, 3*numColours) == 0 );
+
+    wxVector<unsigned char> indices(w*h);
+
+    SECTION("Same as wxQuantize")
+    {
+        // Mapping the image twice must reuse the lookup tables without
+        // changing the result.
+        for ( int n = 0; n < 2; n++ )
+        {
+            REQUIRE( quantizer.MapImage(image, &indices[0]) );
+            CHECK( indices == expected );
+        }
+    }
+
+    SECTION("Bands")
+    {
+        quantizer.SetBandHeight(16);
+
+        // The result must not depend on the number of threads used: check it
+        // using an image big enough for the work to be really split between
+        // several threads, horse.png is too small for this.
+        const wxImage big = CreateImageForThreads(false);
+        const int size = big.GetWidth()*big.GetHeight();
+
+        const int maxThreadsOrig = wxImage::GetMaxThreads();
+
+        wxVector<unsigned char> indices1(size);
+        wxImage::SetMaxThreads(1);
+        REQUIRE( quantizer.MapImage(big, &indices1[0]) );
+
+        wxVector<unsigned char> indices4(size);
+        wxImage::SetMaxThreads(4);
+        REQUIRE( quantizer.MapImage(big, &indices4[0]) );
+
+        wxImage::SetMaxThreads(maxThreadsOrig);
+
+        CHECK( indices1 == indices4 );
+
+        for ( int n = 0; n < size; n++ )
+        {
+            if ( indices1[n] >= numColours )
+            {
+                FAIL("Invalid palette index " << (int)indices1[n] << " at " << n);
+            }
+        }
+    }
+
+    SECTION("Image")
+    {
+        wxImage dest;
+        REQUIRE( quantizer.MapImage(image, dest) );
+        REQUIRE( dest.GetSize() == image.GetSize() );
+
+        const unsigned char* data = dest.GetData();
+        for ( int n = 0; n < w*h; n++, data += 3 )
+        {
+            const unsigned char* const colour = palette + 3*expected[n];
+            if ( memcmp(data, colour, 3) != 0 )
+            {
+                FAIL("Unexpected colour at " << n);
+            }
+        }
+    }
+
+    SECTION("Reset")
+    {
+        quantizer.Reset();
+        CHECK( quantizer.AddImage(image.Mirror()) );
+        CHECK( quantizer.MapImage(image, &indices[0]) );
+    }
+
+    SECTION("No images")
+    {
+        quantizer.Reset();
+        WX_ASSERT_FAILS_WITH_ASSERT( quantizer.CreatePalette() );
+        WX_ASSERT_FAILS_WITH_ASSERT( quantizer.MapImage(image, &indices[0]) );
+
+        wxImage dest;
+        WX_ASSERT_FAILS_WITH_ASSERT( quantizer.MapImage(image, dest) );
+        CHECK( !dest.IsOk() );
+    }
+}
+
+#if wxUSE_THREADS
+
+namespace
+{
+
+// Log target collecting all the errors, including the ones logged by the other
+// threads, which are only passed to it by wxLog::FlushActive().
+class ImageLoaderErrorsLog : public wxLog
+{
+public:
+    ImageLoaderErrorsLog() : m_logOld(wxLog::SetActiveTarget(this)) { }
+    virtual ~ImageLoaderErrorsLog() { wxLog::SetActiveTarget(m_logOld); }
+
+    const wxString& GetErrors() const { return m_errors; }
+
+protected:
+    virtual void DoLogTextAtLevel(wxLogLevel level,
+                                  const wxString& msg) wxOVERRIDE
+    {
+        if ( level == wxLOG_Error )
+            m_errors << msg << "\n";
+    }
+
+private:
+    wxLog* const m_logOld;
+    wxString m_errors;
+
+    wxDECLARE_NO_COPY_CLASS(ImageLoaderErrorsLog);
+};
+
+// Event handler storing the contents of all wxEVT_IMAGE_LOADED events.
+class ImageLoaderHandler : public wxEvtHandler
+{
+public:
+    struct Loaded
+    {
+        int index;
+        wxString filename;
+        wxImage image;
+    };
+
+    ImageLoaderHandler()
+    {
+        Bind(wxEVT_IMAGE_LOADED, &ImageLoaderHandler::OnLoaded, this);
+    }
+
+    const wxVector<Loaded>& GetLoaded() const { return m_loaded; }
+
+    // Return the image loaded with the given index, checking that it was sent
+    // exactly once.
+    wxImage GetImage(int index) const
+    {
+        wxImage image;
+        int count = 0;
+        for ( size_t n = 0; n < m_loaded.size(); n++ )
+        {
+            if ( m_loaded[n].index == index )
+            {
+                image = m_loaded[n].image;
+                count++;
+            }
+        }
+
+        CHECK( count == 1 );
+
+        return image;
+    }
+
+private:
+    void OnLoaded(wxImageLoaderEvent& event)
+    {
+        CHECK( event.IsOk() == event.GetImage().IsOk() );
+
+        Loaded loaded;
+        loaded.index = event.GetIndex();
+        loaded.filename = event.GetFileName();
+        loaded.image = event.GetImage();
+        m_loaded.push_back(loaded);
+    }
+
+    wxVector<Loaded> m_loaded;
+};
+
+} // anonymous namespace
+
+TEST_CASE("wxImageLoader", "[image][load]")
+{
+    wxImage::AddHandler(new wxPNGHandler);
+    wxImage::AddHandler(new wxJPEGHandler);
+
+    const char* const files[] =
+    {
+        "horse.png",
+        "horse.jpg",
+        "horse.bmp",
+        "horse.png",
+        "image/cross_bicubic_256x256.png",
+    };
+
+    wxImageLoader loader(NULL, 3);
+    for ( size_t n = 0; n < WXSIZEOF(files); n++ )
+        CHECK( loader.Load(files[n]) == static_cast<int>(n) );
+
+    const int indexStream = loader.Load(new wxFileInputStream("horse.jpg"));
+    const int indexMissing = loader.Load("no-such-file.png");
+    CHECK( loader.GetCount() == static_cast<int>(WXSIZEOF(files)) + 2 );
+
+    for ( size_t n = 0; n < WXSIZEOF(files); n++ )
+    {
+        INFO("File " << files[n]);
+
+        wxImage expected;
+        REQUIRE( expected.LoadFile(files[n]) );
+
+        const wxImage image = loader.GetImage(n);
+        REQUIRE( image.IsOk() );
+        CHECK( loader.IsDone(n) );
+        CHECK_THAT( image, RGBSameAs(expected) );
+    }
+
+    CHECK_THAT( loader.GetImage(indexStream), RGBSameAs(wxImage("horse.jpg")) );
+
+    {
+        // The error is logged by the worker thread, so wxLogNull can't be
+        // used to suppress it, but it must be logged.
+        ImageLoaderErrorsLog log;
+        CHECK( !loader.GetImage(indexMissing).IsOk() );
+        wxLog::FlushActive();
+        CHECK( log.GetErrors().Contains("no-such-file.png") );
+    }
+
+    SECTION("MaxSize")
+    {
+        loader.SetMaxSize(90, 70);
+
+        wxImage expected;
+        expected.SetOption(wxIMAGE_OPTION_MAX_WIDTH, 90);
+        expected.SetOption(wxIMAGE_OPTION_MAX_HEIGHT, 70);
+        REQUIRE( expected.LoadFile("horse.png") );
+
+        CHECK_THAT( loader.GetImage(loader.Load("horse.png")),
+                    RGBSameAs(expected) );
+    }
+
+    SECTION("Cancel")
+    {
+        for ( int n = 0; n < 100; n++ )
+            loader.Load("horse.jpg");
+
+        loader.Cancel();
+        loader.Wait();
+        for ( int n = 0; n < loader.GetCount(); n++ )
+            CHECK( loader.IsDone(n) );
+    }
+}
+
+TEST_CASE("wxImageLoader::Events", "[image][load]")
+{
+    wxImage::AddHandler(new wxPNGHandler);
+    wxImage::AddHandler(new wxJPEGHandler);
+
+    ImageLoaderErrorsLog log;
+
+    ImageLoaderHandler handler;
+    wxImageLoader loader(&handler, 2);
+
+    const int indexPNG = loader.Load("horse.png");
+    const int indexStream = loader.Load(new wxFileInputStream("horse.jpg"));
+    const int indexMissing = loader.Load("no-such-file.png");
+
+    // All the events must have been queued when Wait() returns.
+    loader.Wait();
+    wxTheApp->ProcessPendingEvents();
+
+    const wxVector<ImageLoaderHandler::Loaded>& loaded = handler.GetLoaded();
+    REQUIRE( loaded.size() == 3 );
+    for ( size_t n = 0; n < loaded.size(); n++ )
+    {
+        if ( loaded[n].index == indexPNG )
+            CHECK( loaded[n].filename == "horse.png" );
+        else if ( loaded[n].index == indexStream )
+            CHECK( loaded[n].filename.empty() );
+        else if ( loaded[n].index == indexMissing )
+            CHECK( loaded[n].filename == "no-such-file.png" );
+    }
+
+    CHECK_THAT( handler.GetImage(indexPNG), RGBSameAs(wxImage("horse.png")) );
+    CHECK_THAT( handler.GetImage(indexStream), RGBSameAs(wxImage("horse.jpg")) );
+    CHECK( !handler.GetImage(indexMissing).IsOk() );
+
+    wxLog::FlushActive();
+    CHECK( log.GetErrors().Contains("no-such-file.png") );
+}
+
+#endif // wxUSE_THREADS
+
 #endif //wxUSE_IMAGE
 
 
@@ -21,6 +21,8 @@
 #endif // WX_PRECOMP
 
 #include "wx/intl.h"
+#include "wx/file.h"
+#include "wx/scopedptr.h"
 
 #if wxUSE_INTL
 
@@ -41,6 +43,7 @@ private:
         CPPUNIT_TEST( RestoreLocale );
         CPPUNIT_TEST( Domain );
         CPPUNIT_TEST( Headers );
+        CPPUNIT_TEST( MsgCatalog );
         CPPUNIT_TEST( DateTimeFmtFrench );
         CPPUNIT_TEST( IsAvailable );
     CPPUNIT_TEST_SUITE_END();
@@ -48,6 +51,7 @@ private:
     void RestoreLocale();
     void Domain();
     void Headers();
+    void MsgCatalog();
     void DateTimeFmtFrench();
     void IsAvailable();
 
@@ -150,6 +154,87 @@ void IntlTestCase::Headers()
     CPPUNIT_ASSERT_EQUAL( "", m_locale->GetHeaderValue("X-Not-Here") );
 }
 
+void IntlTestCase::MsgCatalog()
+{
+    // This test doesn't need the French locale, so it doesn't use m_locale.
+    wxScopedPtr<wxMsgCatalog>
+        cat(wxMsgCatalog::CreateFromFile("./intl/fr/internat.mo", "internat"));
+    CPPUNIT_ASSERT( cat );
+
+    const wxString* str = cat->GetString("&Open bogus file");
+    CPPUNIT_ASSERT( str );
+    CPPUNIT_ASSERT_EQUAL( "&Ouvrir un fichier", *str );
+
+    // Looking up the same string again must return the same result.
+    CPPUNIT_ASSERT( cat->GetString("&Open bogus file") == str );
+
+    str = cat->GetString("Enter your number:");
+    CPPUNIT_ASSERT( str );
+    CPPUNIT_ASSERT_EQUAL( wxString::FromUTF8("Entrez votre num\xc3\xa9ro:"), *str );
+
+    CPPUNIT_ASSERT( !cat->GetString("&Open") );
+    CPPUNIT_ASSERT( !cat->GetString("&Open bogus file", UINT_MAX, "Bogus") );
+
+    // Check that the catalogs created from memory work in the same way.
+    wxFile file("./intl/ja/internat.mo");
+    CPPUNIT_ASSERT( file.IsOpened() );
+
+    const size_t len = file.Length();
+    wxCharBuffer data(len);
+    CPPUNIT_ASSERT_EQUAL( len, file.Read(data.data(), len) );
+
+    cat.reset(wxMsgCatalog::CreateFromData(data, "internat"));
+    CPPUNIT_ASSERT( cat );
+
+    str = cat->GetString("View");
+    CPPUNIT_ASSERT( str );
+    CPPUNIT_ASSERT_EQUAL( wxString::FromUTF8("\xe9\x96\xb2\xe8\xa6\xa7"), *str );
+
+    str = cat->GetString("B&ogus");
+    CPPUNIT_ASSERT( str );
+    CPPUNIT_ASSERT_EQUAL( "Preten&d", *str );
+
+    CPPUNIT_ASSERT( !cat->GetString("Bogus") );
+
+    // The catalog must still work after the data of a non-owned buffer it
+    // was created from is changed.
+    wxCharBuffer copy(len);
+    memcpy(copy.data(), data.data(), len);
+
+    cat.reset(wxMsgCatalog::CreateFromData
+              (
+                wxScopedCharBuffer::CreateNonOwned(copy.data(), len),
+                "internat"
+              ));
+    CPPUNIT_ASSERT( cat );
+
+    memset(copy.data(), 0, len);
+
+    str = cat->GetString("View");
+    CPPUNIT_ASSERT( str );
+    CPPUNIT_ASSERT_EQUAL( wxString::FromUTF8("\xe9\x96\xb2\xe8\xa6\xa7"), *str );
+
+    // And creating a catalog from corrupted data must fail instead of
+    // crashing when the strings are looked up: make the offset of the last
+    // translation (the catalog is in little endian format) point outside it.
+    memcpy(copy.data(), data.data(), len);
+
+    wxUint32 ofsTransTable;
+    memcpy(&ofsTransTable, copy.data() + 0x10, sizeof(ofsTransTable));
+    ofsTransTable = wxUINT32_SWAP_ON_BE(ofsTransTable);
+
+    wxUint32 numStrings;
+    memcpy(&numStrings, copy.data() + 0x08, sizeof(numStrings));
+    numStrings = wxUINT32_SWAP_ON_BE(numStrings);
+
+    const wxUint32 ofsBad = 0xfffffff0;
+    memcpy(copy.data() + ofsTransTable + 8*(numStrings - 1) + 4,
+           &ofsBad, sizeof(ofsBad));
+
+    cat.reset(wxMsgCatalog::CreateFromData(copy, "internat"));
+    CPPUNIT_ASSERT( !cat );
+}
+
 static wxString
 NormalizeFormat(const wxString& fmtOrig)
 {
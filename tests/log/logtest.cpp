@@ -22,6 +22,7 @@
 #endif // WX_PRECOMP
 
 #include "wx/scopeguard.h"
+#include "wx/thread.h"
 
 #if wxUSE_LOG
 
@@ -98,6 +99,27 @@ private:
     wxDECLARE_NO_COPY_CLASS(TestLog);
 };
 
+// log sink which stores all the formatted messages
+class TestTextLog : public wxLog
+{
+public:
+    TestTextLog() { }
+
+    const wxArrayString& GetMessages() const { return m_messages; }
+
+protected:
+    virtual void DoLogTextAtLevel(wxLogLevel WXUNUSED(level),
+                                  const wxString& msg) wxOVERRIDE
+    {
+        m_messages.push_back(msg);
+    }
+
+private:
+    wxArrayString m_messages;
+
+    wxDECLARE_NO_COPY_CLASS(TestTextLog);
+};
+
 #if WXWIN_COMPATIBILITY_2_8
 
 // log sink overriding the old DoLogXXX() functions should still work too
@@ -178,6 +200,10 @@ private:
 #endif // WXWIN_COMPATIBILITY_2_8
         CPPUNIT_TEST( SysError );
         CPPUNIT_TEST( NoWarnings );
+#if wxUSE_THREADS
+        CPPUNIT_TEST( Async );
+        CPPUNIT_TEST( AsyncChangeTarget );
+#endif // wxUSE_THREADS
     CPPUNIT_TEST_SUITE_END();
 
     void Functions();
@@ -192,6 +218,10 @@ private:
 #endif // WXWIN_COMPATIBILITY_2_8
     void SysError();
     void NoWarnings();
+#if wxUSE_THREADS
+    void Async();
+    void AsyncChangeTarget();
+#endif // wxUSE_THREADS
 
     TestLog *m_log;
     wxLog *m_logOld;
@@ -394,6 +424,101 @@ void LogTestCase::NoWarnings()
     CPPUNIT_ASSERT_EQUAL( "If", m_log->GetLog(wxLOG_Error) );
 }
 
+#if wxUSE_THREADS
+
+// thread logging the given number of messages
+class LoggingThread : public wxThread
+{
+public:
+    explicit LoggingThread(int numMessages)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_numMessages(numMessages)
+    {
+    }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        for ( int n = 0; n < m_numMessages; n++ )
+            wxLogMessage("Thread %d", n);
+
+        return 0;
+    }
+
+private:
+    const int m_numMessages;
+};
+
+void LogTestCase::Async()
+{
+    TestTextLog* const log = new TestTextLog;
+
+    // Use a long flush interval to ensure that the messages are not flushed
+    // before we call Flush() ourselves, unless the buffer gets full.
+    wxLogAsync* const logAsync = new wxLogAsync(log, 10, 100000);
+    wxLog* const logOld = wxLog::SetActiveTarget(logAsync);
+
+    wxLogMessage("Main");
+
+    LoggingThread thread(100);
+    CPPUNIT_ASSERT( thread.Run() == wxTHREAD_NO_ERROR );
+    thread.Wait();
+
+    logAsync->Flush();
+
+    // The message from the main thread must have been logged first and the
+    // messages from the other thread must have been logged in order, with
+    // the possible exception of the warnings about the dropped messages.
+    const wxArrayString& messages = log->GetMessages();
+    CPPUNIT_ASSERT( !messages.empty() );
+    CPPUNIT_ASSERT( messages[0].EndsWith("Main") );
+
+    unsigned long numLogged = 0;
+    long numLast = -1;
+    for ( size_t n = 1; n < messages.size(); n++ )
+    {
+        if ( messages[n].EndsWith("dropped") )
+            continue;
+
+        long num;
+        CPPUNIT_ASSERT( messages[n].AfterLast(' ').ToLong(&num) );
+        CPPUNIT_ASSERT( num > numLast );
+
+        numLast = num;
+        numLogged++;
+    }
+
+    // And all of them must have been either logged or dropped.
+    CPPUNIT_ASSERT_EQUAL( 100, numLogged + logAsync->GetDroppedCount() );
+
+    delete wxLog::SetActiveTarget(logOld);
+}
+
+void LogTestCase::AsyncChangeTarget()
+{
+    wxLog* const logOld = wxLog::SetActiveTarget(new wxLogAsync(new TestTextLog));
+
+    LoggingThread thread1(10000),
+                  thread2(10000);
+    CPPUNIT_ASSERT( thread1.Run() == wxTHREAD_NO_ERROR );
+    CPPUNIT_ASSERT( thread2.Run() == wxTHREAD_NO_ERROR );
+
+    // Deleting the old target returned by SetActiveTarget() must be safe even
+    // if the other threads are logging to it.
+    for ( int n = 0; n < 50; n++ )
+    {
+        delete wxLog::SetActiveTarget(new wxLogAsync(new TestTextLog));
+        wxMilliSleep(1);
+    }
+
+    thread1.Wait();
+    thread2.Wait();
+
+    delete wxLog::SetActiveTarget(logOld);
+}
+
+#endif // wxUSE_THREADS
+
 // The following two functions (v, macroCompilabilityTest) are not run by
 // any test, and their purpose is merely to guarantee that the wx(V)LogXXX
 // macros compile without 'dangling else' warnings.
@@ -1509,3 +1509,54 @@ TEST_CASE("wxMBConv::cMB2WC", "[mbconv][mb2wc]")
     CHECK( wxConvUTF7.cMB2WC(wxCharBuffer()).length() == 0 );
     CHECK( wxConvUTF7.cMB2WC("+AKM-").length() == 1 );
 }
+
+// Long strings are converted in blocks, check that the characters needing
+// special handling are found at any position in them.
+TEST_CASE("wxMBConv::Blocks", "[mbconv][utf8][utf16]")
+{
+    const size_t LEN = 80;
+
+    wxMBConvUTF16LE convUTF16LE;
+    wxMBConvUTF16BE convUTF16BE;
+
+    for ( size_t pos = 0; pos < LEN; pos++ )
+    {
+        INFO("Special character at " << pos);
+
+        const wxString ascii(wxString(wxS('x'), pos) + wxString(wxS('y'), LEN - pos));
+
+        wxString bmp(ascii);
+        bmp[pos] = wxUniChar(0x426);
+
+        wxString nonBMP(ascii);
+        nonBMP.replace(pos, 1, wxString::FromUTF8("\xF0\x9F\x98\x80"));
+
+        const wxString* const strings[] = { &ascii, &bmp, &nonBMP };
+        for ( size_t n = 0; n < WXSIZEOF(strings); n++ )
+        {
+            const wxString& s = *strings[n];
+
+            const wxCharBuffer utf8 = s.utf8_str();
+            CHECK( utf8.length() == LEN + n + (n == 2) );
+            CHECK( wxString::FromUTF8(utf8.data(), utf8.length()) == s );
+
+            const wxCharBuffer utf16le = s.mb_str(convUTF16LE);
+            CHECK( utf16le.length() == 2*(LEN + (n == 2)) );
+            CHECK( wxString(utf16le, convUTF16LE, utf16le.length()) == s );
+
+            const wxCharBuffer utf16be = s.mb_str(convUTF16BE);
+            CHECK( utf16be.length() == utf16le.length() );
+            CHECK( wxString(utf16be, convUTF16BE, utf16be.length()) == s );
+
+            // The output buffer must be big enough for all characters.
+            char buf[2*LEN];
+            CHECK( wxConvUTF8.FromWChar(buf, utf8.length() - 1,
+                                        s.wc_str(), s.length()) == wxCONV_FAILED );
+        }
+
+        // Invalid UTF-8 must be detected anywhere too.
+        wxCharBuffer invalid(ascii.utf8_str());
+        invalid.data()[pos] = '\x80';
+        CHECK( wxConvUTF8.ToWChar(NULL, 0, invalid.data(), LEN) == wxCONV_FAILED );
+    }
+}
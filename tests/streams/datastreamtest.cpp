@@ -24,6 +24,7 @@
 
 #include "wx/datstrm.h"
 #include "wx/wfstream.h"
+#include "wx/mstream.h"
 #include "wx/math.h"
 
 #include "testfile.h"
@@ -312,4 +313,141 @@ void DataStreamTestCase::NaNRW()
     //TODO?
 }
 
+// Helpers allowing to call the array overloads from a template.
+static void WriteValues(wxDataOutputStream& dos, const float* p, size_t n)
+    { dos.WriteFloat(p, n); }
+static void WriteValues(wxDataOutputStream& dos, const double* p, size_t n)
+    { dos.WriteDouble(p, n); }
+static void WriteValues(wxDataOutputStream& dos, const wxUint16* p, size_t n)
+    { dos.Write16(p, n); }
+static void WriteValues(wxDataOutputStream& dos, const wxUint32* p, size_t n)
+    { dos.Write32(p, n); }
+#if wxHAS_INT64
+static void WriteValues(wxDataOutputStream& dos, const wxUint64* p, size_t n)
+    { dos.Write64(p, n); }
+#endif // wxHAS_INT64
+
+static void ReadValues(wxDataInputStream& dis, float* p, size_t n)
+    { dis.ReadFloat(p, n); }
+static void ReadValues(wxDataInputStream& dis, double* p, size_t n)
+    { dis.ReadDouble(p, n); }
+static void ReadValues(wxDataInputStream& dis, wxUint16* p, size_t n)
+    { dis.Read16(p, n); }
+static void ReadValues(wxDataInputStream& dis, wxUint32* p, size_t n)
+    { dis.Read32(p, n); }
+#if wxHAS_INT64
+static void ReadValues(wxDataInputStream& dis, wxUint64* p, size_t n)
+    { dis.Read64(p, n); }
+#endif // wxHAS_INT64
+
+// Write the array of values and read it back using the array overloads, the
+// number of values is big enough to not fit into a single internal chunk.
+// Also check that the array overloads write exactly the same data as writing
+// the values one by one does.
+template <typename T>
+static void DoTestArrayRW(bool bigEndian, bool basicPrecision)
+{
+    std::vector<T> values(3000);
+    for ( size_t n = 0; n < values.size(); n++ )
+        values[n] = static_cast<T>(n*1.5 + 0.25);
+
+    wxMemoryOutputStream mos, mosScalar;
+    {
+        wxDataOutputStream dos(mos), dosScalar(mosScalar);
+        dos.BigEndianOrdered(bigEndian);
+        dosScalar.BigEndianOrdered(bigEndian);
+        if ( basicPrecision )
+        {
+            dos.UseBasicPrecisions();
+            dosScalar.UseBasicPrecisions();
+        }
+
+        dos.Write32(static_cast<wxUint32>(values.size()));
+        WriteValues(dos, &values[0], values.size());
+        dos << values.back();
+
+        dosScalar.Write32(static_cast<wxUint32>(values.size()));
+        for ( size_t n = 0; n < values.size(); n++ )
+            dosScalar << values[n];
+        dosScalar << values.back();
+    }
+
+    const size_t len = mos.GetLength();
+    REQUIRE( mosScalar.GetLength() == len );
+
+    std::vector<char> data(len), dataScalar(len);
+    REQUIRE( mos.CopyTo(&data[0], len) == len );
+    REQUIRE( mosScalar.CopyTo(&dataScalar[0], len) == len );
+    CHECK( data == dataScalar );
+
+    wxMemoryInputStream mis(mos);
+    wxDataInputStream dis(mis);
+    dis.BigEndianOrdered(bigEndian);
+    if ( basicPrecision )
+        dis.UseBasicPrecisions();
+
+    std::vector<T> read(dis.Read32());
+    REQUIRE( read.size() == values.size() );
+    ReadValues(dis, &read[0], read.size());
+    CHECK( read == values );
+
+    T last;
+    dis >> last;
+    CHECK( last == values.back() );
+    CHECK( mis.GetLastError() == wxSTREAM_NO_ERROR );
+}
+
+TEST_CASE("wxDataStream::Arrays", "[stream][datastream]")
+{
+    SECTION("Order")
+    {
+        const wxUint32 values32[] = { 0x01020304, 0x05060708 };
+        const wxUint16 values16[] = { 0x090a };
+
+        wxMemoryOutputStream mosBE, mosLE;
+        wxDataOutputStream dosBE(mosBE), dosLE(mosLE);
+        dosBE.BigEndianOrdered(true);
+        dosBE.Write32(values32, WXSIZEOF(values32));
+        dosBE.Write16(values16, WXSIZEOF(values16));
+        dosLE.Write32(values32, WXSIZEOF(values32));
+        dosLE.Write16(values16, WXSIZEOF(values16));
+
+        char buf[10];
+        REQUIRE( mosBE.CopyTo(buf, sizeof(buf)) == sizeof(buf) );
+        CHECK( memcmp(buf, "\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0a", 10) == 0 );
+        REQUIRE( mosLE.CopyTo(buf, sizeof(buf)) == sizeof(buf) );
+        CHECK( memcmp(buf, "\x04\x03\x02\x01\x08\x07\x06\x05\x0a\x09", 10) == 0 );
+    }
+
+    SECTION("Float")
+    {
+        DoTestArrayRW<float>(false, true);
+        DoTestArrayRW<float>(true, true);
+#if wxUSE_APPLE_IEEE
+        DoTestArrayRW<float>(false, false);
+        DoTestArrayRW<float>(true, false);
+#endif // wxUSE_APPLE_IEEE
+    }
 
+    SECTION("Double")
+    {
+        DoTestArrayRW<double>(false, true);
+        DoTestArrayRW<double>(true, true);
+#if wxUSE_APPLE_IEEE
+        DoTestArrayRW<double>(false, false);
+        DoTestArrayRW<double>(true, false);
+#endif // wxUSE_APPLE_IEEE
+    }
+
+    SECTION("Integers")
+    {
+        DoTestArrayRW<wxUint32>(false, true);
+        DoTestArrayRW<wxUint32>(true, true);
+        DoTestArrayRW<wxUint16>(false, true);
+        DoTestArrayRW<wxUint16>(true, true);
+#if wxHAS_INT64
+        DoTestArrayRW<wxUint64>(false, true);
+        DoTestArrayRW<wxUint64>(true, true);
+#endif // wxHAS_INT64
+    }
+}
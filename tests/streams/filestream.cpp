@@ -22,6 +22,7 @@
 #include "wx/wfstream.h"
 
 #include "bstream.h"
+#include "testfile.h"
 
 #define DATABUFFER_SIZE     1024
 
@@ -147,3 +148,35 @@ wxString fileStream::GetInFileName() const
 // Register the stream sub suite, by using some stream helper macro.
 // Note: Don't forget to connect it to the base suite (See: bstream.cpp => StreamCase::suite())
 STREAM_TEST_SUBSUITE_NAMED_REGISTRATION(fileStream)
+
+TEST_CASE("wxMappedFileInputStream", "[stream][file][mmap]")
+{
+    TempFile tf("mappedinstream.test");
+    {
+        wxFileOutputStream out(tf.GetName());
+        REQUIRE( out.Write("0123456789", 10).LastWrite() == 10 );
+    }
+
+    wxMappedFileInputStream in(tf.GetName());
+    REQUIRE( in.IsOk() );
+    CHECK( in.IsSeekable() );
+    CHECK( in.GetLength() == 10 );
+
+    char buf[16];
+    CHECK( in.Read(buf, 4).LastRead() == 4 );
+    CHECK( memcmp(buf, "0123", 4) == 0 );
+    CHECK( in.TellI() == 4 );
+
+    CHECK( in.SeekI(-2, wxFromEnd) == 8 );
+    CHECK( in.Read(buf, sizeof(buf)).LastRead() == 2 );
+    CHECK( memcmp(buf, "89", 2) == 0 );
+    CHECK( in.Eof() );
+
+    CHECK( in.SeekI(1) == 1 );
+    CHECK( in.GetC() == '1' );
+    CHECK( in.SeekI(20) == wxInvalidOffset );
+
+    wxLogNull noLog;
+    wxMappedFileInputStream missing("no-such-file");
+    CHECK( !missing.IsOk() );
+}
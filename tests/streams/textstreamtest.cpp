@@ -21,6 +21,7 @@
 #endif // WX_PRECOMP
 
 #include "wx/txtstrm.h"
+#include "wx/vector.h"
 #include "wx/wfstream.h"
 
 #if wxUSE_LONGLONG
@@ -326,4 +327,93 @@ TEST_CASE("wxTextInputStream::GetChar", "[text][input][stream][char]")
     }
 }
 
+TEST_CASE("wxTextInputStream::ReadLine", "[text][input][stream][line]")
+{
+    // Use lines long enough to be read in several blocks, with multibyte
+    // characters, including non-BMP ones, split between them.
+    SECTION("long-lines")
+    {
+        const wxString euro = wxString::FromUTF8("\xe2\x82\xac");
+        const wxString smiley = wxString::FromUTF8("\xf0\x9f\x98\x80");
+        const char* const eols[] = { "\n", "\r\n", "\r" };
+
+        wxVector<wxString> lines;
+        wxString text;
+        for ( int n = 0; n < 30; n++ )
+        {
+            wxString line;
+            for ( int i = 0; i < n*n; i++ )
+                line += i % 3 ? wxString(euro) : i % 5 ? smiley : "x";
+
+            lines.push_back(line);
+            text += line + eols[n % WXSIZEOF(eols)];
+        }
+
+        const wxScopedCharBuffer utf8 = text.utf8_str();
+        wxMemoryInputStream mis(utf8.data(), utf8.length());
+        wxTextInputStream tis(mis);
+
+        for ( size_t n = 0; n < lines.size(); n++ )
+        {
+            INFO("Line #" << n);
+            CHECK( !mis.Eof() );
+            CHECK( tis.ReadLine() == lines[n] );
+        }
+
+        // The last line ends with CR, so we had to read beyond it.
+        CHECK( mis.Eof() );
+    }
+
+    SECTION("no-final-eol")
+    {
+        const char buf[] = "first\nsecond\nlast";
+        wxMemoryInputStream mis(buf, strlen(buf));
+        wxTextInputStream tis(mis);
+
+        CHECK( tis.ReadLine() == "first" );
+        CHECK( tis.ReadLine() == "second" );
+        CHECK( !mis.Eof() );
+        CHECK( tis.ReadLine() == "last" );
+        CHECK( mis.Eof() );
+        CHECK( tis.ReadLine() == "" );
+    }
+
+    SECTION("final-eol")
+    {
+        const char buf[] = "first\nlast\n";
+        wxMemoryInputStream mis(buf, strlen(buf));
+        wxTextInputStream tis(mis);
+
+        CHECK( tis.ReadLine() == "first" );
+        CHECK( tis.ReadLine() == "last" );
+        CHECK( !mis.Eof() );
+        CHECK( tis.ReadLine() == "" );
+        CHECK( mis.Eof() );
+    }
+
+    // Invalid UTF-8 must still make wxConvAuto fall back to Latin-1.
+    SECTION("fallback")
+    {
+        const char buf[] = "first\ncaf\xe9\nlast\n";
+        wxMemoryInputStream mis(buf, strlen(buf));
+        wxTextInputStream tis(mis);
+
+        CHECK( tis.ReadLine() == "first" );
+        CHECK( tis.ReadLine() == wxString::FromUTF8("caf\xc3\xa9") );
+        CHECK( tis.ReadLine() == "last" );
+    }
+
+    // And an explicit UTF-8 conversion must not accept it at all.
+    SECTION("invalid")
+    {
+        const char buf[] = "first\ncaf\xe9\nlast\n";
+        wxMemoryInputStream mis(buf, strlen(buf));
+        wxTextInputStream tis(mis, " \t", wxConvUTF8);
+
+        CHECK( tis.ReadLine() == "first" );
+        CHECK( tis.ReadLine() == "caf" );
+        CHECK( !mis.IsOk() );
+    }
+}
+
 #endif // wxUSE_UNICODE
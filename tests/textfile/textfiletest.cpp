@@ -24,6 +24,8 @@
 #include "wx/ffile.h"
 #include "wx/textfile.h"
 
+#include "testfile.h"
+
 #ifdef __VISUALC__
     #define unlink _unlink
 #endif
@@ -338,6 +340,195 @@ void TextFileTestCase::ReadBig()
                           f[NUM_LINES - 1] );
 }
 
+#if wxUSE_UNICODE
+
+TEST_CASE("wxTextFile::BOM", "[textfile][bom]")
+{
+    TempFile tf("textfilebom.txt");
+    {
+        wxFFile f(tf.GetName(), "wb");
+        REQUIRE( f.Write("\xef\xbb\xbf" "foo\nbar", 10) );
+    }
+
+    wxTextFile f;
+
+    SECTION("Auto")
+    {
+        // The BOM is skipped when using the default conversion.
+        REQUIRE( f.Open(tf.GetName()) );
+        REQUIRE( f.GetLineCount() == 2 );
+        CHECK( f[0] == "foo" );
+        CHECK( f[1] == "bar" );
+    }
+
+    SECTION("UTF-8")
+    {
+        // But it is kept when using UTF-8 explicitly.
+        REQUIRE( f.Open(tf.GetName(), wxConvUTF8) );
+        REQUIRE( f.GetLineCount() == 2 );
+        CHECK( f[0] == wxString(wxUniChar(0xfeff)) + "foo" );
+    }
+}
+
+TEST_CASE("wxTextFile::Conv", "[textfile][conv]")
+{
+    TempFile tf("textfileconv.txt");
+    {
+        wxFFile f(tf.GetName(), "wb");
+        REQUIRE( f.Write("\\\xc3\xa9\n\xe9", 5) );
+    }
+
+    wxTextFile f;
+
+    SECTION("Latin-1")
+    {
+        REQUIRE( f.Open(tf.GetName(), wxConvISO8859_1) );
+        REQUIRE( f.GetLineCount() == 2 );
+        CHECK( f[0] == wxString::FromUTF8("\\\xc3\x83\xc2\xa9") );
+        CHECK( f[1] == wxString::FromUTF8("\xc3\xa9") );
+    }
+
+    SECTION("Octal")
+    {
+        wxMBConvUTF8 conv(wxMBConvUTF8::MAP_INVALID_UTF8_TO_OCTAL);
+        REQUIRE( f.Open(tf.GetName(), conv) );
+        REQUIRE( f.GetLineCount() == 2 );
+        CHECK( f[0] == wxString::FromUTF8("\\\\\xc3\xa9") );
+        CHECK( f[1] == "\\351" );
+    }
+
+    SECTION("Fallback")
+    {
+        // This file is not valid UTF-8, so wxConvAuto falls back to Latin-1.
+        REQUIRE( f.Open(tf.GetName()) );
+        REQUIRE( f.GetLineCount() == 2 );
+        CHECK( f[1] == wxString::FromUTF8("\xc3\xa9") );
+    }
+}
+
+#ifdef __LINUX__
+
+// Check if the file with the given name is currently mapped by this process.
+static bool IsFileMapped(const wxString& name)
+{
+    FILE* const fp = fopen("/proc/self/maps", "r");
+    if ( !fp )
+        return false;
+
+    bool found = false;
+    char buf[4096];
+    while ( !found && fgets(buf, sizeof(buf), fp) )
+        found = strstr(buf, name.utf8_str()) != NULL;
+
+    fclose(fp);
+
+    return found;
+}
+
+#endif // __LINUX__
+
+TEST_CASE("wxTextFile::Lazy", "[textfile][lazy]")
+{
+    TempFile tf("textfilelazy.txt");
+    {
+        wxFFile f(tf.GetName(), "wb");
+        REQUIRE( f.Write("foo\r\n\xd0\x9f\rbar\n\nbaz", 16) );
+    }
+
+    wxTextFile f;
+    f.SetLazyLoading();
+    REQUIRE( f.Open(tf.GetName()) );
+    REQUIRE( f.GetLineCount() == 5 );
+
+    SECTION("Read")
+    {
+        CHECK( f.GetLineType(0) == wxTextFileType_Dos );
+        CHECK( f.GetLineType(1) == wxTextFileType_Mac );
+        CHECK( f.GetLineType(2) == wxTextFileType_Unix );
+        CHECK( f.GetLineType(4) == wxTextFileType_None );
+
+        CHECK( f[4] == "baz" );
+        CHECK( f[0] == "foo" );
+        CHECK( f[1] == wxString::FromUTF8("\xd0\x9f") );
+        CHECK( f[3] == "" );
+
+        wxString all;
+        for ( wxString str = f.GetFirstLine(); !f.Eof(); str = f.GetNextLine() )
+            all += str;
+        CHECK( all == wxString::FromUTF8("foo\xd0\x9f" "barbaz") );
+    }
+
+    SECTION("Modify")
+    {
+        f.RemoveLine(1);
+        f.InsertLine("first", 0);
+        f.AddLine("last");
+        f.GetLine(1) += "!";
+
+        REQUIRE( f.GetLineCount() == 6 );
+        CHECK( f[0] == "first" );
+        CHECK( f[1] == "foo!" );
+        CHECK( f[2] == "bar" );
+        CHECK( f[4] == "baz" );
+        CHECK( f[5] == "last" );
+        CHECK( f.GetLineType(1) == wxTextFileType_Dos );
+    }
+
+    SECTION("Write")
+    {
+        f.GetLine(2) = "qux";
+        REQUIRE( f.Write(wxTextFileType_Unix) );
+
+        wxTextFile f2;
+        REQUIRE( f2.Open(tf.GetName()) );
+        REQUIRE( f2.GetLineCount() == 5 );
+        CHECK( f2[1] == wxString::FromUTF8("\xd0\x9f") );
+        CHECK( f2[2] == "qux" );
+        CHECK( f2[4] == "baz" );
+    }
+
+    SECTION("Reopen")
+    {
+        f.Close();
+        CHECK( f.GetLineCount() == 0 );
+
+        REQUIRE( f.Open(tf.GetName()) );
+        CHECK( f.GetLineCount() == 5 );
+        CHECK( f[2] == "bar" );
+    }
+
+#ifdef __LINUX__
+    // The file must be unmapped as soon as its lines are not needed.
+    SECTION("Unmap on close")
+    {
+        CHECK( IsFileMapped(tf.GetName()) );
+        f.Close();
+        CHECK( !IsFileMapped(tf.GetName()) );
+    }
+
+    SECTION("Unmap on removing all lines")
+    {
+        while ( f.GetLineCount() )
+            f.RemoveLine(0);
+        CHECK( !IsFileMapped(tf.GetName()) );
+    }
+
+    SECTION("Unmap on write")
+    {
+        // Accessing all the lines one by one doesn't unmap it.
+        for ( size_t n = 0; n < f.GetLineCount(); n++ )
+            f.GetLine(n);
+        CHECK( IsFileMapped(tf.GetName()) );
+
+        REQUIRE( f.Write() );
+        CHECK( !IsFileMapped(tf.GetName()) );
+        CHECK( f[0] == "foo" );
+    }
+#endif // __LINUX__
+}
+
+#endif // wxUSE_UNICODE
+
 #ifdef __LINUX__
 
 // Check if using wxTextFile with special files, whose reported size doesn't